@@ -31,6 +31,10 @@ extern "C"
 #ifdef HAVE_CONFIG_H
 #include <config.h>
 #endif
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
 }
 
 
@@ -81,8 +85,16 @@ int main(int argc, char *argv[])
 			std::auto_ptr<JAULA::Value_Complex> pParsed(JAULA::Parser::parseStream(arch));
 			std::cout << "Ok." << std::endl
 				<< std::endl
-				<< "Reduced expression of " << argv[i] << ':' << std::endl
-				<< *(pParsed.get()) << std::endl;
+				<< "Reduced expression of " << argv[i] << ':' << std::endl;
+
+			// output bypasses std::cout, so its pending data goes first
+			std::cout.flush();
+			{
+				JAULA::Fd_Sink	out(STDOUT_FILENO);
+				JAULA::Writer	writer(out);
+				writer.write(*(pParsed.get()));
+			}
+			std::cout << std::endl;
 			good++;
 		}
 		catch(JAULA::Exception ex)
@@ -129,7 +129,7 @@ int main(int argc, char *argv[])
 						std::cerr << std::endl
 							<< "Unsupported Symbol read (" << resp
 							<< ") analyzing line "
-							<< lexan.lineno()
+							<< lexan.getLine()
 							<< "from " << argv[i] << "." << std::endl;
 						break;
 				}
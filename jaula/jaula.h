@@ -446,6 +446,12 @@ namespace JAULA
 #include <jaula/jaula_syntax_error.h>
 
 // Data containers
+#include <jaula/jaula_column_table.h>
+#include <jaula/jaula_json_patch.h>
+#include <jaula/jaula_json_path.h>
+#include <jaula/jaula_json_pointer.h>
+#include <jaula/jaula_json_schema.h>
+#include <jaula/jaula_shared_value.h>
 #include <jaula/jaula_value_array.h>
 #include <jaula/jaula_value_boolean.h>
 #include <jaula/jaula_value_null.h>
@@ -454,8 +460,38 @@ namespace JAULA
 #include <jaula/jaula_value_object.h>
 #include <jaula/jaula_value_string.h>
 
+// output routines
+#include <jaula/jaula_fd_sink.h>
+#include <jaula/jaula_number_format.h>
+#include <jaula/jaula_output_buffer.h>
+#include <jaula/jaula_sink.h>
+#include <jaula/jaula_stream_sink.h>
+#include <jaula/jaula_stream_writer.h>
+#include <jaula/jaula_string_escape.h>
+#include <jaula/jaula_writer.h>
+
+// binary encodings
+#include <jaula/jaula_cbor.h>
+#include <jaula/jaula_msgpack.h>
+#include <jaula/jaula_snapshot.h>
+
+// binding to C++ types
+#include <jaula/jaula_bind.h>
+#include <jaula/jaula_bind_handler.h>
+#include <jaula/jaula_bind_type.h>
+#include <jaula/jaula_optional.h>
+
 // parsing routines
+#include <jaula/jaula_column_builder.h>
+#include <jaula/jaula_document_cache.h>
+#include <jaula/jaula_incremental_parser.h>
+#include <jaula/jaula_json_path_matcher.h>
+#include <jaula/jaula_json_schema_validator.h>
 #include <jaula/jaula_parse.h>
+#include <jaula/jaula_parse_handler.h>
+#include <jaula/jaula_parse_result.h>
+#include <jaula/jaula_value_builder.h>
+#include <jaula/jaula_value_walker.h>
 #endif
 
 // EOF $Id: jaula.h 45 2009-01-11 16:17:03Z morongo $
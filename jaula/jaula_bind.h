@@ -0,0 +1,290 @@
+
+/*
+ * jaula_bind.h : JSON Analysis User Library Acronym
+ * C++ type binding definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_BIND_H_
+#define _JAULA_BIND_H_
+
+#include <cstddef>
+
+#include <jaula/jaula_bind_handler.h>
+#include <jaula/jaula_bind_type.h>
+#include <jaula/jaula_incremental_parser.h>
+#include <jaula/jaula_optional.h>
+#include <jaula/jaula_parse_result.h>
+#include <jaula/jaula_stream_writer.h>
+
+/**
+ * \addtogroup jaula_bind JAULA: Binding to C++ types
+ */
+
+/**
+ * \brief Binds the members of a structure to JSON object properties
+ *
+ * \ingroup jaula_bind
+ *
+ * \param S Name of the structure, that must be default constructible and
+ * assignable.
+ *
+ * \param ... Names of the members to bind (up to 32). Each one is bound to
+ * the property with the same name and its type must be bound too.
+ *
+ * \par Description
+ * This macro must be used at global scope. It generates the Bind_Traits
+ * specialization for the structure, holding one accessor per member and the
+ * member table looked up while parsing, so the structure can be filled by a
+ * Bind_Handler and written by a Stream_Writer with no intermediate Value.
+ *
+ * \par
+ * Members must be accessible, so private ones require the structure to
+ * declare Bind_Traits<S> as a friend.
+ *
+ * \par Example
+ * \code
+ * struct Order
+ * {
+ *   long id;
+ *   double price;
+ *   std::vector<std::string> items;
+ *   JAULA::Optional<std::string> note;
+ * };
+ *
+ * JAULA_BIND(Order, id, price, items, note)
+ * \endcode
+ */
+#define JAULA_BIND(S, ...) \
+  namespace JAULA \
+  { \
+    template <> \
+      struct Bind_Traits<S> \
+    { \
+      JAULA_BIND_EACH(JAULA_BIND_ACCESS, S, __VA_ARGS__) \
+      static Bind_Type const &type(void) \
+      { \
+        static Bind_Field const fields[] = \
+        { \
+          JAULA_BIND_EACH(JAULA_BIND_FIELD, S, __VA_ARGS__) \
+        }; \
+        static Bind_Fields const table(fields \
+          , sizeof(fields) / sizeof(fields[0])); \
+        static Bind_Type const type = \
+        { \
+          #S, Bind_Type::OBJECT, 0, 0, 0, 0, 0 \
+          , &clear, 0, 0, 0, &table, 0, &write \
+        }; \
+        return type; \
+      } \
+      static void clear(void *target) \
+      { \
+        *static_cast<S *>(target) = S(); \
+      } \
+      static void write(void const *value, Stream_Writer &writer) \
+      { \
+        type().fields->write(value, writer); \
+      } \
+    }; \
+  }
+
+/**
+ * \brief Generates the accessors of a bound member (internal use)
+ */
+#define JAULA_BIND_ACCESS(S, f) \
+  static void *bindAccess_##f(void *object) \
+  { \
+    return &static_cast<S *>(object)->f; \
+  } \
+  static Bind_Type const &bindType_##f(void) \
+  { \
+    return bindMemberType(&S::f); \
+  }
+
+/**
+ * \brief Generates the table entry of a bound member (internal use)
+ */
+#define JAULA_BIND_FIELD(S, f) \
+  { #f, &bindAccess_##f, &bindType_##f },
+
+/**
+ * \brief Applies a macro to each member name (internal use)
+ */
+#define JAULA_BIND_EACH(M, S, ...) \
+  JAULA_BIND_CAT(JAULA_BIND_EACH_, JAULA_BIND_COUNT(__VA_ARGS__)) \
+    (M, S, __VA_ARGS__)
+
+/**
+ * \brief Pastes two tokens after expanding them (internal use)
+ */
+#define JAULA_BIND_CAT(a, b) JAULA_BIND_CAT_(a, b)
+#define JAULA_BIND_CAT_(a, b) a##b
+
+/**
+ * \brief Counts the member names (internal use)
+ */
+#define JAULA_BIND_COUNT(...) \
+  JAULA_BIND_COUNT_(__VA_ARGS__, \
+    32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, \
+    14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define JAULA_BIND_COUNT_( \
+    _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, \
+    _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, \
+    _31, _32, N, ...) N
+
+#define JAULA_BIND_EACH_1(M, S, f) M(S, f)
+#define JAULA_BIND_EACH_2(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_1(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_3(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_2(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_4(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_3(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_5(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_4(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_6(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_5(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_7(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_6(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_8(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_7(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_9(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_8(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_10(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_9(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_11(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_10(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_12(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_11(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_13(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_12(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_14(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_13(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_15(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_14(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_16(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_15(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_17(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_16(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_18(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_17(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_19(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_18(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_20(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_19(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_21(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_20(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_22(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_21(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_23(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_22(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_24(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_23(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_25(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_24(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_26(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_25(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_27(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_26(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_28(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_27(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_29(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_28(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_30(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_29(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_31(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_30(M, S, __VA_ARGS__)
+#define JAULA_BIND_EACH_32(M, S, f, ...) \
+  M(S, f) JAULA_BIND_EACH_31(M, S, __VA_ARGS__)
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Entry points for bound C++ types
+   *
+   * \ingroup jaula_bind
+   *
+   * \par
+   * This class gathers the operations that parse JSON data straight into
+   * variables of bound types and write them back.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Bind
+  {                              // class Bind
+    public:
+
+      /**
+       * \brief Parses a memory buffer into a variable
+       *
+       * \param data Pointer to the data to parse.
+       *
+       * \param len Number of bytes to parse.
+       *
+       * \param target Variable to fill.
+       *
+       * \param result Where the outcome of the process is stored. Mismatches
+       * between the data and the variable type are reported as
+       * Parse_Result::HANDLER_STOPPED with their description as message.
+       *
+       * \param strict Flag for rejecting properties without a matching
+       * structure member.
+       *
+       * \param comments_allowed Flag for accepting comments in the data.
+       *
+       * \returns true if the variable was filled.
+       *
+       * \note
+       * The kind of a mismatch can be retrieved by giving a Bind_Handler to
+       * Incremental_Parser::parseBuffer() instead.
+       */
+      template <typename T>
+        static bool parseBuffer(char const *data, size_t len, T &target
+        , Parse_Result &result, bool strict = false
+        , bool comments_allowed = false)
+      {
+        Bind_Handler handler(Bind_Traits<T>::type(), &target, strict);
+        return Incremental_Parser::parseBuffer(data, len, handler, result
+          , comments_allowed);
+      }
+
+      /**
+       * \brief Writes a variable
+       *
+       * \param value Variable to write.
+       *
+       * \param writer Writer to send the JSON data to.
+       */
+      template <typename T>
+        static void write(T const &value, Stream_Writer &writer)
+      {
+        Bind_Traits<T>::type().write(&value, writer);
+      }
+
+  };                             // class Bind
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
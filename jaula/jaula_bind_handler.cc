@@ -0,0 +1,362 @@
+
+/*
+ * jaula_bind_handler.cc : JSON Analysis User Library Acronym
+ * Parsing events handler for bound C++ types implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+}
+
+#include <jaula/jaula_bind_handler.h>
+#include <jaula/jaula_json_pointer.h>
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Bind_Handler::Bind_Handler(Bind_Type const &type, void *target
+    , bool strict)
+    : Parse_Handler()
+    , type_(type)
+    , target_(target)
+    , strict_(strict)
+    , frames_()
+    , depth_(0)
+    , pPendingType_(0)
+    , pPendingTarget_(0)
+    , skipping_(0)
+    , code_(SUCCESS)
+    , pErrorReport_(0)
+    {}
+
+  Bind_Handler::~Bind_Handler()
+  {
+    if (pErrorReport_)
+      delete pErrorReport_;
+  }
+
+  bool Bind_Handler::nullValue(void)
+  {
+    if (skipping_)
+      return true;
+    Bind_Type const *pType;
+    void    *pTarget;
+    slot(true, pType, pTarget);
+    return !pType || mismatch(*pType, "null");
+  }
+
+  bool Bind_Handler::booleanValue(bool data)
+  {
+    if (skipping_)
+      return true;
+    Bind_Type const *pType;
+    void    *pTarget;
+    slot(false, pType, pTarget);
+    if (!pType)
+      return true;
+    if (!pType->setBoolean)
+      return mismatch(*pType, "boolean");
+    return pType->setBoolean(pTarget, data);
+  }
+
+  bool Bind_Handler::numberValue(double data)
+  {
+    if (skipping_)
+      return true;
+    Bind_Type const *pType;
+    void    *pTarget;
+    slot(false, pType, pTarget);
+    if (!pType)
+      return true;
+    if (!pType->setNumber)
+      return mismatch(*pType, "number");
+    if (!pType->setNumber(pTarget, data))
+      return fail(OUT_OF_RANGE, std::string("Number not representable as ")
+        + pType->name, depth_);
+    return true;
+  }
+
+  bool Bind_Handler::numberIntValue(int64_t data)
+  {
+    if (skipping_)
+      return true;
+    Bind_Type const *pType;
+    void    *pTarget;
+    slot(false, pType, pTarget);
+    if (!pType)
+      return true;
+    if (!pType->setNumberInt)
+      return mismatch(*pType, "number");
+    if (!pType->setNumberInt(pTarget, data))
+      return fail(OUT_OF_RANGE, std::string("Number not representable as ")
+        + pType->name, depth_);
+    return true;
+  }
+
+  bool Bind_Handler::numberUnsignedValue(uint64_t data)
+  {
+    if (skipping_)
+      return true;
+    Bind_Type const *pType;
+    void    *pTarget;
+    slot(false, pType, pTarget);
+    if (!pType)
+      return true;
+    if (!pType->setNumberUnsigned && !pType->setNumber)
+      return mismatch(*pType, "number");
+    if (pType->setNumberUnsigned
+      ? !pType->setNumberUnsigned(pTarget, data)
+      : !pType->setNumber(pTarget, static_cast<double>(data)))
+      return fail(OUT_OF_RANGE, std::string("Number not representable as ")
+        + pType->name, depth_);
+    return true;
+  }
+
+  bool Bind_Handler::stringValue(std::string const &data)
+  {
+    if (skipping_)
+      return true;
+    Bind_Type const *pType;
+    void    *pTarget;
+    slot(false, pType, pTarget);
+    if (!pType)
+      return true;
+    if (!pType->setString)
+      return mismatch(*pType, "string");
+    return pType->setString(pTarget, data);
+  }
+
+  bool Bind_Handler::arrayBegin(void)
+  {
+    if (skipping_)
+    {
+      skipping_++;
+      return true;
+    }
+    Bind_Type const *pType;
+    void    *pTarget;
+    slot(false, pType, pTarget);
+    if (!pType)
+    {
+      skipping_ = 1;
+      return true;
+    }
+    if (pType->kind != Bind_Type::ARRAY)
+      return mismatch(*pType, "array");
+    open(*pType, pTarget);
+    return true;
+  }
+
+  bool Bind_Handler::arrayEnd(void)
+  {
+    if (skipping_)
+    {
+      skipping_--;
+      return true;
+    }
+    return close();
+  }
+
+  bool Bind_Handler::objectBegin(void)
+  {
+    if (skipping_)
+    {
+      skipping_++;
+      return true;
+    }
+    Bind_Type const *pType;
+    void    *pTarget;
+    slot(false, pType, pTarget);
+    if (!pType)
+    {
+      skipping_ = 1;
+      return true;
+    }
+    if ((pType->kind != Bind_Type::OBJECT) && (pType->kind != Bind_Type::MAP))
+      return mismatch(*pType, "object");
+    open(*pType, pTarget);
+    return true;
+  }
+
+  bool Bind_Handler::propertyName(std::string const &name)
+  {
+    if (skipping_)
+      return true;
+    Frame &frame = frames_[depth_ - 1];
+    frame.name = name;
+    frame.count++;
+    if (frame.pType->kind == Bind_Type::MAP)
+    {
+      pPendingType_ = &frame.pType->content();
+      pPendingTarget_ = frame.pType->entry(frame.pTarget, name);
+      return true;
+    }
+    size_t const pos = frame.pType->fields->find(name);
+    if (pos == Bind_Fields::NO_FIELD)
+    {
+      pPendingType_ = 0;
+      if (strict_)
+        return fail(UNKNOWN_MEMBER, std::string("No member of ")
+          + frame.pType->name + " bound to this property", depth_);
+      return true;
+    }
+    Bind_Field const  &field = frame.pType->fields->getField(pos);
+    frame.seen[pos] = true;
+    pPendingType_ = &field.type();
+    pPendingTarget_ = field.access(frame.pTarget);
+    return true;
+  }
+
+  bool Bind_Handler::objectEnd(void)
+  {
+    if (skipping_)
+    {
+      skipping_--;
+      return true;
+    }
+    return close();
+  }
+
+  Exception const *Bind_Handler::getErrorReport(void) const
+  {
+    return pErrorReport_;
+  }
+
+  Bind_Handler::Error_Code Bind_Handler::getCode(void) const
+  {
+    return code_;
+  }
+
+  void Bind_Handler::reset(void)
+  {
+    depth_ = 0;
+    pPendingType_ = 0;
+    pPendingTarget_ = 0;
+    skipping_ = 0;
+    code_ = SUCCESS;
+    if (pErrorReport_)
+      delete pErrorReport_;
+    pErrorReport_ = 0;
+  }
+
+  void Bind_Handler::slot(bool null, Bind_Type const *&pType, void *&pTarget)
+  {
+    if (!depth_)
+    {
+      pType = &type_;
+      pTarget = target_;
+    }
+    else
+    {
+      Frame &frame = frames_[depth_ - 1];
+      if (frame.pType->kind == Bind_Type::ARRAY)
+      {
+        frame.count++;
+        pType = &frame.pType->content();
+        pTarget = frame.pType->item(frame.pTarget);
+      }
+      else
+      {
+        pType = pPendingType_;
+        pTarget = pPendingTarget_;
+      }
+    }
+    while (pType && (pType->kind == Bind_Type::OPTIONAL))
+    {
+      if (null)
+      {
+        pType->setNull(pTarget);
+        pType = 0;
+      }
+      else
+      {
+        pTarget = pType->item(pTarget);
+        pType = &pType->content();
+      }
+    }
+  }
+
+  void Bind_Handler::open(Bind_Type const &type, void *target)
+  {
+    if (frames_.size() == depth_)
+      frames_.push_back(Frame());
+    Frame &frame = frames_[depth_++];
+    frame.pType = &type;
+    frame.pTarget = target;
+    frame.count = 0;
+    frame.name.erase();
+    frame.seen.assign((type.kind == Bind_Type::OBJECT)
+      ? type.fields->size() : 0, false);
+    type.clear(target);
+  }
+
+  bool Bind_Handler::close(void)
+  {
+    Frame &frame = frames_[depth_ - 1];
+    for (size_t i = 0; (i < frame.seen.size()); i++)
+    {
+      Bind_Field const  &field = frame.pType->fields->getField(i);
+      if (!frame.seen[i] && (field.type().kind != Bind_Type::OPTIONAL))
+        return fail(MISSING_MEMBER, std::string("Member ") + field.name
+          + " of " + frame.pType->name + " missing", depth_ - 1);
+    }
+    depth_--;
+    return true;
+  }
+
+  bool Bind_Handler::mismatch(Bind_Type const &type, char const *found)
+  {
+    return fail(TYPE_MISMATCH, std::string("Found ") + found + " where "
+      + type.name + " was expected", depth_);
+  }
+
+  bool Bind_Handler::fail(Error_Code code, std::string const &detail
+    , size_t levels)
+  {
+    Json_Pointer  where;
+    for (size_t i = 0; (i < levels); i++)
+    {
+      if (frames_[i].pType->kind == Bind_Type::ARRAY)
+        where.append(frames_[i].count - 1);
+      else
+        where.append(frames_[i].name);
+    }
+    code_ = code;
+    if (pErrorReport_)
+      delete pErrorReport_;
+    pErrorReport_ = new Bad_Data_Type(detail + (where.getPointer().empty()
+      ? std::string(" at the document root")
+      : " at " + where.getPointer())
+      , "binding parsed data"
+      , "Bind_Handler");
+    return false;
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
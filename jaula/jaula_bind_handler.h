@@ -0,0 +1,307 @@
+
+/*
+ * jaula_bind_handler.h : JSON Analysis User Library Acronym
+ * Parsing events handler for bound C++ types definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_BIND_HANDLER_H_
+#define _JAULA_BIND_HANDLER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <jaula/jaula_bad_data_type.h>
+#include <jaula/jaula_bind_type.h>
+#include <jaula/jaula_exception.h>
+#include <jaula/jaula_parse_handler.h>
+
+/**
+ * \addtogroup jaula_bind JAULA: Binding to C++ types
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Parsing events handler that fills bound C++ types
+   *
+   * \ingroup jaula_bind
+   *
+   * \par
+   * This class stores the events produced by a parser straight into a
+   * variable of a type described by a Bind_Type, without building any
+   * Value on the way. Arrays are appended to vectors, objects fill maps or
+   * the members of structures bound with JAULA_BIND and null values clear
+   * Optional instances.
+   *
+   * \par
+   * Members of structures that are not Optional must be present in the
+   * data. Properties without a matching member are skipped unless the
+   * handler is strict.
+   *
+   * \par
+   * The first mismatch stops the process. Its kind can be retrieved through
+   * getCode() and getErrorReport() describes it with the location of the
+   * offending value as a JSON Pointer.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Bind_Handler : public Parse_Handler
+  {                              // class Bind_Handler
+    public:
+
+      /**
+       * \brief Error codes
+       */
+      enum Error_Code
+      {                          // enum Error_Code
+        SUCCESS
+        , TYPE_MISMATCH
+        , OUT_OF_RANGE
+        , MISSING_MEMBER
+        , UNKNOWN_MEMBER
+      };                         // enum Error_Code
+
+      /**
+       * \brief Constructor
+       *
+       * \param type Description of the type to fill.
+       *
+       * \param target Address of the variable to fill. It must exist
+       * during all the handler life cycle.
+       *
+       * \param strict Flag for rejecting properties without a matching
+       * structure member.
+       */
+      Bind_Handler(Bind_Type const &type, void *target, bool strict = false);
+
+      /**
+       * \brief Destructor
+       */
+      virtual ~Bind_Handler();
+
+      /**
+       * \brief Processes a null value
+       */
+      virtual bool nullValue(void);
+
+      /**
+       * \brief Processes a boolean value
+       */
+      virtual bool booleanValue(bool data);
+
+      /**
+       * \brief Processes a floating point number
+       */
+      virtual bool numberValue(double data);
+
+      /**
+       * \brief Processes an integer number
+       */
+      virtual bool numberIntValue(int64_t data);
+
+      /**
+       * \brief Processes an integer number beyond the 64 bit signed range
+       */
+      virtual bool numberUnsignedValue(uint64_t data);
+
+      /**
+       * \brief Processes a string value
+       */
+      virtual bool stringValue(std::string const &data);
+
+      /**
+       * \brief Processes the beginning of an array
+       */
+      virtual bool arrayBegin(void);
+
+      /**
+       * \brief Processes the end of an array
+       */
+      virtual bool arrayEnd(void);
+
+      /**
+       * \brief Processes the beginning of an object
+       */
+      virtual bool objectBegin(void);
+
+      /**
+       * \brief Processes the name of an object property
+       */
+      virtual bool propertyName(std::string const &name);
+
+      /**
+       * \brief Processes the end of an object
+       */
+      virtual bool objectEnd(void);
+
+      /**
+       * \brief Retrieves the description of the mismatch found
+       *
+       * \returns a pointer to a Bad_Data_Type or null if no mismatch has
+       * been found.
+       */
+      virtual Exception const *getErrorReport(void) const;
+
+      /**
+       * \brief Retrieves the kind of the mismatch found
+       */
+      Error_Code getCode(void) const;
+
+      /**
+       * \brief Prepares the handler for filling the variable again
+       */
+      void reset(void);
+
+    private:
+
+      /**
+       * \brief State of an array or object being filled
+       */
+      struct Frame
+      {                          // struct Frame
+        /** type filled */
+        Bind_Type const *pType;
+        /** address filled */
+        void    *pTarget;
+        /** items or properties found so far */
+        size_t  count;
+        /** last property name found */
+        std::string name;
+        /** structure members found */
+        std::vector<bool> seen;
+      };                         // struct Frame
+
+      /**
+       * \brief Copy constructor (not available)
+       */
+      Bind_Handler(Bind_Handler const &orig);
+
+      /**
+       * \brief Assignment operator (not available)
+       */
+      Bind_Handler &operator=(Bind_Handler const &orig);
+
+      /**
+       * \brief Locates the variable the next value is stored into
+       *
+       * \param null Flag for a null value, which clears optional values.
+       *
+       * \param pType Where the type to fill is stored. It is null if the
+       * value must be skipped or has already been stored.
+       *
+       * \param pTarget Where the address to fill is stored.
+       */
+      void slot(bool null, Bind_Type const *&pType, void *&pTarget);
+
+      /**
+       * \brief Starts filling an array or object
+       */
+      void open(Bind_Type const &type, void *target);
+
+      /**
+       * \brief Finishes filling an array or object
+       */
+      bool close(void);
+
+      /**
+       * \brief Records a value of a type not matching the variable
+       *
+       * \param type Type of the variable.
+       *
+       * \param found JSON type of the value.
+       */
+      bool mismatch(Bind_Type const &type, char const *found);
+
+      /**
+       * \brief Records a mismatch
+       *
+       * \param code Kind of the mismatch.
+       *
+       * \param detail Description of the mismatch.
+       *
+       * \param levels Number of open arrays and objects in the location.
+       *
+       * \returns false so it can be returned by the event handlers.
+       */
+      bool fail(Error_Code code, std::string const &detail, size_t levels);
+
+      /**
+       * \brief Type of the variable filled
+       */
+      Bind_Type const &type_;
+
+      /**
+       * \brief Address of the variable filled
+       */
+      void    *target_;
+
+      /**
+       * \brief Flag for rejecting properties not bound
+       */
+      bool    strict_;
+
+      /**
+       * \brief Arrays and objects being filled
+       */
+      std::vector<Frame>  frames_;
+
+      /**
+       * \brief Number of frames in use
+       */
+      size_t  depth_;
+
+      /**
+       * \brief Type for the value of the last property name found
+       */
+      Bind_Type const *pPendingType_;
+
+      /**
+       * \brief Address for the value of the last property name found
+       */
+      void    *pPendingTarget_;
+
+      /**
+       * \brief Nesting level inside a value being skipped
+       */
+      size_t  skipping_;
+
+      /**
+       * \brief Kind of the mismatch found
+       */
+      Error_Code  code_;
+
+      /**
+       * \brief Description of the mismatch found
+       */
+      Bad_Data_Type *pErrorReport_;
+
+  };                             // class Bind_Handler
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
@@ -0,0 +1,348 @@
+
+/*
+ * jaula_bind_type.cc : JSON Analysis User Library Acronym
+ * C++ type binding descriptors implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_MATH_H
+#include <math.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+}
+
+#ifdef HAVE_LIMITS
+#include <limits>
+#endif
+
+#include <jaula/jaula_bind_type.h>
+
+namespace
+{                                // anonymous namespace
+
+  /**
+   * \brief Checks whether a floating point number fits an integer type
+   */
+  template <typename T>
+    bool integral(double data)
+  {
+    return (data >= static_cast<double>(std::numeric_limits<T>::min()))
+      && (data < -static_cast<double>(std::numeric_limits<T>::min()))
+      && (data == floor(data));
+  }
+
+  bool setBoolean(void *target, bool data)
+  {
+    *static_cast<bool *>(target) = data;
+    return true;
+  }
+
+  void writeBoolean(void const *value, JAULA::Stream_Writer &writer)
+  {
+    writer.value(*static_cast<bool const *>(value));
+  }
+
+  bool setIntNumber(void *target, double data)
+  {
+    if (!integral<int>(data))
+      return false;
+    *static_cast<int *>(target) = static_cast<int>(data);
+    return true;
+  }
+
+  bool setIntNumberInt(void *target, int64_t data)
+  {
+    if ((data < std::numeric_limits<int>::min())
+      || (data > std::numeric_limits<int>::max()))
+      return false;
+    *static_cast<int *>(target) = static_cast<int>(data);
+    return true;
+  }
+
+  void writeInt(void const *value, JAULA::Stream_Writer &writer)
+  {
+    writer.value(*static_cast<int const *>(value));
+  }
+
+  bool setLongNumber(void *target, double data)
+  {
+    if (!integral<long>(data))
+      return false;
+    *static_cast<long *>(target) = static_cast<long>(data);
+    return true;
+  }
+
+  bool setLongNumberInt(void *target, int64_t data)
+  {
+    if ((data < std::numeric_limits<long>::min())
+      || (data > std::numeric_limits<long>::max()))
+      return false;
+    *static_cast<long *>(target) = static_cast<long>(data);
+    return true;
+  }
+
+  void writeLong(void const *value, JAULA::Stream_Writer &writer)
+  {
+    writer.value(*static_cast<long const *>(value));
+  }
+
+  bool setUnsignedNumber(void *target, double data)
+  {
+    if ((data < 0) || (data >= 18446744073709551616.0)
+      || (data != floor(data)))
+      return false;
+    *static_cast<uint64_t *>(target) = static_cast<uint64_t>(data);
+    return true;
+  }
+
+  bool setUnsignedNumberInt(void *target, int64_t data)
+  {
+    if (data < 0)
+      return false;
+    *static_cast<uint64_t *>(target) = static_cast<uint64_t>(data);
+    return true;
+  }
+
+  bool setUnsignedNumberUnsigned(void *target, uint64_t data)
+  {
+    *static_cast<uint64_t *>(target) = data;
+    return true;
+  }
+
+  void writeUnsigned(void const *value, JAULA::Stream_Writer &writer)
+  {
+    writer.value(*static_cast<uint64_t const *>(value));
+  }
+
+  bool setFloatNumber(void *target, double data)
+  {
+    if ((fabs(data) > std::numeric_limits<float>::max())
+      && (fabs(data) <= std::numeric_limits<double>::max()))
+      return false;
+    *static_cast<float *>(target) = static_cast<float>(data);
+    return true;
+  }
+
+  bool setFloatNumberInt(void *target, int64_t data)
+  {
+    *static_cast<float *>(target) = static_cast<float>(data);
+    return true;
+  }
+
+  void writeFloat(void const *value, JAULA::Stream_Writer &writer)
+  {
+    writer.value(static_cast<double>(*static_cast<float const *>(value)));
+  }
+
+  bool setDoubleNumber(void *target, double data)
+  {
+    *static_cast<double *>(target) = data;
+    return true;
+  }
+
+  bool setDoubleNumberInt(void *target, int64_t data)
+  {
+    *static_cast<double *>(target) = static_cast<double>(data);
+    return true;
+  }
+
+  void writeDouble(void const *value, JAULA::Stream_Writer &writer)
+  {
+    writer.value(*static_cast<double const *>(value));
+  }
+
+  bool setString(void *target, std::string const &data)
+  {
+    *static_cast<std::string *>(target) = data;
+    return true;
+  }
+
+  void writeString(void const *value, JAULA::Stream_Writer &writer)
+  {
+    writer.value(*static_cast<std::string const *>(value));
+  }
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  size_t const Bind_Fields::NO_FIELD = static_cast<size_t>(-1);
+
+  Bind_Fields::Bind_Fields(Bind_Field const *fields, size_t count)
+    : fields_(fields)
+    , count_(count)
+    , seed_(0)
+    , mask_(0)
+    , slots_()
+  {
+    size_t  size = 1;
+    while (size < (count * 2))
+      size <<= 1;
+    for (;; size <<= 1)
+    {
+      mask_ = static_cast<unsigned int>(size - 1);
+      for (seed_ = 1; (seed_ <= 64); seed_++)
+      {
+        slots_.assign(size, NO_FIELD);
+        size_t  i;
+        for (i = 0; (i < count); i++)
+        {
+          size_t &slot = slots_[hash(fields[i].name, strlen(fields[i].name)
+            , seed_) & mask_];
+          if (slot != NO_FIELD)
+            break;
+          slot = i;
+        }
+        if (i == count)
+          return;
+      }
+    }
+  }
+
+  size_t Bind_Fields::size(void) const
+  {
+    return count_;
+  }
+
+  Bind_Field const &Bind_Fields::getField(size_t pos) const
+  {
+    return fields_[pos];
+  }
+
+  size_t Bind_Fields::find(std::string const &name) const
+  {
+    size_t const pos = slots_[hash(name.data(), name.size(), seed_) & mask_];
+    if ((pos == NO_FIELD) || (name != fields_[pos].name))
+      return NO_FIELD;
+    return pos;
+  }
+
+  void Bind_Fields::write(void const *object, Stream_Writer &writer) const
+  {
+    writer.beginObject();
+    for (size_t i = 0; (i < count_); i++)
+    {
+      void const  *member = fields_[i].access(const_cast<void *>(object));
+      Bind_Type const &type = fields_[i].type();
+      if (type.isEmpty && type.isEmpty(member))
+        continue;
+      writer.key(fields_[i].name);
+      type.write(member, writer);
+    }
+    writer.endObject();
+  }
+
+  unsigned int Bind_Fields::hash(char const *data, size_t len
+    , unsigned int seed)
+  {
+    unsigned int  h = 2166136261U ^ (seed * 2654435761U);
+    for (size_t i = 0; (i < len); i++)
+      h = (h ^ static_cast<unsigned char>(data[i])) * 16777619U;
+    return h ^ (h >> 15);
+  }
+
+  Bind_Type const &Bind_Traits<bool>::type(void)
+  {
+    static Bind_Type const type =
+    {
+      "boolean", Bind_Type::SCALAR, 0, &setBoolean, 0, 0, 0
+      , 0, 0, 0, 0, 0, 0, &writeBoolean
+    };
+    return type;
+  }
+
+  Bind_Type const &Bind_Traits<int>::type(void)
+  {
+    static Bind_Type const type =
+    {
+      "integer", Bind_Type::SCALAR, 0, 0, &setIntNumber, &setIntNumberInt, 0
+      , 0, 0, 0, 0, 0, 0, &writeInt
+    };
+    return type;
+  }
+
+  Bind_Type const &Bind_Traits<long>::type(void)
+  {
+    static Bind_Type const type =
+    {
+      "integer", Bind_Type::SCALAR, 0, 0, &setLongNumber, &setLongNumberInt, 0
+      , 0, 0, 0, 0, 0, 0, &writeLong
+    };
+    return type;
+  }
+
+  Bind_Type const &Bind_Traits<uint64_t>::type(void)
+  {
+    static Bind_Type const type =
+    {
+      "unsigned integer", Bind_Type::SCALAR, 0, 0, &setUnsignedNumber
+      , &setUnsignedNumberInt, 0, 0, 0, 0, 0, 0, 0, &writeUnsigned
+      , &setUnsignedNumberUnsigned
+    };
+    return type;
+  }
+
+  Bind_Type const &Bind_Traits<float>::type(void)
+  {
+    static Bind_Type const type =
+    {
+      "number", Bind_Type::SCALAR, 0, 0, &setFloatNumber, &setFloatNumberInt, 0
+      , 0, 0, 0, 0, 0, 0, &writeFloat
+    };
+    return type;
+  }
+
+  Bind_Type const &Bind_Traits<double>::type(void)
+  {
+    static Bind_Type const type =
+    {
+      "number", Bind_Type::SCALAR, 0, 0, &setDoubleNumber, &setDoubleNumberInt
+      , 0, 0, 0, 0, 0, 0, 0, &writeDouble
+    };
+    return type;
+  }
+
+  Bind_Type const &Bind_Traits<std::string>::type(void)
+  {
+    static Bind_Type const type =
+    {
+      "string", Bind_Type::SCALAR, 0, 0, 0, 0, &setString
+      , 0, 0, 0, 0, 0, 0, &writeString
+    };
+    return type;
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
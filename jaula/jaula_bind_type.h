@@ -0,0 +1,477 @@
+
+/*
+ * jaula_bind_type.h : JSON Analysis User Library Acronym
+ * C++ type binding descriptors definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_BIND_TYPE_H_
+#define _JAULA_BIND_TYPE_H_
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <jaula/jaula_optional.h>
+#include <jaula/jaula_stream_writer.h>
+
+/**
+ * \addtogroup jaula_bind JAULA: Binding to C++ types
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  class Bind_Fields;
+
+  /**
+   * \brief Description of how a C++ type is filled and written
+   *
+   * \ingroup jaula_bind
+   *
+   * \par
+   * Each bound type has one constant instance of this structure, provided
+   * by the Bind_Traits template for that type, holding the functions that
+   * store JSON data into a value of the type and write it back. Functions
+   * that do not apply to the type are null, so receiving the matching JSON
+   * data is a type mismatch.
+   *
+   * \par
+   * Targets are passed as untyped pointers, so a parser can descend through
+   * nested structures without knowing their types at compile time.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  struct Bind_Type
+  {                              // struct Bind_Type
+
+    /**
+     * \brief Kinds of bound types
+     */
+    enum Kind
+    {                            // enum Kind
+      SCALAR
+      , ARRAY
+      , MAP
+      , OBJECT
+      , OPTIONAL
+    };                           // enum Kind
+
+    /** name of the type for error reports */
+    char const  *name;
+    /** kind of the type */
+    Kind    kind;
+    /** stores a null value (clears optional values) */
+    bool    (*setNull)(void *target);
+    /** stores a boolean value */
+    bool    (*setBoolean)(void *target, bool data);
+    /** stores a floating point number, false if not representable */
+    bool    (*setNumber)(void *target, double data);
+    /** stores an integer number, false if not representable */
+    bool    (*setNumberInt)(void *target, int64_t data);
+    /** stores a string value */
+    bool    (*setString)(void *target, std::string const &data);
+    /** empties containers and resets objects before filling them */
+    void    (*clear)(void *target);
+    /** appends an array item or sets an optional value, returning it */
+    void    *(*item)(void *target);
+    /** adds a map entry, returning its value */
+    void    *(*entry)(void *target, std::string const &name);
+    /** type of array items, map values or optional values */
+    Bind_Type const &(*content)(void);
+    /** members of objects */
+    Bind_Fields const *fields;
+    /** checks whether an optional value is missing */
+    bool    (*isEmpty)(void const *target);
+    /** writes a value */
+    void    (*write)(void const *value, Stream_Writer &writer);
+    /** stores an integer beyond the 64 bit signed range, false if not
+     * representable (setNumber() is used when missing) */
+    bool    (*setNumberUnsigned)(void *target, uint64_t data);
+
+  };                             // struct Bind_Type
+
+  /**
+   * \brief Description of a bound structure member
+   *
+   * \ingroup jaula_bind
+   */
+  struct Bind_Field
+  {                              // struct Bind_Field
+
+    /** name of the member */
+    char const  *name;
+    /** retrieves the member of a structure */
+    void    *(*access)(void *object);
+    /** type of the member */
+    Bind_Type const &(*type)(void);
+
+  };                             // struct Bind_Field
+
+  /**
+   * \brief Member table of a bound structure
+   *
+   * \ingroup jaula_bind
+   *
+   * \par
+   * This class finds members by name through a perfect hash computed when
+   * the table is created, so each property name is hashed once and
+   * compared against a single candidate.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Bind_Fields
+  {                              // class Bind_Fields
+    public:
+
+      /**
+       * \brief Position returned for names not found
+       */
+      static size_t const NO_FIELD;
+
+      /**
+       * \brief Constructor
+       *
+       * \param fields Members of the structure in declaration order. They
+       * are not copied, so they must exist during all the table life cycle.
+       *
+       * \param count Number of members. Their names must be different.
+       */
+      Bind_Fields(Bind_Field const *fields, size_t count);
+
+      /**
+       * \brief Retrieves the number of members
+       */
+      size_t size(void) const;
+
+      /**
+       * \brief Retrieves a member
+       *
+       * \param pos Position of the member in declaration order.
+       */
+      Bind_Field const &getField(size_t pos) const;
+
+      /**
+       * \brief Looks for a member by name
+       *
+       * \param name Name of the member.
+       *
+       * \returns the position of the member or NO_FIELD.
+       */
+      size_t find(std::string const &name) const;
+
+      /**
+       * \brief Writes a structure as an object
+       *
+       * \param object Address of the structure.
+       *
+       * \param writer Writer to send the object to.
+       *
+       * \par Description
+       * Members are written in declaration order. Optional members without
+       * value are left out.
+       */
+      void write(void const *object, Stream_Writer &writer) const;
+
+    private:
+
+      /**
+       * \brief Copy constructor (not available)
+       */
+      Bind_Fields(Bind_Fields const &orig);
+
+      /**
+       * \brief Assignment operator (not available)
+       */
+      Bind_Fields &operator=(Bind_Fields const &orig);
+
+      /**
+       * \brief Hashes a member name
+       */
+      static unsigned int hash(char const *data, size_t len
+        , unsigned int seed);
+
+      /**
+       * \brief Members
+       */
+      Bind_Field const  *fields_;
+
+      /**
+       * \brief Number of members
+       */
+      size_t  count_;
+
+      /**
+       * \brief Hash seed without collisions among the names
+       */
+      unsigned int  seed_;
+
+      /**
+       * \brief Mask for hash values
+       */
+      unsigned int  mask_;
+
+      /**
+       * \brief Member position for each hash value
+       */
+      std::vector<size_t> slots_;
+
+  };                             // class Bind_Fields
+
+  /**
+   * \brief Binding descriptor provider
+   *
+   * \ingroup jaula_bind
+   *
+   * \par
+   * Specializations of this template provide a static type() method
+   * returning the Bind_Type for their type. They are available for bool,
+   * int, long, uint64_t, float, double, std::string, std::vector, std::map
+   * with string keys and Optional, and can be generated for structures with the
+   * JAULA_BIND macro. Using any other type does not compile.
+   */
+  template <typename T>
+    struct Bind_Traits;
+
+  /**
+   * \brief Binding descriptor provider for booleans
+   */
+  template <>
+    struct Bind_Traits<bool>
+  {                              // struct Bind_Traits<bool>
+    static Bind_Type const &type(void);
+  };                             // struct Bind_Traits<bool>
+
+  /**
+   * \brief Binding descriptor provider for integers
+   */
+  template <>
+    struct Bind_Traits<int>
+  {                              // struct Bind_Traits<int>
+    static Bind_Type const &type(void);
+  };                             // struct Bind_Traits<int>
+
+  /**
+   * \brief Binding descriptor provider for long integers
+   */
+  template <>
+    struct Bind_Traits<long>
+  {                              // struct Bind_Traits<long>
+    static Bind_Type const &type(void);
+  };                             // struct Bind_Traits<long>
+
+  /**
+   * \brief Binding descriptor provider for 64 bit unsigned integers
+   */
+  template <>
+    struct Bind_Traits<uint64_t>
+  {                              // struct Bind_Traits<uint64_t>
+    static Bind_Type const &type(void);
+  };                             // struct Bind_Traits<uint64_t>
+
+  /**
+   * \brief Binding descriptor provider for single precision numbers
+   */
+  template <>
+    struct Bind_Traits<float>
+  {                              // struct Bind_Traits<float>
+    static Bind_Type const &type(void);
+  };                             // struct Bind_Traits<float>
+
+  /**
+   * \brief Binding descriptor provider for double precision numbers
+   */
+  template <>
+    struct Bind_Traits<double>
+  {                              // struct Bind_Traits<double>
+    static Bind_Type const &type(void);
+  };                             // struct Bind_Traits<double>
+
+  /**
+   * \brief Binding descriptor provider for strings
+   */
+  template <>
+    struct Bind_Traits<std::string>
+  {                              // struct Bind_Traits<std::string>
+    static Bind_Type const &type(void);
+  };                             // struct Bind_Traits<std::string>
+
+  /**
+   * \brief Binding descriptor provider for vectors (bound to arrays)
+   */
+  template <typename T>
+    struct Bind_Traits<std::vector<T> >
+  {                              // struct Bind_Traits<std::vector<T> >
+
+    static Bind_Type const &type(void)
+    {
+      static Bind_Type const type =
+      {
+        "array", Bind_Type::ARRAY, 0, 0, 0, 0, 0
+        , &clear, &item, 0, &Bind_Traits<T>::type, 0, 0, &write
+      };
+      return type;
+    }
+
+    static void clear(void *target)
+    {
+      static_cast<std::vector<T> *>(target)->clear();
+    }
+
+    static void *item(void *target)
+    {
+      std::vector<T>  &items = *static_cast<std::vector<T> *>(target);
+      items.push_back(T());
+      return &items.back();
+    }
+
+    static void write(void const *value, Stream_Writer &writer)
+    {
+      std::vector<T> const  &items =
+        *static_cast<std::vector<T> const *>(value);
+      Bind_Type const &content = Bind_Traits<T>::type();
+      writer.beginArray();
+      for (typename std::vector<T>::const_iterator it = items.begin()
+        ; (it != items.end())
+        ; it++)
+        content.write(&*it, writer);
+      writer.endArray();
+    }
+
+  };                             // struct Bind_Traits<std::vector<T> >
+
+  /**
+   * \brief Binding descriptor provider for maps (bound to objects)
+   */
+  template <typename T>
+    struct Bind_Traits<std::map<std::string, T> >
+  {                              // struct Bind_Traits<std::map<std::string, T> >
+
+    static Bind_Type const &type(void)
+    {
+      static Bind_Type const type =
+      {
+        "object", Bind_Type::MAP, 0, 0, 0, 0, 0
+        , &clear, 0, &entry, &Bind_Traits<T>::type, 0, 0, &write
+      };
+      return type;
+    }
+
+    static void clear(void *target)
+    {
+      static_cast<std::map<std::string, T> *>(target)->clear();
+    }
+
+    static void *entry(void *target, std::string const &name)
+    {
+      return &(*static_cast<std::map<std::string, T> *>(target))[name];
+    }
+
+    static void write(void const *value, Stream_Writer &writer)
+    {
+      std::map<std::string, T> const  &entries =
+        *static_cast<std::map<std::string, T> const *>(value);
+      Bind_Type const &content = Bind_Traits<T>::type();
+      writer.beginObject();
+      for (typename std::map<std::string, T>::const_iterator it =
+        entries.begin()
+        ; (it != entries.end())
+        ; it++)
+      {
+        writer.key(it->first);
+        content.write(&it->second, writer);
+      }
+      writer.endObject();
+    }
+
+  };                             // struct Bind_Traits<std::map<std::string, T> >
+
+  /**
+   * \brief Binding descriptor provider for optional values
+   *
+   * \par
+   * Optional values accept null and may be missing from objects.
+   */
+  template <typename T>
+    struct Bind_Traits<Optional<T> >
+  {                              // struct Bind_Traits<Optional<T> >
+
+    static Bind_Type const &type(void)
+    {
+      static Bind_Type const type =
+      {
+        "optional", Bind_Type::OPTIONAL, &setNull, 0, 0, 0, 0
+        , 0, &item, 0, &Bind_Traits<T>::type, 0, &isEmpty, &write
+      };
+      return type;
+    }
+
+    static bool setNull(void *target)
+    {
+      static_cast<Optional<T> *>(target)->reset();
+      return true;
+    }
+
+    static void *item(void *target)
+    {
+      return &static_cast<Optional<T> *>(target)->set();
+    }
+
+    static bool isEmpty(void const *target)
+    {
+      return !static_cast<Optional<T> const *>(target)->isSet();
+    }
+
+    static void write(void const *value, Stream_Writer &writer)
+    {
+      Optional<T> const &optional =
+        *static_cast<Optional<T> const *>(value);
+      if (optional.isSet())
+        Bind_Traits<T>::type().write(&optional.get(), writer);
+      else
+        writer.nullValue();
+    }
+
+  };                             // struct Bind_Traits<Optional<T> >
+
+  /**
+   * \brief Retrieves the binding descriptor for a structure member
+   *
+   * \par Description
+   * This function only deduces the member type from a member pointer for
+   * the code generated by the JAULA_BIND macro.
+   */
+  template <typename C, typename M>
+    Bind_Type const &bindMemberType(M C::*)
+  {
+    return Bind_Traits<M>::type();
+  }
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
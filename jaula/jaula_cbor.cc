@@ -0,0 +1,645 @@
+
+/*
+ * jaula_cbor.cc : JSON Analysis User Library Acronym
+ * CBOR encoding implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_MATH_H
+#include <math.h>
+#endif
+
+#ifdef HAVE_STDINT_H
+#include <stdint.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+}
+
+
+#ifdef HAVE_LIMITS
+#include <limits>
+#endif
+
+#ifdef HAVE_SSTREAM
+#include <sstream>
+#endif
+
+#ifdef HAVE_STRING
+#include <string>
+#endif
+
+#ifdef HAVE_VECTOR
+#include <vector>
+#endif
+
+#include <jaula/jaula_cbor.h>
+#include <jaula/jaula_value_array.h>
+#include <jaula/jaula_value_boolean.h>
+#include <jaula/jaula_value_builder.h>
+#include <jaula/jaula_value_number.h>
+#include <jaula/jaula_value_number_int.h>
+#include <jaula/jaula_value_object.h>
+#include <jaula/jaula_value_string.h>
+
+namespace
+{                                // anonymous namespace
+
+  using namespace JAULA;
+
+  /**
+   * \brief CBOR major types
+   */
+  enum    Major_Type
+  {                              // enum Major_Type
+    MAJOR_UNSIGNED = 0
+    ,   MAJOR_NEGATIVE = 1
+    ,   MAJOR_BYTES = 2
+    ,   MAJOR_TEXT = 3
+    ,   MAJOR_ARRAY = 4
+    ,   MAJOR_MAP = 5
+    ,   MAJOR_TAG = 6
+    ,   MAJOR_SIMPLE = 7
+  };                             // enum Major_Type
+
+  /**
+   * \brief Writes an unsigned number in network byte order
+   */
+  void store(unsigned char *p, uint64_t n, size_t bytes)
+  {
+    while (bytes--)
+    {
+      p[bytes] = static_cast<unsigned char>(n & 0xff);
+      n >>= 8;
+    }
+  }
+
+  /**
+   * \brief Reads an unsigned number in network byte order
+   */
+  uint64_t load(unsigned char const *p, size_t bytes)
+  {
+    uint64_t  n = 0;
+    while (bytes--)
+      n = (n << 8) | *(p++);
+    return n;
+  }
+
+  /**
+   * \brief Writes the initial bytes of a data item
+   */
+  void writeHead(Output_Buffer &out, unsigned char major, uint64_t n)
+  {
+    unsigned char *p = reinterpret_cast<unsigned char *>(out.reserve(9));
+    major <<= 5;
+    if (n < 24)
+    {
+      p[0] = static_cast<unsigned char>(major | n);
+      out.commit(1);
+    }
+    else if (n <= 0xffU)
+    {
+      p[0] = major | 24;
+      p[1] = static_cast<unsigned char>(n);
+      out.commit(2);
+    }
+    else if (n <= 0xffffU)
+    {
+      p[0] = major | 25;
+      store(p + 1, n, 2);
+      out.commit(3);
+    }
+    else if (n <= 0xffffffffU)
+    {
+      p[0] = major | 26;
+      store(p + 1, n, 4);
+      out.commit(5);
+    }
+    else
+    {
+      p[0] = major | 27;
+      store(p + 1, n, 8);
+      out.commit(9);
+    }
+  }
+
+  /**
+   * \brief Writes a text string data item
+   */
+  void writeText(Output_Buffer &out, std::string const &str)
+  {
+    writeHead(out, MAJOR_TEXT, str.size());
+    out.append(str.data(), str.size());
+  }
+
+  /**
+   * \brief Writes a floating point data item
+   */
+  void writeFloat(Output_Buffer &out, double data)
+  {
+    unsigned char *p = reinterpret_cast<unsigned char *>(out.reserve(9));
+    float single = static_cast<float>(data);
+    if ((single == data) || (data != data))
+    {
+      uint32_t  bits;
+      memcpy(&bits, &single, sizeof(bits));
+      p[0] = (MAJOR_SIMPLE << 5) | 26;
+      store(p + 1, bits, 4);
+      out.commit(5);
+    }
+    else
+    {
+      uint64_t  bits;
+      memcpy(&bits, &data, sizeof(bits));
+      p[0] = (MAJOR_SIMPLE << 5) | 27;
+      store(p + 1, bits, 8);
+      out.commit(9);
+    }
+  }
+
+  /**
+   * \brief Converts a half precision float to double
+   */
+  double halfToDouble(unsigned int half)
+  {
+    int     exponent = (half >> 10) & 0x1f;
+    int     mantissa = half & 0x3ff;
+    double  val;
+    if (!exponent)
+      val = ldexp(static_cast<double>(mantissa), -24);
+    else if (exponent != 31)
+      val = ldexp(static_cast<double>(mantissa + 1024), exponent - 25);
+    else if (!mantissa)
+      val = std::numeric_limits<double>::infinity();
+    else
+      val = std::numeric_limits<double>::quiet_NaN();
+    return (half & 0x8000) ? -val : val;
+  }
+
+  /**
+   * \brief Array or map being decoded
+   */
+  struct Decode_Frame
+  {                              // struct Decode_Frame
+    /** flag for maps */
+    bool      map;
+    /** flag for maps expecting a key */
+    bool      key;
+    /** flag for indefinite length */
+    bool      indefinite;
+    /** data items left (keys and values for maps) */
+    uint64_t  remaining;
+  };                             // struct Decode_Frame
+
+  /**
+   * \brief Array or object being encoded
+   */
+  struct Encode_Frame
+  {                              // struct Encode_Frame
+    /** array being encoded (null for objects) */
+    Value_Array const   *pArray;
+    /** object being encoded (null for arrays) */
+    Value_Object const  *pObject;
+    /** next array item */
+    Value_Array::dataType::const_iterator   item;
+    /** next object property */
+    Value_Object::dataType::const_iterator  property;
+  };                             // struct Encode_Frame
+
+  /**
+   * \brief Bounds checked access to the encoded data
+   */
+  class Cbor_Reader
+  {                              // class Cbor_Reader
+    public:
+
+      Cbor_Reader(char const *data, size_t len)
+        : begin_(reinterpret_cast<unsigned char const *>(data))
+        , p_(begin_)
+        , end_(begin_ + len)
+        {}
+
+      /**
+       * \brief Reads the next byte
+       */
+      unsigned char byte(void) throw(Syntax_Error)
+      {
+        if (p_ == end_)
+          fail("Unexpected end of data");
+        return *(p_++);
+      }
+
+      /**
+       * \brief Reads the argument of a data item
+       */
+      uint64_t argument(unsigned char info) throw(Syntax_Error)
+      {
+        if (info < 24)
+          return info;
+        if (info > 27)
+          fail("Invalid additional information");
+        size_t  bytes = static_cast<size_t>(1) << (info - 24);
+        return load(take(bytes), bytes);
+      }
+
+      /**
+       * \brief Reads a block of bytes
+       */
+      unsigned char const *take(uint64_t len) throw(Syntax_Error)
+      {
+        if (len > static_cast<uint64_t>(end_ - p_))
+          fail("Unexpected end of data");
+        unsigned char const *p = p_;
+        p_ += len;
+        return p;
+      }
+
+      /**
+       * \brief Reads the contents of a byte or text string
+       */
+      void string(unsigned char major, unsigned char info, std::string &str)
+        throw(Syntax_Error)
+      {
+        if (info != 31)
+        {
+          uint64_t  len = argument(info);
+          str.assign(reinterpret_cast<char const *>(take(len)), len);
+          return;
+        }
+
+        str.erase();
+        for (;;)
+        {                        // chunks loop
+          unsigned char ib = byte();
+          if (ib == 0xff)
+            break;
+          if (((ib >> 5) != major) || ((ib & 0x1f) == 31))
+            fail("Invalid chunk in indefinite length string");
+          uint64_t  len = argument(ib & 0x1f);
+          str.append(reinterpret_cast<char const *>(take(len)), len);
+        }                        // chunks loop
+      }
+
+      /**
+       * \brief Retrieves the number of bytes read
+       */
+      size_t offset(void) const
+      {
+        return p_ - begin_;
+      }
+
+      /**
+       * \brief Raises a decoding error
+       */
+      void fail(char const *detail) const throw(Syntax_Error)
+      {
+        std::ostringstream  errAct;
+        errAct << "decoding CBOR data at byte " << (p_ - begin_);
+        throw Syntax_Error(detail, errAct.str());
+      }
+
+      /**
+       * \brief Raises the error reported by a parsing events handler
+       */
+      void handlerFail(Parse_Handler const &handler) const throw(Exception)
+      {
+        if (handler.getErrorReport())
+          throw Exception(*(handler.getErrorReport()));
+        fail("The parsing events handler stopped the process");
+      }
+
+    private:
+
+      unsigned char const *begin_;
+      unsigned char const *p_;
+      unsigned char const *end_;
+  };                             // class Cbor_Reader
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  void Cbor::encode(Value const &val, Output_Buffer &out)
+  {
+    std::vector<Encode_Frame> stack;
+    Value const *pItem = &val;
+    while (pItem)
+    {                            // items loop
+      switch (pItem->getType())
+      {                          // value type switch
+        case Value::TYPE_NULL :
+          out.append(static_cast<char>((MAJOR_SIMPLE << 5) | 22));
+          break;
+
+        case Value::TYPE_BOOLEAN :
+          out.append(static_cast<char>((MAJOR_SIMPLE << 5)
+            | (static_cast<Value_Boolean const *>(pItem)->getData() ? 21 : 20)));
+          break;
+
+        case Value::TYPE_STRING :
+          writeText(out, static_cast<Value_String const *>(pItem)->getData());
+          break;
+
+        case Value::TYPE_NUMBER :
+          writeFloat(out, static_cast<Value_Number const *>(pItem)->getData());
+          break;
+
+        case Value::TYPE_NUMBER_INT :
+        {
+          Value_Number_Int const *pNumber =
+            static_cast<Value_Number_Int const *>(pItem);
+          int64_t data = pNumber->getInt64();
+          if (pNumber->isUnsigned())
+            writeHead(out, MAJOR_UNSIGNED, pNumber->getUnsigned());
+          else if (data >= 0)
+            writeHead(out, MAJOR_UNSIGNED, static_cast<uint64_t>(data));
+          else
+            writeHead(out, MAJOR_NEGATIVE, static_cast<uint64_t>(-(data + 1)));
+        }
+        break;
+
+        case Value::TYPE_ARRAY :
+        {
+          Encode_Frame  frame;
+          frame.pArray = static_cast<Value_Array const *>(pItem);
+          frame.pObject = 0;
+          frame.item = frame.pArray->getData().begin();
+          writeHead(out, MAJOR_ARRAY, frame.pArray->size());
+          stack.push_back(frame);
+        }
+        break;
+
+        case Value::TYPE_OBJECT :
+        {
+          Encode_Frame  frame;
+          frame.pArray = 0;
+          frame.pObject = static_cast<Value_Object const *>(pItem);
+          frame.property = frame.pObject->getData().begin();
+          writeHead(out, MAJOR_MAP, frame.pObject->size());
+          stack.push_back(frame);
+        }
+        break;
+
+        default :
+          out.append(static_cast<char>((MAJOR_SIMPLE << 5) | 22));
+          break;
+      }                          // value type switch
+
+      pItem = 0;
+      while (!pItem && !stack.empty())
+      {                          // next item search
+        Encode_Frame  &frame = stack.back();
+        if (frame.pArray)
+        {
+          if (frame.item != frame.pArray->getData().end())
+            pItem = *(frame.item++);
+          else
+            stack.pop_back();
+        }
+        else
+        {
+          if (frame.property != frame.pObject->getData().end())
+          {
+            writeText(out, frame.property->first);
+            pItem = (frame.property++)->second;
+          }
+          else
+            stack.pop_back();
+        }
+      }                          // next item search
+    }                            // items loop
+  }
+
+  void Cbor::encode(Value const &val, Sink &sink)
+  {
+    Output_Buffer out(sink);
+    encode(val, out);
+    out.flush();
+  }
+
+  Value *Cbor::decode(char const *data, size_t len) throw(Exception)
+  {
+    try
+    {
+      Value_Builder builder;
+      if (decode(data, len, builder) != len)
+        throw Syntax_Error("Data found after the first data item"
+          , "decoding CBOR data");
+      return builder.release();
+    }
+    catch(Syntax_Error &ex)
+    {
+      ex.addOrigin("Cbor::decode(char const *, size_t)");
+      throw ex;
+    }
+    catch(Exception &ex)
+    {
+      ex.addOrigin("Cbor::decode(char const *, size_t)");
+      throw ex;
+    }
+  }
+
+  size_t Cbor::decode(char const *data, size_t len, Parse_Handler &handler)
+    throw(Exception)
+  {
+    try
+    {
+      Cbor_Reader in(data, len);
+      std::vector<Decode_Frame> stack;
+      std::string str;
+      for (;;)
+      {                          // data items loop
+        unsigned char ib = in.byte();
+        unsigned char major = ib >> 5;
+        unsigned char info = ib & 0x1f;
+
+        if (ib == 0xff)
+        {                        // break code
+          if (stack.empty() || !stack.back().indefinite
+            || (stack.back().map && !stack.back().key))
+            in.fail("Unexpected break code");
+          bool  map = stack.back().map;
+          stack.pop_back();
+          if (!(map ? handler.objectEnd() : handler.arrayEnd()))
+            in.handlerFail(handler);
+        }                        // break code
+        else
+        {                        // data item
+          if (major == MAJOR_TAG)
+          {
+            in.argument(info);
+            continue;
+          }
+
+          bool  asKey = !stack.empty() && stack.back().map
+            && stack.back().key;
+          if (asKey && (major != MAJOR_TEXT))
+            in.fail("Map keys must be text strings");
+
+          bool  accepted = true;
+          switch (major)
+          {                      // major type switch
+            case MAJOR_UNSIGNED :
+            {
+              uint64_t  n = in.argument(info);
+              if (n <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+                accepted = handler.numberIntValue(static_cast<int64_t>(n));
+              else
+                accepted = handler.numberUnsignedValue(n);
+            }
+            break;
+
+            case MAJOR_NEGATIVE :
+            {
+              uint64_t  n = in.argument(info);
+              if (n <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+                accepted = handler.numberIntValue(-1 - static_cast<int64_t>(n));
+              else
+                accepted = handler.numberValue(-1.0 - static_cast<double>(n));
+            }
+            break;
+
+            case MAJOR_BYTES :
+            case MAJOR_TEXT :
+              in.string(major, info, str);
+              accepted = asKey
+                ? handler.propertyName(str)
+                : handler.stringValue(str);
+              break;
+
+            case MAJOR_ARRAY :
+            case MAJOR_MAP :
+            {
+              Decode_Frame  frame;
+              frame.map = (major == MAJOR_MAP);
+              frame.key = frame.map;
+              frame.indefinite = (info == 31);
+              frame.remaining = frame.indefinite ? 0 : in.argument(info);
+              if (frame.map)
+              {
+                if (frame.remaining > (frame.remaining * 2))
+                  in.fail("Invalid map length");
+                frame.remaining *= 2;
+              }
+              if (!(frame.map ? handler.objectBegin() : handler.arrayBegin()))
+                in.handlerFail(handler);
+              if (frame.indefinite || frame.remaining)
+              {
+                stack.push_back(frame);
+                continue;
+              }
+              accepted = frame.map ? handler.objectEnd() : handler.arrayEnd();
+            }
+            break;
+
+            default :
+              switch (info)
+              {                  // simple value switch
+                case 20 :
+                  accepted = handler.booleanValue(false);
+                  break;
+
+                case 21 :
+                  accepted = handler.booleanValue(true);
+                  break;
+
+                case 22 :
+                case 23 :
+                  accepted = handler.nullValue();
+                  break;
+
+                case 25 :
+                  accepted = handler.numberValue(halfToDouble(
+                    static_cast<unsigned int>(in.argument(info))));
+                  break;
+
+                case 26 :
+                {
+                  uint32_t  bits = static_cast<uint32_t>(in.argument(info));
+                  float     single;
+                  memcpy(&single, &bits, sizeof(single));
+                  accepted = handler.numberValue(single);
+                }
+                break;
+
+                case 27 :
+                {
+                  uint64_t  bits = in.argument(info);
+                  double    number;
+                  memcpy(&number, &bits, sizeof(number));
+                  accepted = handler.numberValue(number);
+                }
+                break;
+
+                default :
+                  in.fail("Unsupported simple value");
+                  break;
+              }                  // simple value switch
+              break;
+          }                      // major type switch
+          if (!accepted)
+            in.handlerFail(handler);
+        }                        // data item
+
+        while (!stack.empty())
+        {                        // item completion
+          Decode_Frame  &frame = stack.back();
+          if (frame.map)
+            frame.key = !frame.key;
+          if (frame.indefinite || --frame.remaining)
+            break;
+          bool  map = frame.map;
+          stack.pop_back();
+          if (!(map ? handler.objectEnd() : handler.arrayEnd()))
+            in.handlerFail(handler);
+        }                        // item completion
+
+        if (stack.empty())
+          return in.offset();
+      }                          // data items loop
+    }
+    catch(Syntax_Error &ex)
+    {
+      ex.addOrigin("Cbor::decode(char const *, size_t, Parse_Handler &)");
+      throw ex;
+    }
+    catch(Exception &ex)
+    {
+      ex.addOrigin("Cbor::decode(char const *, size_t, Parse_Handler &)");
+      throw ex;
+    }
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
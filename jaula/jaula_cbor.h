@@ -0,0 +1,143 @@
+
+/*
+ * jaula_cbor.h : JSON Analysis User Library Acronym
+ * CBOR encoding definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_CBOR_H_
+#define _JAULA_CBOR_H_
+
+#include <cstddef>
+
+#include <jaula/jaula_exception.h>
+#include <jaula/jaula_output_buffer.h>
+#include <jaula/jaula_parse_handler.h>
+#include <jaula/jaula_sink.h>
+#include <jaula/jaula_syntax_error.h>
+#include <jaula/jaula_value.h>
+
+/**
+ * \addtogroup jaula_bin JAULA: Binary encodings
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief CBOR encoding and decoding routines
+   *
+   * \ingroup jaula_bin
+   *
+   * \par
+   * This class converts values to and from the Concise Binary Object
+   * Representation (RFC 8949), avoiding the text number formatting and
+   * string escaping of the JSON notation.
+   *
+   * \par
+   * Integer numbers are encoded as CBOR integers and the other numbers as
+   * single precision floats when no precision is lost or as double
+   * precision ones otherwise. Strings are encoded as text strings and
+   * arrays and objects as definite length arrays and maps.
+   *
+   * \par
+   * Decoding accepts any well formed CBOR data item whose map keys are
+   * text strings. Byte strings are taken as strings, tags are ignored,
+   * the undefined value is taken as null and negative integers beyond the
+   * 64 bit signed range are taken as floating point numbers. Nesting is handled without
+   * recursion.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Cbor
+  {                              // class Cbor
+    public:
+
+      /**
+       * \brief Encodes a value
+       *
+       * \param val Value to encode.
+       *
+       * \param out Buffer where the encoded data is to be written.
+       */
+      static void encode(Value const &val, Output_Buffer &out);
+
+      /**
+       * \brief Encodes a value
+       *
+       * \param val Value to encode.
+       *
+       * \param sink Sink where the encoded data is to be sent. It is flushed
+       * once the value is complete.
+       */
+      static void encode(Value const &val, Sink &sink);
+
+      /**
+       * \brief Decodes a value
+       *
+       * \param data Pointer to the encoded data.
+       *
+       * \param len Number of bytes of encoded data. It must contain exactly
+       * one data item.
+       *
+       * \returns a pointer to memory taken from the heap containing the
+       * decoded value.
+       *
+       * \exception Syntax_Error raised if the data is not well formed or
+       * cannot be represented as a value.
+       *
+       * \warning
+       * As this method returns a pointer to memory allocated from the heap,
+       * it is up to the caller to release once it is no longer needed in
+       * order to avoid leaks.
+       */
+      static Value *decode(char const *data, size_t len) throw(Exception);
+
+      /**
+       * \brief Decodes a data item into parsing events
+       *
+       * \param data Pointer to the encoded data.
+       *
+       * \param len Number of bytes available.
+       *
+       * \param handler Handler to receive the parsing events.
+       *
+       * \returns the number of bytes of the data item decoded (further data
+       * is not examined).
+       *
+       * \exception Syntax_Error raised if the data is not well formed or
+       * cannot be represented as JSON data.
+       *
+       * \exception Exception raised if the handler stops the process. The
+       * handler error report is used if available.
+       */
+      static size_t decode(char const *data, size_t len
+        , Parse_Handler &handler) throw(Exception);
+
+  };                             // class Cbor
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
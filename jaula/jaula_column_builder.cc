@@ -0,0 +1,375 @@
+
+/*
+ * jaula_column_builder.cc : JSON Analysis User Library Acronym
+ * Columnar projection builder implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+}
+
+
+#include <jaula/jaula_column_builder.h>
+#include <jaula/jaula_number_format.h>
+#include <jaula/jaula_syntax_error.h>
+#include <jaula/jaula_value_object.h>
+
+namespace
+{                                // anonymous namespace
+
+  /**
+   * \brief Appends a property name to a JSON pointer
+   */
+  void appendToken(std::string &path, std::string const &name)
+  {
+    path += '/';
+    for (std::string::const_iterator it = name.begin(); it != name.end(); it++)
+    {
+      if (*it == '~')
+        path += "~0";
+      else if (*it == '/')
+        path += "~1";
+      else
+        path += *it;
+    }
+  }
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Column_Builder::Column_Builder(void)
+    : Parse_Handler()
+    , pTable_(new Column_Table())
+    , depth_(0)
+    , row_(0)
+    , path_()
+    , pathLengths_()
+    , tokens_()
+    , empty_()
+    , name_()
+    , pCapture_(0)
+    , captureDepth_(0)
+    , complete_(false)
+    , pErrorReport_(0)
+    {}
+
+  Column_Builder::~Column_Builder()
+  {
+    reset();
+    delete pTable_;
+  }
+
+  bool Column_Builder::nullValue(void)
+  {
+    if (pCapture_)
+      return pCapture_->nullValue();
+    Column_Table::Column *pColumn = current();
+    if (!pColumn)
+      return false;
+    pColumn->setNull(row_);
+    return true;
+  }
+
+  bool Column_Builder::booleanValue(bool data)
+  {
+    if (pCapture_)
+      return pCapture_->booleanValue(data);
+    Column_Table::Column *pColumn = current();
+    if (!pColumn)
+      return false;
+    pColumn->setBoolean(row_, data);
+    return true;
+  }
+
+  bool Column_Builder::numberValue(double data)
+  {
+    if (pCapture_)
+      return pCapture_->numberValue(data);
+    Column_Table::Column *pColumn = current();
+    if (!pColumn)
+      return false;
+    pColumn->setNumber(row_, data);
+    return true;
+  }
+
+  bool Column_Builder::numberIntValue(int64_t data)
+  {
+    if (pCapture_)
+      return pCapture_->numberIntValue(data);
+    Column_Table::Column *pColumn = current();
+    if (!pColumn)
+      return false;
+    pColumn->setNumberInt(row_, data);
+    return true;
+  }
+
+  bool Column_Builder::numberUnsignedValue(uint64_t data)
+  {
+    if (pCapture_)
+      return pCapture_->numberUnsignedValue(data);
+    Column_Table::Column *pColumn = current();
+    if (!pColumn)
+      return false;
+    pColumn->setNumberUnsigned(row_, data);
+    return true;
+  }
+
+  bool Column_Builder::numberTextValue(std::string const &data)
+  {
+    if (pCapture_)
+      return pCapture_->numberTextValue(data);
+
+    // numbers a column holds exactly are stored as such
+    if (Number_Format::isInt(data.data(), data.size()))
+    {
+      int64_t   val = 0;
+      uint64_t  uval = 0;
+      switch (Number_Format::scanInt(data.data(), data.size(), val, uval))
+      {
+        case Number_Format::INT_SIGNED :
+          return numberIntValue(val);
+
+        case Number_Format::INT_UNSIGNED :
+          return numberUnsignedValue(uval);
+
+        default :
+          break;
+      }
+    }
+    else
+    {
+      double const  number = strtod(data.c_str(), 0);
+      if (Number_Format::normalize(data.data(), data.size())
+        == Number_Format::normalize(number))
+        return numberValue(number);
+    }
+
+    // the others keep their text
+    Column_Table::Column *pColumn = current();
+    if (!pColumn)
+      return false;
+    pColumn->setValue(row_, Value::numberFromText(data));
+    return true;
+  }
+
+  bool Column_Builder::stringValue(std::string const &data)
+  {
+    if (pCapture_)
+      return pCapture_->stringValue(data);
+    Column_Table::Column *pColumn = current();
+    if (!pColumn)
+      return false;
+    pColumn->setString(row_, pTable_->intern(data));
+    return true;
+  }
+
+  bool Column_Builder::arrayBegin(void)
+  {
+    if (pCapture_)
+    {
+      captureDepth_++;
+      return pCapture_->arrayBegin();
+    }
+    if (!depth_)
+    {
+      depth_ = 1;
+      return true;
+    }
+    if (depth_ == 1)
+      return error("Rows must be objects", "Column_Builder::arrayBegin()");
+
+    if (!empty_.empty())
+      empty_.back() = false;
+    pCapture_ = new Value_Builder();
+    captureDepth_ = 1;
+    return pCapture_->arrayBegin();
+  }
+
+  bool Column_Builder::arrayEnd(void)
+  {
+    if (pCapture_)
+    {
+      if (!pCapture_->arrayEnd())
+        return false;
+      captureDepth_--;
+      captured();
+      return true;
+    }
+    depth_ = 0;
+    complete_ = true;
+    pTable_->complete();
+    return true;
+  }
+
+  bool Column_Builder::objectBegin(void)
+  {
+    if (pCapture_)
+    {
+      captureDepth_++;
+      return pCapture_->objectBegin();
+    }
+    if (!depth_)
+      return error("Data must be an array of objects"
+        , "Column_Builder::objectBegin()");
+
+    if (depth_ == 1)
+    {                            // new row
+      row_ = pTable_->addRow();
+      depth_ = 2;
+      return true;
+    }                            // new row
+
+    pathLengths_.push_back(path_.size());
+    appendToken(path_, name_);
+    tokens_.push_back(name_);
+    empty_.push_back(true);
+    depth_++;
+    return true;
+  }
+
+  bool Column_Builder::propertyName(std::string const &name)
+  {
+    if (pCapture_)
+      return pCapture_->propertyName(name);
+    name_ = name;
+    if (!empty_.empty())
+      empty_.back() = false;
+    return true;
+  }
+
+  bool Column_Builder::objectEnd(void)
+  {
+    if (pCapture_)
+    {
+      if (!pCapture_->objectEnd())
+        return false;
+      captureDepth_--;
+      captured();
+      return true;
+    }
+
+    depth_--;
+    if (depth_ == 1)
+      return true;
+
+    // empty objects are kept whole
+    std::string name = tokens_.back();
+    tokens_.pop_back();
+    if (empty_.back())
+      pTable_->column(path_, tokens_, name).setValue(row_, new Value_Object());
+    path_.erase(pathLengths_.back());
+    pathLengths_.pop_back();
+    empty_.pop_back();
+    return true;
+  }
+
+  Exception const *Column_Builder::getErrorReport(void) const
+  {
+    return pErrorReport_;
+  }
+
+  bool Column_Builder::complete(void) const
+  {
+    return complete_;
+  }
+
+  Column_Table *Column_Builder::release(void)
+  {
+    pTable_->complete();
+    Column_Table  *pResult = pTable_;
+    pTable_ = new Column_Table();
+    reset();
+    return pResult;
+  }
+
+  void Column_Builder::reset(void)
+  {
+    if (pTable_->getRowCount() || pTable_->getColumnCount())
+    {
+      delete pTable_;
+      pTable_ = new Column_Table();
+    }
+    depth_ = 0;
+    row_ = 0;
+    path_.erase();
+    pathLengths_.clear();
+    tokens_.clear();
+    empty_.clear();
+    name_.erase();
+    if (pCapture_)
+      delete pCapture_;
+    pCapture_ = 0;
+    captureDepth_ = 0;
+    complete_ = false;
+    if (pErrorReport_)
+      delete pErrorReport_;
+    pErrorReport_ = 0;
+  }
+
+  Column_Table::Column *Column_Builder::current(void)
+  {
+    if (depth_ < 2)
+    {
+      error("Rows must be objects", "Column_Builder::current()");
+      return 0;
+    }
+    std::string path = path_;
+    appendToken(path, name_);
+    return &(pTable_->column(path, tokens_, name_));
+  }
+
+  void Column_Builder::captured(void)
+  {
+    if (captureDepth_)
+      return;
+    std::string path = path_;
+    appendToken(path, name_);
+    pTable_->column(path, tokens_, name_).setValue(row_, pCapture_->release());
+    delete pCapture_;
+    pCapture_ = 0;
+  }
+
+  bool Column_Builder::error(char const *detail, char const *origin)
+  {
+    if (pErrorReport_)
+      delete pErrorReport_;
+    pErrorReport_ = new Syntax_Error(detail, "building a columnar projection"
+      , origin);
+    return false;
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
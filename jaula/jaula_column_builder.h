@@ -0,0 +1,269 @@
+
+/*
+ * jaula_column_builder.h : JSON Analysis User Library Acronym
+ * Columnar projection builder definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_COLUMN_BUILDER_H_
+#define _JAULA_COLUMN_BUILDER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <jaula/jaula_column_table.h>
+#include <jaula/jaula_exception.h>
+#include <jaula/jaula_parse_handler.h>
+#include <jaula/jaula_value_builder.h>
+
+/**
+ * \addtogroup jaula_parse JAULA: JSON data parser
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Parsing events handler that builds columnar projections
+   *
+   * \ingroup jaula_parse
+   *
+   * \par
+   * This class collects the events produced by a parser for an array of
+   * objects and stores them straight into a Column_Table, without building
+   * the objects. Only arrays and empty objects found inside the rows are
+   * built as values.
+   *
+   * \par
+   * The process is stopped with a Syntax_Error report if the data is not
+   * an array of objects.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Column_Builder : public Parse_Handler
+  {                              // class Column_Builder
+    public:
+
+      /**
+       * \brief Constructor
+       */
+      Column_Builder(void);
+
+      /**
+       * \brief Destructor
+       *
+       * \note
+       * Any table built and not released is destroyed with the instance.
+       */
+      virtual ~Column_Builder();
+
+      /**
+       * \brief Stores a null value
+       */
+      virtual bool nullValue(void);
+
+      /**
+       * \brief Stores a boolean value
+       */
+      virtual bool booleanValue(bool data);
+
+      /**
+       * \brief Stores a floating point number
+       */
+      virtual bool numberValue(double data);
+
+      /**
+       * \brief Stores an integer number
+       */
+      virtual bool numberIntValue(int64_t data);
+
+      /**
+       * \brief Stores an unsigned integer number
+       */
+      virtual bool numberUnsignedValue(uint64_t data);
+
+      /**
+       * \brief Stores a number kept by its decimal text
+       *
+       * \par Description
+       * Numbers no column can hold exactly are stored as whole values
+       * keeping the text.
+       */
+      virtual bool numberTextValue(std::string const &data);
+
+      /**
+       * \brief Stores a string
+       */
+      virtual bool stringValue(std::string const &data);
+
+      /**
+       * \brief Starts the rows array or an array inside a row
+       */
+      virtual bool arrayBegin(void);
+
+      /**
+       * \brief Ends the rows array or an array inside a row
+       */
+      virtual bool arrayEnd(void);
+
+      /**
+       * \brief Starts a row or an object inside a row
+       */
+      virtual bool objectBegin(void);
+
+      /**
+       * \brief Establishes the name for the next value
+       */
+      virtual bool propertyName(std::string const &name);
+
+      /**
+       * \brief Ends a row or an object inside a row
+       */
+      virtual bool objectEnd(void);
+
+      /**
+       * \brief Retrieves the error that stopped the process
+       */
+      virtual Exception const *getErrorReport(void) const;
+
+      /**
+       * \brief Checks if the rows array has been completed
+       */
+      bool complete(void) const;
+
+      /**
+       * \brief Takes the table built
+       *
+       * \returns a pointer to memory taken from the heap containing the
+       * table. The instance is reset so it can be used to build a new one.
+       *
+       * \warning
+       * It is up to the caller to release the table once it is no longer
+       * needed in order to avoid leaks.
+       */
+      Column_Table *release(void);
+
+      /**
+       * \brief Discards any table built so far
+       */
+      void reset(void);
+
+    private:
+
+      /**
+       * \brief Copy constructor (not available)
+       */
+      Column_Builder(Column_Builder const &orig);
+
+      /**
+       * \brief Assignment operator (not available)
+       */
+      Column_Builder &operator=(Column_Builder const &orig);
+
+      /**
+       * \brief Finds the column for the current property
+       *
+       * \returns a pointer to the column or a null pointer (with the error
+       * report set) if there is no row to store values into.
+       */
+      Column_Table::Column *current(void);
+
+      /**
+       * \brief Stores the value captured if complete
+       */
+      void captured(void);
+
+      /**
+       * \brief Sets the error report
+       *
+       * \returns false.
+       */
+      bool error(char const *detail, char const *origin);
+
+      /**
+       * \brief Table being built
+       */
+      Column_Table  *pTable_;
+
+      /**
+       * \brief Nesting level (1 inside the rows array, 2 inside a row)
+       */
+      size_t  depth_;
+
+      /**
+       * \brief Current row
+       */
+      size_t  row_;
+
+      /**
+       * \brief Path of the current object inside the row
+       */
+      std::string path_;
+
+      /**
+       * \brief Length of path_ for each enclosing object
+       */
+      std::vector<size_t> pathLengths_;
+
+      /**
+       * \brief Property names making up path_
+       */
+      std::vector<std::string>  tokens_;
+
+      /**
+       * \brief Flags for objects inside the row still without properties
+       */
+      std::vector<bool> empty_;
+
+      /**
+       * \brief Name for the next value
+       */
+      std::string name_;
+
+      /**
+       * \brief Builder for values kept whole (null when not capturing)
+       */
+      Value_Builder *pCapture_;
+
+      /**
+       * \brief Nesting level inside the value being captured
+       */
+      size_t  captureDepth_;
+
+      /**
+       * \brief Flag for the rows array completed
+       */
+      bool  complete_;
+
+      /**
+       * \brief Error that stopped the process
+       */
+      Exception *pErrorReport_;
+  };                             // class Column_Builder
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
@@ -0,0 +1,611 @@
+
+/*
+ * jaula_column_table.cc : JSON Analysis User Library Acronym
+ * Columnar projection implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+}
+
+
+#include <jaula/jaula_column_table.h>
+#include <jaula/jaula_value_boolean.h>
+#include <jaula/jaula_value_builder.h>
+#include <jaula/jaula_value_null.h>
+#include <jaula/jaula_value_number.h>
+#include <jaula/jaula_value_number_int.h>
+#include <jaula/jaula_value_string.h>
+#include <jaula/jaula_value_walker.h>
+
+namespace
+{                                // anonymous namespace
+
+  /**
+   * \brief Checks a bitmap bit
+   */
+  bool testBit(std::vector<uint64_t> const &bitmap, size_t bit)
+  {
+    return (bitmap[bit / 64] >> (bit % 64)) & 1;
+  }
+
+  /**
+   * \brief Sets a bitmap bit
+   */
+  void setBit(std::vector<uint64_t> &bitmap, size_t bit)
+  {
+    bitmap[bit / 64] |= static_cast<uint64_t>(1) << (bit % 64);
+  }
+
+  /**
+   * \brief Clears a bitmap bit
+   */
+  void clearBit(std::vector<uint64_t> &bitmap, size_t bit)
+  {
+    bitmap[bit / 64] &= ~(static_cast<uint64_t>(1) << (bit % 64));
+  }
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Column_Table::Column::Column(Column_Table &table, std::string const &path
+    , std::vector<std::string> const &tokens)
+    : table_(table)
+    , path_(path)
+    , tokens_(tokens)
+    , type_(COLUMN_NULL)
+    , rows_(0)
+    , presence_()
+    , validity_()
+    , booleans_()
+    , numbersInt_()
+    , numbersUnsigned_()
+    , numbers_()
+    , stringIds_()
+    , values_()
+    {}
+
+  Column_Table::Column::~Column()
+  {
+    for (std::vector<Value *>::iterator it = values_.begin()
+      ; it != values_.end(); it++)
+      delete *it;
+  }
+
+  std::string const &Column_Table::Column::getPath(void) const
+  {
+    return path_;
+  }
+
+  std::vector<std::string> const &Column_Table::Column::getTokens(void) const
+  {
+    return tokens_;
+  }
+
+  Column_Table::Column_Type Column_Table::Column::getType(void) const
+  {
+    return type_;
+  }
+
+  bool Column_Table::Column::isPresent(size_t row) const
+  {
+    return (row < rows_) && testBit(presence_, row);
+  }
+
+  bool Column_Table::Column::isNull(size_t row) const
+  {
+    return isPresent(row) && !testBit(validity_, row);
+  }
+
+  std::vector<uint64_t> const &Column_Table::Column::getPresence(void) const
+  {
+    return presence_;
+  }
+
+  std::vector<uint64_t> const &Column_Table::Column::getValidity(void) const
+  {
+    return validity_;
+  }
+
+  std::vector<unsigned char> const &Column_Table::Column::getBooleans(void) const
+  {
+    return booleans_;
+  }
+
+  std::vector<int64_t> const &Column_Table::Column::getNumbersInt(void) const
+  {
+    return numbersInt_;
+  }
+
+  std::vector<uint64_t> const &Column_Table::Column::getNumbersUnsigned(void) const
+  {
+    return numbersUnsigned_;
+  }
+
+  std::vector<double> const &Column_Table::Column::getNumbers(void) const
+  {
+    return numbers_;
+  }
+
+  std::vector<uint32_t> const &Column_Table::Column::getStringIds(void) const
+  {
+    return stringIds_;
+  }
+
+  std::vector<Value *> const &Column_Table::Column::getValues(void) const
+  {
+    return values_;
+  }
+
+  void Column_Table::Column::setNull(size_t row)
+  {
+    prepare(row, COLUMN_NULL);
+  }
+
+  void Column_Table::Column::setBoolean(size_t row, bool data)
+  {
+    switch (prepare(row, COLUMN_BOOLEAN))
+    {
+      case COLUMN_BOOLEAN :
+        booleans_[row] = data;
+        break;
+
+      default :
+        values_[row] = new Value_Boolean(data);
+        break;
+    }
+    setBit(validity_, row);
+  }
+
+  void Column_Table::Column::setNumberInt(size_t row, int64_t data)
+  {
+    if ((data >= 0) && (type_ == COLUMN_NUMBER_UNSIGNED))
+    {
+      setNumberUnsigned(row, static_cast<uint64_t>(data));
+      return;
+    }
+    switch (prepare(row, COLUMN_NUMBER_INT))
+    {
+      case COLUMN_NUMBER_INT :
+        numbersInt_[row] = data;
+        break;
+
+      case COLUMN_NUMBER :
+        numbers_[row] = static_cast<double>(data);
+        break;
+
+      default :
+        values_[row] = new Value_Number_Int(data);
+        break;
+    }
+    setBit(validity_, row);
+  }
+
+  void Column_Table::Column::setNumberUnsigned(size_t row, uint64_t data)
+  {
+    switch (prepare(row, COLUMN_NUMBER_UNSIGNED))
+    {
+      case COLUMN_NUMBER_UNSIGNED :
+        numbersUnsigned_[row] = data;
+        break;
+
+      case COLUMN_NUMBER :
+        numbers_[row] = static_cast<double>(data);
+        break;
+
+      default :
+      {
+        Value_Number_Int  *pNumber = new Value_Number_Int();
+        pNumber->setUnsigned(data);
+        values_[row] = pNumber;
+      }
+      break;
+    }
+    setBit(validity_, row);
+  }
+
+  void Column_Table::Column::setNumber(size_t row, double data)
+  {
+    switch (prepare(row, COLUMN_NUMBER))
+    {
+      case COLUMN_NUMBER :
+        numbers_[row] = data;
+        break;
+
+      default :
+        values_[row] = new Value_Number(data);
+        break;
+    }
+    setBit(validity_, row);
+  }
+
+  void Column_Table::Column::setString(size_t row, uint32_t id)
+  {
+    switch (prepare(row, COLUMN_STRING))
+    {
+      case COLUMN_STRING :
+        stringIds_[row] = id;
+        break;
+
+      default :
+        values_[row] = new Value_String(table_.strings_[id]);
+        break;
+    }
+    setBit(validity_, row);
+  }
+
+  void Column_Table::Column::setValue(size_t row, Value *pVal)
+  {
+    prepare(row, COLUMN_VALUE);
+    values_[row] = pVal;
+    setBit(validity_, row);
+  }
+
+  Column_Table::Column_Type Column_Table::Column::prepare(size_t row
+    , Column_Type type)
+  {
+    if (row >= rows_)
+      resize(row + 1);
+
+    // a repeated property replaces the previous value
+    if (testBit(validity_, row))
+    {
+      clearBit(validity_, row);
+      if (type_ == COLUMN_VALUE)
+      {
+        delete values_[row];
+        values_[row] = 0;
+      }
+    }
+    setBit(presence_, row);
+
+    if ((type == COLUMN_NULL) || (type == type_))
+      return type_;
+
+    if (type_ == COLUMN_NULL)
+    {
+      type_ = type;
+      resize(rows_);
+      return type_;
+    }
+
+    if ((type_ == COLUMN_NUMBER) && ((type == COLUMN_NUMBER_INT)
+      || (type == COLUMN_NUMBER_UNSIGNED)))
+      return COLUMN_NUMBER;
+
+    if (((type_ == COLUMN_NUMBER_INT) || (type_ == COLUMN_NUMBER_UNSIGNED))
+      && (type == COLUMN_NUMBER))
+    {                            // integers promotion
+      if (type_ == COLUMN_NUMBER_INT)
+        numbers_.assign(numbersInt_.begin(), numbersInt_.end());
+      else
+        numbers_.assign(numbersUnsigned_.begin(), numbersUnsigned_.end());
+      std::vector<int64_t>().swap(numbersInt_);
+      std::vector<uint64_t>().swap(numbersUnsigned_);
+      type_ = COLUMN_NUMBER;
+      return type_;
+    }                            // integers promotion
+
+    if ((type_ == COLUMN_NUMBER_INT) && (type == COLUMN_NUMBER_UNSIGNED))
+    {                            // unsigned promotion
+      size_t  i = 0;
+      while ((i < rows_) && (numbersInt_[i] >= 0))
+        i++;
+      if (i == rows_)
+      {
+        numbersUnsigned_.assign(numbersInt_.begin(), numbersInt_.end());
+        std::vector<int64_t>().swap(numbersInt_);
+        type_ = COLUMN_NUMBER_UNSIGNED;
+        return type_;
+      }
+    }                            // unsigned promotion
+
+    if (type_ != COLUMN_VALUE)
+    {                            // values conversion
+      std::vector<Value *>  values(rows_, static_cast<Value *>(0));
+      for (size_t i = 0; i < rows_; i++)
+      {
+        if (testBit(validity_, i))
+          values[i] = makeValue(i);
+      }
+      values_.swap(values);
+      std::vector<unsigned char>().swap(booleans_);
+      std::vector<int64_t>().swap(numbersInt_);
+      std::vector<uint64_t>().swap(numbersUnsigned_);
+      std::vector<double>().swap(numbers_);
+      std::vector<uint32_t>().swap(stringIds_);
+      type_ = COLUMN_VALUE;
+    }                            // values conversion
+    return type_;
+  }
+
+  void Column_Table::Column::resize(size_t rows)
+  {
+    rows_ = rows;
+    presence_.resize((rows + 63) / 64, 0);
+    validity_.resize((rows + 63) / 64, 0);
+    switch (type_)
+    {
+      case COLUMN_BOOLEAN :
+        booleans_.resize(rows, 0);
+        break;
+
+      case COLUMN_NUMBER_INT :
+        numbersInt_.resize(rows, 0);
+        break;
+
+      case COLUMN_NUMBER_UNSIGNED :
+        numbersUnsigned_.resize(rows, 0);
+        break;
+
+      case COLUMN_NUMBER :
+        numbers_.resize(rows, 0);
+        break;
+
+      case COLUMN_STRING :
+        stringIds_.resize(rows, 0);
+        break;
+
+      case COLUMN_VALUE :
+        values_.resize(rows, 0);
+        break;
+
+      default :
+        break;
+    }
+  }
+
+  Value *Column_Table::Column::makeValue(size_t row) const
+  {
+    if (!testBit(validity_, row))
+      return new Value_Null();
+
+    switch (type_)
+    {
+      case COLUMN_BOOLEAN :
+        return new Value_Boolean(booleans_[row] != 0);
+
+      case COLUMN_NUMBER_INT :
+        return new Value_Number_Int(numbersInt_[row]);
+
+      case COLUMN_NUMBER_UNSIGNED :
+      {
+        Value_Number_Int  *pNumber = new Value_Number_Int();
+        pNumber->setUnsigned(numbersUnsigned_[row]);
+        return pNumber;
+      }
+
+      case COLUMN_NUMBER :
+        return new Value_Number(numbers_[row]);
+
+      case COLUMN_STRING :
+        return new Value_String(table_.strings_[stringIds_[row]]);
+
+      case COLUMN_VALUE :
+        return Value::duplicate(*(values_[row]));
+
+      default :
+        return new Value_Null();
+    }
+  }
+
+  Column_Table::Column_Table(void)
+    : rows_(0)
+    , columns_()
+    , order_()
+    , stringIds_()
+    , strings_()
+    {}
+
+  Column_Table::~Column_Table()
+  {
+    for (std::vector<Column *>::iterator it = order_.begin()
+      ; it != order_.end(); it++)
+      delete *it;
+  }
+
+  size_t Column_Table::getRowCount(void) const
+  {
+    return rows_;
+  }
+
+  size_t Column_Table::getColumnCount(void) const
+  {
+    return order_.size();
+  }
+
+  Column_Table::Column const &Column_Table::getColumn(size_t index) const
+  {
+    return *(order_[index]);
+  }
+
+  Column_Table::Column const *Column_Table::findColumn(std::string const &path) const
+  {
+    std::map<std::string, Column *>::const_iterator it = columns_.find(path);
+    return (it == columns_.end()) ? 0 : it->second;
+  }
+
+  std::string const &Column_Table::getString(uint32_t id) const
+  {
+    return strings_[id];
+  }
+
+  size_t Column_Table::getStringCount(void) const
+  {
+    return strings_.size();
+  }
+
+  bool Column_Table::walkRow(size_t row, Parse_Handler &handler) const
+  {
+    if (!handler.objectBegin())
+      return false;
+
+    // columns are sorted by path, so the ones inside the same nested
+    // object come together
+    std::vector<std::string>  open;
+    for (std::vector<Column *>::const_iterator it = order_.begin()
+      ; it != order_.end(); it++)
+    {                            // columns loop
+      Column const  &col = **it;
+      if (!col.isPresent(row))
+        continue;
+
+      std::vector<std::string> const &tokens = col.tokens_;
+      size_t  common = 0;
+      while ((common < open.size()) && (common < (tokens.size() - 1))
+        && (open[common] == tokens[common]))
+        common++;
+      while (open.size() > common)
+      {
+        if (!handler.objectEnd())
+          return false;
+        open.pop_back();
+      }
+      while (open.size() < (tokens.size() - 1))
+      {
+        if (!handler.propertyName(tokens[open.size()])
+          || !handler.objectBegin())
+          return false;
+        open.push_back(tokens[open.size()]);
+      }
+
+      if (!handler.propertyName(tokens.back()))
+        return false;
+      bool  accepted;
+      if (!testBit(col.validity_, row))
+        accepted = handler.nullValue();
+      else
+      {
+        switch (col.type_)
+        {
+          case COLUMN_BOOLEAN :
+            accepted = handler.booleanValue(col.booleans_[row] != 0);
+            break;
+
+          case COLUMN_NUMBER_INT :
+            accepted = handler.numberIntValue(col.numbersInt_[row]);
+            break;
+
+          case COLUMN_NUMBER_UNSIGNED :
+          {
+            uint64_t const  data = col.numbersUnsigned_[row];
+            accepted = (static_cast<int64_t>(data) < 0)
+              ? handler.numberUnsignedValue(data)
+              : handler.numberIntValue(static_cast<int64_t>(data));
+          }
+          break;
+
+          case COLUMN_NUMBER :
+            accepted = handler.numberValue(col.numbers_[row]);
+            break;
+
+          case COLUMN_STRING :
+            accepted = handler.stringValue(strings_[col.stringIds_[row]]);
+            break;
+
+          default :
+            accepted = Value_Walker::walk(*(col.values_[row]), handler);
+            break;
+        }
+      }
+      if (!accepted)
+        return false;
+    }                            // columns loop
+
+    while (!open.empty())
+    {
+      if (!handler.objectEnd())
+        return false;
+      open.pop_back();
+    }
+    return handler.objectEnd();
+  }
+
+  Value_Object *Column_Table::getRow(size_t row) const
+  {
+    Value_Builder builder;
+    walkRow(row, builder);
+    return static_cast<Value_Object *>(builder.release());
+  }
+
+  Value_Array *Column_Table::getRows(void) const
+  {
+    Value_Array *pRows = new Value_Array();
+    for (size_t row = 0; row < rows_; row++)
+      pRows->adoptItem(getRow(row));
+    return pRows;
+  }
+
+  Column_Table::Column &Column_Table::column(std::string const &path
+    , std::vector<std::string> const &parent_tokens, std::string const &name)
+  {
+    std::map<std::string, Column *>::iterator it = columns_.find(path);
+    if (it != columns_.end())
+      return *(it->second);
+
+    std::vector<std::string>  tokens(parent_tokens);
+    tokens.push_back(name);
+    Column  *pColumn = new Column(*this, path, tokens);
+    columns_.insert(std::make_pair(path, pColumn));
+    order_.clear();
+    for (it = columns_.begin(); it != columns_.end(); it++)
+      order_.push_back(it->second);
+    return *pColumn;
+  }
+
+  uint32_t Column_Table::intern(std::string const &str)
+  {
+    std::map<std::string, uint32_t>::iterator it = stringIds_.find(str);
+    if (it != stringIds_.end())
+      return it->second;
+    uint32_t  id = static_cast<uint32_t>(strings_.size());
+    stringIds_.insert(std::make_pair(str, id));
+    strings_.push_back(str);
+    return id;
+  }
+
+  size_t Column_Table::addRow(void)
+  {
+    return rows_++;
+  }
+
+  void Column_Table::complete(void)
+  {
+    for (std::vector<Column *>::iterator it = order_.begin()
+      ; it != order_.end(); it++)
+    {
+      if ((*it)->rows_ < rows_)
+        (*it)->resize(rows_);
+    }
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
@@ -0,0 +1,430 @@
+
+/*
+ * jaula_column_table.h : JSON Analysis User Library Acronym
+ * Columnar projection definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_COLUMN_TABLE_H_
+#define _JAULA_COLUMN_TABLE_H_
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <jaula/jaula_parse_handler.h>
+#include <jaula/jaula_value.h>
+#include <jaula/jaula_value_array.h>
+#include <jaula/jaula_value_object.h>
+
+/**
+ * \addtogroup jaula_val JAULA: JSON Values containers
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  class Column_Builder;
+
+  /**
+   * \brief Columnar projection of an array of objects
+   *
+   * \ingroup jaula_val
+   *
+   * \par
+   * This class keeps the data of an array of objects (rows) as one typed
+   * vector per property (column), so scanning a property reads contiguous
+   * memory instead of walking every object. Tables are built straight from
+   * the parsing events by Column_Builder.
+   *
+   * \par
+   * Properties of nested objects are flattened into columns whose paths
+   * are JSON pointers (\\c /address/city). Columns keep booleans, 64 bits
+   * integers, floating point numbers or string identifiers (strings are
+   * interned in the table). Integers are kept unsigned when some of them
+   * only fit so and none is negative. A column with both integer and
+   * floating point numbers keeps floating point ones. Numbers no column can
+   * hold exactly are kept as whole values with their text. Arrays, empty objects and columns
+   * with values of different kinds keep whole values.
+   *
+   * \par
+   * Two bitmaps tell, for each row, whether the property was present and
+   * whether it had a non null value. Bit \\c n of a bitmap is bit
+   * <tt>n % 64</tt> of word <tt>n / 64</tt>.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Column_Table
+  {                              // class Column_Table
+    public:
+
+      /**
+       * \brief Column types
+       */
+      enum    Column_Type
+      {                          // enum Column_Type
+        /** Only null values */
+        COLUMN_NULL
+        /** Booleans (getBooleans()) */
+        ,   COLUMN_BOOLEAN
+        /** Integer numbers (getNumbersInt()) */
+        ,   COLUMN_NUMBER_INT
+        /** Non negative integer numbers, some of them beyond the 64 bit
+         * signed range (getNumbersUnsigned()) */
+        ,   COLUMN_NUMBER_UNSIGNED
+        /** Floating point numbers (getNumbers()) */
+        ,   COLUMN_NUMBER
+        /** String identifiers (getStringIds()) */
+        ,   COLUMN_STRING
+        /** Whole values (getValues()) */
+        ,   COLUMN_VALUE
+      };                         // enum Column_Type
+
+      /**
+       * \brief Column data
+       *
+       * \par
+       * Data vectors have an element per row. Only the one matching the
+       * column type is used, and its elements for rows without a non null
+       * value are 0.
+       */
+      class Column
+      {                          // class Column
+        public:
+
+          /**
+           * \brief Destructor
+           */
+          ~Column();
+
+          /**
+           * \brief Retrieves the column path (JSON pointer)
+           */
+          std::string const &getPath(void) const;
+
+          /**
+           * \brief Retrieves the property names making up the path
+           */
+          std::vector<std::string> const &getTokens(void) const;
+
+          /**
+           * \brief Retrieves the column type
+           */
+          Column_Type getType(void) const;
+
+          /**
+           * \brief Checks if a row has the property
+           */
+          bool isPresent(size_t row) const;
+
+          /**
+           * \brief Checks if a row has the property with a null value
+           */
+          bool isNull(size_t row) const;
+
+          /**
+           * \brief Retrieves the bitmap of rows having the property
+           */
+          std::vector<uint64_t> const &getPresence(void) const;
+
+          /**
+           * \brief Retrieves the bitmap of rows having a non null value
+           */
+          std::vector<uint64_t> const &getValidity(void) const;
+
+          /**
+           * \brief Retrieves the data of a boolean column (0 or 1)
+           */
+          std::vector<unsigned char> const &getBooleans(void) const;
+
+          /**
+           * \brief Retrieves the data of an integer column
+           */
+          std::vector<int64_t> const &getNumbersInt(void) const;
+
+          /**
+           * \brief Retrieves the data of an unsigned integer column
+           */
+          std::vector<uint64_t> const &getNumbersUnsigned(void) const;
+
+          /**
+           * \brief Retrieves the data of a floating point column
+           */
+          std::vector<double> const &getNumbers(void) const;
+
+          /**
+           * \brief Retrieves the data of a string column (see
+           * Column_Table::getString())
+           */
+          std::vector<uint32_t> const &getStringIds(void) const;
+
+          /**
+           * \brief Retrieves the data of a values column (null pointers
+           * for rows without a non null value)
+           */
+          std::vector<Value *> const &getValues(void) const;
+
+        private:
+
+          friend class Column_Builder;
+          friend class Column_Table;
+
+          /**
+           * \brief Constructor
+           */
+          Column(Column_Table &table, std::string const &path
+            , std::vector<std::string> const &tokens);
+
+          /**
+           * \brief Copy constructor (not available)
+           */
+          Column(Column const &orig);
+
+          /**
+           * \brief Assignment operator (not available)
+           */
+          Column &operator=(Column const &orig);
+
+          /**
+           * \brief Stores a null value
+           */
+          void setNull(size_t row);
+
+          /**
+           * \brief Stores a boolean value
+           */
+          void setBoolean(size_t row, bool data);
+
+          /**
+           * \brief Stores an integer value
+           */
+          void setNumberInt(size_t row, int64_t data);
+
+          /**
+           * \brief Stores an unsigned integer value
+           */
+          void setNumberUnsigned(size_t row, uint64_t data);
+
+          /**
+           * \brief Stores a floating point value
+           */
+          void setNumber(size_t row, double data);
+
+          /**
+           * \brief Stores a string value
+           */
+          void setString(size_t row, uint32_t id);
+
+          /**
+           * \brief Stores a value (ownership is taken)
+           */
+          void setValue(size_t row, Value *pVal);
+
+          /**
+           * \brief Prepares the column for a non null value of a type
+           *
+           * \returns the type to use for the value.
+           */
+          Column_Type prepare(size_t row, Column_Type type);
+
+          /**
+           * \brief Makes the vectors and bitmaps hold a number of rows
+           */
+          void resize(size_t rows);
+
+          /**
+           * \brief Builds the value stored for a row
+           *
+           * \returns a pointer to memory taken from the heap (a null value
+           * if the row has no non null value).
+           */
+          Value *makeValue(size_t row) const;
+
+          Column_Table  &table_;
+          std::string   path_;
+          std::vector<std::string>  tokens_;
+          Column_Type   type_;
+          size_t        rows_;
+          std::vector<uint64_t>       presence_;
+          std::vector<uint64_t>       validity_;
+          std::vector<unsigned char>  booleans_;
+          std::vector<int64_t>        numbersInt_;
+          std::vector<uint64_t>       numbersUnsigned_;
+          std::vector<double>         numbers_;
+          std::vector<uint32_t>       stringIds_;
+          std::vector<Value *>        values_;
+      };                         // class Column
+
+      /**
+       * \brief Constructor (empty table)
+       */
+      Column_Table(void);
+
+      /**
+       * \brief Destructor
+       */
+      ~Column_Table();
+
+      /**
+       * \brief Retrieves the number of rows
+       */
+      size_t getRowCount(void) const;
+
+      /**
+       * \brief Retrieves the number of columns
+       */
+      size_t getColumnCount(void) const;
+
+      /**
+       * \brief Retrieves a column
+       *
+       * \param index Column position (columns are sorted by path).
+       */
+      Column const &getColumn(size_t index) const;
+
+      /**
+       * \brief Finds a column
+       *
+       * \param path Column path (JSON pointer).
+       *
+       * \returns a pointer to the column or a null pointer if there is no
+       * column with such a path.
+       */
+      Column const *findColumn(std::string const &path) const;
+
+      /**
+       * \brief Retrieves an interned string
+       *
+       * \param id String identifier.
+       */
+      std::string const &getString(uint32_t id) const;
+
+      /**
+       * \brief Retrieves the number of interned strings
+       */
+      size_t getStringCount(void) const;
+
+      /**
+       * \brief Sends the parsing events of a row to a handler
+       *
+       * \returns true if the handler accepted all the events.
+       */
+      bool walkRow(size_t row, Parse_Handler &handler) const;
+
+      /**
+       * \brief Builds a row
+       *
+       * \returns a pointer to memory taken from the heap containing the
+       * object for the row.
+       *
+       * \warning
+       * It is up to the caller to release the object once it is no longer
+       * needed in order to avoid leaks.
+       */
+      Value_Object *getRow(size_t row) const;
+
+      /**
+       * \brief Builds all the rows
+       *
+       * \returns a pointer to memory taken from the heap containing an
+       * array with the objects for all the rows.
+       *
+       * \warning
+       * It is up to the caller to release the array once it is no longer
+       * needed in order to avoid leaks.
+       */
+      Value_Array *getRows(void) const;
+
+    private:
+
+      friend class Column_Builder;
+      friend class Column;
+
+      /**
+       * \brief Copy constructor (not available)
+       */
+      Column_Table(Column_Table const &orig);
+
+      /**
+       * \brief Assignment operator (not available)
+       */
+      Column_Table &operator=(Column_Table const &orig);
+
+      /**
+       * \brief Finds or creates a column
+       */
+      Column &column(std::string const &path
+        , std::vector<std::string> const &parent_tokens
+        , std::string const &name);
+
+      /**
+       * \brief Interns a string
+       */
+      uint32_t intern(std::string const &str);
+
+      /**
+       * \brief Adds a row
+       *
+       * \returns the new row position.
+       */
+      size_t addRow(void);
+
+      /**
+       * \brief Makes all the columns hold all the rows
+       */
+      void complete(void);
+
+      /**
+       * \brief Number of rows
+       */
+      size_t  rows_;
+
+      /**
+       * \brief Columns by path
+       */
+      std::map<std::string, Column *> columns_;
+
+      /**
+       * \brief Columns sorted by path
+       */
+      std::vector<Column *> order_;
+
+      /**
+       * \brief Interned strings identifiers
+       */
+      std::map<std::string, uint32_t> stringIds_;
+
+      /**
+       * \brief Interned strings
+       */
+      std::vector<std::string>  strings_;
+  };                             // class Column_Table
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
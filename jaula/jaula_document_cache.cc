@@ -0,0 +1,529 @@
+
+/*
+ * jaula_document_cache.cc : JSON Analysis User Library Acronym
+ * Parsed documents cache implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_ERRNO_H
+#include <errno.h>
+#endif
+
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+#ifdef HAVE_STDINT_H
+#include <stdint.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+}
+
+#ifdef HAVE_MAP
+#include <map>
+#endif
+
+#ifdef HAVE_MEMORY
+#include <memory>
+#endif
+
+#include <jaula/jaula_document_cache.h>
+#include <jaula/jaula_incremental_parser.h>
+#include <jaula/jaula_lexan_error.h>
+#include <jaula/jaula_value_complex.h>
+
+namespace
+{                                // anonymous namespace
+
+  /**
+   * \brief Multiplier used to spread bits
+   */
+  uint64_t const GOLDEN = (static_cast<uint64_t>(0x9e3779b9UL) << 32)
+    | 0x7f4a7c15UL;
+
+  /**
+   * \brief Final mixing step from MurmurHash3
+   */
+  uint64_t mix(uint64_t h)
+  {
+    h ^= h >> 33;
+    h *= (static_cast<uint64_t>(0xff51afd7UL) << 32) | 0xed558ccdUL;
+    h ^= h >> 33;
+    h *= (static_cast<uint64_t>(0xc4ceb9feUL) << 32) | 0x1a85ec53UL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  /**
+   * \brief Hashes a sequence of bytes eight at a time
+   */
+  uint64_t hashBytes(char const *data, size_t len)
+  {
+    uint64_t  h = mix(len * GOLDEN);
+    for (; (len >= 8); data += 8, len -= 8)
+    {
+      uint64_t  word;
+      memcpy(&word, data, 8);
+      h = mix(h ^ word) * GOLDEN;
+    }
+    uint64_t  tail = 0;
+    memcpy(&tail, data, len);
+    return mix(h ^ tail);
+  }
+
+  /**
+   * \brief Appends the raw bytes of a value to a string
+   */
+  template<class T>
+  void appendRaw(std::string &str, T const &data)
+  {
+    str.append(reinterpret_cast<char const *>(&data), sizeof(data));
+  }
+
+  /**
+   * \brief Closes a file descriptor when going out of scope
+   */
+  class Fd_Guard
+  {                              // class Fd_Guard
+    public:
+      Fd_Guard(int fd) : fd_(fd) {}
+      ~Fd_Guard() { close(fd_); }
+    private:
+      int                         fd_;
+  };                             // class Fd_Guard
+
+  /**
+   * \brief Holds a mutex locked while in scope
+   */
+  class Lock_Guard
+  {                              // class Lock_Guard
+    public:
+      Lock_Guard(pthread_mutex_t &mutex) : mutex_(mutex)
+      {
+        pthread_mutex_lock(&mutex_);
+      }
+      ~Lock_Guard() { pthread_mutex_unlock(&mutex_); }
+    private:
+      pthread_mutex_t             &mutex_;
+  };                             // class Lock_Guard
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  struct Document_Cache::Entry
+  {                              // struct Document_Cache::Entry
+
+    /**
+     * \brief Key in the shard index
+     */
+    std::string                 key;
+
+    /**
+     * \brief Validation data
+     */
+    std::string                 stamp;
+
+    /**
+     * \brief Document kept
+     */
+    Shared_Value                document;
+
+    /**
+     * \brief Bytes accounted for the entry
+     */
+    size_t                      bytes;
+
+    /**
+     * \brief Next more recently used entry
+     */
+    Entry                       *pNewer;
+
+    /**
+     * \brief Next less recently used entry
+     */
+    Entry                       *pOlder;
+  };                             // struct Document_Cache::Entry
+
+  struct Document_Cache::Shard
+  {                              // struct Document_Cache::Shard
+
+    /**
+     * \brief Container type for the index
+     */
+    typedef std::map<std::string, Entry *> indexType;
+
+    /**
+     * \brief Constructor
+     */
+    Shard(void)
+      : index()
+      , pNewest(0)
+      , pOldest(0)
+      , bytes(0)
+      , budget(0)
+      , hits(0)
+      , misses(0)
+    {
+      pthread_mutex_init(&lock, 0);
+    }
+
+    /**
+     * \brief Destructor
+     */
+    ~Shard()
+    {
+      clear();
+      pthread_mutex_destroy(&lock);
+    }
+
+    /**
+     * \brief Unlinks an entry from the LRU list
+     */
+    void unlink(Entry *pEntry)
+    {
+      (pEntry->pNewer ? pEntry->pNewer->pOlder : pNewest) = pEntry->pOlder;
+      (pEntry->pOlder ? pEntry->pOlder->pNewer : pOldest) = pEntry->pNewer;
+    }
+
+    /**
+     * \brief Links an entry as the most recently used one
+     */
+    void link(Entry *pEntry)
+    {
+      pEntry->pNewer = 0;
+      pEntry->pOlder = pNewest;
+      (pNewest ? pNewest->pNewer : pOldest) = pEntry;
+      pNewest = pEntry;
+    }
+
+    /**
+     * \brief Discards an entry
+     */
+    void discard(Entry *pEntry)
+    {
+      unlink(pEntry);
+      index.erase(pEntry->key);
+      bytes -= pEntry->bytes;
+      delete pEntry;
+    }
+
+    /**
+     * \brief Discards all the entries
+     */
+    void clear(void)
+    {
+      while (pOldest)
+        discard(pOldest);
+    }
+
+    /**
+     * \brief Lock protecting all the other fields
+     */
+    pthread_mutex_t             lock;
+
+    /**
+     * \brief Entries by key
+     */
+    indexType                   index;
+
+    /**
+     * \brief Most recently used entry
+     */
+    Entry                       *pNewest;
+
+    /**
+     * \brief Least recently used entry
+     */
+    Entry                       *pOldest;
+
+    /**
+     * \brief Bytes accounted for the entries
+     */
+    size_t                      bytes;
+
+    /**
+     * \brief Share of the memory budget
+     */
+    size_t                      budget;
+
+    /**
+     * \brief Loads served from the shard
+     */
+    unsigned long               hits;
+
+    /**
+     * \brief Loads that required parsing
+     */
+    unsigned long               misses;
+  };                             // struct Document_Cache::Shard
+
+  Document_Cache::Document_Cache(size_t budget, unsigned int shards)
+    : budget_(budget)
+    , count_(shards ? shards : 1)
+    , shards_(0)
+  {
+    shards_ = new Shard[count_];
+    for (unsigned int i = 0; (i < count_); i++)
+      shards_[i].budget = budget_ / count_;
+  }
+
+  Document_Cache::~Document_Cache()
+  {
+    delete [] shards_;
+  }
+
+  Shared_Value Document_Cache::loadFile(std::string const &path
+    , bool comments_allowed) throw(Exception)
+  {
+    try
+    {
+      int const fd = open(path.c_str(), O_RDONLY);
+      if (fd < 0)
+        throw Lexan_Error(strerror(errno), "opening file " + path);
+      Fd_Guard guard(fd);
+
+      struct stat st;
+      if (fstat(fd, &st))
+        throw Lexan_Error(strerror(errno), "checking file " + path);
+      std::string key("F");
+      key += path;
+      std::string stamp;
+      appendRaw(stamp, st.st_dev);
+      appendRaw(stamp, st.st_ino);
+      appendRaw(stamp, st.st_mtime);
+      appendRaw(stamp, st.st_size);
+
+      Shared_Value document;
+      if (lookup(key, stamp, document))
+        return document;
+
+      std::string data;
+      data.resize(static_cast<size_t>(st.st_size) + 1);
+      size_t len = 0;
+      for (;;)
+      {
+        if (len == data.size())
+          data.resize(len * 2);
+        ssize_t const got = read(fd, &data[len], data.size() - len);
+        if (got < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          throw Lexan_Error(strerror(errno), "reading file " + path);
+        }
+        if (!got)
+          break;
+        len += got;
+      }
+
+      document = parse(data.data(), len, comments_allowed);
+      store(key, stamp, document);
+      return document;
+    }
+    catch(Exception &ex)
+    {
+      ex.addOrigin("Document_Cache::loadFile(std::string const &, bool)");
+      throw ex;
+    }
+  }
+
+  Shared_Value Document_Cache::loadBuffer(char const *data, size_t len
+    , bool comments_allowed) throw(Exception)
+  {
+    try
+    {
+      std::string key("B");
+      appendRaw(key, hashBytes(data, len));
+      appendRaw(key, len);
+
+      Shared_Value document;
+      if (lookup(key, "", document))
+        return document;
+      document = parse(data, len, comments_allowed);
+      store(key, "", document);
+      return document;
+    }
+    catch(Exception &ex)
+    {
+      ex.addOrigin("Document_Cache::loadBuffer(char const *, size_t, bool)");
+      throw ex;
+    }
+  }
+
+  void Document_Cache::clear(void)
+  {
+    for (unsigned int i = 0; (i < count_); i++)
+    {
+      Lock_Guard guard(shards_[i].lock);
+      shards_[i].clear();
+    }
+  }
+
+  size_t Document_Cache::getBudget(void) const
+  {
+    return budget_;
+  }
+
+  size_t Document_Cache::getBytes(void) const
+  {
+    size_t bytes = 0;
+    for (unsigned int i = 0; (i < count_); i++)
+    {
+      Lock_Guard guard(shards_[i].lock);
+      bytes += shards_[i].bytes;
+    }
+    return bytes;
+  }
+
+  size_t Document_Cache::getCount(void) const
+  {
+    size_t count = 0;
+    for (unsigned int i = 0; (i < count_); i++)
+    {
+      Lock_Guard guard(shards_[i].lock);
+      count += shards_[i].index.size();
+    }
+    return count;
+  }
+
+  unsigned long Document_Cache::getHits(void) const
+  {
+    unsigned long hits = 0;
+    for (unsigned int i = 0; (i < count_); i++)
+    {
+      Lock_Guard guard(shards_[i].lock);
+      hits += shards_[i].hits;
+    }
+    return hits;
+  }
+
+  unsigned long Document_Cache::getMisses(void) const
+  {
+    unsigned long misses = 0;
+    for (unsigned int i = 0; (i < count_); i++)
+    {
+      Lock_Guard guard(shards_[i].lock);
+      misses += shards_[i].misses;
+    }
+    return misses;
+  }
+
+  Document_Cache::Shard &Document_Cache::shardFor(std::string const &key)
+    const
+  {
+    return shards_[hashBytes(key.data(), key.size()) % count_];
+  }
+
+  bool Document_Cache::lookup(std::string const &key
+    , std::string const &stamp, Shared_Value &document) const
+  {
+    Shard &shard = shardFor(key);
+    Lock_Guard guard(shard.lock);
+    Shard::indexType::iterator it = shard.index.find(key);
+    if ((it == shard.index.end()) || (it->second->stamp != stamp))
+    {
+      shard.misses++;
+      return false;
+    }
+    shard.hits++;
+    shard.unlink(it->second);
+    shard.link(it->second);
+    document = it->second->document;
+    return true;
+  }
+
+  void Document_Cache::store(std::string const &key
+    , std::string const &stamp, Shared_Value &document)
+  {
+    size_t const bytes = document.footprint() + sizeof(Entry)
+      + sizeof(Shard::indexType::value_type) + (4 * sizeof(void *))
+      + (2 * key.size()) + stamp.size();
+    Shard &shard = shardFor(key);
+    Lock_Guard guard(shard.lock);
+
+    Shard::indexType::iterator it = shard.index.find(key);
+    if (it != shard.index.end())
+    {
+      if (it->second->stamp == stamp)
+      {
+        document = it->second->document;
+        shard.unlink(it->second);
+        shard.link(it->second);
+        return;
+      }
+      shard.discard(it->second);
+    }
+    if (bytes > shard.budget)
+      return;
+
+    while (shard.pOldest && ((shard.bytes + bytes) > shard.budget))
+      shard.discard(shard.pOldest);
+
+    Entry *pEntry = new Entry();
+    pEntry->key = key;
+    pEntry->stamp = stamp;
+    pEntry->document = document;
+    pEntry->bytes = bytes;
+    shard.index[key] = pEntry;
+    shard.link(pEntry);
+    shard.bytes += bytes;
+  }
+
+  Shared_Value Document_Cache::parse(char const *data, size_t len
+    , bool comments_allowed) throw(Exception)
+  {
+    Incremental_Parser parser(comments_allowed);
+    parser.feed(data, len);
+    if (parser.finish() != Incremental_Parser::DONE)
+      throw Exception(*(parser.getErrorReport()));
+    std::auto_ptr<Value_Complex> pValue(parser.release());
+    return Shared_Value(*pValue);
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
@@ -0,0 +1,251 @@
+
+/*
+ * jaula_document_cache.h : JSON Analysis User Library Acronym
+ * Parsed documents cache definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_DOCUMENT_CACHE_H_
+#define _JAULA_DOCUMENT_CACHE_H_
+
+#include <string>
+
+#include <jaula/jaula_exception.h>
+#include <jaula/jaula_shared_value.h>
+
+/**
+ * \addtogroup jaula_parse JAULA: JSON data parser
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Cache of parsed documents
+   *
+   * \ingroup jaula_parse
+   *
+   * \par
+   * This class keeps the documents parsed from files and memory buffers so
+   * loading the same data again returns the tree already built instead of
+   * parsing it another time. Documents are handed out as Shared_Value
+   * handles, so a repeated load costs a lookup and a reference count
+   * increment and every caller sees the same immutable tree.
+   *
+   * \par
+   * Files are identified by their path and revalidated on every load
+   * against their modification time and size; a file that changed is parsed
+   * again and replaces the old entry. Buffers are identified by a hash of
+   * their contents and their length.
+   *
+   * \par
+   * Entries are spread over a number of shards, each one with its own lock,
+   * LRU list and share of the memory budget, so concurrent lookups only
+   * contend when they hit the same shard. Parsing is done without holding
+   * any lock. Memory is accounted from the actual size of the trees kept
+   * (see Shared_Value::footprint()) and the least recently used entries of
+   * a shard are evicted when it goes over its share. Documents bigger than
+   * a shard share are returned but not kept.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Document_Cache
+  {                              // class Document_Cache
+    public:
+
+      /**
+       * \brief Constructor
+       *
+       * \param budget Maximum number of bytes to keep.
+       *
+       * \param shards Number of independently locked partitions. Values
+       * below 1 are taken as 1.
+       */
+      Document_Cache(size_t budget, unsigned int shards = 16);
+
+      /**
+       * \brief Destructor
+       *
+       * \par Description
+       * Documents still referenced by handles outside the cache survive it.
+       */
+      ~Document_Cache();
+
+      /**
+       * \brief Loads a document from a file
+       *
+       * \param path Path of the file.
+       *
+       * \param comments_allowed flag to extend basic format and allow for
+       * hash symbol '#' starting comments in input.
+       *
+       * \returns a handle to the document.
+       *
+       * \exception Lexan_Error
+       * This exception is launched if the file cannot be read.
+       *
+       * \exception Exception
+       * Any error found parsing the file is reported with its own type.
+       */
+      Shared_Value loadFile(std::string const &path
+        , bool comments_allowed = false) throw(Exception);
+
+      /**
+       * \brief Loads a document from a memory buffer
+       *
+       * \param data Pointer to the buffer.
+       *
+       * \param len Number of bytes in the buffer.
+       *
+       * \param comments_allowed flag to extend basic format and allow for
+       * hash symbol '#' starting comments in input.
+       *
+       * \returns a handle to the document.
+       *
+       * \exception Exception
+       * Any error found parsing the buffer is reported with its own type.
+       *
+       * \note
+       * Buffers are matched by a 64 bit hash and their length, without
+       * comparing the contents.
+       */
+      Shared_Value loadBuffer(char const *data, size_t len
+        , bool comments_allowed = false) throw(Exception);
+
+      /**
+       * \brief Discards all the entries
+       */
+      void clear(void);
+
+      /**
+       * \brief Retrieves the memory budget
+       */
+      size_t getBudget(void) const;
+
+      /**
+       * \brief Retrieves the number of bytes currently accounted
+       */
+      size_t getBytes(void) const;
+
+      /**
+       * \brief Retrieves the number of documents currently kept
+       */
+      size_t getCount(void) const;
+
+      /**
+       * \brief Retrieves the number of loads served from the cache
+       */
+      unsigned long getHits(void) const;
+
+      /**
+       * \brief Retrieves the number of loads that required parsing
+       */
+      unsigned long getMisses(void) const;
+
+    private:
+
+      /**
+       * \brief Cached document
+       */
+      struct Entry;
+
+      /**
+       * \brief Independently locked partition
+       */
+      struct Shard;
+
+      /**
+       * \brief Copy Constructor
+       *
+       * \note
+       * Unimplemented to prevent copying caches.
+       */
+      Document_Cache(Document_Cache const &orig);
+
+      /**
+       * \brief Assignment operator
+       *
+       * \note
+       * Unimplemented to prevent copying caches.
+       */
+      Document_Cache &operator=(Document_Cache const &orig);
+
+      /**
+       * \brief Selects the shard for a key
+       */
+      Shard &shardFor(std::string const &key) const;
+
+      /**
+       * \brief Looks up an entry
+       *
+       * \param key Key of the entry.
+       *
+       * \param stamp Validation data the entry must match.
+       *
+       * \param document Handle that receives the document on a hit.
+       *
+       * \returns true if the entry exists and matches.
+       */
+      bool lookup(std::string const &key, std::string const &stamp
+        , Shared_Value &document) const;
+
+      /**
+       * \brief Stores an entry
+       *
+       * \param key Key of the entry.
+       *
+       * \param stamp Validation data for the entry.
+       *
+       * \param document Document to keep. If another thread stored an entry
+       * with the same key and stamp meanwhile it is replaced by that one.
+       */
+      void store(std::string const &key, std::string const &stamp
+        , Shared_Value &document);
+
+      /**
+       * \brief Parses a document
+       */
+      static Shared_Value parse(char const *data, size_t len
+        , bool comments_allowed) throw(Exception);
+
+      /**
+       * \brief Memory budget
+       */
+      size_t                      budget_;
+
+      /**
+       * \brief Number of shards
+       */
+      unsigned int                count_;
+
+      /**
+       * \brief Shards
+       */
+      Shard                       *shards_;
+  };                             // class Document_Cache
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
@@ -0,0 +1,275 @@
+
+/*
+ * jaula_fd_sink.cc : JSON Analysis User Library Acronym
+ * File descriptor output sink implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_ERRNO_H
+#include <errno.h>
+#endif
+
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#ifdef HAVE_SYS_UIO_H
+#include <sys/uio.h>
+#endif
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+}
+
+
+#ifdef HAVE_NEW
+#include <new>
+#endif
+
+#include <jaula/jaula_fd_sink.h>
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Fd_Sink::Fd_Sink(int fd, size_t capacity)
+    : Sink()
+    , fd_(fd)
+    , buffer_(0)
+    , capacity_(((capacity + DIRECT_ALIGNMENT - 1) / DIRECT_ALIGNMENT)
+      * DIRECT_ALIGNMENT)
+    , size_(0)
+    , gatherThreshold_(0)
+    , direct_(false)
+    , syncPolicy_(SYNC_NONE)
+    , error_(0)
+  {
+    if (!capacity_)
+      capacity_ = DIRECT_ALIGNMENT;
+    gatherThreshold_ = capacity_ / 4;
+#ifdef HAVE_POSIX_MEMALIGN
+    void  *p;
+    if (!posix_memalign(&p, DIRECT_ALIGNMENT, capacity_))
+      buffer_ = static_cast<char *>(p);
+#else
+    buffer_ = static_cast<char *>(malloc(capacity_));
+#endif
+    if (!buffer_)
+      throw std::bad_alloc();
+  }
+
+  Fd_Sink::~Fd_Sink()
+  {
+    sync();
+    free(buffer_);
+  }
+
+  void Fd_Sink::write(char const *data, size_t len)
+  {
+    if (!direct_ && (len >= gatherThreshold_))
+    {                            // gathering write
+      if (!size_)
+      {
+        writeAll(data, len);
+        return;
+      }
+
+      struct iovec  iov[2];
+      iov[0].iov_base = buffer_;
+      iov[0].iov_len = size_;
+      iov[1].iov_base = const_cast<char *>(data);
+      iov[1].iov_len = len;
+      ssize_t written = -1;
+      while (!error_)
+      {
+        written = writev(fd_, iov, 2);
+        if (written >= 0)
+          break;
+        if (errno != EINTR)
+          error_ = errno;
+      }
+      if (error_)
+      {
+        size_ = 0;
+        return;
+      }
+
+      size_t  done = static_cast<size_t>(written);
+      if (done < size_)
+      {
+        writeAll(buffer_ + done, size_ - done);
+        done = size_;
+      }
+      size_ = 0;
+      writeAll(data + (done - iov[0].iov_len), len - (done - iov[0].iov_len));
+      return;
+    }                            // gathering write
+
+    while (len)
+    {                            // buffered write
+      size_t  chunk = capacity_ - size_;
+      if (chunk > len)
+        chunk = len;
+      memcpy(buffer_ + size_, data, chunk);
+      size_ += chunk;
+      data += chunk;
+      len -= chunk;
+      if (size_ == capacity_)
+        drain(false);
+    }                            // buffered write
+  }
+
+  void Fd_Sink::flush(void)
+  {
+    drain(false);
+  }
+
+  void Fd_Sink::sync(void)
+  {
+    drain(true);
+    if (error_)
+      return;
+
+    int result = 0;
+    switch (syncPolicy_)
+    {
+      case SYNC_DATA :
+#ifdef HAVE_FDATASYNC
+        result = fdatasync(fd_);
+        break;
+#endif
+        // fsync() is used when fdatasync() is not available
+      case SYNC_ALL :
+        result = fsync(fd_);
+        break;
+
+      default :
+        break;
+    }
+    if (result)
+      error_ = errno;
+  }
+
+  bool Fd_Sink::setDirect(bool direct)
+  {
+#if defined(O_DIRECT) && defined(HAVE_POSIX_MEMALIGN)
+    int flags = fcntl(fd_, F_GETFL);
+    if (flags == -1)
+      return false;
+    flags = direct ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+    if (fcntl(fd_, F_SETFL, flags) == -1)
+      return false;
+    direct_ = direct;
+    return true;
+#else
+    return !direct;
+#endif
+  }
+
+  bool Fd_Sink::getDirect(void) const
+  {
+    return direct_;
+  }
+
+  void Fd_Sink::setSyncPolicy(Sync_Policy policy)
+  {
+    syncPolicy_ = policy;
+  }
+
+  Fd_Sink::Sync_Policy Fd_Sink::getSyncPolicy(void) const
+  {
+    return syncPolicy_;
+  }
+
+  void Fd_Sink::setGatherThreshold(size_t threshold)
+  {
+    gatherThreshold_ = threshold;
+  }
+
+  int Fd_Sink::getFd(void) const
+  {
+    return fd_;
+  }
+
+  int Fd_Sink::getError(void) const
+  {
+    return error_;
+  }
+
+  void Fd_Sink::drain(bool all)
+  {
+    if (!direct_)
+    {
+      writeAll(buffer_, size_);
+      size_ = 0;
+      return;
+    }
+
+    size_t  aligned = size_ - (size_ % DIRECT_ALIGNMENT);
+    writeAll(buffer_, aligned);
+    size_ -= aligned;
+    if (size_)
+    {
+      memmove(buffer_, buffer_ + aligned, size_);
+      if (all)
+      {                          // unaligned tail
+        setDirect(false);
+        writeAll(buffer_, size_);
+        size_ = 0;
+      }                          // unaligned tail
+    }
+  }
+
+  void Fd_Sink::writeAll(char const *data, size_t len)
+  {
+    while (len && !error_)
+    {
+      ssize_t written = ::write(fd_, data, len);
+      if (written >= 0)
+      {
+        data += written;
+        len -= written;
+      }
+      else if (errno != EINTR)
+        error_ = errno;
+    }
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
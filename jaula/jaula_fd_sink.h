@@ -0,0 +1,259 @@
+
+/*
+ * jaula_fd_sink.h : JSON Analysis User Library Acronym
+ * File descriptor output sink definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_FD_SINK_H_
+#define _JAULA_FD_SINK_H_
+
+#include <cstddef>
+
+#include <jaula/jaula_sink.h>
+
+/**
+ * \addtogroup jaula_out JAULA: JSON data output
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Output sink for file descriptors
+   *
+   * \ingroup jaula_out
+   *
+   * \par
+   * This class sends data to a raw file descriptor through a large buffer,
+   * avoiding the standard C++ streams overhead. Large blocks received
+   * while other data is pending are sent together with it in a single
+   * gathering write, without copying them into the buffer.
+   *
+   * \par
+   * For durable exports the descriptor may be switched to direct I/O
+   * (O_DIRECT), which bypasses the system page cache, and sync() may be
+   * asked to synchronize the data with the storage device. The writers
+   * flush the sink after every document, which stays cheap: flush() only
+   * hands data to the operating system, while sync() ends the export.
+   *
+   * \par
+   * Write errors do not raise exceptions, as happens with standard
+   * streams: the first error is recorded (see getError()) and any further
+   * data is discarded.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Fd_Sink : public Sink
+  {                              // class Fd_Sink
+    public:
+
+      /**
+       * \brief Synchronization to perform on sync()
+       */
+      enum    Sync_Policy
+      {                          // enum Sync_Policy
+        /** Data is just handed to the operating system */
+        SYNC_NONE
+        /** Data is written to the storage device (fdatasync) */
+        ,   SYNC_DATA
+        /** Data and metadata are written to the storage device (fsync) */
+        ,   SYNC_ALL
+      };                         // enum Sync_Policy
+
+      /**
+       * \brief Alignment required for direct I/O
+       */
+      enum    { DIRECT_ALIGNMENT = 4096 };
+
+      /**
+       * \brief Constructor
+       *
+       * \param fd File descriptor where data is to be written. It is not
+       * closed by the sink.
+       *
+       * \param capacity Buffer size (rounded up to a multiple of
+       * DIRECT_ALIGNMENT).
+       */
+      Fd_Sink(int fd, size_t capacity = 1048576);
+
+      /**
+       * \brief Destructor
+       *
+       * \note
+       * Pending data is written and synchronized (see sync()).
+       */
+      virtual ~Fd_Sink();
+
+      /**
+       * \brief Sends data to the sink
+       *
+       * \param data Pointer to the data to send.
+       *
+       * \param len Number of bytes to send.
+       */
+      virtual void write(char const *data, size_t len);
+
+      /**
+       * \brief Writes the pending data
+       *
+       * \par Description
+       * No synchronization is performed. Under direct I/O only whole blocks
+       * are written, and the last block not fully filled is kept for the
+       * next data, so direct I/O stays enabled.
+       */
+      virtual void flush(void);
+
+      /**
+       * \brief Writes all the pending data and synchronizes it
+       *
+       * \par Description
+       * Ends an export: under direct I/O the final block of data is usually
+       * not aligned, so direct I/O is disabled for writing it. Then the
+       * synchronization established by setSyncPolicy() is performed.
+       */
+      void sync(void);
+
+      /**
+       * \brief Enables or disables direct I/O
+       *
+       * \param direct flag for direct I/O.
+       *
+       * \returns true if the mode could be established.
+       *
+       * \par Description
+       * Direct I/O should be enabled before any data is written, as the
+       * file offset must also be aligned. It is not available on every
+       * system or file system.
+       */
+      bool setDirect(bool direct);
+
+      /**
+       * \brief Retrieves if direct I/O is enabled
+       */
+      bool getDirect(void) const;
+
+      /**
+       * \brief Establishes the synchronization to perform on sync()
+       */
+      void setSyncPolicy(Sync_Policy policy);
+
+      /**
+       * \brief Retrieves the synchronization performed on sync()
+       */
+      Sync_Policy getSyncPolicy(void) const;
+
+      /**
+       * \brief Establishes the size from which blocks are sent without
+       * copying them into the buffer
+       *
+       * \param threshold Size in bytes (by default, a quarter of the buffer
+       * capacity). This is not done under direct I/O.
+       */
+      void setGatherThreshold(size_t threshold);
+
+      /**
+       * \brief Retrieves the file descriptor
+       */
+      int getFd(void) const;
+
+      /**
+       * \brief Retrieves the first write error
+       *
+       * \returns the errno value of the first failed operation or 0 if
+       * everything has gone well.
+       */
+      int getError(void) const;
+
+    private:
+
+      /**
+       * \brief Copy constructor (not available)
+       */
+      Fd_Sink(Fd_Sink const &orig);
+
+      /**
+       * \brief Assignment operator (not available)
+       */
+      Fd_Sink &operator=(Fd_Sink const &orig);
+
+      /**
+       * \brief Writes the buffer contents
+       *
+       * \param all flag to write everything. Otherwise, under direct I/O,
+       * the last block not fully filled is kept in the buffer.
+       */
+      void drain(bool all);
+
+      /**
+       * \brief Writes a block of data handling partial writes
+       */
+      void writeAll(char const *data, size_t len);
+
+      /**
+       * \brief File descriptor
+       */
+      int   fd_;
+
+      /**
+       * \brief Buffer (aligned for direct I/O)
+       */
+      char  *buffer_;
+
+      /**
+       * \brief Buffer size
+       */
+      size_t  capacity_;
+
+      /**
+       * \brief Bytes pending in the buffer
+       */
+      size_t  size_;
+
+      /**
+       * \brief Size from which blocks are not copied into the buffer
+       */
+      size_t  gatherThreshold_;
+
+      /**
+       * \brief Flag for direct I/O enabled
+       */
+      bool  direct_;
+
+      /**
+       * \brief Synchronization on sync()
+       */
+      Sync_Policy   syncPolicy_;
+
+      /**
+       * \brief First error detected
+       */
+      int   error_;
+
+  };                             // class Fd_Sink
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
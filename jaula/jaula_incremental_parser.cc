@@ -0,0 +1,1001 @@
+
+/*
+ * jaula_incremental_parser.cc : JSON Analysis User Library Acronym
+ * Push based incremental parser definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_CTYPE_H
+#include <ctype.h>
+#endif
+
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+}
+
+
+#ifdef HAVE_SSTREAM
+#include <sstream>
+#endif
+
+#include <jaula/jaula_incremental_parser.h>
+#include <jaula/jaula_lexan_error.h>
+#include <jaula/jaula_number_format.h>
+#include <jaula/jaula_string_escape.h>
+#include <jaula/jaula_syntax_error.h>
+
+namespace
+{                                // anonymous namespace
+
+  /**
+   * \brief Length of the UTF-8 sequence starting with a byte
+   *
+   * \returns 0 if the byte cannot start a multibyte sequence.
+   */
+  size_t utf8Length(char lead)
+  {
+    unsigned char c = static_cast<unsigned char>(lead);
+    if ((c >= 0xc2) && (c < 0xe0))
+      return 2;
+    if ((c >= 0xe0) && (c < 0xf0))
+      return 3;
+    if ((c >= 0xf0) && (c < 0xf5))
+      return 4;
+    return 0;
+  }
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Incremental_Parser::Incremental_Parser(bool comments_allowed
+    , bool full_read
+    , bool keep_input
+    , bool validate_utf8
+    , bool keep_big_numbers
+    , bool lazy_numbers)
+    : builder_()
+    , handler_(builder_)
+    , commented_(comments_allowed)
+    , fullRead_(full_read)
+    , keepInput_(keep_input)
+    , status_(NEED_MORE)
+    , scan_(scan_space)
+    , state_(START)
+    , stack_()
+    , tokenData_()
+    , literal_(0)
+    , literalPos_(0)
+    , literalToken_(0)
+    , unicode_(0)
+    , unicodeDigits_(0)
+    , surrogate_(0)
+    , validateUTF8_(validate_utf8)
+    , utf8_()
+    , utf8Length_(0)
+    , keepBigNumbers_(keep_big_numbers)
+    , lazyNumbers_(lazy_numbers)
+    , offset_(0)
+    , consumed_(0)
+    , tokenOffset_(0)
+    , line_(1)
+    , lineStart_(0)
+    , input_()
+    , result_()
+    , pErrorReport_(0)
+    {}
+
+  Incremental_Parser::Incremental_Parser(Parse_Handler &handler
+    , bool comments_allowed
+    , bool full_read
+    , bool keep_input
+    , bool validate_utf8
+    , bool keep_big_numbers
+    , bool lazy_numbers)
+    : builder_()
+    , handler_(handler)
+    , commented_(comments_allowed)
+    , fullRead_(full_read)
+    , keepInput_(keep_input)
+    , status_(NEED_MORE)
+    , scan_(scan_space)
+    , state_(START)
+    , stack_()
+    , tokenData_()
+    , literal_(0)
+    , literalPos_(0)
+    , literalToken_(0)
+    , unicode_(0)
+    , unicodeDigits_(0)
+    , surrogate_(0)
+    , validateUTF8_(validate_utf8)
+    , utf8_()
+    , utf8Length_(0)
+    , keepBigNumbers_(keep_big_numbers)
+    , lazyNumbers_(lazy_numbers)
+    , offset_(0)
+    , consumed_(0)
+    , tokenOffset_(0)
+    , line_(1)
+    , lineStart_(0)
+    , input_()
+    , result_()
+    , pErrorReport_(0)
+    {}
+
+  Incremental_Parser::~Incremental_Parser()
+  {
+    if (pErrorReport_)
+      delete pErrorReport_;
+  }
+
+  Incremental_Parser::Status Incremental_Parser::feed(char const *data
+    , size_t len)
+  {
+    consumed_ = 0;
+    if (status_ == ERROR)
+      return status_;
+
+    char const  *p = data;
+    char const  *end = data + len;
+    while ((p != end) && (status_ != ERROR))
+    {                            // chunk loop
+      if ((state_ == END) && (!fullRead_))
+        break;
+
+      switch (scan_)
+      {                          // scan state switch
+
+        case scan_space :
+        {
+          char  c = *p;
+          tokenOffset_ = offset_ + (p - data);
+          switch (c)
+          {                      // token start switch
+            case ' ' :
+            case '\f' :
+            case '\r' :
+            case '\t' :
+              p++;
+              break;
+
+            case '\n' :
+              line_++;
+              p++;
+              lineStart_ = offset_ + (p - data);
+              break;
+
+            case '[' :
+            case ']' :
+            case '{' :
+            case '}' :
+            case ':' :
+            case ',' :
+              p++;
+              token(c);
+              break;
+
+            case '"' :
+              p++;
+              tokenData_.erase();
+              scan_ = scan_string;
+              break;
+
+            case 'n' :
+              literal_ = "null";
+              literalToken_ = NULL_TOKEN;
+              literalPos_ = 0;
+              scan_ = scan_literal;
+              break;
+
+            case 'f' :
+              literal_ = "false";
+              literalToken_ = FALSE_TOKEN;
+              literalPos_ = 0;
+              scan_ = scan_literal;
+              break;
+
+            case 't' :
+              literal_ = "true";
+              literalToken_ = TRUE_TOKEN;
+              literalPos_ = 0;
+              scan_ = scan_literal;
+              break;
+
+            case '+' :
+            case '-' :
+            case '0' :
+            case '1' :
+            case '2' :
+            case '3' :
+            case '4' :
+            case '5' :
+            case '6' :
+            case '7' :
+            case '8' :
+            case '9' :
+              tokenData_.erase();
+              scan_ = scan_number;
+              break;
+
+            case '#' :
+              if (commented_)
+              {
+                p++;
+                scan_ = scan_comment;
+              }
+              else
+                error(Parse_Result::COMMENT_NOT_ALLOWED, tokenOffset_, c);
+              break;
+
+            default :
+              error(Parse_Result::UNEXPECTED_CHARACTER, tokenOffset_, c);
+              break;
+
+          }                      // token start switch
+        }
+        break;
+
+        case scan_comment :
+        {
+          char const *eol =
+            static_cast<char const *>(memchr(p, '\n', end - p));
+          if (eol)
+          {
+            line_++;
+            p = eol + 1;
+            lineStart_ = offset_ + (p - data);
+            scan_ = scan_space;
+          }
+          else
+            p = end;
+        }
+        break;
+
+        case scan_string :
+        {
+          char const  *run = p;
+          for (;;)
+          {                      // raw contents loop
+            p += String_Escape::stringRun(p, end - p, validateUTF8_);
+            if ((p == end) || (!(*p & 0x80)))
+              break;
+            size_t  seq = String_Escape::validUTF8(p, end - p);
+            if (seq)
+            {
+              p += seq;
+              continue;
+            }
+            utf8Length_ = utf8Length(*p);
+            if ((!utf8Length_) || (utf8Length_ <= static_cast<size_t>(end - p)))
+            {
+              error(Parse_Result::INVALID_UTF8, offset_ + (p - data), *p);
+              break;
+            }
+            tokenData_.append(run, p - run);
+            utf8_.assign(p, end - p);
+            run = p = end;
+            scan_ = scan_utf8;
+            break;
+          }                      // raw contents loop
+          if (status_ == ERROR)
+            break;
+          tokenData_.append(run, p - run);
+          if ((p == end) || (scan_ != scan_string))
+            break;
+
+          if (*p == '"')
+          {
+            p++;
+            scan_ = scan_space;
+            token(STRING_TOKEN);
+          }
+          else if (*p == '\\')
+          {
+            p++;
+            scan_ = scan_escape;
+          }
+          else
+            error(Parse_Result::NEWLINE_IN_STRING, offset_ + (p - data)
+              , *p);
+        }
+        break;
+
+        case scan_escape :
+          if (surrogate_ && (*p != 'u'))
+          {
+            error(Parse_Result::INVALID_SURROGATE, offset_ + (p - data), *p);
+            break;
+          }
+          switch (*p)
+          {                      // escape switch
+            case '"' :
+            case '\\' :
+            case '/' :
+              tokenData_ += *p;
+              scan_ = scan_string;
+              break;
+
+            case 'b' :
+              tokenData_ += '\b';
+              scan_ = scan_string;
+              break;
+
+            case 'f' :
+              tokenData_ += '\f';
+              scan_ = scan_string;
+              break;
+
+            case 'n' :
+              tokenData_ += '\n';
+              scan_ = scan_string;
+              break;
+
+            case 'r' :
+              tokenData_ += '\r';
+              scan_ = scan_string;
+              break;
+
+            case 't' :
+              tokenData_ += '\t';
+              scan_ = scan_string;
+              break;
+
+            case 'u' :
+            {
+              size_t  run = surrogate_ ? 0
+                : String_Escape::unescapeUnicode(p, end - p, tokenData_);
+              if (run)
+              {
+                p += run - 1;
+                scan_ = scan_string;
+              }
+              else
+              {
+                unicode_ = 0;
+                unicodeDigits_ = 0;
+                scan_ = scan_unicode;
+              }
+            }
+            break;
+
+            default :
+              error(Parse_Result::INVALID_ESCAPE, offset_ + (p - data), *p);
+              break;
+
+          }                      // escape switch
+          if (status_ != ERROR)
+            p++;
+          break;
+
+        case scan_unicode :
+          if (!isxdigit(static_cast<unsigned char>(*p)))
+          {
+            error(Parse_Result::INVALID_ESCAPE, offset_ + (p - data), 'u');
+            break;
+          }
+          unicode_ = (unicode_ << 4)
+            | ((*p <= '9') ? (*p - '0') : ((*p | 0x20) - 'a' + 10));
+          p++;
+          if (++unicodeDigits_ == 4)
+            unicodeChar(offset_ + (p - data) - 1);
+          break;
+
+        case scan_pair :
+          if (*p != '\\')
+          {
+            error(Parse_Result::INVALID_SURROGATE, offset_ + (p - data), *p);
+            break;
+          }
+          p++;
+          scan_ = scan_escape;
+          break;
+
+        case scan_utf8 :
+          utf8_ += *p;
+          if (utf8_.size() == utf8Length_)
+          {
+            if (!String_Escape::validUTF8(utf8_.data(), utf8_.size()))
+            {
+              error(Parse_Result::INVALID_UTF8
+                , offset_ + (p - data) + 1 - utf8Length_, utf8_[0]);
+              break;
+            }
+            tokenData_ += utf8_;
+            scan_ = scan_string;
+          }
+          p++;
+          break;
+
+        case scan_number :
+        {
+          char const  *run = p;
+          while ((p != end)
+            && (isdigit(static_cast<unsigned char>(*p))
+            || (*p == '.') || (*p == 'e') || (*p == 'E')
+            || (*p == '+') || (*p == '-')))
+            p++;
+          tokenData_.append(run, p - run);
+          if (p != end)
+          {
+            scan_ = scan_space;
+            number();
+          }
+        }
+        break;
+
+        case scan_literal :
+          if (*p != literal_[literalPos_])
+          {
+            error(Parse_Result::UNEXPECTED_CHARACTER, tokenOffset_
+              , literal_[0]);
+            break;
+          }
+          p++;
+          if (!literal_[++literalPos_])
+          {
+            scan_ = scan_space;
+            token(literalToken_);
+          }
+          break;
+
+      }                          // scan state switch
+    }                            // chunk loop
+
+    consumed_ = p - data;
+    if (keepInput_)
+      input_.append(data, consumed_);
+    offset_ += consumed_;
+    return status_;
+  }
+
+  Incremental_Parser::Status Incremental_Parser::finish(void)
+  {
+    if (status_ == ERROR)
+      return status_;
+
+    switch (scan_)
+    {                            // pending token switch
+      case scan_space :
+        break;
+
+      case scan_comment :
+        error(Parse_Result::UNTERMINATED_COMMENT, offset_);
+        break;
+
+      case scan_string :
+      case scan_pair :
+      case scan_utf8 :
+        error(Parse_Result::UNTERMINATED_STRING, offset_);
+        break;
+
+      case scan_escape :
+      case scan_unicode :
+        error(Parse_Result::UNTERMINATED_ESCAPE, offset_);
+        break;
+
+      case scan_number :
+        scan_ = scan_space;
+        number();
+        break;
+
+      case scan_literal :
+        error(Parse_Result::UNEXPECTED_CHARACTER, tokenOffset_, literal_[0]);
+        break;
+
+    }                            // pending token switch
+    if (status_ == ERROR)
+      return status_;
+
+    switch (stack_.empty() ? state_
+      : static_cast<parser_states>(stack_.back()))
+    {                            // EOF state switch
+      case END :
+        return status_;
+
+      case START :
+        error(Parse_Result::UNEXPECTED_EOF, offset_, 0, "a value");
+        break;
+
+      case array_addItem :
+        error(Parse_Result::UNEXPECTED_EOF, offset_, 0
+          , "a value or a closing array symbol");
+        break;
+
+      case array_nextItem :
+        error(Parse_Result::UNEXPECTED_EOF, offset_, 0
+          , "an item delimiter or a closing array symbol");
+        break;
+
+      case property_begin :
+        error(Parse_Result::UNEXPECTED_EOF, offset_, 0
+          , "a property name or a closing object symbol");
+        break;
+
+      case property_name :
+        error(Parse_Result::UNEXPECTED_EOF, offset_, 0
+          , "a property name delimiter symbol");
+        break;
+
+      case property_value :
+        error(Parse_Result::UNEXPECTED_EOF, offset_, 0
+          , "a value for an object property");
+        break;
+
+      case property_next :
+        error(Parse_Result::UNEXPECTED_EOF, offset_, 0
+          , "an item delimiter or a closing object symbol");
+        break;
+
+    }                            // EOF state switch
+    return status_;
+  }
+
+  Incremental_Parser::Status Incremental_Parser::getStatus(void) const
+  {
+    return status_;
+  }
+
+  size_t Incremental_Parser::getConsumed(void) const
+  {
+    return consumed_;
+  }
+
+  size_t Incremental_Parser::getOffset(void) const
+  {
+    return offset_;
+  }
+
+  size_t Incremental_Parser::getTokenOffset(void) const
+  {
+    return tokenOffset_;
+  }
+
+  std::string const &Incremental_Parser::getInput(void) const
+  {
+    return input_;
+  }
+
+  Exception const *Incremental_Parser::getErrorReport(void) const
+  {
+    if ((status_ == ERROR) && !pErrorReport_)
+    {
+      std::ostringstream  errAct;
+      errAct << "analyzing line "
+        << result_.getLine()
+        << ", column "
+        << result_.getColumn()
+        << " from input stream.";
+      if (result_.isLexical())
+        pErrorReport_ = new Lexan_Error(result_.getMessage(), errAct.str());
+      else
+        pErrorReport_ = new Syntax_Error(result_.getMessage(), errAct.str());
+      pErrorReport_->addOrigin("Incremental_Parser::feed(char const *"
+        ", size_t)");
+    }
+    return pErrorReport_;
+  }
+
+  Parse_Result const &Incremental_Parser::getResult(void) const
+  {
+    return result_;
+  }
+
+  Value_Complex *Incremental_Parser::release(void)
+  {
+    if ((status_ != DONE) || (&handler_ != &builder_))
+      return 0;
+    return static_cast<Value_Complex *>(builder_.release());
+  }
+
+  void Incremental_Parser::reset(void)
+  {
+    builder_.reset();
+    status_ = NEED_MORE;
+    scan_ = scan_space;
+    state_ = START;
+    stack_.clear();
+    tokenData_.erase();
+    literal_ = 0;
+    literalPos_ = 0;
+    surrogate_ = 0;
+    utf8_.erase();
+    offset_ = 0;
+    consumed_ = 0;
+    tokenOffset_ = 0;
+    line_ = 1;
+    lineStart_ = 0;
+    input_.erase();
+    result_.clear();
+    if (pErrorReport_)
+      delete pErrorReport_;
+    pErrorReport_ = 0;
+  }
+
+  bool Incremental_Parser::token(int token)
+  {
+    if (stack_.empty())
+    {                            // first level
+      if (state_ == END)
+      {
+        error(Parse_Result::EXTRA_VALUE, tokenOffset_);
+        return false;
+      }
+      if ((token != '[') && (token != '{'))
+      {
+        syntaxError(token, "the beginning of an array or object");
+        return false;
+      }
+      return value(token);
+    }                            // first level
+
+    unsigned char &state = stack_.back();
+    switch (state)
+    {                            // container state switch
+      case array_addItem :
+        if (token == ']')
+          return close(token);
+        state = array_nextItem;
+        if (!value(token))
+        {
+          if (status_ != ERROR)
+            syntaxError(token, "a value or the end of an array");
+          return false;
+        }
+        return true;
+
+      case array_nextItem :
+        if (token == ']')
+          return close(token);
+        if (token == ',')
+        {
+          state = array_addItem;
+          return true;
+        }
+        syntaxError(token, "an item delimiter or the end of an array");
+        return false;
+
+      case property_begin :
+        if (token == '}')
+          return close(token);
+        if (token == STRING_TOKEN)
+        {
+          state = property_name;
+          if (!handler_.propertyName(tokenData_))
+          {
+            handlerError();
+            return false;
+          }
+          return true;
+        }
+        syntaxError(token, "a property name or the end of an object");
+        return false;
+
+      case property_name :
+        if (token == ':')
+        {
+          state = property_value;
+          return true;
+        }
+        syntaxError(token, "property name delimiter");
+        return false;
+
+      case property_value :
+        state = property_next;
+        if (!value(token))
+        {
+          if (status_ != ERROR)
+            syntaxError(token, "a value for an object property");
+          return false;
+        }
+        return true;
+
+      case property_next :
+        if (token == '}')
+          return close(token);
+        if (token == ',')
+        {
+          state = property_begin;
+          return true;
+        }
+        syntaxError(token, "an item delimiter or the end of an object");
+        return false;
+
+    }                            // container state switch
+
+    error(Parse_Result::INTERNAL_ERROR, tokenOffset_);
+    return false;
+  }
+
+  bool Incremental_Parser::value(int token)
+  {
+    bool  accepted;
+    switch (token)
+    {                            // value switch
+      case '[' :
+        stack_.push_back(array_addItem);
+        accepted = handler_.arrayBegin();
+        break;
+
+      case '{' :
+        stack_.push_back(property_begin);
+        accepted = handler_.objectBegin();
+        break;
+
+      case NULL_TOKEN :
+        accepted = handler_.nullValue();
+        break;
+
+      case FALSE_TOKEN :
+        accepted = handler_.booleanValue(false);
+        break;
+
+      case TRUE_TOKEN :
+        accepted = handler_.booleanValue(true);
+        break;
+
+      case NUMBER_TOKEN :
+        accepted = lazyNumbers_
+          ? handler_.numberTextValue(tokenData_)
+          : handler_.numberValue(strtod(tokenData_.c_str(), 0));
+        break;
+
+      case NUMBER_INT_TOKEN :
+      {
+        if (lazyNumbers_)
+        {
+          accepted = handler_.numberTextValue(tokenData_);
+          break;
+        }
+        int64_t   val = 0;
+        uint64_t  uval = 0;
+        switch (Number_Format::scanInt(tokenData_.data(), tokenData_.size()
+          , val, uval))
+        {
+          case Number_Format::INT_SIGNED :
+            accepted = handler_.numberIntValue(val);
+            break;
+
+          case Number_Format::INT_UNSIGNED :
+            accepted = handler_.numberUnsignedValue(uval);
+            break;
+
+          default :
+            accepted = keepBigNumbers_
+              ? handler_.numberTextValue(tokenData_)
+              : handler_.numberValue(strtod(tokenData_.c_str(), 0));
+            break;
+        }
+        break;
+      }
+
+      case STRING_TOKEN :
+        accepted = handler_.stringValue(tokenData_);
+        break;
+
+      default :
+        return false;
+
+    }                            // value switch
+
+    if (!accepted)
+    {
+      handlerError();
+      return false;
+    }
+    if (stack_.empty())
+    {
+      state_ = END;
+      status_ = DONE;
+    }
+    return true;
+  }
+
+  bool Incremental_Parser::close(int token)
+  {
+    stack_.pop_back();
+    if (!((token == ']') ? handler_.arrayEnd() : handler_.objectEnd()))
+    {
+      handlerError();
+      return false;
+    }
+    if (stack_.empty())
+    {
+      state_ = END;
+      status_ = DONE;
+    }
+    return true;
+  }
+
+  bool Incremental_Parser::number(void)
+  {
+    // [+-]?{DIGIT}+(\.{DIGIT}+)?([eE][+-]?{DIGIT}+)?
+    std::string::size_type  i = 0;
+    std::string::size_type  len = tokenData_.size();
+    bool  isInt = true;
+    if ((i < len) && ((tokenData_[i] == '+') || (tokenData_[i] == '-')))
+      i++;
+    std::string::size_type  digits = i;
+    while ((i < len) && isdigit(static_cast<unsigned char>(tokenData_[i])))
+      i++;
+    bool  valid = (i != digits);
+    if (valid && (i < len) && (tokenData_[i] == '.'))
+    {
+      isInt = false;
+      digits = ++i;
+      while ((i < len) && isdigit(static_cast<unsigned char>(tokenData_[i])))
+        i++;
+      valid = (i != digits);
+    }
+    if (valid && (i < len) && ((tokenData_[i] == 'e') || (tokenData_[i] == 'E')))
+    {
+      isInt = false;
+      i++;
+      if ((i < len) && ((tokenData_[i] == '+') || (tokenData_[i] == '-')))
+        i++;
+      digits = i;
+      while ((i < len) && isdigit(static_cast<unsigned char>(tokenData_[i])))
+        i++;
+      valid = (i != digits);
+    }
+    if ((!valid) || (i != len))
+    {
+      error(Parse_Result::INVALID_NUMBER, tokenOffset_);
+      result_.text_ = tokenData_;
+      return false;
+    }
+    return token(isInt ? NUMBER_INT_TOKEN : NUMBER_TOKEN);
+  }
+
+  void Incremental_Parser::syntaxError(int token, char const *expected)
+  {
+    error(Parse_Result::UNEXPECTED_TOKEN, tokenOffset_
+      , static_cast<char>(token), expected);
+    switch (token)
+    {                            // token description switch
+      case NULL_TOKEN :
+        result_.symbol_ = "null";
+        break;
+
+      case FALSE_TOKEN :
+        result_.symbol_ = "false";
+        break;
+
+      case TRUE_TOKEN :
+        result_.symbol_ = "true";
+        break;
+
+      case NUMBER_TOKEN :
+      case NUMBER_INT_TOKEN :
+        result_.text_ = tokenData_;
+        break;
+
+      case STRING_TOKEN :
+        result_.text_ = tokenData_;
+        result_.quoted_ = true;
+        break;
+
+      default :
+        break;
+
+    }                            // token description switch
+  }
+
+  void Incremental_Parser::error(Parse_Result::Error_Code code
+    , size_t offset, char character, char const *expected)
+  {
+    result_.clear();
+    result_.code_ = code;
+    result_.offset_ = offset;
+    result_.line_ = line_;
+    result_.column_ = offset - lineStart_ + 1;
+    result_.character_ = character;
+    result_.expected_ = expected;
+    if (pErrorReport_)
+      delete pErrorReport_;
+    pErrorReport_ = 0;
+    status_ = ERROR;
+  }
+
+  void Incremental_Parser::handlerError(void)
+  {
+    error(handler_.getErrorCode(), tokenOffset_);
+    if (handler_.getErrorReport())
+    {
+      pErrorReport_ = new Exception(*(handler_.getErrorReport()));
+      pErrorReport_->addOrigin("Incremental_Parser::feed(char const *"
+        ", size_t)");
+      result_.text_ = pErrorReport_->getDetail();
+    }
+  }
+
+  void Incremental_Parser::unicodeChar(size_t offset)
+  {
+    bool const  high = (unicode_ >= 0xd800) && (unicode_ <= 0xdbff);
+    bool const  low = (unicode_ >= 0xdc00) && (unicode_ <= 0xdfff);
+    if (surrogate_)
+    {
+      if (!low)
+      {
+        error(Parse_Result::INVALID_SURROGATE, offset, 'u');
+        return;
+      }
+      String_Escape::appendUTF8(tokenData_
+        , 0x10000 + ((surrogate_ - 0xd800) << 10) + (unicode_ - 0xdc00));
+      surrogate_ = 0;
+      scan_ = scan_string;
+    }
+    else if (high)
+    {
+      surrogate_ = unicode_;
+      scan_ = scan_pair;
+    }
+    else if (low)
+      error(Parse_Result::INVALID_SURROGATE, offset, 'u');
+    else
+    {
+      String_Escape::appendUTF8(tokenData_, unicode_);
+      scan_ = scan_string;
+    }
+  }
+
+  Value_Complex *Incremental_Parser::parseBuffer(char const *data
+    , size_t len, Parse_Result &result, bool comments_allowed
+    , bool validate_utf8, bool keep_big_numbers, bool lazy_numbers)
+  {
+    Incremental_Parser parser(comments_allowed, true, false, validate_utf8
+      , keep_big_numbers, lazy_numbers);
+    parser.feed(data, len);
+    parser.finish();
+    result = parser.result_;
+    return parser.release();
+  }
+
+  bool Incremental_Parser::parseBuffer(char const *data, size_t len
+    , Parse_Handler &handler, Parse_Result &result, bool comments_allowed
+    , bool validate_utf8, bool keep_big_numbers, bool lazy_numbers)
+  {
+    Incremental_Parser parser(handler, comments_allowed, true, false
+      , validate_utf8, keep_big_numbers, lazy_numbers);
+    parser.feed(data, len);
+    parser.finish();
+    result = parser.result_;
+    return !result.failed();
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
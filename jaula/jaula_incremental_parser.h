@@ -0,0 +1,627 @@
+
+/*
+ * jaula_incremental_parser.h : JSON Analysis User Library Acronym
+ * Push based incremental parser definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_INCREMENTAL_PARSER_H_
+#define _JAULA_INCREMENTAL_PARSER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <jaula/jaula_exception.h>
+#include <jaula/jaula_parse_handler.h>
+#include <jaula/jaula_parse_result.h>
+#include <jaula/jaula_value_builder.h>
+#include <jaula/jaula_value_complex.h>
+
+/**
+ * \addtogroup jaula_parse JAULA: JSON data parser
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Push based JSON Data Parser
+   *
+   * \ingroup jaula_parse
+   *
+   * \par
+   * This class implements a JSON parser that receives its input in chunks of
+   * any size as they become available, instead of pulling it from a stream.
+   * It never blocks waiting for data: whenever a chunk is exhausted the
+   * parser keeps its state (including any token left half way) and waits for
+   * the next one.
+   *
+   * \par
+   * The language accepted is the same one accepted by Parser::parseStream().
+   * Unicode escape sequences are decoded as UTF-8, combining surrogate pairs.
+   * Optionally, raw string contents can be checked to be valid UTF-8 while
+   * they are scanned, so no separate validation pass is required.
+   *
+   * \par
+   * Values are reported to a Parse_Handler as soon as they are read. If no
+   * handler is specified, an internal Value_Builder is used and the value
+   * read can be retrieved by means of release().
+   *
+   * \par
+   * Errors never leave the parser as exceptions. They are recorded as a
+   * Parse_Result (see getResult()) and the Exception returned by
+   * getErrorReport() is only built if it is requested.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Incremental_Parser
+  {                              // class Incremental_Parser
+    public:
+
+      /**
+       * \brief Enumeration of parsing process status
+       */
+      enum    Status
+      {                          // enum Status
+        /** More data is required to complete the first level value */
+        NEED_MORE
+        /** A whole first level value has been read */
+        ,   DONE
+        /** An error has been detected (see getErrorReport()) */
+        ,   ERROR
+      };                         // enum Status
+
+      /**
+       * \brief Constructor
+       *
+       * \param comments_allowed flag to extend basic format and allow for
+       * hash symbol '#' starting comments in input.
+       *
+       * \param full_read flag that if it is true means that any data after
+       * the first level value that is not a space (or a comment if comments
+       * are allowed) is an error. If it is false, the parser stops consuming
+       * data as soon as the first level value is complete (see
+       * getConsumed()).
+       *
+       * \param keep_input flag that if it is true makes the parser keep a
+       * copy of all the data consumed (see getInput()). Otherwise no data is
+       * kept but for the token being read.
+       *
+       * \param validate_utf8 flag to reject strings whose contents are not
+       * valid UTF-8.
+       *
+       * \param keep_big_numbers flag to report integers that fit no native
+       * type by their decimal text (see Parse_Handler::numberTextValue()).
+       * Otherwise they are converted to the nearest double.
+       *
+       * \param lazy_numbers flag to report every number by its decimal text
+       * so it is only converted if it is ever retrieved and written back
+       * as read otherwise (implies keep_big_numbers).
+       *
+       * \par Description
+       * Creates a parser that builds the values read.
+       */
+      Incremental_Parser(bool comments_allowed = false
+        , bool full_read = true
+        , bool keep_input = false
+        , bool validate_utf8 = false
+        , bool keep_big_numbers = false
+        , bool lazy_numbers = false);
+
+      /**
+       * \brief Constructor
+       *
+       * \param handler Reference to the instance that will receive the
+       * parsing events. It must exist during all the parser life cycle.
+       *
+       * \param comments_allowed flag to extend basic format and allow for
+       * hash symbol '#' starting comments in input.
+       *
+       * \param full_read flag to force checking that no data follows the
+       * first level value (see above).
+       *
+       * \param keep_input flag to keep a copy of all the data consumed.
+       *
+       * \param validate_utf8 flag to reject strings whose contents are not
+       * valid UTF-8.
+       *
+       * \param keep_big_numbers flag to report integers that fit no native
+       * type by their decimal text (see Parse_Handler::numberTextValue()).
+       * Otherwise they are converted to the nearest double.
+       *
+       * \param lazy_numbers flag to report every number by its decimal text
+       * so it is only converted if it is ever retrieved and written back
+       * as read otherwise (implies keep_big_numbers).
+       *
+       * \par Description
+       * Creates a parser that reports the values read to a handler.
+       */
+      Incremental_Parser(Parse_Handler &handler
+        , bool comments_allowed = false
+        , bool full_read = true
+        , bool keep_input = false
+        , bool validate_utf8 = false
+        , bool keep_big_numbers = false
+        , bool lazy_numbers = false);
+
+      /**
+       * \brief Destructor
+       */
+      ~Incremental_Parser();
+
+      /**
+       * \brief Analyzes a new chunk of data
+       *
+       * \param data Pointer to the chunk.
+       *
+       * \param len Number of bytes in the chunk.
+       *
+       * \returns the status of the parsing process after analyzing the
+       * chunk.
+       *
+       * \par Description
+       * Analyzes the data received continuing from the point where the
+       * previous chunk ended. The chunk is not referenced once this method
+       * returns.
+       */
+      Status feed(char const *data, size_t len);
+
+      /**
+       * \brief Signals the end of the input
+       *
+       * \returns DONE if the data received holds a whole first level value
+       * or ERROR otherwise.
+       */
+      Status finish(void);
+
+      /**
+       * \brief Retrieves the status of the parsing process
+       */
+      Status getStatus(void) const;
+
+      /**
+       * \brief Retrieves the number of bytes consumed from the last chunk
+       *
+       * \note
+       * It may be less than the chunk size only if full_read was false and
+       * the first level value ended before the chunk did, or if an error was
+       * detected.
+       */
+      size_t getConsumed(void) const;
+
+      /**
+       * \brief Retrieves the number of bytes consumed since the beginning
+       */
+      size_t getOffset(void) const;
+
+      /**
+       * \brief Retrieves the offset where the last token read begins
+       */
+      size_t getTokenOffset(void) const;
+
+      /**
+       * \brief Retrieves the data consumed so far
+       *
+       * \note
+       * Data is only kept if the instance was created with keep_input flag.
+       */
+      std::string const &getInput(void) const;
+
+      /**
+       * \brief Retrieves details for the last error detected
+       *
+       * \returns a pointer to an instance containing the details for the
+       * error that stopped the process or a null pointer if no error has been
+       * detected so far.
+       *
+       * \note
+       * The instance is built on the first call after the error.
+       */
+      Exception const *getErrorReport(void) const;
+
+      /**
+       * \brief Retrieves the outcome of the parsing process
+       *
+       * \returns the error code and position for the error that stopped the
+       * process, if any.
+       */
+      Parse_Result const &getResult(void) const;
+
+      /**
+       * \brief Takes the value read
+       *
+       * \returns a pointer to memory taken from the heap containing the first
+       * level value read or a null pointer if the process is not DONE or a
+       * handler was specified at construction time.
+       *
+       * \warning
+       * As this method returns a pointer to memory allocated from the heap,
+       * it is up to the caller to release once it is no longer needed in
+       * order to avoid leaks.
+       */
+      Value_Complex *release(void);
+
+      /**
+       * \brief Prepares the instance to analyze a new input
+       */
+      void reset(void);
+
+      /**
+       * \brief Parses a memory buffer without throwing exceptions
+       *
+       * \param data Pointer to the buffer.
+       *
+       * \param len Number of bytes in the buffer.
+       *
+       * \param result Reference to the instance receiving the outcome.
+       *
+       * \param comments_allowed flag to extend basic format and allow for
+       * hash symbol '#' starting comments in input.
+       *
+       * \param validate_utf8 flag to reject strings whose contents are not
+       * valid UTF-8.
+       *
+       * \param keep_big_numbers flag to report integers that fit no native
+       * type by their decimal text (see Parse_Handler::numberTextValue()).
+       * Otherwise they are converted to the nearest double.
+       *
+       * \param lazy_numbers flag to report every number by its decimal text
+       * so it is only converted if it is ever retrieved and written back
+       * as read otherwise (implies keep_big_numbers).
+       *
+       * \returns a pointer to memory taken from the heap containing the
+       * first level value read or a null pointer if an error was found. It is
+       * up to the caller to release it.
+       */
+      static Value_Complex *parseBuffer(char const *data, size_t len
+        , Parse_Result &result, bool comments_allowed = false
+        , bool validate_utf8 = false
+        , bool keep_big_numbers = false
+        , bool lazy_numbers = false);
+
+      /**
+       * \brief Parses a memory buffer without throwing exceptions
+       *
+       * \param data Pointer to the buffer.
+       *
+       * \param len Number of bytes in the buffer.
+       *
+       * \param handler Reference to the instance that will receive the
+       * parsing events.
+       *
+       * \param result Reference to the instance receiving the outcome.
+       *
+       * \param comments_allowed flag to extend basic format and allow for
+       * hash symbol '#' starting comments in input.
+       *
+       * \param validate_utf8 flag to reject strings whose contents are not
+       * valid UTF-8.
+       *
+       * \param keep_big_numbers flag to report integers that fit no native
+       * type by their decimal text (see Parse_Handler::numberTextValue()).
+       * Otherwise they are converted to the nearest double.
+       *
+       * \param lazy_numbers flag to report every number by its decimal text
+       * so it is only converted if it is ever retrieved and written back
+       * as read otherwise (implies keep_big_numbers).
+       *
+       * \returns true if the buffer holds exactly one first level value.
+       */
+      static bool parseBuffer(char const *data, size_t len
+        , Parse_Handler &handler, Parse_Result &result
+        , bool comments_allowed = false, bool validate_utf8 = false
+        , bool keep_big_numbers = false, bool lazy_numbers = false);
+
+    private:
+
+      /**
+       * \brief Enumeration for the lexical analysis state machine
+       */
+      enum scan_states
+      {
+        /** waiting for a token */
+        scan_space,
+        /** inside a comment */
+        scan_comment,
+        /** inside a string */
+        scan_string,
+        /** after a backslash inside a string */
+        scan_escape,
+        /** reading the hexadecimal digits for an unicode escape sequence */
+        scan_unicode,
+        /** after a high surrogate, waiting for the backslash of its pair */
+        scan_pair,
+        /** reading the rest of a multibyte UTF-8 sequence */
+        scan_utf8,
+        /** inside a number */
+        scan_number,
+        /** inside a null, true or false constant */
+        scan_literal
+      };                         // enum scan_states
+
+      /**
+       * \brief Enumeration for the parser state machine
+       */
+      enum parser_states
+      {
+        /** initial state */
+        START,
+        /** a new item for an array has been read */
+        array_addItem,
+        /** an inter-item delimiter for an array has been read */
+        array_nextItem,
+        /** an object initial delimiter has been read */
+        property_begin,
+        /** an object property name has been read */
+        property_name,
+        /** an object property delimiter has been read */
+        property_value,
+        /** an inter-property delimiter for an object has been read */
+        property_next,
+        /** final state */
+        END
+      };                         // enum parser_states
+
+      /**
+       * \brief Codes for tokens without a single character representation
+       */
+      enum token_codes
+      {
+        NULL_TOKEN = 256,
+        FALSE_TOKEN,
+        TRUE_TOKEN,
+        NUMBER_TOKEN,
+        NUMBER_INT_TOKEN,
+        STRING_TOKEN
+      };                         // enum token_codes
+
+      /**
+       * \brief Copy constructor (not available)
+       */
+      Incremental_Parser(Incremental_Parser const &orig);
+
+      /**
+       * \brief Assignment operator (not available)
+       */
+      Incremental_Parser &operator=(Incremental_Parser const &orig);
+
+      /**
+       * \brief Runs the parser state machine for a token
+       *
+       * \param token code for the token read (single character tokens are
+       * represented by the character itself).
+       *
+       * \returns false if an error has been detected.
+       */
+      bool token(int token);
+
+      /**
+       * \brief Reports a value start token to the handler
+       *
+       * \returns false if an error has been detected.
+       */
+      bool value(int token);
+
+      /**
+       * \brief Closes the innermost complex value
+       *
+       * \returns false if an error has been detected.
+       */
+      bool close(int token);
+
+      /**
+       * \brief Converts and reports the number held in the token data
+       *
+       * \returns false if an error has been detected.
+       */
+      bool number(void);
+
+      /**
+       * \brief Registers an unexpected token error
+       */
+      void syntaxError(int token, char const *expected);
+
+      /**
+       * \brief Registers an error
+       *
+       * \param code Error code.
+       *
+       * \param offset Byte offset where the error was detected.
+       *
+       * \param character Offending character, if relevant.
+       *
+       * \param expected Description of what was expected, if relevant.
+       */
+      void error(Parse_Result::Error_Code code, size_t offset
+        , char character = 0, char const *expected = 0);
+
+      /**
+       * \brief Registers an error reported by the handler
+       */
+      void handlerError(void);
+
+      /**
+       * \brief Stores the character of the unicode escape sequence just read
+       *
+       * \param offset Position of the last hexadecimal digit.
+       *
+       * \par Description
+       * High surrogates are kept until their pair is read.
+       */
+      void unicodeChar(size_t offset);
+
+      /**
+       * \brief Handler used when none is specified
+       */
+      Value_Builder builder_;
+
+      /**
+       * \brief Handler receiving the parsing events
+       */
+      Parse_Handler &handler_;
+
+      /**
+       * \brief Flag for extending language to accept # comments
+       */
+      bool    commented_;
+
+      /**
+       * \brief Flag to check there is no data after the first level value
+       */
+      bool    fullRead_;
+
+      /**
+       * \brief Flag to keep a copy of all the data consumed
+       */
+      bool    keepInput_;
+
+      /**
+       * \brief Status of the parsing process
+       */
+      Status  status_;
+
+      /**
+       * \brief Current lexical analysis state
+       */
+      scan_states   scan_;
+
+      /**
+       * \brief Parser state for the first level
+       */
+      parser_states state_;
+
+      /**
+       * \brief Parser states for the complex values still open
+       */
+      std::vector<unsigned char>  stack_;
+
+      /**
+       * \brief Container for the token associated data
+       */
+      std::string tokenData_;
+
+      /**
+       * \brief Constant being read when in scan_literal state
+       */
+      char const  *literal_;
+
+      /**
+       * \brief Number of characters already matched from literal_
+       */
+      size_t  literalPos_;
+
+      /**
+       * \brief Token code for literal_
+       */
+      int     literalToken_;
+
+      /**
+       * \brief Value of the unicode escape sequence being read
+       */
+      unsigned int  unicode_;
+
+      /**
+       * \brief Hexadecimal digits read for the unicode escape sequence
+       */
+      unsigned int  unicodeDigits_;
+
+      /**
+       * \brief High surrogate waiting for its pair (0 if none)
+       */
+      unsigned int  surrogate_;
+
+      /**
+       * \brief Flag to check that string contents are valid UTF-8
+       */
+      bool    validateUTF8_;
+
+      /**
+       * \brief Bytes read from a multibyte UTF-8 sequence split between
+       * chunks
+       */
+      std::string utf8_;
+
+      /**
+       * \brief Length of the multibyte UTF-8 sequence being read
+       */
+      size_t  utf8Length_;
+
+      /**
+       * \brief Flag to report big integers by their decimal text
+       */
+      bool    keepBigNumbers_;
+
+      /**
+       * \brief Flag to report every number by its decimal text
+       */
+      bool    lazyNumbers_;
+
+      /**
+       * \brief Bytes consumed before the current chunk
+       */
+      size_t  offset_;
+
+      /**
+       * \brief Bytes consumed from the last chunk
+       */
+      size_t  consumed_;
+
+      /**
+       * \brief Offset where the last token begins
+       */
+      size_t  tokenOffset_;
+
+      /**
+       * \brief Current line number
+       */
+      unsigned int  line_;
+
+      /**
+       * \brief Offset where the current line begins
+       */
+      size_t  lineStart_;
+
+      /**
+       * \brief Copy of the data consumed
+       */
+      std::string input_;
+
+      /**
+       * \brief Outcome of the parsing process
+       */
+      Parse_Result  result_;
+
+      /**
+       * \brief Pointer to the exception describing the last error, built
+       * on request
+       */
+      mutable Exception   *pErrorReport_;
+
+  };                             // class Incremental_Parser
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
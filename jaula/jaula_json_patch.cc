@@ -0,0 +1,977 @@
+
+/*
+ * jaula_json_patch.cc : JSON Analysis User Library Acronym
+ * JSON Patch implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_STDINT_H
+#include <stdint.h>
+#endif
+}
+
+
+#ifdef HAVE_ALGORITHM
+#include <algorithm>
+#endif
+
+#ifdef HAVE_MEMORY
+#include <memory>
+#endif
+
+#ifdef HAVE_SSTREAM
+#include <sstream>
+#endif
+
+#ifdef HAVE_VECTOR
+#include <vector>
+#endif
+
+#include <jaula/jaula_json_patch.h>
+#include <jaula/jaula_json_pointer.h>
+#include <jaula/jaula_value_object.h>
+#include <jaula/jaula_value_string.h>
+
+namespace
+{                                // anonymous namespace
+
+  using namespace JAULA;
+
+  /**
+   * \brief Marker for array items without an original item
+   */
+  size_t const  NONE = static_cast<size_t>(-1);
+
+  /**
+   * \brief Checks if two values are equal, comparing hashes first
+   */
+  bool same(Value const &left, Value const &right)
+  {
+    return (left.hash() == right.hash()) && left.equals(right);
+  }
+
+  /**
+   * \brief Appends an array index to a JSON Pointer
+   */
+  void appendIndex(std::string &path, size_t index)
+  {
+    char  digits[24];
+    char  *p = digits + sizeof(digits);
+    do
+    {
+      *(--p) = static_cast<char>('0' + (index % 10));
+      index /= 10;
+    } while (index);
+    path += '/';
+    path.append(p, digits + sizeof(digits) - p);
+  }
+
+  /**
+   * \brief Appends an object property name to a JSON Pointer
+   */
+  void appendName(std::string &path, std::string const &name)
+  {
+    path += '/';
+    path += Json_Pointer::escape(name);
+  }
+
+  /**
+   * \brief Map from hashes to the positions of the items that have them
+   *
+   * \par Description
+   * Entries sharing a hash are kept together in position order. Entries
+   * found used are linked to the next one, so that searching among many
+   * equal items does not walk again over the ones already taken.
+   */
+  class Hash_Index
+  {                              // class Hash_Index
+    public:
+
+      /**
+       * \brief Constructor
+       *
+       * \param items Values to index by position.
+       */
+      Hash_Index(std::vector<Value const *> const &items)
+        : entries_()
+        , next_()
+      {
+        entries_.reserve(items.size());
+        for (size_t i = 0; (i < items.size()); i++)
+          entries_.push_back(std::make_pair(items[i]->hash(), i));
+        std::sort(entries_.begin(), entries_.end());
+        next_.reserve(entries_.size() + 1);
+        for (size_t i = 0; (i <= entries_.size()); i++)
+          next_.push_back(i);
+      }
+
+      /**
+       * \brief Finds an unused item equal to a value
+       *
+       * \param items Values indexed.
+       * \param used Flags for the items already taken.
+       * \param value Value to look for.
+       *
+       * \returns the position of the item or NONE.
+       */
+      size_t findEqual(std::vector<Value const *> const &items
+        , std::vector<bool> const &used, Value const &value)
+      {
+        uint64_t const  h = value.hash();
+        size_t  entry = std::lower_bound(entries_.begin(), entries_.end()
+          , std::make_pair(h, static_cast<size_t>(0))) - entries_.begin();
+        while (((entry = skip(entry)) < entries_.size())
+          && (entries_[entry].first == h))
+        {
+          size_t const  item = entries_[entry].second;
+          if (used[item])
+            next_[entry] = entry + 1;
+          else if (items[item]->equals(value))
+            return item;
+          entry++;
+        }
+        return NONE;
+      }
+
+    private:
+
+      /**
+       * \brief Follows the links of used entries
+       *
+       * \returns the first entry from the one given not known to be used.
+       */
+      size_t skip(size_t entry)
+      {
+        size_t  last = entry;
+        while (next_[last] != last)
+          last = next_[last];
+        while (next_[entry] != last)
+        {
+          size_t const  following = next_[entry];
+          next_[entry] = last;
+          entry = following;
+        }
+        return last;
+      }
+
+      /**
+       * \brief Hash and position pairs sorted
+       */
+      std::vector<std::pair<uint64_t, size_t> > entries_;
+
+      /**
+       * \brief Links from used entries towards the next ones
+       */
+      std::vector<size_t> next_;
+  };                             // class Hash_Index
+
+  /**
+   * \brief Count of items still waiting at each position
+   *
+   * \par Description
+   * Binary indexed (Fenwick) tree, so that both counting the items waiting
+   * before a position and marking one as done take logarithmic time.
+   */
+  class Waiting_Count
+  {                              // class Waiting_Count
+    public:
+
+      /**
+       * \brief Constructor
+       *
+       * \param waiting Flags for the positions with an item waiting.
+       */
+      Waiting_Count(std::vector<bool> const &waiting)
+        : tree_(waiting.size() + 1, 0)
+      {
+        for (size_t i = 1; (i < tree_.size()); i++)
+        {
+          if (waiting[i - 1])
+            tree_[i]++;
+          size_t const  parent = i + (i & (~i + 1));
+          if (parent < tree_.size())
+            tree_[parent] += tree_[i];
+        }
+      }
+
+      /**
+       * \brief Number of items waiting before a position
+       */
+      size_t before(size_t pos) const
+      {
+        size_t  count = 0;
+        for (; (pos > 0); pos -= (pos & (~pos + 1)))
+          count += tree_[pos];
+        return count;
+      }
+
+      /**
+       * \brief Marks the item at a position as no longer waiting
+       */
+      void done(size_t pos)
+      {
+        for (pos++; (pos < tree_.size()); pos += (pos & (~pos + 1)))
+          tree_[pos]--;
+      }
+
+    private:
+
+      /**
+       * \brief Partial counts
+       */
+      std::vector<size_t> tree_;
+  };                             // class Waiting_Count
+
+  /**
+   * \brief Place for a value inside its container
+   */
+  struct Location
+  {                              // struct Location
+    /** container (array or object) */
+    Value_Complex   *pContainer;
+    /** property name for objects */
+    std::string name;
+    /** item index for arrays */
+    size_t  index;
+  };                             // struct Location
+
+  /**
+   * \brief Takes the value out of a location
+   */
+  Value *take(Location const &location)
+  {
+    if (location.pContainer->getType() == Value::TYPE_ARRAY)
+      return static_cast<Value_Array *>(location.pContainer)
+        ->detachItem(location.index);
+    return static_cast<Value_Object *>(location.pContainer)
+      ->detachItem(location.name);
+  }
+
+  /**
+   * \brief Stores a value in an empty location
+   */
+  void put(Location const &location, Value *pValue)
+  {
+    if (location.pContainer->getType() == Value::TYPE_ARRAY)
+      static_cast<Value_Array *>(location.pContainer)
+        ->adoptItem(location.index, pValue);
+    else
+      static_cast<Value_Object *>(location.pContainer)
+        ->replaceItem(location.name, pValue);
+  }
+
+  /**
+   * \brief Replaces the value in a location
+   *
+   * \returns the former value or NULL if the location was empty.
+   */
+  Value *exchange(Location const &location, Value *pValue)
+  {
+    if (location.pContainer->getType() == Value::TYPE_ARRAY)
+      return static_cast<Value_Array *>(location.pContainer)
+        ->replaceItem(location.index, pValue);
+    return static_cast<Value_Object *>(location.pContainer)
+      ->replaceItem(location.name, pValue);
+  }
+
+  /**
+   * \brief Exchanges the contents of the document root and another value
+   *
+   * \par Description
+   * Arrays and objects exchange their items without copying them, scalars
+   * exchange their data. Both values must have the same type.
+   */
+  void swapRoot(Value &target, Value &other)
+  {
+    switch (target.getType())
+    {
+      case Value::TYPE_ARRAY :
+        static_cast<Value_Array &>(target).swap(
+          static_cast<Value_Array &>(other));
+        break;
+
+      case Value::TYPE_OBJECT :
+        static_cast<Value_Object &>(target).swap(
+          static_cast<Value_Object &>(other));
+        break;
+
+      default :
+      {
+        std::auto_ptr<Value>  pCopy(Value::duplicate(target));
+        target.set(other);
+        other.set(*pCopy);
+      }
+      break;
+    }
+  }
+
+  /**
+   * \brief Record of the changes made while applying a patch
+   */
+  class Undo_Log
+  {                              // class Undo_Log
+    public:
+
+      /**
+       * \brief Constructor
+       *
+       * \param target Root of the document being changed.
+       */
+      Undo_Log(Value &target)
+        : target_(target)
+        , entries_()
+        {}
+
+      /**
+       * \brief Destructor
+       *
+       * \par Description
+       * Releases the values kept as if the changes were committed.
+       */
+      ~Undo_Log()
+      {
+        commit();
+      }
+
+      /**
+       * \brief Number of changes recorded
+       */
+      size_t size(void) const
+      {
+        return entries_.size();
+      }
+
+      /**
+       * \brief Records a value stored in an empty location
+       *
+       * \param moved Flag for values taken from another location.
+       */
+      void inserted(Location const &location, bool moved)
+      {
+        record(INSERTED, location, 0, moved);
+      }
+
+      /**
+       * \brief Records a value taken out of its location
+       *
+       * \param pValue Value taken. It is released on commit unless moved.
+       */
+      void removed(Location const &location, Value *pValue, bool moved)
+      {
+        record(REMOVED, location, pValue, moved);
+      }
+
+      /**
+       * \brief Records a value replaced by another
+       *
+       * \param pOld Former value, released on commit.
+       *
+       * \param moved Flag for new values taken from another location.
+       */
+      void replaced(Location const &location, Value *pOld, bool moved)
+      {
+        record(REPLACED, location, pOld, moved);
+      }
+
+      /**
+       * \brief Records the contents of the document replaced
+       *
+       * \param pOld Value holding the former contents, released on commit.
+       *
+       * \param moved Flag for new contents taken from another location.
+       */
+      void root(Value *pOld, bool moved)
+      {
+        Location  location;
+        location.pContainer = 0;
+        location.index = 0;
+        record(ROOT, location, pOld, moved);
+      }
+
+      /**
+       * \brief Releases the values kept and forgets the changes
+       */
+      void commit(void)
+      {
+        for (size_t i = 0; (i < entries_.size()); i++)
+          if ((entries_[i].kind != INSERTED)
+            && ((entries_[i].kind != REMOVED) || !entries_[i].moved))
+            delete entries_[i].pValue;
+        entries_.clear();
+      }
+
+      /**
+       * \brief Undoes the changes recorded after a mark
+       *
+       * \param mark Number of changes to keep.
+       */
+      void rollback(size_t mark)
+      {
+        while (entries_.size() > mark)
+        {
+          Entry const &entry = entries_.back();
+          switch (entry.kind)
+          {
+            case INSERTED :
+            {
+              Value *pValue = take(entry.location);
+              if (!entry.moved)
+                delete pValue;
+            }
+            break;
+
+            case REMOVED :
+              put(entry.location, entry.pValue);
+              break;
+
+            case REPLACED :
+            {
+              Value *pValue = exchange(entry.location, entry.pValue);
+              if (!entry.moved)
+                delete pValue;
+            }
+            break;
+
+            default :
+              swapRoot(target_, *(entry.pValue));
+              if (!entry.moved)
+                delete entry.pValue;
+              break;
+          }
+          entries_.pop_back();
+        }
+      }
+
+    private:
+
+      /**
+       * \brief Kinds of changes
+       */
+      enum Kind
+      {
+        INSERTED, REMOVED, REPLACED, ROOT
+      };
+
+      /**
+       * \brief Change recorded
+       */
+      struct Entry
+      {                          // struct Entry
+        /** kind of change */
+        Kind    kind;
+        /** place changed */
+        Location    location;
+        /** value kept to undo the change */
+        Value   *pValue;
+        /** flag for values moved from another location */
+        bool    moved;
+      };                         // struct Entry
+
+      /**
+       * \brief Appends an entry
+       */
+      void record(Kind kind, Location const &location, Value *pValue
+        , bool moved)
+      {
+        Entry entry;
+        entry.kind = kind;
+        entry.location = location;
+        entry.pValue = pValue;
+        entry.moved = moved;
+        entries_.push_back(entry);
+      }
+
+      /**
+       * \brief Root of the document
+       */
+      Value   &target_;
+
+      /**
+       * \brief Changes recorded
+       */
+      std::vector<Entry>  entries_;
+  };                             // class Undo_Log
+
+  /**
+   * \brief Retrieves a string member of an operation
+   *
+   * \exception JAULA::Syntax_Error
+   * This exception is launched if the member is missing or not a string.
+   */
+  std::string const &member(Value_Object const &operation, char const *name)
+    throw(Syntax_Error)
+  {
+    Value const *pMember = operation.getItem(name);
+    if (!pMember || (pMember->getType() != Value::TYPE_STRING))
+      throw Syntax_Error(std::string("operation without a valid \"") + name
+        + "\" member", "reading the operation");
+    return static_cast<Value_String const *>(pMember)->getData();
+  }
+
+  /**
+   * \brief Finds the location a pointer refers to
+   *
+   * \param inserting Flag for locations that may be empty.
+   *
+   * \exception JAULA::Bad_Data_Type
+   * This exception is launched if the container does not exist or the
+   * location is not valid.
+   */
+  Location locate(Value &target, Json_Pointer const &pointer, bool inserting)
+    throw(Bad_Data_Type)
+  {
+    size_t const  last = pointer.size() - 1;
+    Location  location;
+    location.pContainer = 0;
+    location.index = 0;
+    Value *pParent = pointer.resolve(target, last);
+    if (pParent && (pParent->getType() == Value::TYPE_OBJECT))
+    {
+      location.pContainer = static_cast<Value_Complex *>(pParent);
+      location.name = pointer.getToken(last);
+      if (inserting
+        || static_cast<Value_Object *>(pParent)->getItem(location.name))
+        return location;
+    }
+    else if (pParent && (pParent->getType() == Value::TYPE_ARRAY))
+    {
+      location.pContainer = static_cast<Value_Complex *>(pParent);
+      size_t const  size = static_cast<Value_Array *>(pParent)->size();
+      location.index = (inserting && (pointer.getToken(last) == "-"))
+        ? size : pointer.getIndex(last);
+      if ((location.index < size) || (inserting && (location.index == size)))
+        return location;
+    }
+    throw Bad_Data_Type("Path " + pointer.getPointer() + " does not exist"
+      , "locating the target of the operation");
+  }
+
+  /**
+   * \brief Checks that a value can replace the document root
+   *
+   * \exception JAULA::Bad_Data_Type
+   * This exception is launched if the types do not match.
+   */
+  void checkRoot(Value const &target, Value const &value)
+    throw(Bad_Data_Type)
+  {
+    if (target.getType() != value.getType())
+      throw Bad_Data_Type("The type of the document can not change"
+        , "replacing the whole document");
+  }
+
+  /**
+   * \brief Stores a value in the document
+   *
+   * \param pValue Value to store. Its ownership is taken.
+   *
+   * \param moved Flag for values taken from another location.
+   *
+   * \param inserting Flag for add operations, which insert array items
+   * instead of replacing them and may store values in empty locations.
+   */
+  void store(Value &target, Json_Pointer const &pointer, Value *pValue
+    , bool moved, bool inserting, Undo_Log &log) throw(Bad_Data_Type)
+  {
+    if (!pointer.size())
+    {
+      swapRoot(target, *pValue);
+      log.root(pValue, moved);
+      return;
+    }
+    Location  location;
+    try
+    {
+      location = locate(target, pointer, inserting);
+    }
+    catch(Bad_Data_Type &ex)
+    {
+      if (!moved)
+        delete pValue;
+      throw ex;
+    }
+    Value *pOld = 0;
+    if (inserting && (location.pContainer->getType() == Value::TYPE_ARRAY))
+      put(location, pValue);
+    else
+      pOld = exchange(location, pValue);
+    if (pOld)
+      log.replaced(location, pOld, moved);
+    else
+      log.inserted(location, moved);
+  }
+
+  /**
+   * \brief Applies one operation
+   */
+  void applyOperation(Value &target, Value const &value, Undo_Log &log)
+    throw(Exception)
+  {
+    if (value.getType() != Value::TYPE_OBJECT)
+      throw Syntax_Error("operation is not an object"
+        , "reading the operation");
+    Value_Object const &operation = static_cast<Value_Object const &>(value);
+    std::string const &op = member(operation, "op");
+    Json_Pointer const  path(member(operation, "path"));
+    Value const *pValue = operation.getItem("value");
+
+    if ((op == "add") || (op == "replace") || (op == "test"))
+    {
+      if (!pValue)
+        throw Syntax_Error("operation without a \"value\" member"
+          , "reading the operation");
+      if (op == "test")
+      {
+        Value const *pCurrent = path.resolve(target);
+        if (!pCurrent || !pCurrent->equals(*pValue))
+          throw Bad_Data_Type("Test failed for " + path.getPointer()
+            , "testing the value");
+        return;
+      }
+      if (!path.size())
+        checkRoot(target, *pValue);
+      else
+        locate(target, path, op == "add");
+      store(target, path, Value::duplicate(*pValue), false, op == "add"
+        , log);
+    }
+    else if (op == "remove")
+    {
+      if (!path.size())
+        throw Bad_Data_Type("The whole document can not be removed"
+          , "removing the value");
+      Location const  location = locate(target, path, false);
+      log.removed(location, take(location), false);
+    }
+    else if ((op == "move") || (op == "copy"))
+    {
+      Json_Pointer const  from(member(operation, "from"));
+      Value const *pSource = from.resolve(target);
+      if (!pSource)
+        throw Bad_Data_Type("Path " + from.getPointer() + " does not exist"
+          , "locating the source of the operation");
+      if (!path.size())
+        checkRoot(target, *pSource);
+      if (op == "copy")
+      {
+        store(target, path, Value::duplicate(*pSource), false, true, log);
+        return;
+      }
+      if (from.getPointer() == path.getPointer())
+        return;
+      bool  inside = from.size() < path.size();
+      for (size_t i = 0; (inside && (i < from.size())); i++)
+        inside = (from.getToken(i) == path.getToken(i));
+      if (inside)
+        throw Syntax_Error("A value can not be moved inside itself"
+          , "locating the target of the operation");
+      Location const  location = locate(target, from, false);
+      Value *pMoved = take(location);
+      log.removed(location, pMoved, true);
+      store(target, path, pMoved, true, true, log);
+    }
+    else
+      throw Syntax_Error("unknown operation " + op, "reading the operation");
+  }
+
+  /**
+   * \brief Merges an object patch into an object
+   */
+  void mergeObject(Value_Object &target, Value_Object const &patch)
+  {
+    for (Value_Object::dataType::const_iterator it = patch.getData().begin()
+      ; (it != patch.getData().end())
+      ; it++)
+    {
+      Value const &value = *(it->second);
+      if (value.getType() == Value::TYPE_NULL)
+      {
+        delete target.detachItem(it->first);
+        continue;
+      }
+      Value *pCurrent = target.getItem(it->first);
+      if (value.getType() != Value::TYPE_OBJECT)
+        delete target.replaceItem(it->first, Value::duplicate(value));
+      else if (pCurrent && (pCurrent->getType() == Value::TYPE_OBJECT))
+        mergeObject(*static_cast<Value_Object *>(pCurrent)
+          , static_cast<Value_Object const &>(value));
+      else
+      {
+        Value_Object  *pObject = new Value_Object();
+        mergeObject(*pObject, static_cast<Value_Object const &>(value));
+        delete target.replaceItem(it->first, pObject);
+      }
+    }
+  }
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Value_Array *Json_Patch::diff(Value const &from, Value const &to)
+  {
+    Value_Array *pPatch = new Value_Array();
+    std::string path;
+    diff(from, to, path, *pPatch);
+    return pPatch;
+  }
+
+  void Json_Patch::apply(Value &target, Value const &patch, bool atomic)
+    throw(Exception)
+  {
+    if (patch.getType() != Value::TYPE_ARRAY)
+      throw Syntax_Error("The patch is not an array"
+        , "reading the patch"
+        , "Json_Patch::apply(Value &, Value const &, bool)");
+
+    Value_Array::dataType const &operations =
+      static_cast<Value_Array const &>(patch).getData();
+    Undo_Log  log(target);
+    for (size_t i = 0; (i < operations.size()); i++)
+    {                            // operations loop
+      size_t const  mark = log.size();
+      try
+      {
+        applyOperation(target, *(operations[i]), log);
+      }
+      catch(Syntax_Error &ex)
+      {
+        log.rollback(atomic ? 0 : mark);
+        std::ostringstream  origin;
+        origin << "Json_Patch::apply(Value &, Value const &, bool)"
+          << " applying operation " << i;
+        ex.addOrigin(origin.str());
+        throw ex;
+      }
+      catch(Bad_Data_Type &ex)
+      {
+        log.rollback(atomic ? 0 : mark);
+        std::ostringstream  origin;
+        origin << "Json_Patch::apply(Value &, Value const &, bool)"
+          << " applying operation " << i;
+        ex.addOrigin(origin.str());
+        throw ex;
+      }
+    }                            // operations loop
+  }
+
+  void Json_Patch::applyMerge(Value &target, Value const &patch)
+    throw(Bad_Data_Type)
+  {
+    if ((patch.getType() == Value::TYPE_OBJECT)
+      && (target.getType() == Value::TYPE_OBJECT))
+    {
+      mergeObject(static_cast<Value_Object &>(target)
+        , static_cast<Value_Object const &>(patch));
+      return;
+    }
+    if (target.getType() != patch.getType())
+      throw Bad_Data_Type("The type of the document can not change"
+        , "replacing the whole document"
+        , "Json_Patch::applyMerge(Value &, Value const &)");
+    std::auto_ptr<Value>  pCopy(Value::duplicate(patch));
+    swapRoot(target, *pCopy);
+  }
+
+  void Json_Patch::diff(Value const &from, Value const &to
+    , std::string &path, Value_Array &patch)
+  {
+    if (same(from, to))
+      return;
+    if ((from.getType() == to.getType())
+      && (from.getType() == Value::TYPE_OBJECT))
+      diffObject(from, to, path, patch);
+    else if ((from.getType() == to.getType())
+      && (from.getType() == Value::TYPE_ARRAY))
+      diffArray(from, to, path, patch);
+    else
+      addOperation(patch, "replace", path, 0, &to);
+  }
+
+  void Json_Patch::diffObject(Value const &from, Value const &to
+    , std::string &path, Value_Array &patch)
+  {
+    Value_Object::dataType const &left =
+      static_cast<Value_Object const &>(from).getData();
+    Value_Object::dataType const &right =
+      static_cast<Value_Object const &>(to).getData();
+    size_t const  len = path.size();
+
+    std::vector<Value_Object::dataType::const_iterator> removed;
+    for (Value_Object::dataType::const_iterator it = left.begin()
+      ; (it != left.end())
+      ; it++)
+      if (right.find(it->first) == right.end())
+        removed.push_back(it);
+
+    std::vector<Value const *>  removedValues;
+    for (size_t i = 0; (i < removed.size()); i++)
+      removedValues.push_back(removed[i]->second);
+    Hash_Index  index(removedValues);
+    std::vector<bool> moved(removed.size(), false);
+
+    for (Value_Object::dataType::const_iterator it = right.begin()
+      ; (it != right.end())
+      ; it++)
+    {                            // new properties loop
+      Value_Object::dataType::const_iterator org = left.find(it->first);
+      appendName(path, it->first);
+      if (org != left.end())
+        diff(*(org->second), *(it->second), path, patch);
+      else
+      {
+        size_t const  source = index.findEqual(removedValues, moved
+          , *(it->second));
+        if (source == NONE)
+          addOperation(patch, "add", path, 0, it->second);
+        else
+        {
+          std::string fromPath(path, 0, len);
+          appendName(fromPath, removed[source]->first);
+          addOperation(patch, "move", path, &fromPath, 0);
+          moved[source] = true;
+        }
+      }
+      path.resize(len);
+    }                            // new properties loop
+
+    for (size_t i = 0; (i < removed.size()); i++)
+    {
+      if (moved[i])
+        continue;
+      appendName(path, removed[i]->first);
+      addOperation(patch, "remove", path, 0, 0);
+      path.resize(len);
+    }
+  }
+
+  void Json_Patch::diffArray(Value const &from, Value const &to
+    , std::string &path, Value_Array &patch)
+  {
+    Value_Array::dataType const &left =
+      static_cast<Value_Array const &>(from).getData();
+    Value_Array::dataType const &right =
+      static_cast<Value_Array const &>(to).getData();
+    size_t const  len = path.size();
+
+    size_t  prefix = 0;
+    size_t  suffix = 0;
+    size_t const  common = std::min(left.size(), right.size());
+    while ((prefix < common) && same(*(left[prefix]), *(right[prefix])))
+      prefix++;
+    while ((suffix < common - prefix)
+      && same(*(left[left.size() - 1 - suffix])
+        , *(right[right.size() - 1 - suffix])))
+      suffix++;
+
+    size_t const  leftCount = left.size() - prefix - suffix;
+    size_t const  rightCount = right.size() - prefix - suffix;
+    if (!leftCount && !rightCount)
+      return;
+
+    std::vector<Value const *>  items(left.begin() + prefix
+      , left.begin() + prefix + leftCount);
+    Hash_Index  index(items);
+
+    std::vector<bool> kept(leftCount, false);
+    std::vector<size_t> source(rightCount, NONE);
+    std::vector<bool> changed(rightCount, false);
+    for (size_t i = 0; (i < rightCount); i++)
+    {
+      source[i] = index.findEqual(items, kept, *(right[prefix + i]));
+      if (source[i] != NONE)
+        kept[source[i]] = true;
+    }
+
+    for (size_t i = 0, j = 0; (i < rightCount); i++)
+    {                            // unmatched items pairing
+      if (source[i] != NONE)
+        continue;
+      while ((j < leftCount) && kept[j])
+        j++;
+      if (j == leftCount)
+        break;
+      source[i] = j;
+      changed[i] = true;
+      kept[j] = true;
+    }                            // unmatched items pairing
+
+    for (size_t i = leftCount; (i > 0); i--)
+    {
+      if (kept[i - 1])
+        continue;
+      appendIndex(path, prefix + i - 1);
+      addOperation(patch, "remove", path, 0, 0);
+      path.resize(len);
+    }
+
+    Waiting_Count  waiting(kept);
+    for (size_t i = 0; (i < rightCount); i++)
+    {                            // target items loop
+      appendIndex(path, prefix + i);
+      if (source[i] == NONE)
+        addOperation(patch, "add", path, 0, right[prefix + i]);
+      else
+      {
+        // items placed take positions up to i, the ones still waiting
+        // follow them keeping their original order
+        size_t const  pos = i + waiting.before(source[i]);
+        if (pos != i)
+        {
+          std::string fromPath(path, 0, len);
+          appendIndex(fromPath, prefix + pos);
+          addOperation(patch, "move", path, &fromPath, 0);
+        }
+        waiting.done(source[i]);
+        if (changed[i])
+          diff(*(items[source[i]]), *(right[prefix + i]), path, patch);
+      }
+      path.resize(len);
+    }                            // target items loop
+  }
+
+  void Json_Patch::addOperation(Value_Array &patch, char const *op
+    , std::string const &path, std::string const *pFrom
+    , Value const *pValue)
+  {
+    Value_Object  *pOperation = new Value_Object();
+    pOperation->adoptItem("op", new Value_String(op));
+    if (pFrom)
+      pOperation->adoptItem("from", new Value_String(*pFrom));
+    pOperation->adoptItem("path", new Value_String(path));
+    if (pValue)
+      pOperation->adoptItem("value", Value::duplicate(*pValue));
+    patch.adoptItem(pOperation);
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
@@ -0,0 +1,194 @@
+
+/*
+ * jaula_json_patch.h : JSON Analysis User Library Acronym
+ * JSON Patch definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_JSON_PATCH_H_
+#define _JAULA_JSON_PATCH_H_
+
+#include <string>
+
+#include <jaula/jaula_bad_data_type.h>
+#include <jaula/jaula_exception.h>
+#include <jaula/jaula_syntax_error.h>
+#include <jaula/jaula_value.h>
+#include <jaula/jaula_value_array.h>
+
+/**
+ * \addtogroup jaula_val JAULA: JSON Values containers
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief JSON Patch operations
+   *
+   * \ingroup jaula_val
+   *
+   * \par
+   * This class groups the operations to compute and apply patches as
+   * defined by RFC 6902 (JSON Patch) and RFC 7396 (JSON Merge Patch).
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Json_Patch
+  {                              // class Json_Patch
+    public:
+
+      /**
+       * \brief Computes the differences between two values
+       *
+       * \param from Original value.
+       *
+       * \param to Modified value.
+       *
+       * \returns a pointer to memory taken from the heap (by means of the
+       * new operator) containing an array of JSON Patch operations that
+       * turns from into to.
+       *
+       * \par Description
+       * Subtrees with equal structural hashes are compared and skipped
+       * without looking for differences inside them. Object properties
+       * whose value moves to a new name and array items that change their
+       * position are reported as move operations, found by hash instead of
+       * comparing every pair of items. Array items that can not be matched
+       * are compared by position, so small changes inside an item give
+       * small operations instead of replacing the whole item.
+       *
+       * \warning
+       * As this method returns a pointer to memory allocated from the heap,
+       * it is up to the caller to release once it is no longer needed in
+       * order to avoid leaks.
+       */
+      static Value_Array *diff(Value const &from, Value const &to);
+
+      /**
+       * \brief Applies a JSON Patch
+       *
+       * \param target Value to modify.
+       *
+       * \param patch Array of JSON Patch operations.
+       *
+       * \param atomic Flag to undo every operation already applied if one
+       * of them fails.
+       *
+       * \exception Syntax_Error
+       * This exception is launched if the patch or any of its operations is
+       * malformed.
+       *
+       * \exception Bad_Data_Type
+       * This exception is launched if an operation can not be applied: its
+       * path does not exist, a test fails or it would change the type of
+       * target.
+       *
+       * \par Description
+       * The target is modified in place. Values removed or replaced are
+       * released and move operations take the subtree out of its former
+       * container without copying it. Parts of the target not referenced by
+       * the operations are not visited.
+       *
+       * \par
+       * In atomic mode every change is recorded in a log, keeping the values
+       * removed or replaced until the whole patch succeeds, so a failure
+       * leaves the target as it was. Otherwise a failure leaves the
+       * operations before it applied.
+       *
+       * \note
+       * As target can not change its type, operations replacing the whole
+       * document must provide a value of the same type.
+       */
+      static void apply(Value &target, Value const &patch, bool atomic = false)
+        throw(Exception);
+
+      /**
+       * \brief Applies a JSON Merge Patch
+       *
+       * \param target Value to modify.
+       *
+       * \param patch Merge patch.
+       *
+       * \exception Bad_Data_Type
+       * This exception is launched if the patch would change the type of
+       * target. It is detected before any change is made.
+       *
+       * \par Description
+       * The target is modified in place: properties set to null in the
+       * patch are removed and the others are merged or replaced, leaving the
+       * rest of the target untouched.
+       */
+      static void applyMerge(Value &target, Value const &patch)
+        throw(Bad_Data_Type);
+
+    private:
+
+      /**
+       * \brief Appends the operations for one value
+       *
+       * \param from Original value.
+       *
+       * \param to Modified value.
+       *
+       * \param path JSON Pointer to the value. It is used as working space
+       * and restored before returning.
+       *
+       * \param patch Array where the operations are appended.
+       */
+      static void diff(Value const &from, Value const &to, std::string &path
+        , Value_Array &patch);
+
+      /**
+       * \brief Appends the operations for two objects
+       */
+      static void diffObject(Value const &from, Value const &to
+        , std::string &path, Value_Array &patch);
+
+      /**
+       * \brief Appends the operations for two arrays
+       */
+      static void diffArray(Value const &from, Value const &to
+        , std::string &path, Value_Array &patch);
+
+      /**
+       * \brief Appends one operation
+       *
+       * \param op Operation name.
+       *
+       * \param path Target for the operation.
+       *
+       * \param pFrom Source for move operations or NULL.
+       *
+       * \param pValue Value for the operation or NULL. It is copied.
+       */
+      static void addOperation(Value_Array &patch, char const *op
+        , std::string const &path, std::string const *pFrom
+        , Value const *pValue);
+  };                             // class Json_Patch
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
@@ -0,0 +1,908 @@
+
+/*
+ * jaula_json_path.cc : JSON Analysis User Library Acronym
+ * JSONPath query implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_CTYPE_H
+#include <ctype.h>
+#endif
+
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+}
+
+
+#ifdef HAVE_ALGORITHM
+#include <algorithm>
+#endif
+
+#ifdef HAVE_SSTREAM
+#include <sstream>
+#endif
+
+#include <jaula/jaula_json_path.h>
+#include <jaula/jaula_value_array.h>
+#include <jaula/jaula_value_boolean.h>
+#include <jaula/jaula_value_number.h>
+#include <jaula/jaula_value_number_int.h>
+#include <jaula/jaula_value_object.h>
+#include <jaula/jaula_value_string.h>
+
+namespace
+{                                // anonymous namespace
+
+  using namespace JAULA;
+
+  /**
+   * \brief Side of a comparison reduced to a comparable form
+   */
+  struct Term
+  {                              // struct Term
+    /** kind of term */
+    enum
+    {
+      MISSING, NUL, BOOLEAN, NUMBER, STRING, COMPLEX
+    }   kind;
+    /** boolean data */
+    bool    boolean;
+    /** numeric data */
+    double  number;
+    /** string data */
+    std::string const *pText;
+    /** array or object */
+    Value const *pValue;
+  };                             // struct Term
+
+  /**
+   * \brief Checks if a character can be part of a name in dotted notation
+   */
+  bool isNameChar(char c)
+  {
+    return isalnum(static_cast<unsigned char>(c)) || (c == '_')
+      || (static_cast<unsigned char>(c) >= 0x80);
+  }
+
+  /**
+   * \brief Appends a code point encoded as UTF-8
+   */
+  void appendUTF8(std::string &text, unsigned long code)
+  {
+    if (code < 0x80)
+      text += static_cast<char>(code);
+    else if (code < 0x800)
+    {
+      text += static_cast<char>(0xc0 | (code >> 6));
+      text += static_cast<char>(0x80 | (code & 0x3f));
+    }
+    else if (code < 0x10000)
+    {
+      text += static_cast<char>(0xe0 | (code >> 12));
+      text += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+      text += static_cast<char>(0x80 | (code & 0x3f));
+    }
+    else
+    {
+      text += static_cast<char>(0xf0 | (code >> 18));
+      text += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+      text += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+      text += static_cast<char>(0x80 | (code & 0x3f));
+    }
+  }
+
+  /**
+   * \brief Converts a value into a comparison term
+   */
+  Term valueTerm(Value const *pValue)
+  {
+    Term  term;
+    term.kind = Term::MISSING;
+    term.boolean = false;
+    term.number = 0;
+    term.pText = 0;
+    term.pValue = pValue;
+    if (!pValue)
+      return term;
+    switch (pValue->getType())
+    {
+      case Value::TYPE_NULL :
+        term.kind = Term::NUL;
+        break;
+
+      case Value::TYPE_BOOLEAN :
+        term.kind = Term::BOOLEAN;
+        term.boolean = static_cast<Value_Boolean const *>(pValue)->getData();
+        break;
+
+      case Value::TYPE_NUMBER :
+        term.kind = Term::NUMBER;
+        term.number = static_cast<Value_Number const *>(pValue)->getData();
+        break;
+
+      case Value::TYPE_NUMBER_INT :
+      {
+        Value_Number_Int const *pNumber =
+          static_cast<Value_Number_Int const *>(pValue);
+        term.kind = Term::NUMBER;
+        term.number = pNumber->isUnsigned()
+          ? static_cast<double>(pNumber->getUnsigned())
+          : static_cast<double>(pNumber->getInt64());
+        break;
+      }
+
+      case Value::TYPE_STRING :
+        term.kind = Term::STRING;
+        term.pText = &(static_cast<Value_String const *>(pValue)->getData());
+        break;
+
+      default :
+        term.kind = Term::COMPLEX;
+        break;
+    }
+    return term;
+  }
+
+  /**
+   * \brief Checks two terms for equality
+   */
+  bool equal(Term const &left, Term const &right)
+  {
+    if (left.kind != right.kind)
+      return false;
+    switch (left.kind)
+    {
+      case Term::BOOLEAN :
+        return left.boolean == right.boolean;
+
+      case Term::NUMBER :
+        return left.number == right.number;
+
+      case Term::STRING :
+        return *(left.pText) == *(right.pText);
+
+      case Term::COMPLEX :
+        return left.pValue->equals(*(right.pValue));
+
+      default :
+        return true;
+    }
+  }
+
+  /**
+   * \brief Checks if a term is lower than another
+   *
+   * \returns false for terms that can not be ordered.
+   */
+  bool lower(Term const &left, Term const &right)
+  {
+    if (left.kind != right.kind)
+      return false;
+    if (left.kind == Term::NUMBER)
+      return left.number < right.number;
+    if (left.kind == Term::STRING)
+      return *(left.pText) < *(right.pText);
+    return false;
+  }
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Json_Path::Json_Path(std::string const &path) throw(Syntax_Error)
+    : path_(path)
+    , steps_()
+    , nodes_()
+    , operands_()
+  {
+    try
+    {
+      compile();
+    }
+    catch(Syntax_Error &ex)
+    {
+      ex.addOrigin("Json_Path::Json_Path(std::string const &)");
+      throw ex;
+    }
+  }
+
+  std::string const &Json_Path::getPath(void) const
+  {
+    return path_;
+  }
+
+  size_t Json_Path::size(void) const
+  {
+    return steps_.size();
+  }
+
+  void Json_Path::select(Value const &root
+    , std::vector<Value const *> &result) const
+  {
+    evaluate(root, 0, result);
+  }
+
+  void Json_Path::compile(void) throw(Syntax_Error)
+  {
+    size_t  pos = 0;
+    skipBlanks(pos);
+    if ((pos >= path_.size()) || (path_[pos] != '$'))
+      fail("query must start with '$'", pos);
+    pos++;
+
+    for (skipBlanks(pos); (pos < path_.size()); skipBlanks(pos))
+    {                            // steps loop
+      Step  step;
+      step.type = SELECT_KEYS;
+      step.recursive = false;
+      step.whole = false;
+      step.start = 0;
+      step.end = 0;
+      step.stride = 1;
+      step.hasStart = false;
+      step.hasEnd = false;
+      step.filter = 0;
+
+      if (path_[pos] == '.')
+      {
+        pos++;
+        if ((pos < path_.size()) && (path_[pos] == '.'))
+        {
+          step.recursive = true;
+          pos++;
+        }
+        if ((pos < path_.size()) && (path_[pos] == '*'))
+        {
+          step.type = SELECT_WILDCARD;
+          pos++;
+        }
+        else if (step.recursive && (pos < path_.size())
+          && (path_[pos] == '['))
+          parseBracket(pos, step);
+        else
+          step.names.push_back(parseName(pos));
+      }
+      else if (path_[pos] == '[')
+        parseBracket(pos, step);
+      else
+        fail("'.' or '[' expected", pos);
+
+      for (size_t i = 0; (i < step.indexes.size()); i++)
+        if (step.indexes[i] < 0)
+          step.whole = true;
+      if ((step.type == SELECT_SLICE) && ((step.stride < 0)
+        || (step.hasStart && (step.start < 0))
+        || (step.hasEnd && (step.end < 0))))
+        step.whole = true;
+      steps_.push_back(step);
+    }                            // steps loop
+  }
+
+  void Json_Path::parseBracket(size_t &pos, Step &step) throw(Syntax_Error)
+  {
+    pos++;
+    skipBlanks(pos);
+    if ((pos < path_.size()) && (path_[pos] == '*'))
+    {
+      step.type = SELECT_WILDCARD;
+      pos++;
+    }
+    else if ((pos < path_.size()) && (path_[pos] == '?'))
+    {
+      pos++;
+      step.type = SELECT_FILTER;
+      step.filter = parseOr(pos);
+    }
+    else
+    {
+      for (;;)
+      {                          // selectors loop
+        skipBlanks(pos);
+        if ((pos < path_.size())
+          && ((path_[pos] == '\'') || (path_[pos] == '"')))
+          step.names.push_back(parseQuoted(pos));
+        else
+        {
+          long  index = 0;
+          bool  present = parseInteger(pos, index);
+          skipBlanks(pos);
+          if ((pos < path_.size()) && (path_[pos] == ':'))
+          {                      // slice
+            if (!step.names.empty() || !step.indexes.empty())
+              fail("slices can not be part of unions", pos);
+            step.type = SELECT_SLICE;
+            step.start = index;
+            step.hasStart = present;
+            pos++;
+            skipBlanks(pos);
+            step.hasEnd = parseInteger(pos, step.end);
+            skipBlanks(pos);
+            if ((pos < path_.size()) && (path_[pos] == ':'))
+            {
+              pos++;
+              skipBlanks(pos);
+              if (parseInteger(pos, step.stride) && !step.stride)
+                fail("slice step can not be zero", pos);
+              skipBlanks(pos);
+            }
+            break;
+          }                      // slice
+          if (!present)
+            fail("name, index or slice expected", pos);
+          step.indexes.push_back(index);
+        }
+        skipBlanks(pos);
+        if ((pos < path_.size()) && (path_[pos] == ','))
+        {
+          pos++;
+          continue;
+        }
+        break;
+      }                          // selectors loop
+    }
+    skipBlanks(pos);
+    if ((pos >= path_.size()) || (path_[pos] != ']'))
+      fail("']' expected", pos);
+    pos++;
+  }
+
+  size_t Json_Path::parseOr(size_t &pos) throw(Syntax_Error)
+  {
+    size_t  left = parseAnd(pos);
+    for (skipBlanks(pos); (path_.compare(pos, 2, "||") == 0)
+      ; skipBlanks(pos))
+    {
+      pos += 2;
+      Filter_Node node;
+      node.op = FILTER_OR;
+      node.left = left;
+      node.right = parseAnd(pos);
+      nodes_.push_back(node);
+      left = nodes_.size() - 1;
+    }
+    return left;
+  }
+
+  size_t Json_Path::parseAnd(size_t &pos) throw(Syntax_Error)
+  {
+    size_t  left = parseUnary(pos);
+    for (skipBlanks(pos); (path_.compare(pos, 2, "&&") == 0)
+      ; skipBlanks(pos))
+    {
+      pos += 2;
+      Filter_Node node;
+      node.op = FILTER_AND;
+      node.left = left;
+      node.right = parseUnary(pos);
+      nodes_.push_back(node);
+      left = nodes_.size() - 1;
+    }
+    return left;
+  }
+
+  size_t Json_Path::parseUnary(size_t &pos) throw(Syntax_Error)
+  {
+    skipBlanks(pos);
+    if (pos >= path_.size())
+      fail("filter expression expected", pos);
+
+    Filter_Node node;
+    if (path_[pos] == '!')
+    {
+      pos++;
+      node.op = FILTER_NOT;
+      node.left = parseUnary(pos);
+      node.right = 0;
+      nodes_.push_back(node);
+      return nodes_.size() - 1;
+    }
+    if (path_[pos] == '(')
+    {
+      pos++;
+      size_t  inner = parseOr(pos);
+      skipBlanks(pos);
+      if ((pos >= path_.size()) || (path_[pos] != ')'))
+        fail("')' expected", pos);
+      pos++;
+      return inner;
+    }
+
+    node.left = parseOperand(pos);
+    node.right = 0;
+    skipBlanks(pos);
+    if (path_.compare(pos, 2, "==") == 0)
+      node.op = FILTER_EQ;
+    else if (path_.compare(pos, 2, "!=") == 0)
+      node.op = FILTER_NE;
+    else if (path_.compare(pos, 2, "<=") == 0)
+      node.op = FILTER_LE;
+    else if (path_.compare(pos, 2, ">=") == 0)
+      node.op = FILTER_GE;
+    else if (path_.compare(pos, 1, "<") == 0)
+      node.op = FILTER_LT;
+    else if (path_.compare(pos, 1, ">") == 0)
+      node.op = FILTER_GT;
+    else
+    {
+      if (!operands_[node.left].isPath)
+        fail("literals can only be used in comparisons", pos);
+      node.op = FILTER_EXISTS;
+    }
+    if (node.op != FILTER_EXISTS)
+    {
+      pos += ((node.op == FILTER_LT) || (node.op == FILTER_GT)) ? 1 : 2;
+      node.right = parseOperand(pos);
+    }
+    nodes_.push_back(node);
+    return nodes_.size() - 1;
+  }
+
+  size_t Json_Path::parseOperand(size_t &pos) throw(Syntax_Error)
+  {
+    skipBlanks(pos);
+    Operand operand;
+    operand.isPath = false;
+    operand.type = Value::TYPE_NULL;
+    operand.boolean = false;
+    operand.number = 0;
+
+    char const  c = (pos < path_.size()) ? path_[pos] : 0;
+    if (c == '@')
+    {                            // relative path
+      operand.isPath = true;
+      pos++;
+      for (;;)
+      {
+        if ((pos + 1 < path_.size()) && (path_[pos] == '.')
+          && isNameChar(path_[pos + 1]))
+        {
+          pos++;
+          operand.path.append(parseName(pos));
+        }
+        else if ((pos < path_.size()) && (path_[pos] == '['))
+        {
+          pos++;
+          skipBlanks(pos);
+          long  index;
+          if ((pos < path_.size())
+            && ((path_[pos] == '\'') || (path_[pos] == '"')))
+            operand.path.append(parseQuoted(pos));
+          else if (parseInteger(pos, index))
+          {
+            if (index < 0)
+              fail("negative indexes are not supported inside filters", pos);
+            operand.path.append(static_cast<size_t>(index));
+          }
+          else
+            fail("name or index expected", pos);
+          skipBlanks(pos);
+          if ((pos >= path_.size()) || (path_[pos] != ']'))
+            fail("']' expected", pos);
+          pos++;
+        }
+        else
+          break;
+      }
+    }                            // relative path
+    else if (c == '$')
+      fail("absolute paths are not supported inside filters", pos);
+    else if ((c == '\'') || (c == '"'))
+    {
+      operand.type = Value::TYPE_STRING;
+      operand.text = parseQuoted(pos);
+    }
+    else if ((c == '-') || isdigit(static_cast<unsigned char>(c)))
+    {
+      char const  *start = path_.c_str() + pos;
+      char  *stop = 0;
+      operand.type = Value::TYPE_NUMBER;
+      operand.number = strtod(start, &stop);
+      if (stop == start)
+        fail("number expected", pos);
+      pos += stop - start;
+    }
+    else if ((path_.compare(pos, 4, "true") == 0)
+      || (path_.compare(pos, 4, "null") == 0))
+    {
+      operand.type = (c == 't') ? Value::TYPE_BOOLEAN : Value::TYPE_NULL;
+      operand.boolean = (c == 't');
+      pos += 4;
+    }
+    else if (path_.compare(pos, 5, "false") == 0)
+    {
+      operand.type = Value::TYPE_BOOLEAN;
+      pos += 5;
+    }
+    else
+      fail("filter operand expected", pos);
+
+    if (!operand.isPath && (pos < path_.size()) && isNameChar(path_[pos]))
+      fail("unexpected character after literal", pos);
+    operands_.push_back(operand);
+    return operands_.size() - 1;
+  }
+
+  std::string Json_Path::parseQuoted(size_t &pos) throw(Syntax_Error)
+  {
+    char const  quote = path_[pos++];
+    std::string text;
+    while ((pos < path_.size()) && (path_[pos] != quote))
+    {
+      if (path_[pos] != '\\')
+      {
+        text += path_[pos++];
+        continue;
+      }
+      if (++pos >= path_.size())
+        break;
+      switch (path_[pos++])
+      {
+        case 'b' : text += '\b'; break;
+        case 'f' : text += '\f'; break;
+        case 'n' : text += '\n'; break;
+        case 'r' : text += '\r'; break;
+        case 't' : text += '\t'; break;
+        case 'u' :
+        {
+          unsigned long code = 0;
+          for (int i = 0; (i < 4); i++, pos++)
+          {
+            if ((pos >= path_.size())
+              || !isxdigit(static_cast<unsigned char>(path_[pos])))
+              fail("invalid unicode escape sequence", pos);
+            char const  h = tolower(static_cast<unsigned char>(path_[pos]));
+            code = (code << 4) | ((h <= '9') ? (h - '0') : (h - 'a' + 10));
+          }
+          if ((code >= 0xd800) && (code < 0xdc00)
+            && (path_.compare(pos, 2, "\\u") == 0))
+          {                      // surrogate pair
+            unsigned long low = 0;
+            size_t  p = pos + 2;
+            for (int i = 0; (i < 4); i++, p++)
+            {
+              if ((p >= path_.size())
+                || !isxdigit(static_cast<unsigned char>(path_[p])))
+                fail("invalid unicode escape sequence", p);
+              char const  h = tolower(static_cast<unsigned char>(path_[p]));
+              low = (low << 4) | ((h <= '9') ? (h - '0') : (h - 'a' + 10));
+            }
+            if ((low >= 0xdc00) && (low < 0xe000))
+            {
+              code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+              pos = p;
+            }
+          }                      // surrogate pair
+          appendUTF8(text, code);
+        }
+        break;
+
+        default :
+          text += path_[pos - 1];
+          break;
+      }
+    }
+    if (pos >= path_.size())
+      fail("unterminated string", pos);
+    pos++;
+    return text;
+  }
+
+  std::string Json_Path::parseName(size_t &pos) throw(Syntax_Error)
+  {
+    size_t const  start = pos;
+    while ((pos < path_.size()) && isNameChar(path_[pos]))
+      pos++;
+    if (pos == start)
+      fail("name expected", pos);
+    return path_.substr(start, pos - start);
+  }
+
+  bool Json_Path::parseInteger(size_t &pos, long &value) throw(Syntax_Error)
+  {
+    size_t  p = pos;
+    bool const  negative = (p < path_.size()) && (path_[p] == '-');
+    if (negative)
+      p++;
+    if ((p >= path_.size()) || !isdigit(static_cast<unsigned char>(path_[p])))
+    {
+      if (negative)
+        fail("digits expected", p);
+      return false;
+    }
+    long  result = 0;
+    for (; (p < path_.size()) && isdigit(static_cast<unsigned char>(path_[p]))
+      ; p++)
+    {
+      if (result > 100000000L)
+        fail("index out of range", p);
+      result = result * 10 + (path_[p] - '0');
+    }
+    value = negative ? -result : result;
+    pos = p;
+    return true;
+  }
+
+  void Json_Path::skipBlanks(size_t &pos) const
+  {
+    while ((pos < path_.size())
+      && isspace(static_cast<unsigned char>(path_[pos])))
+      pos++;
+  }
+
+  void Json_Path::fail(char const *detail, size_t pos) const
+    throw(Syntax_Error)
+  {
+    std::ostringstream  action;
+    action << "compiling JSONPath " << path_ << " at position " << pos;
+    throw Syntax_Error(detail, action.str(), "Json_Path::compile()");
+  }
+
+  void Json_Path::evaluate(Value const &node, size_t step
+    , std::vector<Value const *> &result) const
+  {
+    if (step >= steps_.size())
+    {
+      result.push_back(&node);
+      return;
+    }
+    if (!steps_[step].recursive)
+    {
+      apply(node, step, result);
+      return;
+    }
+
+    std::vector<Value const *>  pending(1, &node);
+    while (!pending.empty())
+    {                            // descendants loop
+      Value const *pCurrent = pending.back();
+      pending.pop_back();
+      apply(*pCurrent, step, result);
+      if (pCurrent->getType() == Value::TYPE_ARRAY)
+      {
+        Value_Array::dataType const &items =
+          static_cast<Value_Array const *>(pCurrent)->getData();
+        for (Value_Array::dataType::const_reverse_iterator it = items.rbegin()
+          ; (it != items.rend())
+          ; it++)
+          pending.push_back(*it);
+      }
+      else if (pCurrent->getType() == Value::TYPE_OBJECT)
+      {
+        Value_Object::dataType const &props =
+          static_cast<Value_Object const *>(pCurrent)->getData();
+        for (Value_Object::dataType::const_reverse_iterator it = props.rbegin()
+          ; (it != props.rend())
+          ; it++)
+          pending.push_back(it->second);
+      }
+    }                            // descendants loop
+  }
+
+  void Json_Path::apply(Value const &node, size_t step
+    , std::vector<Value const *> &result) const
+  {
+    Step const  &s = steps_[step];
+    if (node.getType() == Value::TYPE_OBJECT)
+    {                            // object
+      Value_Object const  &object = static_cast<Value_Object const &>(node);
+      if (s.type == SELECT_KEYS)
+      {
+        for (size_t i = 0; (i < s.names.size()); i++)
+        {
+          Value const *pItem = object.getItem(s.names[i]);
+          if (pItem)
+            evaluate(*pItem, step + 1, result);
+        }
+      }
+      else if (s.type != SELECT_SLICE)
+      {
+        for (Value_Object::dataType::const_iterator it =
+          object.getData().begin()
+          ; (it != object.getData().end())
+          ; it++)
+          if ((s.type == SELECT_WILDCARD) || test(s.filter, *(it->second)))
+            evaluate(*(it->second), step + 1, result);
+      }
+    }                            // object
+    else if (node.getType() == Value::TYPE_ARRAY)
+    {                            // array
+      Value_Array::dataType const &items =
+        static_cast<Value_Array const &>(node).getData();
+      long const  len = items.size();
+      switch (s.type)
+      {                          // selector switch
+        case SELECT_KEYS :
+          for (size_t i = 0; (i < s.indexes.size()); i++)
+          {
+            long const  index = (s.indexes[i] < 0)
+              ? (s.indexes[i] + len) : s.indexes[i];
+            if ((index >= 0) && (index < len))
+              evaluate(*(items[index]), step + 1, result);
+          }
+          break;
+
+        case SELECT_SLICE :
+          if (s.stride > 0)
+          {
+            long  start = s.hasStart ? s.start : 0;
+            long  end = s.hasEnd ? s.end : len;
+            start = (start < 0) ? std::max(start + len, 0L)
+              : std::min(start, len);
+            end = (end < 0) ? std::max(end + len, 0L) : std::min(end, len);
+            for (long i = start; (i < end); i += s.stride)
+              evaluate(*(items[i]), step + 1, result);
+          }
+          else
+          {
+            long  start = s.hasStart ? s.start : (len - 1);
+            long  end = s.hasEnd ? s.end : (-len - 1);
+            start = (start < 0) ? (start + len) : start;
+            end = (end < 0) ? (end + len) : end;
+            start = std::min(std::max(start, -1L), len - 1);
+            end = std::min(std::max(end, -1L), len - 1);
+            for (long i = start; (end < i); i += s.stride)
+              evaluate(*(items[i]), step + 1, result);
+          }
+          break;
+
+        default :
+          for (long i = 0; (i < len); i++)
+            if ((s.type == SELECT_WILDCARD) || test(s.filter, *(items[i])))
+              evaluate(*(items[i]), step + 1, result);
+          break;
+      }                          // selector switch
+    }                            // array
+  }
+
+  bool Json_Path::selects(Step const &step, std::string const *pName
+    , size_t index) const
+  {
+    switch (step.type)
+    {
+      case SELECT_WILDCARD :
+        return true;
+
+      case SELECT_KEYS :
+        if (pName)
+        {
+          for (size_t i = 0; (i < step.names.size()); i++)
+            if (step.names[i] == *pName)
+              return true;
+        }
+        else
+        {
+          for (size_t i = 0; (i < step.indexes.size()); i++)
+            if (static_cast<size_t>(step.indexes[i]) == index)
+              return true;
+        }
+        return false;
+
+      case SELECT_SLICE :
+      {
+        if (pName)
+          return false;
+        size_t const  start = step.hasStart ? step.start : 0;
+        return (index >= start)
+          && (!step.hasEnd || (index < static_cast<size_t>(step.end)))
+          && !((index - start) % step.stride);
+      }
+
+      default :
+        return false;
+    }
+  }
+
+  bool Json_Path::test(size_t node, Value const &candidate) const
+  {
+    Filter_Node const &n = nodes_[node];
+    switch (n.op)
+    {
+      case FILTER_OR :
+        return test(n.left, candidate) || test(n.right, candidate);
+
+      case FILTER_AND :
+        return test(n.left, candidate) && test(n.right, candidate);
+
+      case FILTER_NOT :
+        return !test(n.left, candidate);
+
+      case FILTER_EXISTS :
+        return operands_[n.left].path.resolve(candidate) != 0;
+
+      default :
+        return compare(n.op, operands_[n.left], operands_[n.right]
+          , candidate);
+    }
+  }
+
+  bool Json_Path::compare(Filter_Op op, Operand const &left
+    , Operand const &right, Value const &candidate) const
+  {
+    Term  terms[2];
+    Operand const *operands[2] = { &left, &right };
+    for (int i = 0; (i < 2); i++)
+    {
+      Operand const &o = *(operands[i]);
+      if (o.isPath)
+      {
+        terms[i] = valueTerm(o.path.resolve(candidate));
+        continue;
+      }
+      terms[i] = valueTerm(0);
+      switch (o.type)
+      {
+        case Value::TYPE_BOOLEAN :
+          terms[i].kind = Term::BOOLEAN;
+          terms[i].boolean = o.boolean;
+          break;
+
+        case Value::TYPE_NUMBER :
+          terms[i].kind = Term::NUMBER;
+          terms[i].number = o.number;
+          break;
+
+        case Value::TYPE_STRING :
+          terms[i].kind = Term::STRING;
+          terms[i].pText = &(o.text);
+          break;
+
+        default :
+          terms[i].kind = Term::NUL;
+          break;
+      }
+    }
+
+    switch (op)
+    {
+      case FILTER_EQ :
+        return equal(terms[0], terms[1]);
+
+      case FILTER_NE :
+        return !equal(terms[0], terms[1]);
+
+      case FILTER_LT :
+        return lower(terms[0], terms[1]);
+
+      case FILTER_LE :
+        return lower(terms[0], terms[1]) || equal(terms[0], terms[1]);
+
+      case FILTER_GT :
+        return lower(terms[1], terms[0]);
+
+      default :
+        return lower(terms[1], terms[0]) || equal(terms[0], terms[1]);
+    }
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
@@ -0,0 +1,338 @@
+
+/*
+ * jaula_json_path.h : JSON Analysis User Library Acronym
+ * JSONPath query definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_JSON_PATH_H_
+#define _JAULA_JSON_PATH_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <jaula/jaula_json_pointer.h>
+#include <jaula/jaula_syntax_error.h>
+#include <jaula/jaula_value.h>
+
+/**
+ * \addtogroup jaula_val JAULA: JSON Values containers
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Compiled JSONPath query
+   *
+   * \ingroup jaula_val
+   *
+   * \par
+   * This class holds a JSONPath query compiled into a sequence of steps.
+   * The query is parsed once at construction time and the resulting plan
+   * can be run against any number of value trees by means of select() or
+   * over the events produced by a parser through a Json_Path_Matcher.
+   *
+   * \par
+   * The supported syntax is:
+   * - $ for the root value.
+   * - .name or ['name'] for object properties.
+   * - [n] for array items, negative indexes counting from the end.
+   * - [start:end:step] for array slices.
+   * - * or [*] for every item or property.
+   * - ['a','b',0] for unions of names and indexes.
+   * - .. before any of the above for recursive descent.
+   * - [?(expression)] for filters, where the expression combines
+   *   relative paths (@, @.name, @[n]) and literals (numbers, quoted
+   *   strings, true, false, null) with ==, !=, <, <=, >, >=, &&, || and !.
+   *   A relative path alone tests for the existence of the value.
+   *
+   * \par
+   * Results are returned in document order for arrays and in name order for
+   * object properties.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Json_Path
+  {                              // class Json_Path
+    public:
+
+      /**
+       * \brief Constructor
+       *
+       * \param path JSONPath query.
+       *
+       * \exception Syntax_Error
+       * This exception is launched if the query is malformed or uses
+       * unsupported constructions.
+       */
+      Json_Path(std::string const &path) throw(Syntax_Error);
+
+      /**
+       * \brief Retrieves the textual representation of the query
+       */
+      std::string const &getPath(void) const;
+
+      /**
+       * \brief Number of steps in the compiled plan
+       */
+      size_t size(void) const;
+
+      /**
+       * \brief Runs the query against a value tree
+       *
+       * \param root Value the query starts from.
+       *
+       * \param result Container where the selected values are appended.
+       * The values are still owned by the tree.
+       */
+      void select(Value const &root, std::vector<Value const *> &result)
+        const;
+
+    private:
+
+      friend class Json_Path_Matcher;
+
+      /**
+       * \brief Kinds of selectors
+       */
+      enum Selector_Type
+      {                          // enum Selector_Type
+        /** object properties by name and array items by index */
+        SELECT_KEYS
+        /** every property or item */
+        ,   SELECT_WILDCARD
+        /** array slice */
+        ,   SELECT_SLICE
+        /** items or properties accepted by a filter */
+        ,   SELECT_FILTER
+      };                         // enum Selector_Type
+
+      /**
+       * \brief Operations in filter expressions
+       */
+      enum Filter_Op
+      {                          // enum Filter_Op
+        FILTER_OR
+        ,   FILTER_AND
+        ,   FILTER_NOT
+        ,   FILTER_EXISTS
+        ,   FILTER_EQ
+        ,   FILTER_NE
+        ,   FILTER_LT
+        ,   FILTER_LE
+        ,   FILTER_GT
+        ,   FILTER_GE
+      };                         // enum Filter_Op
+
+      /**
+       * \brief Compiled query step
+       */
+      struct Step
+      {                          // struct Step
+        /** kind of selector */
+        Selector_Type   type;
+        /** flag for recursive descent */
+        bool    recursive;
+        /** flag for steps that need the whole array when streaming */
+        bool    whole;
+        /** names selected (SELECT_KEYS) */
+        std::vector<std::string>  names;
+        /** indexes selected (SELECT_KEYS) */
+        std::vector<long> indexes;
+        /** slice start (SELECT_SLICE) */
+        long    start;
+        /** slice end (SELECT_SLICE) */
+        long    end;
+        /** slice step (SELECT_SLICE) */
+        long    stride;
+        /** flag for slice start given */
+        bool    hasStart;
+        /** flag for slice end given */
+        bool    hasEnd;
+        /** root expression node (SELECT_FILTER) */
+        size_t  filter;
+      };                         // struct Step
+
+      /**
+       * \brief Operand in filter expressions
+       */
+      struct Operand
+      {                          // struct Operand
+        /** flag for relative paths (literal otherwise) */
+        bool    isPath;
+        /** relative path */
+        Json_Pointer  path;
+        /** literal type */
+        Value::ValueType  type;
+        /** boolean literal */
+        bool    boolean;
+        /** number literal */
+        double  number;
+        /** string literal */
+        std::string text;
+      };                         // struct Operand
+
+      /**
+       * \brief Node in filter expressions
+       */
+      struct Filter_Node
+      {                          // struct Filter_Node
+        /** operation */
+        Filter_Op   op;
+        /** left node (logical operations) or operand (the others) */
+        size_t  left;
+        /** right node (logical operations) or operand (comparisons) */
+        size_t  right;
+      };                         // struct Filter_Node
+
+      /**
+       * \brief Parses the query text
+       */
+      void compile(void) throw(Syntax_Error);
+
+      /**
+       * \brief Parses a bracketed selector
+       */
+      void parseBracket(size_t &pos, Step &step) throw(Syntax_Error);
+
+      /**
+       * \brief Parses a filter || expression
+       *
+       * \returns the index of the expression node.
+       */
+      size_t parseOr(size_t &pos) throw(Syntax_Error);
+
+      /**
+       * \brief Parses a filter && expression
+       */
+      size_t parseAnd(size_t &pos) throw(Syntax_Error);
+
+      /**
+       * \brief Parses a filter ! expression, comparison or existence test
+       */
+      size_t parseUnary(size_t &pos) throw(Syntax_Error);
+
+      /**
+       * \brief Parses a filter operand
+       *
+       * \returns the index of the operand.
+       */
+      size_t parseOperand(size_t &pos) throw(Syntax_Error);
+
+      /**
+       * \brief Parses a quoted string
+       */
+      std::string parseQuoted(size_t &pos) throw(Syntax_Error);
+
+      /**
+       * \brief Parses a name in dotted notation
+       */
+      std::string parseName(size_t &pos) throw(Syntax_Error);
+
+      /**
+       * \brief Parses an optionally signed integer
+       *
+       * \returns false if there is no integer at the position.
+       */
+      bool parseInteger(size_t &pos, long &value) throw(Syntax_Error);
+
+      /**
+       * \brief Skips white space
+       */
+      void skipBlanks(size_t &pos) const;
+
+      /**
+       * \brief Launches a Syntax_Error for the query
+       */
+      void fail(char const *detail, size_t pos) const throw(Syntax_Error);
+
+      /**
+       * \brief Runs the plan from one step on
+       *
+       * \param node Value the step is applied to.
+       *
+       * \param step First step to run.
+       *
+       * \param result Container for the selected values.
+       */
+      void evaluate(Value const &node, size_t step
+        , std::vector<Value const *> &result) const;
+
+      /**
+       * \brief Applies one step to a value, without recursive descent, and
+       * runs the rest of the plan on the values selected
+       */
+      void apply(Value const &node, size_t step
+        , std::vector<Value const *> &result) const;
+
+      /**
+       * \brief Checks if a step selects an array item or object property
+       *
+       * \param step Step to check.
+       *
+       * \param pName Property name or NULL for array items.
+       *
+       * \param index Array index.
+       */
+      bool selects(Step const &step, std::string const *pName, size_t index)
+        const;
+
+      /**
+       * \brief Evaluates a filter expression node
+       */
+      bool test(size_t node, Value const &candidate) const;
+
+      /**
+       * \brief Evaluates a comparison
+       */
+      bool compare(Filter_Op op, Operand const &left, Operand const &right
+        , Value const &candidate) const;
+
+      /**
+       * \brief Textual representation
+       */
+      std::string path_;
+
+      /**
+       * \brief Compiled steps
+       */
+      std::vector<Step> steps_;
+
+      /**
+       * \brief Filter expression nodes
+       */
+      std::vector<Filter_Node>  nodes_;
+
+      /**
+       * \brief Filter operands
+       */
+      std::vector<Operand>  operands_;
+  };                             // class Json_Path
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
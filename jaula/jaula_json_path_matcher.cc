@@ -0,0 +1,364 @@
+
+/*
+ * jaula_json_path_matcher.cc : JSON Analysis User Library Acronym
+ * Streaming JSONPath evaluation implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+}
+
+
+#ifdef HAVE_MEMORY
+#include <memory>
+#endif
+
+#include <jaula/jaula_json_path_matcher.h>
+#include <jaula/jaula_value_boolean.h>
+#include <jaula/jaula_value_null.h>
+#include <jaula/jaula_value_number.h>
+#include <jaula/jaula_value_number_int.h>
+#include <jaula/jaula_value_string.h>
+#include <jaula/jaula_value_walker.h>
+
+namespace
+{                                // anonymous namespace
+
+  /**
+   * \brief Inserts a step in a sorted set of steps
+   */
+  void addState(std::vector<size_t> &states, size_t step)
+  {
+    std::vector<size_t>::iterator it = states.begin();
+    while ((it != states.end()) && (*it < step))
+      it++;
+    if ((it == states.end()) || (*it != step))
+      states.insert(it, step);
+  }
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Json_Path_Matcher::Json_Path_Matcher(Json_Path const &path)
+    : Parse_Handler()
+    , path_(path)
+    , frames_()
+    , depth_(0)
+    , states_()
+    , matched_(false)
+    , captures_()
+    , pool_()
+    , selected_()
+    , matches_()
+    , pFailed_(0)
+    {}
+
+  Json_Path_Matcher::~Json_Path_Matcher()
+  {
+    reset();
+    for (size_t i = 0; (i < pool_.size()); i++)
+      delete pool_[i];
+  }
+
+  bool Json_Path_Matcher::nullValue(void)
+  {
+    enter(false);
+    if (!matched_ && captures_.empty())
+      return true;
+    Value_Null  value;
+    return scalar(value);
+  }
+
+  bool Json_Path_Matcher::booleanValue(bool data)
+  {
+    enter(false);
+    if (!matched_ && captures_.empty())
+      return true;
+    Value_Boolean value(data);
+    return scalar(value);
+  }
+
+  bool Json_Path_Matcher::numberValue(double data)
+  {
+    enter(false);
+    if (!matched_ && captures_.empty())
+      return true;
+    Value_Number  value(data);
+    return scalar(value);
+  }
+
+  bool Json_Path_Matcher::numberIntValue(int64_t data)
+  {
+    enter(false);
+    if (!matched_ && captures_.empty())
+      return true;
+    Value_Number_Int  value(data);
+    return scalar(value);
+  }
+
+  bool Json_Path_Matcher::numberUnsignedValue(uint64_t data)
+  {
+    enter(false);
+    if (!matched_ && captures_.empty())
+      return true;
+    Value_Number_Int  value;
+    value.setUnsigned(data);
+    return scalar(value);
+  }
+
+  bool Json_Path_Matcher::numberTextValue(std::string const &data)
+  {
+    enter(false);
+    if (!matched_ && captures_.empty())
+      return true;
+    std::auto_ptr<Value> pValue(Value::numberFromText(data));
+    return scalar(*pValue);
+  }
+
+  bool Json_Path_Matcher::stringValue(std::string const &data)
+  {
+    enter(false);
+    if (!matched_ && captures_.empty())
+      return true;
+    Value_String  value(data);
+    return scalar(value);
+  }
+
+  bool Json_Path_Matcher::arrayBegin(void)
+  {
+    enter(true);
+    frames_[depth_ - 1].isArray = true;
+    for (size_t i = 0; (i < captures_.size()); i++)
+      if (!captures_[i].pBuilder->arrayBegin())
+        return failed(i);
+    return true;
+  }
+
+  bool Json_Path_Matcher::arrayEnd(void)
+  {
+    for (size_t i = 0; (i < captures_.size()); i++)
+      if (!captures_[i].pBuilder->arrayEnd())
+        return failed(i);
+    if (depth_)
+      depth_--;
+    return complete();
+  }
+
+  bool Json_Path_Matcher::objectBegin(void)
+  {
+    enter(true);
+    frames_[depth_ - 1].isArray = false;
+    for (size_t i = 0; (i < captures_.size()); i++)
+      if (!captures_[i].pBuilder->objectBegin())
+        return failed(i);
+    return true;
+  }
+
+  bool Json_Path_Matcher::propertyName(std::string const &name)
+  {
+    if (depth_)
+      frames_[depth_ - 1].name = name;
+    for (size_t i = 0; (i < captures_.size()); i++)
+      if (!captures_[i].pBuilder->propertyName(name))
+        return failed(i);
+    return true;
+  }
+
+  bool Json_Path_Matcher::objectEnd(void)
+  {
+    for (size_t i = 0; (i < captures_.size()); i++)
+      if (!captures_[i].pBuilder->objectEnd())
+        return failed(i);
+    if (depth_)
+      depth_--;
+    return complete();
+  }
+
+  Exception const *Json_Path_Matcher::getErrorReport(void) const
+  {
+    return pFailed_ ? pFailed_->getErrorReport() : 0;
+  }
+
+  std::vector<Value *> const &Json_Path_Matcher::getMatches(void) const
+  {
+    return matches_;
+  }
+
+  void Json_Path_Matcher::reset(void)
+  {
+    for (size_t i = 0; (i < captures_.size()); i++)
+    {
+      captures_[i].pBuilder->reset();
+      pool_.push_back(captures_[i].pBuilder);
+    }
+    captures_.clear();
+    for (size_t i = 0; (i < matches_.size()); i++)
+      delete matches_[i];
+    matches_.clear();
+    delete pFailed_;
+    pFailed_ = 0;
+    depth_ = 0;
+  }
+
+  bool Json_Path_Matcher::match(Value const &value)
+  {
+    matches_.push_back(Value::duplicate(value));
+    return true;
+  }
+
+  void Json_Path_Matcher::enter(bool container)
+  {
+    if (frames_.size() <= depth_)
+      frames_.resize(depth_ + 1);
+
+    states_.clear();
+    matched_ = false;
+    if (!depth_)
+      states_.push_back(0);
+    else
+    {                            // item of a container
+      Frame &parent = frames_[depth_ - 1];
+      std::string const *pName = parent.isArray ? 0 : &(parent.name);
+      size_t const  index = parent.isArray ? parent.index++ : 0;
+      for (size_t i = 0; (i < parent.states.size()); i++)
+      {
+        size_t const  k = parent.states[i];
+        Json_Path::Step const &step = path_.steps_[k];
+        if (step.recursive)
+          addState(states_, k);
+        if (step.type == Json_Path::SELECT_FILTER)
+          capture(k, true);
+        else if (!step.whole && path_.selects(step, pName, index))
+          addState(states_, k + 1);
+      }
+    }                            // item of a container
+
+    size_t const  last = path_.steps_.size();
+    for (size_t i = 0; (i < states_.size()); )
+    {
+      size_t const  k = states_[i];
+      if (k == last)
+      {
+        matched_ = true;
+        states_.erase(states_.begin() + i);
+        continue;
+      }
+      if (path_.steps_[k].whole && container)
+      {
+        capture(k, false);
+        if (!path_.steps_[k].recursive)
+        {
+          states_.erase(states_.begin() + i);
+          continue;
+        }
+      }
+      i++;
+    }
+
+    if (!container)
+      return;
+    if (matched_)
+      capture(last, false);
+    Frame &frame = frames_[depth_++];
+    frame.states.swap(states_);
+    frame.index = 0;
+    frame.name.clear();
+  }
+
+  void Json_Path_Matcher::capture(size_t step, bool filter)
+  {
+    Capture c;
+    if (pool_.empty())
+      c.pBuilder = new Value_Builder();
+    else
+    {
+      c.pBuilder = pool_.back();
+      pool_.pop_back();
+    }
+    c.step = step;
+    c.filter = filter;
+    captures_.push_back(c);
+  }
+
+  bool Json_Path_Matcher::scalar(Value const &value)
+  {
+    for (size_t i = 0; (i < captures_.size()); i++)
+      if (!Value_Walker::walk(value, *(captures_[i].pBuilder)))
+        return failed(i);
+    if (matched_ && !match(value))
+      return false;
+    return complete();
+  }
+
+  bool Json_Path_Matcher::complete(void)
+  {
+    size_t  first = captures_.size();
+    while (first && captures_[first - 1].pBuilder->complete())
+      first--;
+
+    bool  accepted = true;
+    for (size_t i = first; (i < captures_.size()); i++)
+    {                            // completed captures loop
+      Capture const &c = captures_[i];
+      if (accepted)
+      {
+        Value const *pValue = c.pBuilder->getValue();
+        selected_.clear();
+        if (c.filter)
+        {
+          if (path_.test(path_.steps_[c.step].filter, *pValue))
+            path_.evaluate(*pValue, c.step + 1, selected_);
+        }
+        else if (c.step == path_.steps_.size())
+          selected_.push_back(pValue);
+        else
+          path_.apply(*pValue, c.step, selected_);
+
+        for (size_t j = 0; (accepted && (j < selected_.size())); j++)
+          accepted = match(*(selected_[j]));
+      }
+      c.pBuilder->reset();
+      pool_.push_back(c.pBuilder);
+    }                            // completed captures loop
+    captures_.resize(first);
+    return accepted;
+  }
+
+  bool Json_Path_Matcher::failed(size_t capture)
+  {
+    delete pFailed_;
+    pFailed_ = captures_[capture].pBuilder;
+    captures_.erase(captures_.begin() + capture);
+    return false;
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
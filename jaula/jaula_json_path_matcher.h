@@ -0,0 +1,314 @@
+
+/*
+ * jaula_json_path_matcher.h : JSON Analysis User Library Acronym
+ * Streaming JSONPath evaluation definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_JSON_PATH_MATCHER_H_
+#define _JAULA_JSON_PATH_MATCHER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <jaula/jaula_exception.h>
+#include <jaula/jaula_json_path.h>
+#include <jaula/jaula_parse_handler.h>
+#include <jaula/jaula_value.h>
+#include <jaula/jaula_value_builder.h>
+
+/**
+ * \addtogroup jaula_parse JAULA: JSON data parser
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Parsing events handler that runs a JSONPath query
+   *
+   * \ingroup jaula_parse
+   *
+   * \par
+   * This class evaluates a compiled Json_Path over the events produced by
+   * a parser, without building the document. Scalar values selected are
+   * reported as they are parsed, and only arrays or objects selected are
+   * built, so memory use depends on the size of the results and not on the
+   * size of the input.
+   *
+   * \par
+   * Steps that can not be decided from the events seen so far fall back to
+   * building part of the document: filters build each candidate item
+   * before testing it, and negative indexes or slices build the whole
+   * array they apply to. The rest of the query is then run on the values
+   * built.
+   *
+   * \par
+   * Every value selected is passed to match(), which by default keeps a
+   * copy available through getMatches(). Derived classes can override it to
+   * process the results as they arrive. Values are reported when their
+   * last event is received, so results nested inside other results are
+   * reported before them.
+   *
+   * \par
+   * Several documents can be processed in sequence with the same instance.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Json_Path_Matcher : public Parse_Handler
+  {                              // class Json_Path_Matcher
+    public:
+
+      /**
+       * \brief Constructor
+       *
+       * \param path Query to run. The instance keeps its own copy.
+       */
+      Json_Path_Matcher(Json_Path const &path);
+
+      /**
+       * \brief Destructor
+       */
+      virtual ~Json_Path_Matcher();
+
+      /**
+       * \brief Processes a null value
+       */
+      virtual bool nullValue(void);
+
+      /**
+       * \brief Processes a boolean value
+       */
+      virtual bool booleanValue(bool data);
+
+      /**
+       * \brief Processes a floating point number
+       */
+      virtual bool numberValue(double data);
+
+      /**
+       * \brief Processes an integer number
+       */
+      virtual bool numberIntValue(int64_t data);
+
+      /**
+       * \brief Processes an unsigned integer number
+       */
+      virtual bool numberUnsignedValue(uint64_t data);
+
+      /**
+       * \brief Processes a number kept by its decimal text
+       */
+      virtual bool numberTextValue(std::string const &data);
+
+      /**
+       * \brief Processes a string
+       */
+      virtual bool stringValue(std::string const &data);
+
+      /**
+       * \brief Processes the start of an array
+       */
+      virtual bool arrayBegin(void);
+
+      /**
+       * \brief Processes the end of an array
+       */
+      virtual bool arrayEnd(void);
+
+      /**
+       * \brief Processes the start of an object
+       */
+      virtual bool objectBegin(void);
+
+      /**
+       * \brief Processes the name for the next value
+       */
+      virtual bool propertyName(std::string const &name);
+
+      /**
+       * \brief Processes the end of an object
+       */
+      virtual bool objectEnd(void);
+
+      /**
+       * \brief Retrieves the error that stopped the process
+       */
+      virtual Exception const *getErrorReport(void) const;
+
+      /**
+       * \brief Retrieves the values kept by the default match()
+       */
+      std::vector<Value *> const &getMatches(void) const;
+
+      /**
+       * \brief Discards the values kept and any document in progress
+       */
+      void reset(void);
+
+    protected:
+
+      /**
+       * \brief Receives each value selected
+       *
+       * \param value Value selected. It is only valid during the call.
+       *
+       * \returns true to go on or false to stop the process.
+       *
+       * \par Description
+       * The default implementation keeps a copy of the value.
+       */
+      virtual bool match(Value const &value);
+
+    private:
+
+      /**
+       * \brief Copy constructor (not available)
+       */
+      Json_Path_Matcher(Json_Path_Matcher const &orig);
+
+      /**
+       * \brief Assignment operator (not available)
+       */
+      Json_Path_Matcher &operator=(Json_Path_Matcher const &orig);
+
+      /**
+       * \brief Array or object being parsed
+       */
+      struct Frame
+      {                          // struct Frame
+        /** steps to apply to the items (sorted) */
+        std::vector<size_t> states;
+        /** flag for arrays */
+        bool    isArray;
+        /** index for the next array item */
+        size_t  index;
+        /** name for the next object property */
+        std::string name;
+      };                         // struct Frame
+
+      /**
+       * \brief Value being built
+       */
+      struct Capture
+      {                          // struct Capture
+        /** builder receiving the events */
+        Value_Builder   *pBuilder;
+        /** step to apply once built */
+        size_t  step;
+        /** flag for filter tests */
+        bool    filter;
+      };                         // struct Capture
+
+      /**
+       * \brief Computes the steps for a new value
+       *
+       * \param container Flag for arrays and objects.
+       *
+       * \par Description
+       * Sets matched_, starts any capture needed and, for containers,
+       * pushes a new frame.
+       */
+      void enter(bool container);
+
+      /**
+       * \brief Starts building a value
+       */
+      void capture(size_t step, bool filter);
+
+      /**
+       * \brief Processes a scalar value once entered
+       */
+      bool scalar(Value const &value);
+
+      /**
+       * \brief Processes the captures completed
+       *
+       * \returns false if the process must stop.
+       */
+      bool complete(void);
+
+      /**
+       * \brief Records a capture that failed
+       *
+       * \returns false.
+       */
+      bool failed(size_t capture);
+
+      /**
+       * \brief Query being run
+       */
+      Json_Path   path_;
+
+      /**
+       * \brief Frames for the arrays and objects open (reused)
+       */
+      std::vector<Frame>  frames_;
+
+      /**
+       * \brief Number of frames in use
+       */
+      size_t  depth_;
+
+      /**
+       * \brief Steps for the value being entered
+       */
+      std::vector<size_t> states_;
+
+      /**
+       * \brief Flag for the value being entered selected by the query
+       */
+      bool    matched_;
+
+      /**
+       * \brief Values being built, innermost last
+       */
+      std::vector<Capture>  captures_;
+
+      /**
+       * \brief Builders available for new captures
+       */
+      std::vector<Value_Builder *>  pool_;
+
+      /**
+       * \brief Scratch container for tree evaluation results
+       */
+      std::vector<Value const *>  selected_;
+
+      /**
+       * \brief Values kept by the default match()
+       */
+      std::vector<Value *>  matches_;
+
+      /**
+       * \brief Builder that stopped the process
+       */
+      Value_Builder   *pFailed_;
+  };                             // class Json_Path_Matcher
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
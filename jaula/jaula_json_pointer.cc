@@ -0,0 +1,249 @@
+
+/*
+ * jaula_json_pointer.cc : JSON Analysis User Library Acronym
+ * JSON Pointer implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+}
+
+
+#include <jaula/jaula_json_pointer.h>
+#include <jaula/jaula_value_array.h>
+#include <jaula/jaula_value_object.h>
+
+namespace
+{                                // anonymous namespace
+
+  /**
+   * \brief Converts a reference token into an array index
+   *
+   * \returns the index or JAULA::Json_Pointer::NO_INDEX if the token is not
+   * a decimal number without leading zeros or it does not fit in a size_t.
+   */
+  size_t tokenIndex(std::string const &token)
+  {
+    size_t const len = token.size();
+    if (!len || ((len > 1) && (token[0] == '0')))
+      return JAULA::Json_Pointer::NO_INDEX;
+    size_t index = 0;
+    for (size_t i = 0; (i < len); i++)
+    {
+      if ((token[i] < '0') || (token[i] > '9'))
+        return JAULA::Json_Pointer::NO_INDEX;
+      size_t const digit = token[i] - '0';
+      if (index > (JAULA::Json_Pointer::NO_INDEX - 1 - digit) / 10)
+        return JAULA::Json_Pointer::NO_INDEX;
+      index = index * 10 + digit;
+    }
+    return index;
+  }
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  size_t const Json_Pointer::NO_INDEX = static_cast<size_t>(-1);
+
+  Json_Pointer::Json_Pointer(void)
+    : pointer_()
+    , tokens_()
+    , indexes_()
+    {}
+
+  Json_Pointer::Json_Pointer(std::string const &pointer) throw(Syntax_Error)
+    : pointer_(pointer)
+    , tokens_()
+    , indexes_()
+  {
+    try
+    {
+      compile();
+    }
+    catch(Syntax_Error &ex)
+    {
+      ex.addOrigin("Json_Pointer::Json_Pointer(std::string const &)");
+      throw ex;
+    }
+  }
+
+  Json_Pointer::Json_Pointer(char const *pointer) throw(Syntax_Error)
+    : pointer_(pointer ? pointer : "")
+    , tokens_()
+    , indexes_()
+  {
+    try
+    {
+      compile();
+    }
+    catch(Syntax_Error &ex)
+    {
+      ex.addOrigin("Json_Pointer::Json_Pointer(char const *)");
+      throw ex;
+    }
+  }
+
+  std::string const &Json_Pointer::getPointer(void) const
+  {
+    return pointer_;
+  }
+
+  size_t Json_Pointer::size(void) const
+  {
+    return tokens_.size();
+  }
+
+  std::string const &Json_Pointer::getToken(size_t pos) const
+  {
+    return tokens_[pos];
+  }
+
+  size_t Json_Pointer::getIndex(size_t pos) const
+  {
+    return indexes_[pos];
+  }
+
+  Json_Pointer &Json_Pointer::append(std::string const &token)
+  {
+    pointer_ += '/';
+    pointer_ += escape(token);
+    tokens_.push_back(token);
+    indexes_.push_back(tokenIndex(token));
+    return *this;
+  }
+
+  Json_Pointer &Json_Pointer::append(size_t index)
+  {
+    std::string token;
+    do
+    {
+      token.insert(token.begin(), static_cast<char>('0' + (index % 10)));
+      index /= 10;
+    } while (index);
+    return append(token);
+  }
+
+  Value const *Json_Pointer::resolve(Value const &root) const
+  {
+    return resolve(root, tokens_.size());
+  }
+
+  Value *Json_Pointer::resolve(Value &root) const
+  {
+    return resolve(root, tokens_.size());
+  }
+
+  Value const *Json_Pointer::resolve(Value const &root, size_t count) const
+  {
+    Value const *current = &root;
+    for (size_t i = 0; (current && (i < count)); i++)
+    {
+      switch (current->getType())
+      {
+        case Value::TYPE_OBJECT:
+          current = static_cast<Value_Object const *>(current)
+            ->getItem(tokens_[i]);
+          break;
+
+        case Value::TYPE_ARRAY:
+          current = (indexes_[i] == NO_INDEX) ? 0
+            : static_cast<Value_Array const *>(current)->getItem(indexes_[i]);
+          break;
+
+        default:
+          current = 0;
+          break;
+      }
+    }
+    return current;
+  }
+
+  Value *Json_Pointer::resolve(Value &root, size_t count) const
+  {
+    return const_cast<Value *>(resolve(static_cast<Value const &>(root)
+      , count));
+  }
+
+  std::string Json_Pointer::escape(std::string const &token)
+  {
+    if (token.find_first_of("~/") == std::string::npos)
+      return token;
+    std::string result;
+    result.reserve(token.size() + 2);
+    for (std::string::const_iterator it = token.begin()
+      ; (it != token.end())
+      ; it++)
+    {
+      if (*it == '~')
+        result += "~0";
+      else if (*it == '/')
+        result += "~1";
+      else
+        result += *it;
+    }
+    return result;
+  }
+
+  void Json_Pointer::compile(void) throw(Syntax_Error)
+  {
+    if (pointer_.empty())
+      return;
+    if (pointer_[0] != '/')
+      throw Syntax_Error("JSON Pointer does not start with '/'"
+        , "compiling pointer " + pointer_
+        , "Json_Pointer::compile()");
+
+    std::string token;
+    for (size_t i = 1; (i <= pointer_.size()); i++)
+    {
+      if ((i == pointer_.size()) || (pointer_[i] == '/'))
+      {
+        tokens_.push_back(token);
+        indexes_.push_back(tokenIndex(token));
+        token.clear();
+      }
+      else if (pointer_[i] == '~')
+      {
+        char const next = (i + 1 < pointer_.size()) ? pointer_[i + 1] : 0;
+        if ((next != '0') && (next != '1'))
+          throw Syntax_Error("invalid escape sequence in JSON Pointer"
+            , "compiling pointer " + pointer_
+            , "Json_Pointer::compile()");
+        token += (next == '0') ? '~' : '/';
+        i++;
+      }
+      else
+        token += pointer_[i];
+    }
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
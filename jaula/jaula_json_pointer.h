@@ -0,0 +1,236 @@
+
+/*
+ * jaula_json_pointer.h : JSON Analysis User Library Acronym
+ * JSON Pointer definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_JSON_POINTER_H_
+#define _JAULA_JSON_POINTER_H_
+
+#include <string>
+#include <vector>
+
+#include <jaula/jaula_syntax_error.h>
+
+/**
+ * \addtogroup jaula_val JAULA: JSON Values containers
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  class Value;
+
+  /**
+   * \brief Compiled JSON Pointer
+   *
+   * \ingroup jaula_val
+   *
+   * \par
+   * This class holds a JSON Pointer as defined by RFC 6901 already split
+   * into its reference tokens. Escape sequences are decoded and tokens that
+   * can be used as array indexes are converted to numbers at construction
+   * time, so an instance can be resolved against any number of values
+   * without parsing the pointer again.
+   *
+   * \par
+   * Instances can be built implicitly from strings so calls like
+   * root.at("/items/0/price") are valid. Code resolving the same pointer
+   * many times should keep a compiled instance around instead.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Json_Pointer
+  {                              // class Json_Pointer
+    public:
+
+      /**
+       * \brief Index value for tokens that are not valid array indexes
+       */
+      static size_t const NO_INDEX;
+
+      /**
+       * \brief Default Constructor
+       *
+       * \par Description
+       * Builds the empty pointer, which refers to the whole document.
+       */
+      Json_Pointer(void);
+
+      /**
+       * \brief Constructor
+       *
+       * \param pointer Textual representation of the pointer.
+       *
+       * \exception Syntax_Error
+       * This exception is launched if the pointer is not empty and does not
+       * start with '/' or if it contains an invalid escape sequence.
+       */
+      Json_Pointer(std::string const &pointer) throw(Syntax_Error);
+
+      /**
+       * \brief Constructor
+       *
+       * \param pointer Textual representation of the pointer as a
+       * null-terminated string.
+       *
+       * \exception Syntax_Error
+       * This exception is launched if the pointer is not empty and does not
+       * start with '/' or if it contains an invalid escape sequence.
+       */
+      Json_Pointer(char const *pointer) throw(Syntax_Error);
+
+      /**
+       * \brief Retrieves the textual representation of the pointer
+       */
+      std::string const &getPointer(void) const;
+
+      /**
+       * \brief Number of reference tokens
+       */
+      size_t size(void) const;
+
+      /**
+       * \brief Retrieves one reference token with escapes already decoded
+       *
+       * \param pos Position of the token.
+       */
+      std::string const &getToken(size_t pos) const;
+
+      /**
+       * \brief Retrieves the array index for one reference token
+       *
+       * \param pos Position of the token.
+       *
+       * \returns the index or NO_INDEX if the token cannot be used to
+       * address array items.
+       */
+      size_t getIndex(size_t pos) const;
+
+      /**
+       * \brief Appends one reference token
+       *
+       * \param token Token to append without escapes.
+       *
+       * \returns a reference to the instance.
+       */
+      Json_Pointer &append(std::string const &token);
+
+      /**
+       * \brief Appends one array index
+       *
+       * \param index Index to append.
+       *
+       * \returns a reference to the instance.
+       */
+      Json_Pointer &append(size_t index);
+
+      /**
+       * \brief Resolves the pointer against a value
+       *
+       * \param root Value where the resolution starts.
+       *
+       * \returns a pointer to the referenced value or NULL if it does not
+       * exist.
+       */
+      Value const *resolve(Value const &root) const;
+
+      /**
+       * \brief Resolves the pointer against a value
+       *
+       * \param root Value where the resolution starts.
+       *
+       * \returns a pointer to the referenced value or NULL if it does not
+       * exist.
+       */
+      Value *resolve(Value &root) const;
+
+      /**
+       * \brief Resolves the first tokens of the pointer against a value
+       *
+       * \param root Value where the resolution starts.
+       *
+       * \param count Number of tokens to use.
+       *
+       * \returns a pointer to the referenced value or NULL if it does not
+       * exist.
+       *
+       * \par Description
+       * Using all but the last token gives the container of the value the
+       * pointer refers to.
+       */
+      Value const *resolve(Value const &root, size_t count) const;
+
+      /**
+       * \brief Resolves the first tokens of the pointer against a value
+       *
+       * \param root Value where the resolution starts.
+       *
+       * \param count Number of tokens to use.
+       *
+       * \returns a pointer to the referenced value or NULL if it does not
+       * exist.
+       */
+      Value *resolve(Value &root, size_t count) const;
+
+      /**
+       * \brief Escapes a reference token
+       *
+       * \param token Token to escape.
+       *
+       * \returns the token with '~' and '/' written as "~0" and "~1".
+       */
+      static std::string escape(std::string const &token);
+
+    private:
+
+      /**
+       * \brief Decodes the textual representation into tokens
+       *
+       * \exception Syntax_Error
+       * This exception is launched if the pointer is malformed.
+       */
+      void compile(void) throw(Syntax_Error);
+
+      /**
+       * \brief Textual representation
+       */
+      std::string                 pointer_;
+
+      /**
+       * \brief Reference tokens with escapes decoded
+       */
+      std::vector<std::string>    tokens_;
+
+      /**
+       * \brief Array index for each token or NO_INDEX
+       */
+      std::vector<size_t>         indexes_;
+  };                             // class Json_Pointer
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
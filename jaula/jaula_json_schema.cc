@@ -0,0 +1,785 @@
+
+/*
+ * jaula_json_schema.cc : JSON Analysis User Library Acronym
+ * Compiled JSON Schema implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_MATH_H
+#include <math.h>
+#endif
+
+#ifdef HAVE_REGEX_H
+#include <regex.h>
+#endif
+}
+
+#ifdef HAVE_ALGORITHM
+#include <algorithm>
+#endif
+
+#ifdef HAVE_SSTREAM
+#include <sstream>
+#endif
+
+#include <jaula/jaula_bad_data_type.h>
+#include <jaula/jaula_json_schema.h>
+#include <jaula/jaula_syntax_error.h>
+#include <jaula/jaula_value_array.h>
+#include <jaula/jaula_value_boolean.h>
+#include <jaula/jaula_value_number.h>
+#include <jaula/jaula_value_number_int.h>
+#include <jaula/jaula_value_object.h>
+#include <jaula/jaula_value_string.h>
+
+namespace
+{                                // anonymous namespace
+
+  /**
+   * \brief Value for unlimited counts
+   */
+  size_t const NO_LIMIT = static_cast<size_t>(-1);
+
+  /**
+   * \brief Type mask flag for floating point numbers with integral values
+   */
+  unsigned int const INTEGRAL = 1 << 8;
+
+  /**
+   * \brief Type mask flag for a value type
+   */
+  unsigned int typeBit(JAULA::Value::ValueType type)
+  {
+    return 1 << type;
+  }
+
+  /**
+   * \brief Type mask for a JSON Schema type name
+   *
+   * \returns the mask or 0 if the name is unknown.
+   */
+  unsigned int typeMask(std::string const &name)
+  {
+    if (name == "null")
+      return typeBit(JAULA::Value::TYPE_NULL);
+    if (name == "boolean")
+      return typeBit(JAULA::Value::TYPE_BOOLEAN);
+    if (name == "integer")
+      return typeBit(JAULA::Value::TYPE_NUMBER_INT) | INTEGRAL;
+    if (name == "number")
+      return typeBit(JAULA::Value::TYPE_NUMBER_INT)
+        | typeBit(JAULA::Value::TYPE_NUMBER);
+    if (name == "string")
+      return typeBit(JAULA::Value::TYPE_STRING);
+    if (name == "array")
+      return typeBit(JAULA::Value::TYPE_ARRAY);
+    if (name == "object")
+      return typeBit(JAULA::Value::TYPE_OBJECT);
+    return 0;
+  }
+
+  /**
+   * \brief Checks whether a value is a number
+   */
+  bool isNumber(JAULA::Value const &value)
+  {
+    return (value.getType() == JAULA::Value::TYPE_NUMBER)
+      || (value.getType() == JAULA::Value::TYPE_NUMBER_INT);
+  }
+
+  /**
+   * \brief Retrieves the contents of a number as floating point
+   */
+  double numberOf(JAULA::Value const &value)
+  {
+    if (value.getType() == JAULA::Value::TYPE_NUMBER_INT)
+    {
+      JAULA::Value_Number_Int const &num =
+        static_cast<JAULA::Value_Number_Int const &>(value);
+      return num.isUnsigned()
+        ? static_cast<double>(num.getUnsigned())
+        : static_cast<double>(num.getInt64());
+    }
+    return static_cast<JAULA::Value_Number const &>(value).getData();
+  }
+
+  /**
+   * \brief Action text for errors found compiling a schema location
+   */
+  std::string compilingAt(JAULA::Json_Pointer const &where)
+  {
+    if (where.getPointer().empty())
+      return "compiling schema root";
+    return "compiling schema at " + where.getPointer();
+  }
+
+  /**
+   * \brief Checks whether a keyword is an annotation without effect
+   */
+  bool isAnnotation(std::string const &keyword)
+  {
+    return (keyword == "$schema") || (keyword == "$id")
+      || (keyword == "$comment") || (keyword == "title")
+      || (keyword == "description") || (keyword == "default")
+      || (keyword == "examples");
+  }
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  struct Json_Schema::Node
+  {                              // struct Json_Schema::Node
+
+    /**
+     * \brief Constructor
+     *
+     * \par Description
+     * Creates a node accepting anything.
+     */
+    Node(void)
+      : types(~0U)
+      , hasMinimum(false)
+      , hasMaximum(false)
+      , hasExclusiveMinimum(false)
+      , hasExclusiveMaximum(false)
+      , minimum(0)
+      , maximum(0)
+      , exclusiveMinimum(0)
+      , exclusiveMaximum(0)
+      , minLength(0)
+      , maxLength(NO_LIMIT)
+      , pPattern(0)
+      , items(ANY)
+      , minItems(0)
+      , maxItems(NO_LIMIT)
+      , names()
+      , nodes()
+      , additional(ANY)
+      , required()
+      , minProperties(0)
+      , maxProperties(NO_LIMIT)
+      , enumeration()
+      {}
+
+    /**
+     * \brief Destructor
+     */
+    ~Node()
+    {
+      if (pPattern)
+      {
+        regfree(pPattern);
+        delete pPattern;
+      }
+      for (std::vector<Value *>::iterator it = enumeration.begin()
+        ; (it != enumeration.end())
+        ; it++)
+        delete *it;
+    }
+
+    /** types allowed as a mask of typeBit() values */
+    unsigned int  types;
+    /** flag for minimum */
+    bool    hasMinimum;
+    /** flag for maximum */
+    bool    hasMaximum;
+    /** flag for exclusiveMinimum */
+    bool    hasExclusiveMinimum;
+    /** flag for exclusiveMaximum */
+    bool    hasExclusiveMaximum;
+    /** inclusive lower limit for numbers */
+    double  minimum;
+    /** inclusive upper limit for numbers */
+    double  maximum;
+    /** exclusive lower limit for numbers */
+    double  exclusiveMinimum;
+    /** exclusive upper limit for numbers */
+    double  exclusiveMaximum;
+    /** minimum number of characters for strings */
+    size_t  minLength;
+    /** maximum number of characters for strings */
+    size_t  maxLength;
+    /** pattern strings must match */
+    regex_t *pPattern;
+    /** node for array items */
+    size_t  items;
+    /** minimum number of array items */
+    size_t  minItems;
+    /** maximum number of array items */
+    size_t  maxItems;
+    /** names with their own node (sorted) */
+    std::vector<std::string>  names;
+    /** nodes for the names */
+    std::vector<size_t> nodes;
+    /** node for the other properties */
+    size_t  additional;
+    /** required property names (sorted) */
+    std::vector<std::string>  required;
+    /** minimum number of object properties */
+    size_t  minProperties;
+    /** maximum number of object properties */
+    size_t  maxProperties;
+    /** values allowed, if not empty */
+    std::vector<Value *>  enumeration;
+
+  private:
+
+    /**
+     * \brief Copy constructor (not available)
+     */
+    Node(Node const &orig);
+
+    /**
+     * \brief Assignment operator (not available)
+     */
+    Node &operator=(Node const &orig);
+  };                             // struct Json_Schema::Node
+
+  size_t const Json_Schema::ANY = 0;
+
+  size_t const Json_Schema::NOTHING = 1;
+
+  Json_Schema::Json_Schema(Value const &schema) throw(Exception)
+    : nodes_()
+    , root_(ANY)
+  {
+    nodes_.push_back(new Node());
+    nodes_.push_back(new Node());
+    nodes_[NOTHING]->types = 0;
+    try
+    {
+      Json_Pointer  where;
+      root_ = compile(schema, where);
+    }
+    catch(Exception &ex)
+    {
+      for (std::vector<Node *>::iterator it = nodes_.begin()
+        ; (it != nodes_.end())
+        ; it++)
+        delete *it;
+      ex.addOrigin("Json_Schema::Json_Schema(Value const &)");
+      throw ex;
+    }
+  }
+
+  Json_Schema::~Json_Schema()
+  {
+    for (std::vector<Node *>::iterator it = nodes_.begin()
+      ; (it != nodes_.end())
+      ; it++)
+      delete *it;
+  }
+
+  bool Json_Schema::validate(Value const &value) const
+  {
+    std::vector<std::string>  where;
+    std::string extra;
+    return !check(root_, value, where, extra);
+  }
+
+  bool Json_Schema::validate(Value const &value, std::string &detail) const
+  {
+    std::vector<std::string>  where;
+    std::string extra;
+    char const *message = check(root_, value, where, extra);
+    if (!message)
+      return true;
+    Json_Pointer  pointer;
+    for (std::vector<std::string>::reverse_iterator it = where.rbegin()
+      ; (it != where.rend())
+      ; it++)
+      pointer.append(*it);
+    detail = describe(message, extra, pointer);
+    return false;
+  }
+
+  size_t Json_Schema::compile(Value const &schema, Json_Pointer &where)
+    throw(Exception)
+  {
+    if (schema.getType() == Value::TYPE_BOOLEAN)
+      return static_cast<Value_Boolean const &>(schema).getData()
+        ? ANY : NOTHING;
+    if (schema.getType() != Value::TYPE_OBJECT)
+      throw Bad_Data_Type("Schema is not an object or a boolean"
+        , compilingAt(where)
+        , "Json_Schema::compile()");
+
+    size_t const index = nodes_.size();
+    nodes_.push_back(new Node());
+    Node &node = *nodes_.back();
+    bool  minimumExclusive = false;
+    bool  maximumExclusive = false;
+
+    Value_Object::dataType const &keywords =
+      static_cast<Value_Object const &>(schema).getData();
+    for (Value_Object::dataType::const_iterator it = keywords.begin()
+      ; (it != keywords.end())
+      ; it++)
+    {                            // keyword loop
+      std::string const &keyword = it->first;
+      Value const &data = *it->second;
+      Json_Pointer  at(where);
+      at.append(keyword);
+
+      if (isAnnotation(keyword))
+        continue;
+
+      if (keyword == "type")
+      {
+        node.types = 0;
+        if (data.getType() == Value::TYPE_STRING)
+          node.types = typeMask(
+            static_cast<Value_String const &>(data).getData());
+        else if (data.getType() == Value::TYPE_ARRAY)
+        {
+          Value_Array::dataType const &names =
+            static_cast<Value_Array const &>(data).getData();
+          for (size_t i = 0; (i < names.size()); i++)
+          {
+            unsigned int  mask = 0;
+            if (names[i]->getType() == Value::TYPE_STRING)
+              mask = typeMask(
+                static_cast<Value_String const *>(names[i])->getData());
+            if (!mask)
+            {
+              node.types = 0;
+              break;
+            }
+            node.types |= mask;
+          }
+        }
+        if (!node.types)
+          throw Bad_Data_Type("Invalid type name"
+            , compilingAt(at)
+            , "Json_Schema::compile()");
+      }
+      else if (keyword == "enum")
+      {
+        if (data.getType() != Value::TYPE_ARRAY)
+          throw Bad_Data_Type("Keyword value is not an array"
+            , compilingAt(at)
+            , "Json_Schema::compile()");
+        Value_Array::dataType const &values =
+          static_cast<Value_Array const &>(data).getData();
+        for (size_t i = 0; (i < values.size()); i++)
+          node.enumeration.push_back(Value::duplicate(*values[i]));
+      }
+      else if ((keyword == "minimum") || (keyword == "maximum")
+        || (keyword == "exclusiveMinimum")
+        || (keyword == "exclusiveMaximum"))
+      {
+        if ((data.getType() == Value::TYPE_BOOLEAN)
+          && (keyword[0] == 'e'))
+        {
+          // earlier drafts make the limit itself exclusive
+          bool const flag = static_cast<Value_Boolean const &>(data)
+            .getData();
+          if (keyword == "exclusiveMinimum")
+            minimumExclusive = flag;
+          else
+            maximumExclusive = flag;
+          continue;
+        }
+        if (!isNumber(data))
+          throw Bad_Data_Type("Keyword value is not a number"
+            , compilingAt(at)
+            , "Json_Schema::compile()");
+        double const limit = numberOf(data);
+        if (keyword == "minimum")
+        {
+          node.hasMinimum = true;
+          node.minimum = limit;
+        }
+        else if (keyword == "maximum")
+        {
+          node.hasMaximum = true;
+          node.maximum = limit;
+        }
+        else if (keyword == "exclusiveMinimum")
+        {
+          node.hasExclusiveMinimum = true;
+          node.exclusiveMinimum = limit;
+        }
+        else
+        {
+          node.hasExclusiveMaximum = true;
+          node.exclusiveMaximum = limit;
+        }
+      }
+      else if ((keyword == "minLength") || (keyword == "maxLength")
+        || (keyword == "minItems") || (keyword == "maxItems")
+        || (keyword == "minProperties") || (keyword == "maxProperties"))
+      {
+        if ((data.getType() != Value::TYPE_NUMBER_INT)
+          || static_cast<Value_Number_Int const &>(data).isUnsigned()
+          || (static_cast<Value_Number_Int const &>(data).getInt64() < 0))
+          throw Bad_Data_Type("Keyword value is not a non-negative integer"
+            , compilingAt(at)
+            , "Json_Schema::compile()");
+        size_t const count = static_cast<size_t>(
+          static_cast<Value_Number_Int const &>(data).getInt64());
+        if (keyword == "minLength")
+          node.minLength = count;
+        else if (keyword == "maxLength")
+          node.maxLength = count;
+        else if (keyword == "minItems")
+          node.minItems = count;
+        else if (keyword == "maxItems")
+          node.maxItems = count;
+        else if (keyword == "minProperties")
+          node.minProperties = count;
+        else
+          node.maxProperties = count;
+      }
+      else if (keyword == "pattern")
+      {
+        if (data.getType() != Value::TYPE_STRING)
+          throw Bad_Data_Type("Keyword value is not a string"
+            , compilingAt(at)
+            , "Json_Schema::compile()");
+        node.pPattern = new regex_t;
+        int const code = regcomp(node.pPattern
+          , static_cast<Value_String const &>(data).getData().c_str()
+          , REG_EXTENDED | REG_NOSUB);
+        if (code)
+        {
+          char  message[256];
+          regerror(code, node.pPattern, message, sizeof(message));
+          delete node.pPattern;
+          node.pPattern = 0;
+          throw Syntax_Error(message
+            , compilingAt(at)
+            , "Json_Schema::compile()");
+        }
+      }
+      else if (keyword == "items")
+      {
+        if (data.getType() == Value::TYPE_ARRAY)
+          throw Bad_Data_Type("Tuple validation is not supported"
+            , compilingAt(at)
+            , "Json_Schema::compile()");
+        node.items = compile(data, at);
+      }
+      else if (keyword == "properties")
+      {
+        if (data.getType() != Value::TYPE_OBJECT)
+          throw Bad_Data_Type("Keyword value is not an object"
+            , compilingAt(at)
+            , "Json_Schema::compile()");
+        Value_Object::dataType const &props =
+          static_cast<Value_Object const &>(data).getData();
+        for (Value_Object::dataType::const_iterator prop = props.begin()
+          ; (prop != props.end())
+          ; prop++)
+        {
+          Json_Pointer  propAt(at);
+          propAt.append(prop->first);
+          node.names.push_back(prop->first);
+          node.nodes.push_back(compile(*prop->second, propAt));
+        }
+      }
+      else if (keyword == "required")
+      {
+        if (data.getType() != Value::TYPE_ARRAY)
+          throw Bad_Data_Type("Keyword value is not an array"
+            , compilingAt(at)
+            , "Json_Schema::compile()");
+        Value_Array::dataType const &names =
+          static_cast<Value_Array const &>(data).getData();
+        for (size_t i = 0; (i < names.size()); i++)
+        {
+          if (names[i]->getType() != Value::TYPE_STRING)
+            throw Bad_Data_Type("Required property name is not a string"
+              , compilingAt(at)
+              , "Json_Schema::compile()");
+          node.required.push_back(
+            static_cast<Value_String const *>(names[i])->getData());
+        }
+        std::sort(node.required.begin(), node.required.end());
+        node.required.erase(std::unique(node.required.begin()
+          , node.required.end()), node.required.end());
+      }
+      else if (keyword == "additionalProperties")
+      {
+        node.additional = compile(data, at);
+      }
+      else
+        throw Bad_Data_Type("Unsupported keyword " + keyword
+          , compilingAt(where)
+          , "Json_Schema::compile()");
+    }                            // keyword loop
+
+    if (minimumExclusive && node.hasMinimum)
+    {
+      node.hasMinimum = false;
+      node.hasExclusiveMinimum = true;
+      node.exclusiveMinimum = node.minimum;
+    }
+    if (maximumExclusive && node.hasMaximum)
+    {
+      node.hasMaximum = false;
+      node.hasExclusiveMaximum = true;
+      node.exclusiveMaximum = node.maximum;
+    }
+    return index;
+  }
+
+  char const *Json_Schema::check(size_t node, Value const &value
+    , std::vector<std::string> &where, std::string &extra) const
+  {
+    Value::ValueType const type = value.getType();
+    double const number = isNumber(value) ? numberOf(value) : 0;
+    char const *message = checkType(node, type, number);
+    if (!message && hasEnum(node))
+      message = checkEnum(node, value);
+    if (message)
+      return message;
+
+    switch (type)
+    {                            // value type switch
+      case Value::TYPE_NUMBER :
+      case Value::TYPE_NUMBER_INT :
+        return checkNumber(node, number);
+
+      case Value::TYPE_STRING :
+        return checkString(node
+          , static_cast<Value_String const &>(value).getData());
+
+      case Value::TYPE_ARRAY :
+      {
+        Value_Array::dataType const &items =
+          static_cast<Value_Array const &>(value).getData();
+        message = checkCount(node, true, items.size(), true);
+        if (message)
+          return message;
+        size_t const child = itemNode(node);
+        if (child == ANY)
+          return 0;
+        for (size_t i = 0; (i < items.size()); i++)
+        {
+          message = check(child, *items[i], where, extra);
+          if (message)
+          {
+            std::ostringstream  index;
+            index << i;
+            where.push_back(index.str());
+            return message;
+          }
+        }
+      }
+      break;
+
+      case Value::TYPE_OBJECT :
+      {
+        Value_Object const &object = static_cast<Value_Object const &>(value);
+        message = checkCount(node, false, object.size(), true);
+        if (message)
+          return message;
+        Node const &n = *nodes_[node];
+        for (size_t i = 0; (i < n.required.size()); i++)
+          if (!object.getItem(n.required[i]))
+          {
+            extra = n.required[i];
+            return "Required property missing";
+          }
+        if (n.names.empty() && (n.additional == ANY))
+          return 0;
+        Value_Object::dataType const &props = object.getData();
+        for (Value_Object::dataType::const_iterator it = props.begin()
+          ; (it != props.end())
+          ; it++)
+        {
+          message = check(propertyNode(node, it->first), *it->second
+            , where, extra);
+          if (message)
+          {
+            where.push_back(it->first);
+            return message;
+          }
+        }
+      }
+      break;
+
+      default :
+        break;
+
+    }                            // value type switch
+    return 0;
+  }
+
+  char const *Json_Schema::checkType(size_t node, Value::ValueType type
+    , double number) const
+  {
+    unsigned int const types = nodes_[node]->types;
+    if (types & typeBit(type))
+      return 0;
+    if (!types)
+      return "Value not allowed by the schema";
+    if ((type == Value::TYPE_NUMBER) && (types & INTEGRAL)
+      && (floor(number) == number))
+      return 0;
+    return "Value type not allowed";
+  }
+
+  char const *Json_Schema::checkNumber(size_t node, double number) const
+  {
+    Node const &n = *nodes_[node];
+    if (n.hasMinimum && (number < n.minimum))
+      return "Number below minimum";
+    if (n.hasMaximum && (number > n.maximum))
+      return "Number above maximum";
+    if (n.hasExclusiveMinimum && (number <= n.exclusiveMinimum))
+      return "Number not above exclusive minimum";
+    if (n.hasExclusiveMaximum && (number >= n.exclusiveMaximum))
+      return "Number not below exclusive maximum";
+    return 0;
+  }
+
+  char const *Json_Schema::checkString(size_t node
+    , std::string const &data) const
+  {
+    Node const &n = *nodes_[node];
+    if (n.minLength || (n.maxLength != NO_LIMIT))
+    {
+      // characters are counted as UTF-8 sequences
+      size_t  length = 0;
+      for (std::string::const_iterator it = data.begin()
+        ; (it != data.end())
+        ; it++)
+        if ((static_cast<unsigned char>(*it) & 0xc0) != 0x80)
+          length++;
+      if (length < n.minLength)
+        return "String shorter than minimum length";
+      if (length > n.maxLength)
+        return "String longer than maximum length";
+    }
+    if (n.pPattern && regexec(n.pPattern, data.c_str(), 0, 0, 0))
+      return "String does not match pattern";
+    return 0;
+  }
+
+  bool Json_Schema::hasEnum(size_t node) const
+  {
+    return !nodes_[node]->enumeration.empty();
+  }
+
+  char const *Json_Schema::checkEnum(size_t node, Value const &value) const
+  {
+    std::vector<Value *> const &values = nodes_[node]->enumeration;
+    for (size_t i = 0; (i < values.size()); i++)
+    {
+      if (isNumber(value) && isNumber(*values[i]))
+      {
+        if (numberOf(value) == numberOf(*values[i]))
+          return 0;
+      }
+      else if (value.equals(*values[i]))
+        return 0;
+    }
+    return "Value not in enumeration";
+  }
+
+  char const *Json_Schema::checkCount(size_t node, bool array, size_t count
+    , bool complete) const
+  {
+    Node const &n = *nodes_[node];
+    if (array)
+    {
+      if (count > n.maxItems)
+        return "Too many items";
+      if (complete && (count < n.minItems))
+        return "Too few items";
+    }
+    else
+    {
+      if (count > n.maxProperties)
+        return "Too many properties";
+      if (complete && (count < n.minProperties))
+        return "Too few properties";
+    }
+    return 0;
+  }
+
+  size_t Json_Schema::itemNode(size_t node) const
+  {
+    return nodes_[node]->items;
+  }
+
+  size_t Json_Schema::propertyNode(size_t node, std::string const &name)
+    const
+  {
+    Node const &n = *nodes_[node];
+    std::vector<std::string>::const_iterator it =
+      std::lower_bound(n.names.begin(), n.names.end(), name);
+    if ((it != n.names.end()) && (*it == name))
+      return n.nodes[it - n.names.begin()];
+    return n.additional;
+  }
+
+  size_t Json_Schema::requiredCount(size_t node) const
+  {
+    return nodes_[node]->required.size();
+  }
+
+  size_t Json_Schema::requiredIndex(size_t node, std::string const &name)
+    const
+  {
+    std::vector<std::string> const &required = nodes_[node]->required;
+    std::vector<std::string>::const_iterator it =
+      std::lower_bound(required.begin(), required.end(), name);
+    if ((it != required.end()) && (*it == name))
+      return it - required.begin();
+    return Json_Pointer::NO_INDEX;
+  }
+
+  std::string const &Json_Schema::requiredName(size_t node, size_t pos)
+    const
+  {
+    return nodes_[node]->required[pos];
+  }
+
+  std::string Json_Schema::describe(char const *message
+    , std::string const &extra, Json_Pointer const &where)
+  {
+    std::string detail(message);
+    if (!extra.empty())
+      detail += " (" + extra + ")";
+    if (where.getPointer().empty())
+      detail += " at the document root";
+    else
+      detail += " at " + where.getPointer();
+    return detail;
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
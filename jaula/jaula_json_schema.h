@@ -0,0 +1,273 @@
+
+/*
+ * jaula_json_schema.h : JSON Analysis User Library Acronym
+ * Compiled JSON Schema definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_JSON_SCHEMA_H_
+#define _JAULA_JSON_SCHEMA_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <jaula/jaula_exception.h>
+#include <jaula/jaula_json_pointer.h>
+#include <jaula/jaula_value.h>
+
+/**
+ * \addtogroup jaula_val JAULA: JSON Values containers
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Compiled JSON Schema
+   *
+   * \ingroup jaula_val
+   *
+   * \par
+   * This class holds a JSON Schema compiled into a table of nodes, one for
+   * each subschema, where every property name and array item leads to the
+   * node that constrains it. Patterns are compiled once as POSIX extended
+   * regular expressions. The table can be run against any number of value
+   * trees by means of validate() or over the events produced by a parser
+   * through a Json_Schema_Validator, which rejects the input as soon as the
+   * first violation is read.
+   *
+   * \par
+   * The supported keywords are type (a name or a list of names), enum,
+   * minimum, maximum, exclusiveMinimum and exclusiveMaximum (as numbers),
+   * minLength, maxLength, pattern, items (a single schema), minItems,
+   * maxItems, properties, required, additionalProperties, minProperties and
+   * maxProperties. Schemas may also be true or false. The annotations
+   * $schema, $id, $comment, title, description, default and examples are
+   * ignored; any other keyword is rejected at construction time so a schema
+   * is never silently enforced only in part.
+   *
+   * \par
+   * Instances are not modified by validation and may be shared by several
+   * threads.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Json_Schema
+  {                              // class Json_Schema
+    public:
+
+      /**
+       * \brief Constructor
+       *
+       * \param schema Schema to compile.
+       *
+       * \exception Bad_Data_Type
+       * This exception is launched if the schema uses an unsupported keyword
+       * or a keyword with a value of the wrong type.
+       *
+       * \exception Syntax_Error
+       * This exception is launched if a pattern is not a valid regular
+       * expression.
+       */
+      Json_Schema(Value const &schema) throw(Exception);
+
+      /**
+       * \brief Destructor
+       */
+      ~Json_Schema();
+
+      /**
+       * \brief Validates a value
+       *
+       * \param value Value to check.
+       *
+       * \returns true if the value satisfies the schema.
+       */
+      bool validate(Value const &value) const;
+
+      /**
+       * \brief Validates a value describing the first violation found
+       *
+       * \param value Value to check.
+       *
+       * \param detail Reference to the string receiving the description of
+       * the violation, including the location of the offending value as a
+       * JSON Pointer. It is only modified if the value is not valid.
+       *
+       * \returns true if the value satisfies the schema.
+       */
+      bool validate(Value const &value, std::string &detail) const;
+
+    private:
+
+      friend class Json_Schema_Validator;
+
+      /**
+       * \brief Subschema
+       */
+      struct Node;
+
+      /**
+       * \brief Index for the schema accepting anything
+       */
+      static size_t const ANY;
+
+      /**
+       * \brief Index for the schema rejecting everything
+       */
+      static size_t const NOTHING;
+
+      /**
+       * \brief Copy constructor (not available)
+       */
+      Json_Schema(Json_Schema const &orig);
+
+      /**
+       * \brief Assignment operator (not available)
+       */
+      Json_Schema &operator=(Json_Schema const &orig);
+
+      /**
+       * \brief Compiles a subschema
+       *
+       * \param schema Subschema to compile.
+       *
+       * \param where Location of the subschema inside the schema.
+       *
+       * \returns the index of the node.
+       */
+      size_t compile(Value const &schema, Json_Pointer &where)
+        throw(Exception);
+
+      /**
+       * \brief Checks a value and its descendants
+       *
+       * \param node Index of the node to check against.
+       *
+       * \param value Value to check.
+       *
+       * \param where Container receiving the reference tokens leading from
+       * the value to the violation, innermost first, if one is found.
+       *
+       * \param extra Additional data for the description, if any.
+       *
+       * \returns the description of the violation or NULL if none is found.
+       */
+      char const *check(size_t node, Value const &value
+        , std::vector<std::string> &where, std::string &extra) const;
+
+      /**
+       * \brief Checks the type of a value
+       *
+       * \param number Numeric contents, used to accept integral floating
+       * point numbers as integers.
+       */
+      char const *checkType(size_t node, Value::ValueType type
+        , double number) const;
+
+      /**
+       * \brief Checks the numeric limits
+       */
+      char const *checkNumber(size_t node, double number) const;
+
+      /**
+       * \brief Checks the string limits and pattern
+       */
+      char const *checkString(size_t node, std::string const &data) const;
+
+      /**
+       * \brief Checks whether a node has an enumeration
+       */
+      bool hasEnum(size_t node) const;
+
+      /**
+       * \brief Checks a value against the enumeration
+       */
+      char const *checkEnum(size_t node, Value const &value) const;
+
+      /**
+       * \brief Checks the number of array items or object properties
+       *
+       * \param array Flag for arrays.
+       *
+       * \param count Number of items or properties seen.
+       *
+       * \param complete Flag for checking the lower limit as well.
+       */
+      char const *checkCount(size_t node, bool array, size_t count
+        , bool complete) const;
+
+      /**
+       * \brief Retrieves the node for array items
+       */
+      size_t itemNode(size_t node) const;
+
+      /**
+       * \brief Retrieves the node for an object property
+       *
+       * \returns the node from properties, the one from additionalProperties
+       * or NOTHING.
+       */
+      size_t propertyNode(size_t node, std::string const &name) const;
+
+      /**
+       * \brief Number of required properties
+       */
+      size_t requiredCount(size_t node) const;
+
+      /**
+       * \brief Position of a property among the required ones
+       *
+       * \returns the position or Json_Pointer::NO_INDEX if it is not
+       * required.
+       */
+      size_t requiredIndex(size_t node, std::string const &name) const;
+
+      /**
+       * \brief Retrieves the name of a required property
+       */
+      std::string const &requiredName(size_t node, size_t pos) const;
+
+      /**
+       * \brief Builds the description of a violation
+       */
+      static std::string describe(char const *message
+        , std::string const &extra, Json_Pointer const &where);
+
+      /**
+       * \brief Compiled subschemas
+       */
+      std::vector<Node *>   nodes_;
+
+      /**
+       * \brief Index for the root schema
+       */
+      size_t  root_;
+  };                             // class Json_Schema
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
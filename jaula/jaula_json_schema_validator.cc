@@ -0,0 +1,359 @@
+
+/*
+ * jaula_json_schema_validator.cc : JSON Analysis User Library Acronym
+ * Streaming JSON Schema validation implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+}
+
+
+#ifdef HAVE_MEMORY
+#include <memory>
+#endif
+
+#include <jaula/jaula_json_schema_validator.h>
+#include <jaula/jaula_value_boolean.h>
+#include <jaula/jaula_value_null.h>
+#include <jaula/jaula_value_number.h>
+#include <jaula/jaula_value_number_int.h>
+#include <jaula/jaula_value_string.h>
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Json_Schema_Validator::Json_Schema_Validator(Json_Schema const &schema)
+    : Parse_Handler()
+    , schema_(schema)
+    , pHandler_(0)
+    , frames_()
+    , depth_(0)
+    , captures_()
+    , pErrorReport_(0)
+    , handlerFailed_(false)
+    {}
+
+  Json_Schema_Validator::Json_Schema_Validator(Json_Schema const &schema
+    , Parse_Handler &handler)
+    : Parse_Handler()
+    , schema_(schema)
+    , pHandler_(&handler)
+    , frames_()
+    , depth_(0)
+    , captures_()
+    , pErrorReport_(0)
+    , handlerFailed_(false)
+    {}
+
+  Json_Schema_Validator::~Json_Schema_Validator()
+  {
+    reset();
+  }
+
+  bool Json_Schema_Validator::nullValue(void)
+  {
+    size_t  node;
+    if (!enter(Value::TYPE_NULL, 0, node))
+      return false;
+    if (schema_.hasEnum(node) && !enumerated(node, Value_Null()))
+      return false;
+    for (size_t i = 0; (i < captures_.size()); i++)
+      captures_[i]->nullValue();
+    return !pHandler_ || forwarded(pHandler_->nullValue());
+  }
+
+  bool Json_Schema_Validator::booleanValue(bool data)
+  {
+    size_t  node;
+    if (!enter(Value::TYPE_BOOLEAN, 0, node))
+      return false;
+    if (schema_.hasEnum(node) && !enumerated(node, Value_Boolean(data)))
+      return false;
+    for (size_t i = 0; (i < captures_.size()); i++)
+      captures_[i]->booleanValue(data);
+    return !pHandler_ || forwarded(pHandler_->booleanValue(data));
+  }
+
+  bool Json_Schema_Validator::numberValue(double data)
+  {
+    size_t  node;
+    if (!enter(Value::TYPE_NUMBER, data, node))
+      return false;
+    if (char const *message = schema_.checkNumber(node, data))
+      return fail(message, "", depth_);
+    if (schema_.hasEnum(node) && !enumerated(node, Value_Number(data)))
+      return false;
+    for (size_t i = 0; (i < captures_.size()); i++)
+      captures_[i]->numberValue(data);
+    return !pHandler_ || forwarded(pHandler_->numberValue(data));
+  }
+
+  bool Json_Schema_Validator::numberIntValue(int64_t data)
+  {
+    size_t  node;
+    if (!enter(Value::TYPE_NUMBER_INT, data, node))
+      return false;
+    if (char const *message = schema_.checkNumber(node, data))
+      return fail(message, "", depth_);
+    if (schema_.hasEnum(node) && !enumerated(node, Value_Number_Int(data)))
+      return false;
+    for (size_t i = 0; (i < captures_.size()); i++)
+      captures_[i]->numberIntValue(data);
+    return !pHandler_ || forwarded(pHandler_->numberIntValue(data));
+  }
+
+  bool Json_Schema_Validator::numberUnsignedValue(uint64_t data)
+  {
+    size_t  node;
+    double const  number = static_cast<double>(data);
+    if (!enter(Value::TYPE_NUMBER_INT, number, node))
+      return false;
+    if (char const *message = schema_.checkNumber(node, number))
+      return fail(message, "", depth_);
+    if (schema_.hasEnum(node))
+    {
+      Value_Number_Int  value;
+      value.setUnsigned(data);
+      if (!enumerated(node, value))
+        return false;
+    }
+    for (size_t i = 0; (i < captures_.size()); i++)
+      captures_[i]->numberUnsignedValue(data);
+    return !pHandler_ || forwarded(pHandler_->numberUnsignedValue(data));
+  }
+
+  bool Json_Schema_Validator::numberTextValue(std::string const &data)
+  {
+    size_t  node;
+    std::auto_ptr<Value> pValue(Value::numberFromText(data));
+    double const  number = pValue->getNumber(Json_Pointer());
+    if (!enter(pValue->getType(), number, node))
+      return false;
+    if (char const *message = schema_.checkNumber(node, number))
+      return fail(message, "", depth_);
+    if (schema_.hasEnum(node) && !enumerated(node, *pValue))
+      return false;
+    for (size_t i = 0; (i < captures_.size()); i++)
+      captures_[i]->numberTextValue(data);
+    return !pHandler_ || forwarded(pHandler_->numberTextValue(data));
+  }
+
+  bool Json_Schema_Validator::stringValue(std::string const &data)
+  {
+    size_t  node;
+    if (!enter(Value::TYPE_STRING, 0, node))
+      return false;
+    if (char const *message = schema_.checkString(node, data))
+      return fail(message, "", depth_);
+    if (schema_.hasEnum(node) && !enumerated(node, Value_String(data)))
+      return false;
+    for (size_t i = 0; (i < captures_.size()); i++)
+      captures_[i]->stringValue(data);
+    return !pHandler_ || forwarded(pHandler_->stringValue(data));
+  }
+
+  bool Json_Schema_Validator::arrayBegin(void)
+  {
+    if (!open(true))
+      return false;
+    for (size_t i = 0; (i < captures_.size()); i++)
+      captures_[i]->arrayBegin();
+    return !pHandler_ || forwarded(pHandler_->arrayBegin());
+  }
+
+  bool Json_Schema_Validator::arrayEnd(void)
+  {
+    for (size_t i = 0; (i < captures_.size()); i++)
+      captures_[i]->arrayEnd();
+    if (!close())
+      return false;
+    return !pHandler_ || forwarded(pHandler_->arrayEnd());
+  }
+
+  bool Json_Schema_Validator::objectBegin(void)
+  {
+    if (!open(false))
+      return false;
+    for (size_t i = 0; (i < captures_.size()); i++)
+      captures_[i]->objectBegin();
+    return !pHandler_ || forwarded(pHandler_->objectBegin());
+  }
+
+  bool Json_Schema_Validator::propertyName(std::string const &name)
+  {
+    Frame &frame = frames_[depth_ - 1];
+    frame.name = name;
+    frame.count++;
+    if (char const *message = schema_.checkCount(frame.node, false
+      , frame.count, false))
+      return fail(message, "", depth_ - 1);
+    size_t const required = schema_.requiredIndex(frame.node, name);
+    if (required != Json_Pointer::NO_INDEX)
+      frame.seen[required] = true;
+    frame.child = schema_.propertyNode(frame.node, name);
+    for (size_t i = 0; (i < captures_.size()); i++)
+      captures_[i]->propertyName(name);
+    return !pHandler_ || forwarded(pHandler_->propertyName(name));
+  }
+
+  bool Json_Schema_Validator::objectEnd(void)
+  {
+    for (size_t i = 0; (i < captures_.size()); i++)
+      captures_[i]->objectEnd();
+    if (!close())
+      return false;
+    return !pHandler_ || forwarded(pHandler_->objectEnd());
+  }
+
+  Exception const *Json_Schema_Validator::getErrorReport(void) const
+  {
+    if (handlerFailed_)
+      return pHandler_->getErrorReport();
+    return pErrorReport_;
+  }
+
+  void Json_Schema_Validator::reset(void)
+  {
+    depth_ = 0;
+    for (size_t i = 0; (i < captures_.size()); i++)
+      delete captures_[i];
+    captures_.clear();
+    if (pErrorReport_)
+      delete pErrorReport_;
+    pErrorReport_ = 0;
+    handlerFailed_ = false;
+  }
+
+  bool Json_Schema_Validator::enter(Value::ValueType type, double number
+    , size_t &node)
+  {
+    if (!depth_)
+      node = schema_.root_;
+    else
+    {
+      Frame &frame = frames_[depth_ - 1];
+      if (frame.isArray)
+      {
+        frame.count++;
+        if (char const *message = schema_.checkCount(frame.node, true
+          , frame.count, false))
+          return fail(message, "", depth_ - 1);
+        node = schema_.itemNode(frame.node);
+      }
+      else
+        node = frame.child;
+    }
+    if (char const *message = schema_.checkType(node, type, number))
+      return fail(message, "", depth_);
+    return true;
+  }
+
+  bool Json_Schema_Validator::enumerated(size_t node, Value const &value)
+  {
+    if (char const *message = schema_.checkEnum(node, value))
+      return fail(message, "", depth_);
+    return true;
+  }
+
+  bool Json_Schema_Validator::open(bool array)
+  {
+    size_t  node;
+    if (!enter(array ? Value::TYPE_ARRAY : Value::TYPE_OBJECT, 0, node))
+      return false;
+    if (frames_.size() == depth_)
+      frames_.push_back(Frame());
+    Frame &frame = frames_[depth_++];
+    frame.node = node;
+    frame.isArray = array;
+    frame.count = 0;
+    frame.child = Json_Schema::ANY;
+    frame.name.erase();
+    frame.seen.assign(array ? 0 : schema_.requiredCount(node), false);
+    frame.pCapture = 0;
+    if (schema_.hasEnum(node))
+    {
+      frame.pCapture = new Value_Builder();
+      captures_.push_back(frame.pCapture);
+    }
+    return true;
+  }
+
+  bool Json_Schema_Validator::close(void)
+  {
+    Frame &frame = frames_[depth_ - 1];
+    if (char const *message = schema_.checkCount(frame.node, frame.isArray
+      , frame.count, true))
+      return fail(message, "", depth_ - 1);
+    for (size_t i = 0; (i < frame.seen.size()); i++)
+      if (!frame.seen[i])
+        return fail("Required property missing"
+          , schema_.requiredName(frame.node, i), depth_ - 1);
+    if (frame.pCapture)
+    {
+      if (char const *message = schema_.checkEnum(frame.node
+        , *frame.pCapture->getValue()))
+        return fail(message, "", depth_ - 1);
+      delete frame.pCapture;
+      captures_.pop_back();
+      frame.pCapture = 0;
+    }
+    depth_--;
+    return true;
+  }
+
+  bool Json_Schema_Validator::fail(char const *message
+    , std::string const &extra, size_t levels)
+  {
+    Json_Pointer  where;
+    for (size_t i = 0; (i < levels); i++)
+    {
+      if (frames_[i].isArray)
+        where.append(frames_[i].count - 1);
+      else
+        where.append(frames_[i].name);
+    }
+    if (pErrorReport_)
+      delete pErrorReport_;
+    pErrorReport_ = new Bad_Data_Type(Json_Schema::describe(message, extra
+      , where)
+      , "validating parsing events"
+      , "Json_Schema_Validator");
+    return false;
+  }
+
+  bool Json_Schema_Validator::forwarded(bool accepted)
+  {
+    if (!accepted)
+      handlerFailed_ = true;
+    return accepted;
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
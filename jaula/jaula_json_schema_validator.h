@@ -0,0 +1,296 @@
+
+/*
+ * jaula_json_schema_validator.h : JSON Analysis User Library Acronym
+ * Streaming JSON Schema validation definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_JSON_SCHEMA_VALIDATOR_H_
+#define _JAULA_JSON_SCHEMA_VALIDATOR_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <jaula/jaula_bad_data_type.h>
+#include <jaula/jaula_exception.h>
+#include <jaula/jaula_json_schema.h>
+#include <jaula/jaula_parse_handler.h>
+#include <jaula/jaula_value_builder.h>
+
+/**
+ * \addtogroup jaula_parse JAULA: JSON data parser
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Parsing events handler that validates against a JSON Schema
+   *
+   * \ingroup jaula_parse
+   *
+   * \par
+   * This class checks the events produced by a parser against a compiled
+   * Json_Schema as they arrive and stops the process at the first
+   * violation, so invalid input is rejected before the rest of it is read.
+   * Limits on the number of items or properties are checked as soon as
+   * they are exceeded. Only values constrained by an enumeration that are
+   * arrays or objects are built to be compared.
+   *
+   * \par
+   * Events can be passed on to another handler once validated, for instance
+   * a Value_Builder, so a document is built and validated in a single pass.
+   *
+   * \par
+   * Several documents can be processed in sequence with the same instance.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Json_Schema_Validator : public Parse_Handler
+  {                              // class Json_Schema_Validator
+    public:
+
+      /**
+       * \brief Constructor
+       *
+       * \param schema Schema to check against. It must exist during all the
+       * validator life cycle.
+       */
+      Json_Schema_Validator(Json_Schema const &schema);
+
+      /**
+       * \brief Constructor
+       *
+       * \param schema Schema to check against. It must exist during all the
+       * validator life cycle.
+       *
+       * \param handler Reference to the instance that will receive the
+       * events validated. It must exist during all the validator life cycle.
+       */
+      Json_Schema_Validator(Json_Schema const &schema
+        , Parse_Handler &handler);
+
+      /**
+       * \brief Destructor
+       */
+      virtual ~Json_Schema_Validator();
+
+      /**
+       * \brief Processes a null value
+       */
+      virtual bool nullValue(void);
+
+      /**
+       * \brief Processes a boolean value
+       */
+      virtual bool booleanValue(bool data);
+
+      /**
+       * \brief Processes a floating point number
+       */
+      virtual bool numberValue(double data);
+
+      /**
+       * \brief Processes an integer number
+       */
+      virtual bool numberIntValue(int64_t data);
+
+      /**
+       * \brief Processes an unsigned integer number
+       */
+      virtual bool numberUnsignedValue(uint64_t data);
+
+      /**
+       * \brief Processes a number kept by its decimal text
+       */
+      virtual bool numberTextValue(std::string const &data);
+
+      /**
+       * \brief Processes a string
+       */
+      virtual bool stringValue(std::string const &data);
+
+      /**
+       * \brief Processes the start of an array
+       */
+      virtual bool arrayBegin(void);
+
+      /**
+       * \brief Processes the end of an array
+       */
+      virtual bool arrayEnd(void);
+
+      /**
+       * \brief Processes the start of an object
+       */
+      virtual bool objectBegin(void);
+
+      /**
+       * \brief Processes the name for the next value
+       */
+      virtual bool propertyName(std::string const &name);
+
+      /**
+       * \brief Processes the end of an object
+       */
+      virtual bool objectEnd(void);
+
+      /**
+       * \brief Retrieves the error that stopped the process
+       *
+       * \returns a Bad_Data_Type describing the violation found, the error
+       * reported by the handler receiving the events if it was the one
+       * stopping the process, or a null pointer.
+       */
+      virtual Exception const *getErrorReport(void) const;
+
+      /**
+       * \brief Discards any document in progress and the last error
+       */
+      void reset(void);
+
+    private:
+
+      /**
+       * \brief Copy constructor (not available)
+       */
+      Json_Schema_Validator(Json_Schema_Validator const &orig);
+
+      /**
+       * \brief Assignment operator (not available)
+       */
+      Json_Schema_Validator &operator=(Json_Schema_Validator const &orig);
+
+      /**
+       * \brief Array or object being parsed
+       */
+      struct Frame
+      {                          // struct Frame
+        /** schema node for the container */
+        size_t  node;
+        /** flag for arrays */
+        bool    isArray;
+        /** number of items or properties seen */
+        size_t  count;
+        /** schema node for the next property value */
+        size_t  child;
+        /** name for the last property */
+        std::string name;
+        /** required properties seen */
+        std::vector<bool> seen;
+        /** builder for the enumeration check, if any */
+        Value_Builder   *pCapture;
+      };                         // struct Frame
+
+      /**
+       * \brief Finds and checks the schema node for a new value
+       *
+       * \param type Type of the value.
+       *
+       * \param number Numeric contents, if any.
+       *
+       * \param node Reference receiving the node.
+       *
+       * \returns false if a violation has been found.
+       */
+      bool enter(Value::ValueType type, double number, size_t &node);
+
+      /**
+       * \brief Checks a scalar value against the enumeration
+       */
+      bool enumerated(size_t node, Value const &value);
+
+      /**
+       * \brief Opens a container
+       */
+      bool open(bool array);
+
+      /**
+       * \brief Checks and closes the innermost container
+       */
+      bool close(void);
+
+      /**
+       * \brief Records a violation
+       *
+       * \param message Description of the violation.
+       *
+       * \param extra Additional data for the description.
+       *
+       * \param levels Number of open containers leading to the offending
+       * value.
+       *
+       * \returns false.
+       */
+      bool fail(char const *message, std::string const &extra
+        , size_t levels);
+
+      /**
+       * \brief Records a stop requested by the handler receiving the events
+       *
+       * \returns the value received.
+       */
+      bool forwarded(bool accepted);
+
+      /**
+       * \brief Schema being checked
+       */
+      Json_Schema const &schema_;
+
+      /**
+       * \brief Handler receiving the events validated, if any
+       */
+      Parse_Handler   *pHandler_;
+
+      /**
+       * \brief Frames for the arrays and objects open (reused)
+       */
+      std::vector<Frame>  frames_;
+
+      /**
+       * \brief Number of frames in use
+       */
+      size_t  depth_;
+
+      /**
+       * \brief Values being built for enumeration checks, innermost last
+       */
+      std::vector<Value_Builder *>  captures_;
+
+      /**
+       * \brief Violation found
+       */
+      Bad_Data_Type   *pErrorReport_;
+
+      /**
+       * \brief Flag for the process stopped by the handler
+       */
+      bool    handlerFailed_;
+  };                             // class Json_Schema_Validator
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
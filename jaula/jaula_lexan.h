@@ -78,6 +78,11 @@ namespace JAULA
    * This class implements the lexical analysis for JSON as specified by
    * RFC 4627.
    *
+   * \par
+   * Only the byte offset is updated for every token. Line feeds are counted
+   * in blocks when a run of spaces or a comment containing them is skipped,
+   * instead of checking every byte read.
+   *
    * \author Kombo Morongo <morongo666@gmail.com>
    */
   class Lexan : public ::jaulaFlexLexer
@@ -143,8 +148,45 @@ namespace JAULA
        */
       Lexan_Error const *getErrorReport(void) const;
 
+      /**
+       * \brief Retrieves the number of bytes consumed from the input
+       */
+      size_t getOffset(void) const;
+
+      /**
+       * \brief Retrieves the offset where the last token read begins
+       */
+      size_t getTokenOffset(void) const;
+
+      /**
+       * \brief Retrieves the line where the last token read begins
+       *
+       * Once the input is exhausted, the line where it ended.
+       *
+       * \returns the line number, starting at 1.
+       */
+      unsigned int getLine(void) const;
+
+      /**
+       * \brief Retrieves the column where the last token read begins
+       *
+       * Once the input is exhausted, the column where it ended.
+       *
+       * \returns the byte position within the line, starting at 1.
+       */
+      size_t getColumn(void) const;
+
     private:
 
+      /**
+       * \brief Accounts for the line feeds in the text just matched
+       *
+       * \param text Text matched.
+       *
+       * \param len Number of bytes matched.
+       */
+      void newLines(char const *text, size_t len);
+
       /**
        * \brief Flag for extending language to accept # comments
        */
@@ -160,6 +202,26 @@ namespace JAULA
        */
       Lexan_Error   *pErrorReport;
 
+      /**
+       * \brief Bytes consumed from the input
+       */
+      size_t  offset;
+
+      /**
+       * \brief Offset where the last token begins
+       */
+      size_t  tokenOffset;
+
+      /**
+       * \brief Current line number
+       */
+      unsigned int  line;
+
+      /**
+       * \brief Offset where the current line begins
+       */
+      size_t  lineStart;
+
   };                             // class Lexan
 }                                // namespace JAULA
 #endif
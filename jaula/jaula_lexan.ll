@@ -33,7 +33,6 @@
 %option c++
 %option prefix="jaula"
 %option yyclass="JAULA::Lexan"
-%option yylineno
 %option noyywrap
 %option outfile = "lex.yy.c"
 
@@ -53,9 +52,17 @@ extern "C"
 
 #include <jaula/jaula_lexan_error.h>
 #include <jaula/jaula_no_error.h>
+#include <jaula/jaula_parse_result.h>
+#include <jaula/jaula_string_escape.h>
 
 #include <jaula_lexan.h>
 
+/* Only byte offsets are kept per token, lines are counted on spaces */
+#define YY_USER_ACTION \
+	if (YY_START == INITIAL) \
+		tokenOffset = offset; \
+	offset += yyleng;
+
 %}
 
 SIGN		[+-]
@@ -72,7 +79,11 @@ FLOAT		{FLOAT1}|{FLOAT2}
 
 %%
 
-[ \f\n\r\t]+	/* Me como los espacios */
+[ \f\r\t]+	/* Me como los espacios */
+
+[ \f\n\r\t]+	{ /* Spaces including line feeds */
+				newLines(yytext, yyleng);
+			} /* Spaces including line feeds */
 
 "["		|
 "]"		|
@@ -129,12 +140,18 @@ true		{ /* true constant value */
 				yyterminate();
 			} /* invalid character */
 
+<INITIAL><<EOF>>	{	/* end of input, reported at its own position */
+							tokenOffset = offset;
+							yyterminate();
+						} /* end of input */
+
 <LINECOMM><<EOF>>	{	/* unterminated comment */
 							LexerError("unterminated comment detected at end of input");
 							yyterminate();
 						} /* unterminated string */
 
 <LINECOMM>\n		{	/* end comment */
+							newLines(yytext, yyleng);
 							BEGIN(0);
 						}	/* end comment */
 
@@ -174,11 +191,8 @@ true		{ /* true constant value */
 					} /* Literal backslash */
 
 <LITERAL>"/"		{ /* Literal slash */
-						std::cerr << "jaula_lexan : Entre a procesar barra escapada." << std::endl;
 						tokenData += '/';
-						std::cerr << "jaula_lexan : Estado del token = " << tokenData << std::endl;
 						yy_pop_state();
-						std::cerr << "jaula_lexan : Vuelvo al estado anterior." << std::endl;
 					} /* Literal slash */
 
 <LITERAL>"b"		{ /* Literal backspace */
@@ -206,19 +220,16 @@ true		{ /* true constant value */
 						yy_pop_state();
 					} /* Literal tab */
 
-<LITERAL>u{XDIGIT}{4}		{ /* unicode character */
-						char	*reminder = 0;
-						unsigned int accum = strtol(&(yytext[1]), &reminder, 16);
-						if ((reminder) && (*reminder))
+<LITERAL>u{XDIGIT}{4}(\\u{XDIGIT}{4})*	{ /* unicode characters */
+						/* the whole run is decoded at once, pairing surrogates */
+						if (String_Escape::unescapeUnicode(yytext, yyleng, tokenData)
+							!= static_cast<size_t>(yyleng))
 						{
-							std::ostringstream	ostr;
-							ostr << "Expresion \\" << yytext << "could not be converted to a unicode character";
-							LexerError(ostr.str().c_str());
+							LexerError("unpaired surrogate detected in unicode escape sequence");
 							yyterminate();
 						}
-						tokenData += static_cast<char>(accum & 0x00ff);
 						yy_pop_state();
-					} /* unicode character */
+					} /* unicode characters */
 
 <LITERAL><<EOF>>	{ /* unterminated literal */
 						LexerError("unterminated escape sequence detected at end of input");
@@ -226,7 +237,6 @@ true		{ /* true constant value */
 					} /* unterminated literal */
 
 <LITERAL>.		{ /* invalid literal */
-						std::cerr << "jaula_lexan : Entre a procesar secuencia de escape invalida." << std::endl;
 						std::ostringstream	ostr;
 						ostr << "Invalid literal sequence \\" << yytext;
 						LexerError(ostr.str().c_str());
@@ -245,12 +255,17 @@ namespace JAULA
 		, commented(comments_allowed)
 		, tokenData()
 		, pErrorReport()
+		, offset(0)
+		, tokenOffset(0)
+		, line(1)
+		, lineStart(0)
 	{}
 
 	void Lexan::LexerError(const char *msg)
 	{
  		std::ostringstream	errAct;
- 		errAct << "analyzing line " << lineno() << " from input stream.";
+ 		errAct << "analyzing line " << line << ", column " << getColumn()
+			<< " from input stream.";
 
 		if (pErrorReport)
 			delete pErrorReport;
@@ -269,6 +284,37 @@ namespace JAULA
  		return pErrorReport;
 	}
 
+	size_t Lexan::getOffset(void) const
+	{
+		return offset;
+	}
+
+	size_t Lexan::getTokenOffset(void) const
+	{
+		return tokenOffset;
+	}
+
+	unsigned int Lexan::getLine(void) const
+	{
+		return line;
+	}
+
+	size_t Lexan::getColumn(void) const
+	{
+		return (tokenOffset < lineStart) ? 1 : (tokenOffset - lineStart + 1);
+	}
+
+	void Lexan::newLines(char const *text, size_t len)
+	{
+		size_t const count = Parse_Result::countLines(text, len);
+		if (!count)
+			return;
+		line += count;
+		while (text[len - 1] != '\n')
+			len--;
+		lineStart = offset - yyleng + len;
+	}
+
 	Lexan::~Lexan()
 	{
 		if (pErrorReport)
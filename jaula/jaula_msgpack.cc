@@ -0,0 +1,623 @@
+
+/*
+ * jaula_msgpack.cc : JSON Analysis User Library Acronym
+ * MessagePack encoding implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_STDINT_H
+#include <stdint.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+}
+
+
+#ifdef HAVE_LIMITS
+#include <limits>
+#endif
+
+#ifdef HAVE_SSTREAM
+#include <sstream>
+#endif
+
+#ifdef HAVE_STRING
+#include <string>
+#endif
+
+#ifdef HAVE_VECTOR
+#include <vector>
+#endif
+
+#include <jaula/jaula_msgpack.h>
+#include <jaula/jaula_value_array.h>
+#include <jaula/jaula_value_boolean.h>
+#include <jaula/jaula_value_builder.h>
+#include <jaula/jaula_value_number.h>
+#include <jaula/jaula_value_number_int.h>
+#include <jaula/jaula_value_object.h>
+#include <jaula/jaula_value_string.h>
+
+namespace
+{                                // anonymous namespace
+
+  using namespace JAULA;
+
+  /**
+   * \brief Writes an unsigned number in network byte order
+   */
+  void store(unsigned char *p, uint64_t n, size_t bytes)
+  {
+    while (bytes--)
+    {
+      p[bytes] = static_cast<unsigned char>(n & 0xff);
+      n >>= 8;
+    }
+  }
+
+  /**
+   * \brief Reads an unsigned number in network byte order
+   */
+  uint64_t load(unsigned char const *p, size_t bytes)
+  {
+    uint64_t  n = 0;
+    while (bytes--)
+      n = (n << 8) | *(p++);
+    return n;
+  }
+
+  /**
+   * \brief Writes a type byte followed by its length or value
+   */
+  void writeTagged(Output_Buffer &out, unsigned char type, uint64_t n
+    , size_t bytes)
+  {
+    unsigned char *p = reinterpret_cast<unsigned char *>(out.reserve(9));
+    p[0] = type;
+    store(p + 1, n, bytes);
+    out.commit(bytes + 1);
+  }
+
+  /**
+   * \brief Writes the header of a string, array or map
+   *
+   * \param fix Type byte for the fix format.
+   *
+   * \param fix_max Largest size allowed by the fix format.
+   *
+   * \param type8 Type byte for the 8 bits size format (0 if not
+   * available). The 16 and 32 bits ones follow it.
+   */
+  void writeHeader(Output_Buffer &out, size_t len, unsigned char fix
+    , size_t fix_max, unsigned char type8, unsigned char type16)
+  {
+    if (len <= fix_max)
+      out.append(static_cast<char>(fix | len));
+    else if (type8 && (len <= 0xffU))
+      writeTagged(out, type8, len, 1);
+    else if (len <= 0xffffU)
+      writeTagged(out, type16, len, 2);
+    else
+      writeTagged(out, type16 + 1, len, 4);
+  }
+
+  /**
+   * \brief Writes a string
+   */
+  void writeString(Output_Buffer &out, std::string const &str)
+  {
+    writeHeader(out, str.size(), 0xa0, 31, 0xd9, 0xda);
+    out.append(str.data(), str.size());
+  }
+
+  /**
+   * \brief Writes an integer number
+   */
+  void writeInt(Output_Buffer &out, int64_t data)
+  {
+    if ((data >= -32) && (data <= 127))
+      out.append(static_cast<char>(data));
+    else if (data > 0)
+    {
+      uint64_t  n = static_cast<uint64_t>(data);
+      if (n <= 0xffU)
+        writeTagged(out, 0xcc, n, 1);
+      else if (n <= 0xffffU)
+        writeTagged(out, 0xcd, n, 2);
+      else if (n <= 0xffffffffU)
+        writeTagged(out, 0xce, n, 4);
+      else
+        writeTagged(out, 0xcf, n, 8);
+    }
+    else
+    {
+      uint64_t  n = static_cast<uint64_t>(data);
+      if (data >= -128)
+        writeTagged(out, 0xd0, n, 1);
+      else if (data >= -32768)
+        writeTagged(out, 0xd1, n, 2);
+      else if (data >= -2147483647L - 1)
+        writeTagged(out, 0xd2, n, 4);
+      else
+        writeTagged(out, 0xd3, n, 8);
+    }
+  }
+
+  /**
+   * \brief Writes a floating point number
+   */
+  void writeFloat(Output_Buffer &out, double data)
+  {
+    float single = static_cast<float>(data);
+    if ((single == data) || (data != data))
+    {
+      uint32_t  bits;
+      memcpy(&bits, &single, sizeof(bits));
+      writeTagged(out, 0xca, bits, 4);
+    }
+    else
+    {
+      uint64_t  bits;
+      memcpy(&bits, &data, sizeof(bits));
+      writeTagged(out, 0xcb, bits, 8);
+    }
+  }
+
+  /**
+   * \brief Array or map being decoded
+   */
+  struct Decode_Frame
+  {                              // struct Decode_Frame
+    /** flag for maps */
+    bool      map;
+    /** flag for maps expecting a key */
+    bool      key;
+    /** objects left (keys and values for maps) */
+    uint64_t  remaining;
+  };                             // struct Decode_Frame
+
+  /**
+   * \brief Array or object being encoded
+   */
+  struct Encode_Frame
+  {                              // struct Encode_Frame
+    /** array being encoded (null for objects) */
+    Value_Array const   *pArray;
+    /** object being encoded (null for arrays) */
+    Value_Object const  *pObject;
+    /** next array item */
+    Value_Array::dataType::const_iterator   item;
+    /** next object property */
+    Value_Object::dataType::const_iterator  property;
+  };                             // struct Encode_Frame
+
+  /**
+   * \brief Bounds checked access to the encoded data
+   */
+  class MsgPack_Reader
+  {                              // class MsgPack_Reader
+    public:
+
+      MsgPack_Reader(char const *data, size_t len)
+        : begin_(reinterpret_cast<unsigned char const *>(data))
+        , p_(begin_)
+        , end_(begin_ + len)
+        {}
+
+      /**
+       * \brief Reads the next byte
+       */
+      unsigned char byte(void) throw(Syntax_Error)
+      {
+        if (p_ == end_)
+          fail("Unexpected end of data");
+        return *(p_++);
+      }
+
+      /**
+       * \brief Reads an unsigned number
+       */
+      uint64_t number(size_t bytes) throw(Syntax_Error)
+      {
+        return load(take(bytes), bytes);
+      }
+
+      /**
+       * \brief Reads a block of bytes
+       */
+      unsigned char const *take(uint64_t len) throw(Syntax_Error)
+      {
+        if (len > static_cast<uint64_t>(end_ - p_))
+          fail("Unexpected end of data");
+        unsigned char const *p = p_;
+        p_ += len;
+        return p;
+      }
+
+      /**
+       * \brief Retrieves the number of bytes read
+       */
+      size_t offset(void) const
+      {
+        return p_ - begin_;
+      }
+
+      /**
+       * \brief Raises a decoding error
+       */
+      void fail(char const *detail) const throw(Syntax_Error)
+      {
+        std::ostringstream  errAct;
+        errAct << "decoding MessagePack data at byte " << (p_ - begin_);
+        throw Syntax_Error(detail, errAct.str());
+      }
+
+      /**
+       * \brief Raises the error reported by a parsing events handler
+       */
+      void handlerFail(Parse_Handler const &handler) const throw(Exception)
+      {
+        if (handler.getErrorReport())
+          throw Exception(*(handler.getErrorReport()));
+        fail("The parsing events handler stopped the process");
+      }
+
+    private:
+
+      unsigned char const *begin_;
+      unsigned char const *p_;
+      unsigned char const *end_;
+  };                             // class MsgPack_Reader
+
+  /**
+   * \brief Sends an unsigned integer to a handler
+   */
+  bool unsignedValue(Parse_Handler &handler, uint64_t n)
+  {
+    if (n <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+      return handler.numberIntValue(static_cast<int64_t>(n));
+    return handler.numberUnsignedValue(n);
+  }
+
+  /**
+   * \brief Sends a signed integer to a handler
+   */
+  bool signedValue(Parse_Handler &handler, uint64_t n, size_t bytes)
+  {
+    int64_t val;
+    switch (bytes)
+    {
+      case 1 :
+        val = static_cast<int8_t>(n);
+        break;
+      case 2 :
+        val = static_cast<int16_t>(n);
+        break;
+      case 4 :
+        val = static_cast<int32_t>(n);
+        break;
+      default :
+        val = static_cast<int64_t>(n);
+        break;
+    }
+    return handler.numberIntValue(val);
+  }
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  void MsgPack::encode(Value const &val, Output_Buffer &out)
+  {
+    std::vector<Encode_Frame> stack;
+    Value const *pItem = &val;
+    while (pItem)
+    {                            // items loop
+      switch (pItem->getType())
+      {                          // value type switch
+        case Value::TYPE_BOOLEAN :
+          out.append(static_cast<Value_Boolean const *>(pItem)->getData()
+            ? '\xc3' : '\xc2');
+          break;
+
+        case Value::TYPE_STRING :
+          writeString(out, static_cast<Value_String const *>(pItem)->getData());
+          break;
+
+        case Value::TYPE_NUMBER :
+          writeFloat(out, static_cast<Value_Number const *>(pItem)->getData());
+          break;
+
+        case Value::TYPE_NUMBER_INT :
+        {
+          Value_Number_Int const *pNumber =
+            static_cast<Value_Number_Int const *>(pItem);
+          if (pNumber->isUnsigned())
+            writeTagged(out, 0xcf, pNumber->getUnsigned(), 8);
+          else
+            writeInt(out, pNumber->getInt64());
+        }
+        break;
+
+        case Value::TYPE_ARRAY :
+        {
+          Encode_Frame  frame;
+          frame.pArray = static_cast<Value_Array const *>(pItem);
+          frame.pObject = 0;
+          frame.item = frame.pArray->getData().begin();
+          writeHeader(out, frame.pArray->size(), 0x90, 15, 0, 0xdc);
+          stack.push_back(frame);
+        }
+        break;
+
+        case Value::TYPE_OBJECT :
+        {
+          Encode_Frame  frame;
+          frame.pArray = 0;
+          frame.pObject = static_cast<Value_Object const *>(pItem);
+          frame.property = frame.pObject->getData().begin();
+          writeHeader(out, frame.pObject->size(), 0x80, 15, 0, 0xde);
+          stack.push_back(frame);
+        }
+        break;
+
+        default :
+          out.append('\xc0');
+          break;
+      }                          // value type switch
+
+      pItem = 0;
+      while (!pItem && !stack.empty())
+      {                          // next item search
+        Encode_Frame  &frame = stack.back();
+        if (frame.pArray)
+        {
+          if (frame.item != frame.pArray->getData().end())
+            pItem = *(frame.item++);
+          else
+            stack.pop_back();
+        }
+        else
+        {
+          if (frame.property != frame.pObject->getData().end())
+          {
+            writeString(out, frame.property->first);
+            pItem = (frame.property++)->second;
+          }
+          else
+            stack.pop_back();
+        }
+      }                          // next item search
+    }                            // items loop
+  }
+
+  void MsgPack::encode(Value const &val, Sink &sink)
+  {
+    Output_Buffer out(sink);
+    encode(val, out);
+    out.flush();
+  }
+
+  Value *MsgPack::decode(char const *data, size_t len) throw(Exception)
+  {
+    try
+    {
+      Value_Builder builder;
+      if (decode(data, len, builder) != len)
+        throw Syntax_Error("Data found after the first object"
+          , "decoding MessagePack data");
+      return builder.release();
+    }
+    catch(Syntax_Error &ex)
+    {
+      ex.addOrigin("MsgPack::decode(char const *, size_t)");
+      throw ex;
+    }
+    catch(Exception &ex)
+    {
+      ex.addOrigin("MsgPack::decode(char const *, size_t)");
+      throw ex;
+    }
+  }
+
+  size_t MsgPack::decode(char const *data, size_t len, Parse_Handler &handler)
+    throw(Exception)
+  {
+    try
+    {
+      MsgPack_Reader  in(data, len);
+      std::vector<Decode_Frame> stack;
+      std::string str;
+      for (;;)
+      {                          // objects loop
+        unsigned char type = in.byte();
+        bool  asKey = !stack.empty() && stack.back().map && stack.back().key;
+
+        // classification of the object
+        uint64_t  strLen = 0;
+        bool      isString = false;
+        uint64_t  containerLen = 0;
+        int       container = 0;
+        if ((type & 0xe0) == 0xa0)
+        {
+          isString = true;
+          strLen = type & 0x1f;
+        }
+        else if ((type >= 0xd9) && (type <= 0xdb))
+        {
+          isString = true;
+          strLen = in.number(static_cast<size_t>(1) << (type - 0xd9));
+        }
+        else if ((type >= 0xc4) && (type <= 0xc6))
+        {
+          isString = true;
+          strLen = in.number(static_cast<size_t>(1) << (type - 0xc4));
+        }
+        else if ((type & 0xf0) == 0x90)
+        {
+          container = ']';
+          containerLen = type & 0x0f;
+        }
+        else if ((type & 0xf0) == 0x80)
+        {
+          container = '}';
+          containerLen = type & 0x0f;
+        }
+        else if ((type == 0xdc) || (type == 0xdd))
+        {
+          container = ']';
+          containerLen = in.number((type == 0xdc) ? 2 : 4);
+        }
+        else if ((type == 0xde) || (type == 0xdf))
+        {
+          container = '}';
+          containerLen = in.number((type == 0xde) ? 2 : 4);
+        }
+
+        if (asKey && !isString)
+          in.fail("Map keys must be strings");
+
+        bool  accepted = true;
+        if (isString)
+        {                        // string
+          str.assign(reinterpret_cast<char const *>(in.take(strLen)), strLen);
+          accepted = asKey ? handler.propertyName(str) : handler.stringValue(str);
+        }                        // string
+        else if (container)
+        {                        // array or map
+          Decode_Frame  frame;
+          frame.map = (container == '}');
+          frame.key = frame.map;
+          frame.remaining = frame.map ? (containerLen * 2) : containerLen;
+          if (!(frame.map ? handler.objectBegin() : handler.arrayBegin()))
+            in.handlerFail(handler);
+          if (frame.remaining)
+          {
+            stack.push_back(frame);
+            continue;
+          }
+          accepted = frame.map ? handler.objectEnd() : handler.arrayEnd();
+        }                        // array or map
+        else if (type <= 0x7f)
+          accepted = handler.numberIntValue(type);
+        else if (type >= 0xe0)
+          accepted = handler.numberIntValue(static_cast<signed char>(type));
+        else
+        {                        // other types
+          switch (type)
+          {                      // type switch
+            case 0xc0 :
+              accepted = handler.nullValue();
+              break;
+
+            case 0xc2 :
+            case 0xc3 :
+              accepted = handler.booleanValue(type == 0xc3);
+              break;
+
+            case 0xca :
+            {
+              uint32_t  bits = static_cast<uint32_t>(in.number(4));
+              float     single;
+              memcpy(&single, &bits, sizeof(single));
+              accepted = handler.numberValue(single);
+            }
+            break;
+
+            case 0xcb :
+            {
+              uint64_t  bits = in.number(8);
+              double    number;
+              memcpy(&number, &bits, sizeof(number));
+              accepted = handler.numberValue(number);
+            }
+            break;
+
+            case 0xcc :
+            case 0xcd :
+            case 0xce :
+            case 0xcf :
+              accepted = unsignedValue(handler
+                , in.number(static_cast<size_t>(1) << (type - 0xcc)));
+              break;
+
+            case 0xd0 :
+            case 0xd1 :
+            case 0xd2 :
+            case 0xd3 :
+            {
+              size_t  bytes = static_cast<size_t>(1) << (type - 0xd0);
+              accepted = signedValue(handler, in.number(bytes), bytes);
+            }
+            break;
+
+            default :
+              in.fail("Unsupported object type");
+              break;
+          }                      // type switch
+        }                        // other types
+        if (!accepted)
+          in.handlerFail(handler);
+
+        while (!stack.empty())
+        {                        // item completion
+          Decode_Frame  &frame = stack.back();
+          if (frame.map)
+            frame.key = !frame.key;
+          if (--frame.remaining)
+            break;
+          bool  map = frame.map;
+          stack.pop_back();
+          if (!(map ? handler.objectEnd() : handler.arrayEnd()))
+            in.handlerFail(handler);
+        }                        // item completion
+
+        if (stack.empty())
+          return in.offset();
+      }                          // objects loop
+    }
+    catch(Syntax_Error &ex)
+    {
+      ex.addOrigin("MsgPack::decode(char const *, size_t, Parse_Handler &)");
+      throw ex;
+    }
+    catch(Exception &ex)
+    {
+      ex.addOrigin("MsgPack::decode(char const *, size_t, Parse_Handler &)");
+      throw ex;
+    }
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
@@ -0,0 +1,857 @@
+
+/*
+ * jaula_number_format.cc : JSON Analysis User Library Acronym
+ * Number formatting implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_MATH_H
+#include <math.h>
+#endif
+
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+}
+
+
+#ifdef HAVE_LIMITS
+#include <limits>
+#endif
+
+#include <jaula/jaula_number_format.h>
+
+namespace
+{                                // anonymous namespace
+
+  /**
+   * \brief Largest magnitude for integral values written as integers
+   *
+   * \par Description
+   * 2^53, beyond it not every integer can be represented as a double.
+   */
+  double const  maxIntegral = 9007199254740992.0;
+
+  /**
+   * \brief Two digits representation of the numbers from 0 to 99
+   */
+  char const  digitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+  /**
+   * \brief Formats an unsigned number at the end of a buffer
+   *
+   * \returns the position of the first digit written.
+   */
+  char *formatDigits(char *end, uint64_t val)
+  {
+    while (val >= 100)
+    {
+      unsigned int  pair = static_cast<unsigned int>(val % 100) * 2;
+      val /= 100;
+      *(--end) = digitPairs[pair + 1];
+      *(--end) = digitPairs[pair];
+    }
+    if (val >= 10)
+    {
+      *(--end) = digitPairs[val * 2 + 1];
+      *(--end) = digitPairs[val * 2];
+    }
+    else
+      *(--end) = static_cast<char>('0' + val);
+    return end;
+  }
+
+  /**
+   * \brief Floating point number with 64 bit significand and no rounding
+   */
+  struct Diy_Fp
+  {                              // struct Diy_Fp
+    /** significand */
+    uint64_t  f;
+    /** binary exponent */
+    int       e;
+  };                             // struct Diy_Fp
+
+  /**
+   * \brief Builds a Diy_Fp
+   */
+  Diy_Fp diyFp(uint64_t f, int e)
+  {
+    Diy_Fp  r;
+    r.f = f;
+    r.e = e;
+    return r;
+  }
+
+  /**
+   * \brief Multiplies two Diy_Fp, rounding the 128 bit product to 64 bits
+   */
+  Diy_Fp multiply(Diy_Fp const &x, Diy_Fp const &y)
+  {
+    uint64_t const  m32 = 0xffffffffUL;
+    uint64_t  a = x.f >> 32;
+    uint64_t  b = x.f & m32;
+    uint64_t  c = y.f >> 32;
+    uint64_t  d = y.f & m32;
+    uint64_t  ac = a * c;
+    uint64_t  bc = b * c;
+    uint64_t  ad = a * d;
+    uint64_t  bd = b * d;
+    uint64_t  tmp = (bd >> 32) + (ad & m32) + (bc & m32)
+      + (static_cast<uint64_t>(1) << 31);
+    return diyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64);
+  }
+
+  /**
+   * \brief Shifts a Diy_Fp until the highest significand bit is set
+   */
+  Diy_Fp normalize(Diy_Fp x)
+  {
+    while (!(x.f & (static_cast<uint64_t>(1) << 63)))
+    {
+      x.f <<= 1;
+      x.e--;
+    }
+    return x;
+  }
+
+  /**
+   * \brief Cached power of ten
+   */
+  struct Cached_Power
+  {                              // struct Cached_Power
+    /** higher half of the normalized significand */
+    uint32_t  high;
+    /** lower half of the normalized significand */
+    uint32_t  low;
+    /** binary exponent */
+    int       binaryExponent;
+    /** decimal exponent */
+    int       decimalExponent;
+  };                             // struct Cached_Power
+
+  /**
+   * \brief Powers of ten from 10^-348 to 10^340 in steps of 10^8
+   */
+  Cached_Power const  cachedPowers[] =
+  {
+    { 0xfa8fd5a0UL, 0x081c0288UL, -1220, -348 },
+    { 0xbaaee17fUL, 0xa23ebf76UL, -1193, -340 },
+    { 0x8b16fb20UL, 0x3055ac76UL, -1166, -332 },
+    { 0xcf42894aUL, 0x5dce35eaUL, -1140, -324 },
+    { 0x9a6bb0aaUL, 0x55653b2dUL, -1113, -316 },
+    { 0xe61acf03UL, 0x3d1a45dfUL, -1087, -308 },
+    { 0xab70fe17UL, 0xc79ac6caUL, -1060, -300 },
+    { 0xff77b1fcUL, 0xbebcdc4fUL, -1034, -292 },
+    { 0xbe5691efUL, 0x416bd60cUL, -1007, -284 },
+    { 0x8dd01fadUL, 0x907ffc3cUL, -980, -276 },
+    { 0xd3515c28UL, 0x31559a83UL, -954, -268 },
+    { 0x9d71ac8fUL, 0xada6c9b5UL, -927, -260 },
+    { 0xea9c2277UL, 0x23ee8bcbUL, -901, -252 },
+    { 0xaecc4991UL, 0x4078536dUL, -874, -244 },
+    { 0x823c1279UL, 0x5db6ce57UL, -847, -236 },
+    { 0xc2109436UL, 0x4dfb5637UL, -821, -228 },
+    { 0x9096ea6fUL, 0x3848984fUL, -794, -220 },
+    { 0xd77485cbUL, 0x25823ac7UL, -768, -212 },
+    { 0xa086cfcdUL, 0x97bf97f4UL, -741, -204 },
+    { 0xef340a98UL, 0x172aace5UL, -715, -196 },
+    { 0xb23867fbUL, 0x2a35b28eUL, -688, -188 },
+    { 0x84c8d4dfUL, 0xd2c63f3bUL, -661, -180 },
+    { 0xc5dd4427UL, 0x1ad3cdbaUL, -635, -172 },
+    { 0x936b9fceUL, 0xbb25c996UL, -608, -164 },
+    { 0xdbac6c24UL, 0x7d62a584UL, -582, -156 },
+    { 0xa3ab6658UL, 0x0d5fdaf6UL, -555, -148 },
+    { 0xf3e2f893UL, 0xdec3f126UL, -529, -140 },
+    { 0xb5b5ada8UL, 0xaaff80b8UL, -502, -132 },
+    { 0x87625f05UL, 0x6c7c4a8bUL, -475, -124 },
+    { 0xc9bcff60UL, 0x34c13053UL, -449, -116 },
+    { 0x964e858cUL, 0x91ba2655UL, -422, -108 },
+    { 0xdff97724UL, 0x70297ebdUL, -396, -100 },
+    { 0xa6dfbd9fUL, 0xb8e5b88fUL, -369, -92 },
+    { 0xf8a95fcfUL, 0x88747d94UL, -343, -84 },
+    { 0xb9447093UL, 0x8fa89bcfUL, -316, -76 },
+    { 0x8a08f0f8UL, 0xbf0f156bUL, -289, -68 },
+    { 0xcdb02555UL, 0x653131b6UL, -263, -60 },
+    { 0x993fe2c6UL, 0xd07b7facUL, -236, -52 },
+    { 0xe45c10c4UL, 0x2a2b3b06UL, -210, -44 },
+    { 0xaa242499UL, 0x697392d3UL, -183, -36 },
+    { 0xfd87b5f2UL, 0x8300ca0eUL, -157, -28 },
+    { 0xbce50864UL, 0x92111aebUL, -130, -20 },
+    { 0x8cbccc09UL, 0x6f5088ccUL, -103, -12 },
+    { 0xd1b71758UL, 0xe219652cUL, -77, -4 },
+    { 0x9c400000UL, 0x00000000UL, -50, 4 },
+    { 0xe8d4a510UL, 0x00000000UL, -24, 12 },
+    { 0xad78ebc5UL, 0xac620000UL, 3, 20 },
+    { 0x813f3978UL, 0xf8940984UL, 30, 28 },
+    { 0xc097ce7bUL, 0xc90715b3UL, 56, 36 },
+    { 0x8f7e32ceUL, 0x7bea5c70UL, 83, 44 },
+    { 0xd5d238a4UL, 0xabe98068UL, 109, 52 },
+    { 0x9f4f2726UL, 0x179a2245UL, 136, 60 },
+    { 0xed63a231UL, 0xd4c4fb27UL, 162, 68 },
+    { 0xb0de6538UL, 0x8cc8ada8UL, 189, 76 },
+    { 0x83c7088eUL, 0x1aab65dbUL, 216, 84 },
+    { 0xc45d1df9UL, 0x42711d9aUL, 242, 92 },
+    { 0x924d692cUL, 0xa61be758UL, 269, 100 },
+    { 0xda01ee64UL, 0x1a708deaUL, 295, 108 },
+    { 0xa26da399UL, 0x9aef774aUL, 322, 116 },
+    { 0xf209787bUL, 0xb47d6b85UL, 348, 124 },
+    { 0xb454e4a1UL, 0x79dd1877UL, 375, 132 },
+    { 0x865b8692UL, 0x5b9bc5c2UL, 402, 140 },
+    { 0xc83553c5UL, 0xc8965d3dUL, 428, 148 },
+    { 0x952ab45cUL, 0xfa97a0b3UL, 455, 156 },
+    { 0xde469fbdUL, 0x99a05fe3UL, 481, 164 },
+    { 0xa59bc234UL, 0xdb398c25UL, 508, 172 },
+    { 0xf6c69a72UL, 0xa3989f5cUL, 534, 180 },
+    { 0xb7dcbf53UL, 0x54e9beceUL, 561, 188 },
+    { 0x88fcf317UL, 0xf22241e2UL, 588, 196 },
+    { 0xcc20ce9bUL, 0xd35c78a5UL, 614, 204 },
+    { 0x98165af3UL, 0x7b2153dfUL, 641, 212 },
+    { 0xe2a0b5dcUL, 0x971f303aUL, 667, 220 },
+    { 0xa8d9d153UL, 0x5ce3b396UL, 694, 228 },
+    { 0xfb9b7cd9UL, 0xa4a7443cUL, 720, 236 },
+    { 0xbb764c4cUL, 0xa7a44410UL, 747, 244 },
+    { 0x8bab8eefUL, 0xb6409c1aUL, 774, 252 },
+    { 0xd01fef10UL, 0xa657842cUL, 800, 260 },
+    { 0x9b10a4e5UL, 0xe9913129UL, 827, 268 },
+    { 0xe7109bfbUL, 0xa19c0c9dUL, 853, 276 },
+    { 0xac2820d9UL, 0x623bf429UL, 880, 284 },
+    { 0x80444b5eUL, 0x7aa7cf85UL, 907, 292 },
+    { 0xbf21e440UL, 0x03acdd2dUL, 933, 300 },
+    { 0x8e679c2fUL, 0x5e44ff8fUL, 960, 308 },
+    { 0xd433179dUL, 0x9c8cb841UL, 986, 316 },
+    { 0x9e19db92UL, 0xb4e31ba9UL, 1013, 324 },
+    { 0xeb96bf6eUL, 0xbadf77d9UL, 1039, 332 },
+    { 0xaf87023bUL, 0x9bf0ee6bUL, 1066, 340 }
+  };
+
+  /**
+   * \brief Decimal exponent of the first cached power, negated
+   */
+  int const cachedPowersOffset = 348;
+
+  /**
+   * \brief Decimal exponent distance between consecutive cached powers
+   */
+  int const cachedPowersStep = 8;
+
+  /**
+   * \brief Powers of ten fitting 32 bits
+   */
+  uint32_t const  smallPowers[] =
+  {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+    , 1000000000
+  };
+
+  /**
+   * \brief Moves the last digit down while the result gets closer to w
+   *
+   * \returns true if the digits are known to be the shortest ones that
+   * read back as the original value (see Loitsch, "Printing floating-point
+   * numbers quickly and accurately with integers", 2010).
+   */
+  bool roundWeed(char *digits, int length, uint64_t distanceHighW
+    , uint64_t unsafe, uint64_t rest, uint64_t tenKappa, uint64_t unit)
+  {
+    uint64_t const  smallDistance = distanceHighW - unit;
+    uint64_t const  bigDistance = distanceHighW + unit;
+    while ((rest < smallDistance) && ((unsafe - rest) >= tenKappa)
+      && (((rest + tenKappa) < smallDistance)
+      || ((smallDistance - rest) >= (rest + tenKappa - smallDistance))))
+    {
+      digits[length - 1]--;
+      rest += tenKappa;
+    }
+    if ((rest < bigDistance) && ((unsafe - rest) >= tenKappa)
+      && (((rest + tenKappa) < bigDistance)
+      || ((bigDistance - rest) > (rest + tenKappa - bigDistance))))
+      return false;
+    return ((2 * unit) <= rest) && (rest <= (unsafe - 4 * unit));
+  }
+
+  /**
+   * \brief Generates the shortest digits of a positive double (Grisu3)
+   *
+   * \param data Number to convert, finite and greater than zero.
+   *
+   * \param digits Where the digits are written (at least 18 bytes).
+   *
+   * \param length Where the number of digits is stored.
+   *
+   * \param exponent Where the decimal exponent is stored, so that the
+   * number is digits * 10^exponent.
+   *
+   * \returns false for the few numbers the algorithm can not prove the
+   * result to be the shortest one.
+   */
+  bool grisu3(double data, char *digits, int &length, int &exponent)
+  {
+    uint64_t  bits;
+    memcpy(&bits, &data, sizeof(bits));
+    uint64_t const  hidden = static_cast<uint64_t>(1) << 52;
+    uint64_t  fraction = bits & (hidden - 1);
+    int       biased = static_cast<int>((bits >> 52) & 0x7ff);
+    Diy_Fp    v = biased
+      ? diyFp(fraction + hidden, biased - 1075)
+      : diyFp(fraction, -1074);
+
+    // boundaries halfway to the neighbour doubles
+    Diy_Fp  plus = normalize(diyFp((v.f << 1) + 1, v.e - 1));
+    Diy_Fp  minus = (!fraction && (biased > 1))
+      ? diyFp((v.f << 2) - 1, v.e - 2)
+      : diyFp((v.f << 1) - 1, v.e - 1);
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+    Diy_Fp  w = normalize(v);
+
+    // cached power bringing the binary exponent into [-60, -32]
+    int const k = static_cast<int>(ceil((-60 - (w.e + 64) + 63)
+      * 0.30102999566398114));
+    Cached_Power const  &cached = cachedPowers[
+      (cachedPowersOffset + k - 1) / cachedPowersStep + 1];
+    Diy_Fp const  tenMk = diyFp((static_cast<uint64_t>(cached.high) << 32)
+      | cached.low, cached.binaryExponent);
+    w = multiply(w, tenMk);
+    minus = multiply(minus, tenMk);
+    plus = multiply(plus, tenMk);
+
+    // digit generation over the unsafe interval
+    uint64_t  unit = 1;
+    Diy_Fp const  tooLow = diyFp(minus.f - unit, minus.e);
+    Diy_Fp const  tooHigh = diyFp(plus.f + unit, plus.e);
+    uint64_t  unsafe = tooHigh.f - tooLow.f;
+    int const shift = -w.e;
+    uint64_t const  one = static_cast<uint64_t>(1) << shift;
+    uint32_t  integrals = static_cast<uint32_t>(tooHigh.f >> shift);
+    uint64_t  fractionals = tooHigh.f & (one - 1);
+    int kappa = 0;
+    while ((kappa < 10) && (integrals >= smallPowers[kappa]))
+      kappa++;
+    length = 0;
+    while (kappa > 0)
+    {
+      uint32_t const  divisor = smallPowers[kappa - 1];
+      digits[length++] = static_cast<char>('0' + integrals / divisor);
+      integrals %= divisor;
+      kappa--;
+      uint64_t const  rest = (static_cast<uint64_t>(integrals) << shift)
+        + fractionals;
+      if (rest < unsafe)
+      {
+        exponent = kappa - cached.decimalExponent;
+        return roundWeed(digits, length, tooHigh.f - w.f, unsafe, rest
+          , static_cast<uint64_t>(divisor) << shift, unit);
+      }
+    }
+    for (;;)
+    {
+      fractionals *= 10;
+      unit *= 10;
+      unsafe *= 10;
+      digits[length++] = static_cast<char>('0' + (fractionals >> shift));
+      fractionals &= one - 1;
+      kappa--;
+      if (fractionals < unsafe)
+      {
+        exponent = kappa - cached.decimalExponent;
+        return roundWeed(digits, length, (tooHigh.f - w.f) * unit, unsafe
+          , fractionals, one, unit);
+      }
+    }
+  }
+
+  /**
+   * \brief Generates the shortest digits of a positive double with printf
+   *
+   * \par Description
+   * Fallback for grisu3(). A correctly rounded representation with some
+   * precision reads back exactly when it does with less, so the shortest
+   * precision is found by a binary search.
+   */
+  void shortestPrintf(double data, char *digits, int &length, int &exponent)
+  {
+    char  buffer[32];
+    int   low = 1;
+    int   high = 17;
+    while (low < high)
+    {
+      int const middle = (low + high) / 2;
+      snprintf(buffer, sizeof(buffer), "%.*e", middle - 1, data);
+      if (strtod(buffer, 0) == data)
+        high = middle;
+      else
+        low = middle + 1;
+    }
+    // d.ddde[+-]xx, the decimal point may be anything but a digit
+    int len = snprintf(buffer, sizeof(buffer), "%.*e", low - 1, data);
+    length = 0;
+    int i = 0;
+    for (; (i < len) && (buffer[i] != 'e'); i++)
+      if ((buffer[i] >= '0') && (buffer[i] <= '9'))
+        digits[length++] = buffer[i];
+    exponent = atoi(buffer + i + 1) - (length - 1);
+    while ((length > 1) && (digits[length - 1] == '0'))
+    {
+      length--;
+      exponent++;
+    }
+  }
+
+  /**
+   * \brief Writes digits and decimal exponent as a JSON number
+   *
+   * \returns the number of bytes written.
+   *
+   * \par Description
+   * The layout is the one of printf %.17g: exponential notation when the
+   * exponent of the first digit is below -4 or above 16, positional
+   * otherwise.
+   */
+  size_t layoutDigits(char *buffer, bool negative, char const *digits
+    , int length, int exponent)
+  {
+    char  *p = buffer;
+    if (negative)
+      *p++ = '-';
+    int const point = length + exponent;
+    if ((point > -4) && (point <= 17))
+    {
+      if (point <= 0)
+      {                          // 0.000ddd
+        *p++ = '0';
+        *p++ = '.';
+        for (int i = point; (i < 0); i++)
+          *p++ = '0';
+        memcpy(p, digits, length);
+        p += length;
+      }
+      else if (point >= length)
+      {                          // ddd000
+        memcpy(p, digits, length);
+        p += length;
+        for (int i = length; (i < point); i++)
+          *p++ = '0';
+      }
+      else
+      {                          // dd.ddd
+        memcpy(p, digits, point);
+        p += point;
+        *p++ = '.';
+        memcpy(p, digits + point, length - point);
+        p += length - point;
+      }
+      return p - buffer;
+    }
+
+    *p++ = digits[0];
+    if (length > 1)
+    {
+      *p++ = '.';
+      memcpy(p, digits + 1, length - 1);
+      p += length - 1;
+    }
+    *p++ = 'e';
+    int scientific = point - 1;
+    if (scientific < 0)
+    {
+      *p++ = '-';
+      scientific = -scientific;
+    }
+    else
+      *p++ = '+';
+    if (scientific < 10)
+    {
+      *p++ = '0';
+      *p++ = static_cast<char>('0' + scientific);
+      return p - buffer;
+    }
+    char  *end = p + ((scientific >= 100) ? 3 : 2);
+    formatDigits(end, static_cast<uint64_t>(scientific));
+    return end - buffer;
+  }
+
+  /**
+   * \brief Skips decimal digits
+   *
+   * \returns the position of the first byte from i not being a digit.
+   */
+  size_t skipDigits(char const *data, size_t len, size_t i)
+  {
+    while ((i < len) && (data[i] >= '0') && (data[i] <= '9'))
+      i++;
+    return i;
+  }
+
+  /**
+   * \brief Adds a value to a decimal number held as text
+   *
+   * \param negative Sign of the number, updated to the one of the result.
+   *
+   * \param digits Digits of the number without leading zeros, replaced by
+   * the ones of the result (empty for zero).
+   *
+   * \param delta Value to add.
+   */
+  void addDecimal(bool &negative, std::string &digits, long delta)
+  {
+    bool const  negativeDelta = (delta < 0);
+    char  buffer[JAULA::Number_Format::BUFFER_SIZE];
+    char  *end = buffer + sizeof(buffer);
+    char  *p = formatDigits(end, negativeDelta
+      ? (0UL - static_cast<unsigned long>(delta))
+      : static_cast<unsigned long>(delta));
+    std::string other(p, end);
+    if ((other == "0") || digits.empty())
+    {
+      if (digits.empty())
+      {
+        negative = negativeDelta;
+        digits = (other == "0") ? std::string() : other;
+      }
+      return;
+    }
+
+    if (other.size() < digits.size())
+      other.insert(0, digits.size() - other.size(), '0');
+    else
+      digits.insert(0, other.size() - digits.size(), '0');
+    bool const  add = (negative == negativeDelta);
+    if (!add && (digits < other))
+    {
+      digits.swap(other);
+      negative = negativeDelta;
+    }
+    int   carry = 0;
+    for (size_t k = digits.size(); (k-- > 0);)
+    {
+      int   d = add ? ((digits[k] - '0') + (other[k] - '0') + carry)
+        : ((digits[k] - '0') - (other[k] - '0') - carry);
+      carry = add ? (d >= 10) : (d < 0);
+      digits[k] = static_cast<char>('0' + (add ? (d % 10) : (d + carry * 10)));
+    }
+    if (carry)
+      digits.insert(0, 1, '1');
+    digits.erase(0, digits.find_first_not_of('0'));
+  }
+
+  /**
+   * \brief Replaces the locale decimal point by a dot
+   *
+   * \returns the resulting length.
+   *
+   * \par Description
+   * Everything not being a digit, a sign or an exponent mark is taken as
+   * part of the decimal point (it may be longer than one byte).
+   */
+  size_t fixDecimalPoint(char *buffer, size_t len)
+  {
+    size_t  out = 0;
+    bool    inPoint = false;
+    for (size_t in = 0; in < len; in++)
+    {
+      char  c = buffer[in];
+      if (((c >= '0') && (c <= '9'))
+        || (c == '-') || (c == '+') || (c == 'e'))
+      {
+        buffer[out++] = c;
+        inPoint = false;
+      }
+      else if (!inPoint)
+      {
+        buffer[out++] = '.';
+        inPoint = true;
+      }
+    }
+    return out;
+  }
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  size_t Number_Format::formatInt(char *buffer, int64_t data)
+  {
+    char  digits[BUFFER_SIZE];
+    char  *end = digits + sizeof(digits);
+    char  *p = formatDigits(end, (data < 0)
+      ? (static_cast<uint64_t>(0) - static_cast<uint64_t>(data))
+      : static_cast<uint64_t>(data));
+    if (data < 0)
+      *(--p) = '-';
+    memcpy(buffer, p, end - p);
+    return end - p;
+  }
+
+  bool Number_Format::isInt(char const *data, size_t len)
+  {
+    size_t  i = 0;
+    if ((i < len) && ((data[i] == '+') || (data[i] == '-')))
+      i++;
+    if (i == len)
+      return false;
+    for (; (i < len); i++)
+      if ((data[i] < '0') || (data[i] > '9'))
+        return false;
+    return true;
+  }
+
+  Number_Format::Int_Range Number_Format::scanInt(char const *data
+    , size_t len, int64_t &value, uint64_t &unsigned_value)
+  {
+    uint64_t const  limit = ~static_cast<uint64_t>(0);
+    bool    negative = false;
+    size_t  i = 0;
+    if ((i < len) && ((data[i] == '+') || (data[i] == '-')))
+      negative = (data[i++] == '-');
+    uint64_t  magnitude = 0;
+    for (; (i < len); i++)
+    {
+      unsigned int  digit = data[i] - '0';
+      if (magnitude > ((limit - digit) / 10))
+        return INT_BIG;
+      magnitude = magnitude * 10 + digit;
+    }
+    uint64_t const  signedMax =
+      static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+    if (negative)
+    {
+      if (magnitude > signedMax + 1)
+        return INT_BIG;
+      value = (magnitude > signedMax)
+        ? std::numeric_limits<int64_t>::min()
+        : -static_cast<int64_t>(magnitude);
+      return INT_SIGNED;
+    }
+    if (magnitude > signedMax)
+    {
+      unsigned_value = magnitude;
+      return INT_UNSIGNED;
+    }
+    value = static_cast<int64_t>(magnitude);
+    return INT_SIGNED;
+  }
+
+  bool Number_Format::jsonText(char const *data, size_t len
+    , std::string &text)
+  {
+    text.erase();
+    bool const  negative = (len > 0) && (data[0] == '-');
+    size_t  i = (negative || ((len > 0) && (data[0] == '+'))) ? 1 : 0;
+    while (((i + 1) < len) && (data[i] == '0')
+      && (data[i + 1] >= '0') && (data[i + 1] <= '9'))
+      i++;
+    size_t const  start = i;
+
+    // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    i = skipDigits(data, len, start);
+    bool  valid = (i != start);
+    if (valid && (i < len) && (data[i] == '.'))
+    {
+      size_t const  digits = ++i;
+      i = skipDigits(data, len, digits);
+      valid = (i != digits);
+    }
+    if (valid && (i < len) && ((data[i] == 'e') || (data[i] == 'E')))
+    {
+      if ((++i < len) && ((data[i] == '+') || (data[i] == '-')))
+        i++;
+      size_t const  digits = i;
+      i = skipDigits(data, len, digits);
+      valid = (i != digits);
+    }
+    if (!valid || (i != len))
+      return false;
+
+    if (negative)
+      text += '-';
+    text.append(data + start, len - start);
+    return true;
+  }
+
+  size_t Number_Format::formatUnsigned(char *buffer, uint64_t data)
+  {
+    char  digits[BUFFER_SIZE];
+    char  *end = digits + sizeof(digits);
+    char  *p = formatDigits(end, data);
+    memcpy(buffer, p, end - p);
+    return end - p;
+  }
+
+  size_t Number_Format::formatDouble(char *buffer, double data, int precision)
+  {
+    if ((data != data) || ((data - data) != (data - data)))
+    {                            // not a number or infinite
+      memcpy(buffer, "null", 4);
+      return 4;
+    }                            // not a number or infinite
+
+    if ((data > -maxIntegral) && (data < maxIntegral)
+      && (data == static_cast<double>(static_cast<int64_t>(data)))
+      && ((data != 0) || ((1.0 / data) > 0)))
+      return formatInt(buffer, static_cast<int64_t>(data));
+
+    if (precision > 0)
+      return fixDecimalPoint(buffer, snprintf(buffer, BUFFER_SIZE, "%.*g"
+        , (precision < 17) ? precision : 17, data));
+
+    if (data == 0)
+    {                            // negative zero
+      memcpy(buffer, "-0", 2);
+      return 2;
+    }                            // negative zero
+
+    // shortest round trip representation
+    char  digits[20];
+    int   length;
+    int   exponent;
+    bool const  negative = (data < 0);
+    if (negative)
+      data = -data;
+    if (!grisu3(data, digits, length, exponent))
+      shortestPrintf(data, digits, length, exponent);
+    return layoutDigits(buffer, negative, digits, length, exponent);
+  }
+
+  std::string Number_Format::normalize(char const *data, size_t len)
+  {
+    size_t const  digits10 = 9;  // always fit in a long
+    bool    negative = false;
+    size_t  i = 0;
+    if ((i < len) && ((data[i] == '+') || (data[i] == '-')))
+      negative = (data[i++] == '-');
+
+    std::string digits;
+    long    exponent = 0;
+    bool    fraction = false;
+    for (; ((i < len) && (data[i] != 'e') && (data[i] != 'E')); i++)
+    {
+      if (data[i] == '.')
+      {
+        fraction = true;
+        continue;
+      }
+      if (fraction)
+        exponent--;
+      if (!digits.empty() || (data[i] != '0'))
+        digits += data[i];
+    }
+    if (digits.empty())
+      return "0";
+    while (digits[digits.size() - 1] == '0')
+    {
+      digits.resize(digits.size() - 1);
+      exponent++;
+    }
+
+    bool    negativeExp = false;
+    std::string expDigits;
+    if (i < len)
+    {                            // explicit exponent
+      if ((++i < len) && ((data[i] == '+') || (data[i] == '-')))
+        negativeExp = (data[i++] == '-');
+      while ((i < len) && (data[i] == '0'))
+        i++;
+      if ((len - i) <= digits10)
+      {
+        long    value = 0;
+        for (; (i < len); i++)
+          value = value * 10 + (data[i] - '0');
+        exponent += negativeExp ? -value : value;
+      }
+      else
+      {                          // too long for a long, added as text
+        expDigits.assign(data + i, len - i);
+        addDecimal(negativeExp, expDigits, exponent);
+        exponent = 0;
+      }                          // too long for a long, added as text
+    }                            // explicit exponent
+
+    std::string result(negative ? "-" : "");
+    result += digits;
+    if (!expDigits.empty())
+    {
+      result += negativeExp ? "e-" : "e";
+      result += expDigits;
+    }
+    else if (exponent)
+    {
+      char  buffer[BUFFER_SIZE];
+      result += 'e';
+      result.append(buffer, formatInt(buffer, exponent));
+    }
+    return result;
+  }
+
+  std::string Number_Format::normalize(double data)
+  {
+    if ((data != data) || ((data - data) != (data - data)))
+      return std::string();
+    char  buffer[BUFFER_SIZE];
+    return normalize(buffer, formatDouble(buffer, data));
+  }
+
+  void Number_Format::writeInt(Output_Buffer &out, int64_t data)
+  {
+    out.commit(formatInt(out.reserve(BUFFER_SIZE), data));
+  }
+
+  void Number_Format::writeUnsigned(Output_Buffer &out, uint64_t data)
+  {
+    out.commit(formatUnsigned(out.reserve(BUFFER_SIZE), data));
+  }
+
+  void Number_Format::writeDouble(Output_Buffer &out, double data
+    , int precision)
+  {
+    out.commit(formatDouble(out.reserve(BUFFER_SIZE), data, precision));
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
@@ -0,0 +1,248 @@
+
+/*
+ * jaula_number_format.h : JSON Analysis User Library Acronym
+ * Number formatting definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_NUMBER_FORMAT_H_
+#define _JAULA_NUMBER_FORMAT_H_
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <string>
+
+#include <jaula/jaula_output_buffer.h>
+
+/**
+ * \addtogroup jaula_out JAULA: JSON data output
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief JSON number formatting routines
+   *
+   * \ingroup jaula_out
+   *
+   * \par
+   * This class groups the routines that write numbers in JSON notation.
+   * Floating point numbers are written by default with the shortest
+   * representation that reads back as the same value, and the output does
+   * not depend on the current locale.
+   *
+   * \par
+   * JSON has no representation for infinite or not a number values, so they
+   * are written as null.
+   *
+   * \par
+   * The routines that tell which native type can hold a number read by the
+   * parsers are here too.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Number_Format
+  {                              // class Number_Format
+    public:
+
+      /**
+       * \brief Size of the buffers passed to the formatting routines
+       */
+      enum    { BUFFER_SIZE = 32 };
+
+      /**
+       * \brief Native types able to hold an integer as returned by scanInt()
+       */
+      enum    Int_Range
+      {                          // enum Int_Range
+        /** The number fits a 64 bit signed integer */
+        INT_SIGNED
+        /** The number is positive and only fits a 64 bit unsigned integer */
+        ,   INT_UNSIGNED
+        /** The number fits neither */
+        ,   INT_BIG
+      };                         // enum Int_Range
+
+      /**
+       * \brief Checks whether a number has neither decimals nor exponent
+       *
+       * \param data Pointer to the representation of a valid JSON number.
+       *
+       * \param len Number of bytes of the representation.
+       *
+       * \returns true if the representation is an optional sign followed by
+       * decimal digits only.
+       */
+      static bool isInt(char const *data, size_t len);
+
+      /**
+       * \brief Reads an integer number
+       *
+       * \param data Pointer to the representation, an optional sign followed
+       * by decimal digits only.
+       *
+       * \param len Number of bytes of the representation.
+       *
+       * \param value Where the number is stored if it fits a 64 bit signed
+       * integer.
+       *
+       * \param unsigned_value Where the number is stored if it only fits a
+       * 64 bit unsigned integer.
+       *
+       * \returns the native type that holds the number exactly.
+       */
+      static Int_Range scanInt(char const *data, size_t len, int64_t &value
+        , uint64_t &unsigned_value);
+
+      /**
+       * \brief Rewrites the text of a number as JSON requires
+       *
+       * \param data Pointer to the representation.
+       *
+       * \param len Number of bytes of the representation.
+       *
+       * \param text Where the rewritten representation is stored.
+       *
+       * \returns true if the representation is a number, false otherwise
+       * (text is left empty then).
+       *
+       * \par Description
+       * The parsers accept a leading plus sign and leading zeros, which
+       * RFC 8259 does not allow. Both are dropped, so that the text kept
+       * from a parser can be written back as valid JSON.
+       */
+      static bool jsonText(char const *data, size_t len, std::string &text);
+
+      /**
+       * \brief Formats an integer number
+       *
+       * \param buffer Pointer to BUFFER_SIZE bytes where the representation
+       * is to be written (without terminating null).
+       *
+       * \param data Number to format.
+       *
+       * \returns the number of bytes written.
+       */
+      static size_t formatInt(char *buffer, int64_t data);
+
+      /**
+       * \brief Formats an unsigned integer number
+       *
+       * \param buffer Pointer to BUFFER_SIZE bytes where the representation
+       * is to be written (without terminating null).
+       *
+       * \param data Number to format.
+       *
+       * \returns the number of bytes written.
+       */
+      static size_t formatUnsigned(char *buffer, uint64_t data);
+
+      /**
+       * \brief Formats a floating point number
+       *
+       * \param buffer Pointer to BUFFER_SIZE bytes where the representation
+       * is to be written (without terminating null).
+       *
+       * \param data Number to format.
+       *
+       * \param precision Number of significant digits to write, 0 for the
+       * shortest representation that reads back as the same value.
+       *
+       * \returns the number of bytes written.
+       *
+       * \par Description
+       * Integral values are written without fraction or exponent. The
+       * shortest digits of other values are found by the Grisu3 algorithm,
+       * with a printf based search for the few values it can not decide.
+       */
+      static size_t formatDouble(char *buffer, double data
+        , int precision = 0);
+
+      /**
+       * \brief Normalizes the text of a number
+       *
+       * \param data Pointer to the representation of a valid JSON number.
+       *
+       * \param len Number of bytes of the representation.
+       *
+       * \returns the sign, the significant digits without leading or trailing
+       * zeros and the decimal exponent of the last one, so that two texts
+       * for the same decimal number give the same result (\c 1.50 and
+       * \c 15e-1 both give \c 15e-1). Zero gives \c 0 whatever its sign.
+       *
+       * \par Description
+       * Exponents of any length are kept exact, those too long for a long
+       * being added up as decimal text.
+       */
+      static std::string normalize(char const *data, size_t len);
+
+      /**
+       * \brief Normalizes a floating point number
+       *
+       * \param data Number to normalize.
+       *
+       * \returns the normalized text of its shortest representation, or an
+       * empty string if it is not finite.
+       */
+      static std::string normalize(double data);
+
+      /**
+       * \brief Writes an integer number
+       *
+       * \param out Buffer where the representation is to be written.
+       *
+       * \param data Number to write.
+       */
+      static void writeInt(Output_Buffer &out, int64_t data);
+
+      /**
+       * \brief Writes an unsigned integer number
+       *
+       * \param out Buffer where the representation is to be written.
+       *
+       * \param data Number to write.
+       */
+      static void writeUnsigned(Output_Buffer &out, uint64_t data);
+
+      /**
+       * \brief Writes a floating point number
+       *
+       * \param out Buffer where the representation is to be written.
+       *
+       * \param data Number to write.
+       *
+       * \param precision Number of significant digits to write, 0 for the
+       * shortest representation that reads back as the same value.
+       */
+      static void writeDouble(Output_Buffer &out, double data
+        , int precision = 0);
+
+  };                             // class Number_Format
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
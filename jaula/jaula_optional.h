@@ -0,0 +1,143 @@
+
+/*
+ * jaula_optional.h : JSON Analysis User Library Acronym
+ * Optional value definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_OPTIONAL_H_
+#define _JAULA_OPTIONAL_H_
+
+/**
+ * \addtogroup jaula_bind JAULA: Binding to C++ types
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Container for a value that may be missing
+   *
+   * \ingroup jaula_bind
+   *
+   * \par
+   * This template holds a value of the type given together with a flag
+   * telling whether it has been set, so bound members can be absent or null
+   * in the JSON data. The value is kept inside the instance, so setting it
+   * does not allocate.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  template <typename T>
+    class Optional
+  {                              // class Optional
+    public:
+
+      /**
+       * \brief Constructor
+       *
+       * \par Description
+       * Creates an instance without value.
+       */
+      Optional(void)
+        : set_(false)
+        , value_()
+        {}
+
+      /**
+       * \brief Constructor
+       *
+       * \param value Value to hold.
+       */
+      Optional(T const &value)
+        : set_(true)
+        , value_(value)
+        {}
+
+      /**
+       * \brief Checks whether a value is held
+       */
+      bool isSet(void) const
+      {
+        return set_;
+      }
+
+      /**
+       * \brief Retrieves the value held
+       *
+       * \note
+       * If no value is held, the default value of the type is returned.
+       */
+      T const &get(void) const
+      {
+        return value_;
+      }
+
+      /**
+       * \brief Marks the instance as set and gives access to its value
+       */
+      T &set(void)
+      {
+        set_ = true;
+        return value_;
+      }
+
+      /**
+       * \brief Holds a new value
+       *
+       * \param value Value to hold.
+       */
+      void set(T const &value)
+      {
+        set_ = true;
+        value_ = value;
+      }
+
+      /**
+       * \brief Discards the value held
+       */
+      void reset(void)
+      {
+        set_ = false;
+        value_ = T();
+      }
+
+    private:
+
+      /**
+       * \brief Flag for a value held
+       */
+      bool  set_;
+
+      /**
+       * \brief Value held
+       */
+      T   value_;
+
+  };                             // class Optional
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
@@ -0,0 +1,168 @@
+
+/*
+ * jaula_output_buffer.cc : JSON Analysis User Library Acronym
+ * Output buffer definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+}
+
+
+#include <jaula/jaula_output_buffer.h>
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Output_Buffer::Output_Buffer(void)
+    : pSink_(0)
+    , buffer_(0)
+    , capacity_(0)
+    , size_(0)
+    {}
+
+  Output_Buffer::Output_Buffer(Sink &sink, size_t capacity)
+    : pSink_(&sink)
+    , buffer_(new char[capacity ? capacity : 1])
+    , capacity_(capacity ? capacity : 1)
+    , size_(0)
+    {}
+
+  Output_Buffer::~Output_Buffer()
+  {
+    drain();
+    delete [] buffer_;
+  }
+
+  char *Output_Buffer::reserve(size_t len)
+  {
+    if ((capacity_ - size_) < len)
+    {
+      drain();
+      if ((capacity_ - size_) < len)
+        grow(len);
+    }
+    return buffer_ + size_;
+  }
+
+  void Output_Buffer::commit(size_t len)
+  {
+    size_ += len;
+  }
+
+  void Output_Buffer::append(char const *data, size_t len)
+  {
+    if ((capacity_ - size_) < len)
+    {
+      drain();
+      if (pSink_ && (len >= capacity_))
+      {
+        pSink_->write(data, len);
+        return;
+      }
+      if ((capacity_ - size_) < len)
+        grow(len);
+    }
+    memcpy(buffer_ + size_, data, len);
+    size_ += len;
+  }
+
+  void Output_Buffer::append(char c)
+  {
+    if (size_ == capacity_)
+    {
+      drain();
+      if (size_ == capacity_)
+        grow(1);
+    }
+    buffer_[size_++] = c;
+  }
+
+  char const *Output_Buffer::data(void) const
+  {
+    return buffer_;
+  }
+
+  size_t Output_Buffer::size(void) const
+  {
+    return size_;
+  }
+
+  std::string Output_Buffer::str(void) const
+  {
+    return std::string(buffer_, size_);
+  }
+
+  Sink *Output_Buffer::getSink(void) const
+  {
+    return pSink_;
+  }
+
+  void Output_Buffer::clear(void)
+  {
+    size_ = 0;
+  }
+
+  void Output_Buffer::flush(void)
+  {
+    if (pSink_)
+    {
+      drain();
+      pSink_->flush();
+    }
+  }
+
+  void Output_Buffer::drain(void)
+  {
+    if (pSink_ && size_)
+    {
+      pSink_->write(buffer_, size_);
+      size_ = 0;
+    }
+  }
+
+  void Output_Buffer::grow(size_t len)
+  {
+    size_t  newCapacity = capacity_ ? (capacity_ * 2) : 256;
+    while ((newCapacity - size_) < len)
+      newCapacity *= 2;
+    char  *newBuffer = new char[newCapacity];
+    if (size_)
+      memcpy(newBuffer, buffer_, size_);
+    delete [] buffer_;
+    buffer_ = newBuffer;
+    capacity_ = newCapacity;
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
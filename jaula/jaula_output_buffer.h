@@ -0,0 +1,211 @@
+
+/*
+ * jaula_output_buffer.h : JSON Analysis User Library Acronym
+ * Output buffer definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_OUTPUT_BUFFER_H_
+#define _JAULA_OUTPUT_BUFFER_H_
+
+#include <cstddef>
+#include <string>
+
+#include <jaula/jaula_sink.h>
+
+/**
+ * \addtogroup jaula_out JAULA: JSON data output
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Contiguous output buffer
+   *
+   * \ingroup jaula_out
+   *
+   * \par
+   * This class holds the data generated by the writers in a contiguous
+   * memory block. If no sink is specified, the block grows as needed to hold
+   * all the data. Otherwise, its contents are sent to the sink every time
+   * it gets full.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Output_Buffer
+  {                              // class Output_Buffer
+    public:
+
+      /**
+       * \brief Default Constructor
+       *
+       * \par Description
+       * Creates an empty buffer that grows to hold all the data.
+       */
+      Output_Buffer(void);
+
+      /**
+       * \brief Sink Constructor
+       *
+       * \param sink Reference to the sink where data is to be sent. It must
+       * exist during all the buffer life cycle.
+       *
+       * \param capacity Amount of data to hold before sending it to the
+       * sink.
+       */
+      Output_Buffer(Sink &sink, size_t capacity = 65536);
+
+      /**
+       * \brief Destructor
+       *
+       * \note
+       * Data not flushed yet is sent to the sink (if any).
+       */
+      ~Output_Buffer();
+
+      /**
+       * \brief Makes room for new data
+       *
+       * \param len Number of bytes needed.
+       *
+       * \returns a pointer to a memory area where at least len bytes can be
+       * written. The data written does not become part of the buffer until
+       * commit() is invoked.
+       *
+       * \warning
+       * The pointer returned is void after any other method is invoked.
+       */
+      char *reserve(size_t len);
+
+      /**
+       * \brief Adds the data written in the area returned by reserve()
+       *
+       * \param len Number of bytes actually written.
+       */
+      void commit(size_t len);
+
+      /**
+       * \brief Adds data to the buffer
+       *
+       * \param data Pointer to the data to add.
+       *
+       * \param len Number of bytes to add.
+       */
+      void append(char const *data, size_t len);
+
+      /**
+       * \brief Adds a single character to the buffer
+       */
+      void append(char c);
+
+      /**
+       * \brief Retrieves the data held by the buffer
+       *
+       * \note
+       * When a sink has been specified, only the data not sent yet is held.
+       */
+      char const *data(void) const;
+
+      /**
+       * \brief Retrieves the number of bytes held by the buffer
+       */
+      size_t size(void) const;
+
+      /**
+       * \brief Retrieves a copy of the data held by the buffer
+       */
+      std::string str(void) const;
+
+      /**
+       * \brief Retrieves the sink where data is sent
+       *
+       * \returns a pointer to the sink or a null pointer if there is none.
+       */
+      Sink *getSink(void) const;
+
+      /**
+       * \brief Discards the data held by the buffer
+       */
+      void clear(void);
+
+      /**
+       * \brief Sends the data held to the sink and flushes it
+       *
+       * \par Description
+       * If no sink has been specified, nothing is done.
+       */
+      void flush(void);
+
+    private:
+
+      /**
+       * \brief Copy constructor (not available)
+       */
+      Output_Buffer(Output_Buffer const &orig);
+
+      /**
+       * \brief Assignment operator (not available)
+       */
+      Output_Buffer &operator=(Output_Buffer const &orig);
+
+      /**
+       * \brief Sends the data held to the sink
+       */
+      void drain(void);
+
+      /**
+       * \brief Makes the memory block grow
+       *
+       * \param len Minimum number of bytes to be available after the data
+       * held.
+       */
+      void grow(size_t len);
+
+      /**
+       * \brief Sink where data is to be sent
+       */
+      Sink    *pSink_;
+
+      /**
+       * \brief Memory block
+       */
+      char    *buffer_;
+
+      /**
+       * \brief Memory block size
+       */
+      size_t  capacity_;
+
+      /**
+       * \brief Bytes held by the memory block
+       */
+      size_t  size_;
+
+  };                             // class Output_Buffer
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
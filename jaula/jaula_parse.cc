@@ -51,6 +51,7 @@ extern "C"
 #include <sstream>
 #endif
 
+#include <jaula/jaula_number_format.h>
 #include <jaula/jaula_parse.h>
 #include <jaula/jaula_syntax_error.h>
 #include <jaula/jaula_value_array.h>
@@ -91,7 +92,9 @@ namespace JAULA
         {
           std::ostringstream  errAct;
           errAct << "analyzing line "
-            << lexer.lineno()
+            << lexer.getLine()
+            << ", column "
+            << lexer.getColumn()
             << " from input stream.";
           throw Syntax_Error("The input stream contains more than one first"
             " level complex (array or object) value"
@@ -137,7 +140,9 @@ namespace JAULA
               {
                 std::ostringstream  errAct;
                 errAct << "analyzing line "
-                  << lexan.lineno()
+                  << lexan.getLine()
+                  << ", column "
+                  << lexan.getColumn()
                   << " from input stream.";
                 EOFError(lexan
                   , Syntax_Error("Unexpected EOF while waiting for a value"
@@ -171,7 +176,9 @@ namespace JAULA
                     << " between double quotes";
                   std::ostringstream  errAct;
                   errAct << "analyzing line "
-                    << lexan.lineno()
+                    << lexan.getLine()
+                    << ", column "
+                    << lexan.getColumn()
                     << " from input stream.";
                   throw Syntax_Error(errDet.str(), errAct.str());
                 }
@@ -180,22 +187,26 @@ namespace JAULA
 
               case NUMBER_INT_VALUE :
               {
-                char *resto;
-                long  val = strtol(lexan.getTokenData().c_str(), &resto, 0);
-                if ((resto) && (*resto))
+                /* the lexer only lets through a sign followed by digits */
+                std::string const &data = lexan.getTokenData();
+                int64_t   val = 0;
+                uint64_t  uval = 0;
+                switch (Number_Format::scanInt(data.data(), data.size()
+                  , val, uval))
                 {
-                  std::ostringstream  errDet;
-                  errDet << "Value "
-                    << lexan.getTokenData()
-                    << " contains a non-numerical value and is not enclosed"
-                    << " between double quotes";
-                  std::ostringstream  errAct;
-                  errAct << "analyzing line "
-                    << lexan.lineno()
-                    << " from input stream.";
-                  throw Syntax_Error(errDet.str(), errAct.str());
+                  case Number_Format::INT_SIGNED :
+                    return new Value_Number_Int(val);
+
+                  case Number_Format::INT_UNSIGNED :
+                  {
+                    std::auto_ptr<Value_Number_Int> pInt(new Value_Number_Int());
+                    pInt->setUnsigned(uval);
+                    return pInt.release();
+                  }
+
+                  default :
+                    return new Value_Number(strtod(data.c_str(), 0));
                 }
-                return new Value_Number_Int(val);
               }
 
               case STRING_VALUE :
@@ -218,7 +229,9 @@ namespace JAULA
                   << " array or object";
                 std::ostringstream  errAct;
                 errAct << "analyzing line "
-                  << lexan.lineno()
+                  << lexan.getLine()
+                  << ", column "
+                  << lexan.getColumn()
                   << " from input stream.";
                 throw Syntax_Error(errDet.str(), errAct.str());
               }
@@ -234,7 +247,9 @@ namespace JAULA
               {
                 std::ostringstream  errAct;
                 errAct << "analyzing line "
-                  << lexan.lineno()
+                  << lexan.getLine()
+                  << ", column "
+                  << lexan.getColumn()
                   << " from input stream.";
                 EOFError(lexan
                   , Syntax_Error("Unexpected EOF while waiting for a value"
@@ -272,7 +287,9 @@ namespace JAULA
                 errDet << " while waiting for a value or the end of an array";
                 std::ostringstream  errAct;
                 errAct << "analyzing line "
-                  << lexan.lineno()
+                  << lexan.getLine()
+                  << ", column "
+                  << lexan.getColumn()
                   << " from input stream.";
                 throw Syntax_Error(errDet.str(), errAct.str());
               }
@@ -288,7 +305,9 @@ namespace JAULA
               {
                 std::ostringstream  errAct;
                 errAct << "analyzing line "
-                  << lexan.lineno()
+                  << lexan.getLine()
+                  << ", column "
+                  << lexan.getColumn()
                   << " from input stream.";
                 EOFError(lexan
                   , Syntax_Error("Unexpected EOF while waiting for an item"
@@ -316,7 +335,9 @@ namespace JAULA
                   << " an array";
                 std::ostringstream  errAct;
                 errAct << "analyzing line "
-                  << lexan.lineno()
+                  << lexan.getLine()
+                  << ", column "
+                  << lexan.getColumn()
                   << " from input stream.";
                 throw Syntax_Error(errDet.str(), errAct.str());
               }
@@ -332,7 +353,9 @@ namespace JAULA
               {
                 std::ostringstream  errAct;
                 errAct << "analyzing line "
-                  << lexan.lineno()
+                  << lexan.getLine()
+                  << ", column "
+                  << lexan.getColumn()
                   << " from input stream.";
                 EOFError(lexan
                   , Syntax_Error("Unexpected EOF while waiting for a"
@@ -362,7 +385,9 @@ namespace JAULA
                   errDet << " while waiting for a property name";
                   std::ostringstream  errAct;
                   errAct << "analyzing line "
-                    << lexan.lineno()
+                    << lexan.getLine()
+                    << ", column "
+                    << lexan.getColumn()
                     << " from input stream.";
                   throw Syntax_Error(errDet.str(), errAct.str());
                 }
@@ -382,7 +407,9 @@ namespace JAULA
                   << " an object";
                 std::ostringstream  errAct;
                 errAct << "analyzing line "
-                  << lexan.lineno()
+                  << lexan.getLine()
+                  << ", column "
+                  << lexan.getColumn()
                   << " from input stream.";
                 throw Syntax_Error(errDet.str(), errAct.str());
               }
@@ -398,7 +425,9 @@ namespace JAULA
               {
                 std::ostringstream  errAct;
                 errAct << "analyzing line "
-                  << lexan.lineno()
+                  << lexan.getLine()
+                  << ", column "
+                  << lexan.getColumn()
                   << " from input stream.";
                 EOFError(lexan
                   , Syntax_Error("Unexpected EOF while waiting for a"
@@ -422,7 +451,9 @@ namespace JAULA
                 errDet << " while waiting for property name delimiter";
                 std::ostringstream  errAct;
                 errAct << "analyzing line "
-                  << lexan.lineno()
+                  << lexan.getLine()
+                  << ", column "
+                  << lexan.getColumn()
                   << " from input stream.";
                 throw Syntax_Error(errDet.str(), errAct.str());
               }
@@ -438,7 +469,9 @@ namespace JAULA
               {
                 std::ostringstream  errAct;
                 errAct << "analyzing line "
-                  << lexan.lineno()
+                  << lexan.getLine()
+                  << ", column "
+                  << lexan.getColumn()
                   << " from input stream.";
                 EOFError(lexan
                   , Syntax_Error("Unexpected EOF while waiting for a value"
@@ -473,7 +506,9 @@ namespace JAULA
                 errDet << " while waiting for a value for an object property";
                 std::ostringstream  errAct;
                 errAct << "analyzing line "
-                  << lexan.lineno()
+                  << lexan.getLine()
+                  << ", column "
+                  << lexan.getColumn()
                   << " from input stream.";
                 throw Syntax_Error(errDet.str(), errAct.str());
               }
@@ -489,7 +524,9 @@ namespace JAULA
               {
                 std::ostringstream  errAct;
                 errAct << "analyzing line "
-                  << lexan.lineno()
+                  << lexan.getLine()
+                  << ", column "
+                  << lexan.getColumn()
                   << " from input stream.";
                 EOFError(lexan
                   , Syntax_Error("Unexpected EOF while waiting for an item"
@@ -517,7 +554,9 @@ namespace JAULA
                   << " an object";
                 std::ostringstream  errAct;
                 errAct << "analyzing line "
-                  << lexan.lineno()
+                  << lexan.getLine()
+                  << ", column "
+                  << lexan.getColumn()
                   << " from input stream.";
                 throw Syntax_Error(errDet.str(), errAct.str());
               }
@@ -530,7 +569,9 @@ namespace JAULA
           {
             std::ostringstream  errAct;
             errAct << "analyzing line "
-              << lexan.lineno()
+              << lexan.getLine()
+              << ", column "
+              << lexan.getColumn()
               << " from input stream.";
             throw Syntax_Error("The parser state machine reached an unknown"
               " value. Internal error"
@@ -544,7 +585,9 @@ namespace JAULA
       {
         std::ostringstream  errAct;
         errAct << "analyzing line "
-          << lexan.lineno()
+          << lexan.getLine()
+          << ", column "
+          << lexan.getColumn()
           << " from input stream.";
         throw Syntax_Error("The parser state machine flow reached to an"
           " unexpected point. Internal error"
@@ -0,0 +1,90 @@
+
+/*
+ * jaula_parse_handler.cc : JSON Analysis User Library Acronym
+ * Parsing events handler definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+}
+
+
+#include <jaula/jaula_number_format.h>
+#include <jaula/jaula_parse_handler.h>
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Parse_Handler::~Parse_Handler()
+    {}
+
+  bool Parse_Handler::numberUnsignedValue(uint64_t data)
+  {
+    return numberValue(static_cast<double>(data));
+  }
+
+  bool Parse_Handler::numberTextValue(std::string const &data)
+  {
+    int64_t   val = 0;
+    uint64_t  uval = 0;
+    if (Number_Format::isInt(data.data(), data.size()))
+      switch (Number_Format::scanInt(data.data(), data.size(), val, uval))
+      {
+        case Number_Format::INT_SIGNED :
+          return numberIntValue(val);
+
+        case Number_Format::INT_UNSIGNED :
+          return numberUnsignedValue(uval);
+
+        default :
+          break;
+      }
+    return numberValue(strtod(data.c_str(), 0));
+  }
+
+  Exception const *Parse_Handler::getErrorReport(void) const
+  {
+    return 0;
+  }
+
+  Parse_Result::Error_Code Parse_Handler::getErrorCode(void) const
+  {
+    return Parse_Result::HANDLER_STOPPED;
+  }
+
+  Parse_Handler::Parse_Handler(void)
+    {}
+
+}                                // namespace JAULA
+
+// EOF $Id$
@@ -0,0 +1,185 @@
+
+/*
+ * jaula_parse_handler.h : JSON Analysis User Library Acronym
+ * Parsing events handler definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_PARSE_HANDLER_H_
+#define _JAULA_PARSE_HANDLER_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include <jaula/jaula_exception.h>
+#include <jaula/jaula_parse_result.h>
+
+/**
+ * \addtogroup jaula_parse JAULA: JSON data parser
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Base class for parsing events handlers
+   *
+   * \ingroup jaula_parse
+   *
+   * \par
+   * This class defines the interface through which the event driven parsers
+   * report the values found in the input as soon as they are recognized,
+   * without building any intermediate data structure.
+   *
+   * \par
+   * Every method returns true for the parsing process to go on or false to
+   * make it stop. In the later case, getErrorReport() may provide the reason
+   * for the parser to report it.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Parse_Handler
+  {                              // class Parse_Handler
+    public:
+
+      /**
+       * \brief Destructor
+       */
+      virtual ~Parse_Handler();
+
+      /**
+       * \brief A null value has been read
+       */
+      virtual bool nullValue(void) = 0;
+
+      /**
+       * \brief A boolean value has been read
+       *
+       * \param data Value read.
+       */
+      virtual bool booleanValue(bool data) = 0;
+
+      /**
+       * \brief A numeric value has been read
+       *
+       * \param data Value read.
+       */
+      virtual bool numberValue(double data) = 0;
+
+      /**
+       * \brief A numeric value without decimals nor exponent has been read
+       *
+       * \param data Value read.
+       */
+      virtual bool numberIntValue(int64_t data) = 0;
+
+      /**
+       * \brief A positive integer beyond the 64 bit signed range has been read
+       *
+       * \param data Value read.
+       *
+       * \par Description
+       * Default implementation reports the value through numberValue().
+       */
+      virtual bool numberUnsignedValue(uint64_t data);
+
+      /**
+       * \brief A number to be kept by its decimal text has been read
+       *
+       * \param data Decimal representation of the value as read.
+       *
+       * \par Description
+       * Only reported by parsers asked to keep big numbers or to convert
+       * numbers lazily. Default implementation converts the text and reports
+       * it through numberIntValue(), numberUnsignedValue() or numberValue()
+       * as the parser would have done otherwise.
+       */
+      virtual bool numberTextValue(std::string const &data);
+
+      /**
+       * \brief A string value has been read
+       *
+       * \param data Value read (escape sequences already resolved).
+       */
+      virtual bool stringValue(std::string const &data) = 0;
+
+      /**
+       * \brief An array starting delimiter has been read
+       */
+      virtual bool arrayBegin(void) = 0;
+
+      /**
+       * \brief An array closing delimiter has been read
+       */
+      virtual bool arrayEnd(void) = 0;
+
+      /**
+       * \brief An object starting delimiter has been read
+       */
+      virtual bool objectBegin(void) = 0;
+
+      /**
+       * \brief An object property name has been read
+       *
+       * \param name Name of the property whose value comes next.
+       */
+      virtual bool propertyName(std::string const &name) = 0;
+
+      /**
+       * \brief An object closing delimiter has been read
+       */
+      virtual bool objectEnd(void) = 0;
+
+      /**
+       * \brief Retrieves details about why the handler stopped the process
+       *
+       * \returns a pointer to an instance describing why the last method
+       * invoked returned false or a null pointer if no details are
+       * available.
+       */
+      virtual Exception const *getErrorReport(void) const;
+
+      /**
+       * \brief Retrieves the kind of error that stopped the process
+       *
+       * \returns the code the parser records when the last method invoked
+       * returned false. The default implementation returns
+       * Parse_Result::HANDLER_STOPPED.
+       */
+      virtual Parse_Result::Error_Code getErrorCode(void) const;
+
+    protected:
+
+      /**
+       * \brief Constructor
+       */
+      Parse_Handler(void);
+
+  };                             // class Parse_Handler
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
@@ -0,0 +1,206 @@
+
+/*
+ * jaula_parse_result.cc : JSON Analysis User Library Acronym
+ * Parsing process outcome implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+}
+
+
+#if defined(HAVE_EMMINTRIN_H) && defined(__SSE2__)
+#include <emmintrin.h>
+#define JAULA_USE_SSE2
+#endif
+
+
+#include <jaula/jaula_parse_result.h>
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Parse_Result::Parse_Result(void)
+    : code_(SUCCESS)
+    , offset_(0)
+    , line_(0)
+    , column_(0)
+    , character_(0)
+    , symbol_(0)
+    , text_()
+    , quoted_(false)
+    , expected_(0)
+    {}
+
+  bool Parse_Result::failed(void) const
+  {
+    return code_ != SUCCESS;
+  }
+
+  Parse_Result::Error_Code Parse_Result::getCode(void) const
+  {
+    return code_;
+  }
+
+  bool Parse_Result::isLexical(void) const
+  {
+    return (code_ > SUCCESS) && (code_ < INVALID_NUMBER);
+  }
+
+  size_t Parse_Result::getOffset(void) const
+  {
+    return offset_;
+  }
+
+  unsigned int Parse_Result::getLine(void) const
+  {
+    return line_;
+  }
+
+  size_t Parse_Result::getColumn(void) const
+  {
+    return column_;
+  }
+
+  std::string Parse_Result::getMessage(void) const
+  {
+    switch (code_)
+    {                            // error code switch
+      case SUCCESS :
+        return std::string();
+
+      case UNEXPECTED_CHARACTER :
+        return std::string("unexpected character '") + character_
+          + "' detected (quotes missing?)";
+
+      case COMMENT_NOT_ALLOWED :
+        return "invalid character (#) detected";
+
+      case NEWLINE_IN_STRING :
+        return "unterminated string detected at end of line";
+
+      case INVALID_ESCAPE :
+        return std::string("Invalid literal sequence \\") + character_;
+
+      case UNTERMINATED_COMMENT :
+        return "unterminated comment detected at end of input";
+
+      case UNTERMINATED_STRING :
+        return "unterminated string detected at end of input";
+
+      case UNTERMINATED_ESCAPE :
+        return "unterminated escape sequence detected at end of input";
+
+      case INVALID_SURROGATE :
+        return "unpaired surrogate detected in unicode escape sequence";
+
+      case INVALID_UTF8 :
+        return "invalid UTF-8 sequence detected in string";
+
+      case INVALID_NUMBER :
+        return "Value " + text_ + " contains a non-numerical value and is"
+          " not enclosed between double quotes";
+
+      case UNEXPECTED_TOKEN :
+      {
+        std::string message("Unexpected symbol ");
+        if (symbol_)
+          message += symbol_;
+        else if (quoted_)
+          message += '"' + text_ + '"';
+        else if (!text_.empty())
+          message += text_;
+        else
+        {
+          message += '\'';
+          message += character_;
+          message += '\'';
+        }
+        return message + " while waiting for " + expected_;
+      }
+
+      case UNEXPECTED_EOF :
+        return std::string("Unexpected EOF while waiting for ") + expected_;
+
+      case EXTRA_VALUE :
+        return "The input stream contains more than one first level complex"
+          " (array or object) value";
+
+      case DUPLICATED_NAME :
+        return text_.empty()
+          ? std::string("Object property name already exists")
+          : text_;
+
+      case HANDLER_STOPPED :
+        return text_.empty()
+          ? std::string("The parsing events handler stopped the process")
+          : text_;
+
+      default :
+        return "The parser state machine reached an unknown value. Internal"
+          " error";
+
+    }                            // error code switch
+  }
+
+  void Parse_Result::clear(void)
+  {
+    code_ = SUCCESS;
+    offset_ = 0;
+    line_ = 0;
+    column_ = 0;
+    character_ = 0;
+    symbol_ = 0;
+    text_.erase();
+    quoted_ = false;
+    expected_ = 0;
+  }
+
+  size_t Parse_Result::countLines(char const *data, size_t len)
+  {
+    size_t  lines = 0;
+    size_t  i = 0;
+#ifdef JAULA_USE_SSE2
+    __m128i const newline = _mm_set1_epi8('\n');
+    for (; ((i + 16) <= len); i += 16)
+    {
+      __m128i block =
+        _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i));
+      lines += __builtin_popcount(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+    }
+#endif
+    for (; (i < len); i++)
+      if (data[i] == '\n')
+        lines++;
+    return lines;
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
@@ -0,0 +1,234 @@
+
+/*
+ * jaula_parse_result.h : JSON Analysis User Library Acronym
+ * Parsing process outcome definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_PARSE_RESULT_H_
+#define _JAULA_PARSE_RESULT_H_
+
+#include <cstddef>
+#include <string>
+
+/**
+ * \addtogroup jaula_parse JAULA: JSON data parser
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  class Incremental_Parser;
+
+  /**
+   * \brief Outcome of a parsing process
+   *
+   * \ingroup jaula_parse
+   *
+   * \par
+   * This class describes why a parsing process failed by means of an error
+   * code and the position where the error was detected. Recording an error
+   * only stores a few scalars (and the token text when it is part of the
+   * description), while the human readable message is formatted when
+   * getMessage() is called, so rejecting malformed input costs about the
+   * same as accepting it.
+   *
+   * \par
+   * No exception is involved in filling or querying an instance, so it can
+   * be used from code built without exception support.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Parse_Result
+  {                              // class Parse_Result
+    public:
+
+      /**
+       * \brief Enumeration of error codes
+       */
+      enum    Error_Code
+      {                          // enum Error_Code
+        /** No error detected */
+        SUCCESS
+        /** A character that cannot start a token */
+        ,   UNEXPECTED_CHARACTER
+        /** A comment symbol when comments are not allowed */
+        ,   COMMENT_NOT_ALLOWED
+        /** An end of line inside a string */
+        ,   NEWLINE_IN_STRING
+        /** An unknown or malformed escape sequence */
+        ,   INVALID_ESCAPE
+        /** The input ended inside a comment */
+        ,   UNTERMINATED_COMMENT
+        /** The input ended inside a string */
+        ,   UNTERMINATED_STRING
+        /** The input ended inside an escape sequence */
+        ,   UNTERMINATED_ESCAPE
+        /** A unicode escape sequence for an unpaired UTF-16 surrogate */
+        ,   INVALID_SURROGATE
+        /** String contents not encoded as valid UTF-8 */
+        ,   INVALID_UTF8
+        /** A malformed number */
+        ,   INVALID_NUMBER
+        /** A token not allowed at its position */
+        ,   UNEXPECTED_TOKEN
+        /** The input ended before the first level value */
+        ,   UNEXPECTED_EOF
+        /** More data after the first level value */
+        ,   EXTRA_VALUE
+        /** An object property name already present in the object */
+        ,   DUPLICATED_NAME
+        /** The parsing events handler stopped the process */
+        ,   HANDLER_STOPPED
+        /** The parser reached an inconsistent state */
+        ,   INTERNAL_ERROR
+      };                         // enum Error_Code
+
+      /**
+       * \brief Constructor
+       *
+       * \par Description
+       * Creates an instance reporting success.
+       */
+      Parse_Result(void);
+
+      /**
+       * \brief Checks whether an error has been recorded
+       */
+      bool failed(void) const;
+
+      /**
+       * \brief Retrieves the error code
+       */
+      Error_Code getCode(void) const;
+
+      /**
+       * \brief Checks whether the error was found by the lexical analysis
+       */
+      bool isLexical(void) const;
+
+      /**
+       * \brief Retrieves the byte offset where the error was detected
+       *
+       * \par Description
+       * Errors on whole tokens point to the first byte of the token. Errors
+       * about the input ending too soon point to the end of the input.
+       */
+      size_t getOffset(void) const;
+
+      /**
+       * \brief Retrieves the line where the error was detected
+       *
+       * \returns the line number, starting at 1.
+       */
+      unsigned int getLine(void) const;
+
+      /**
+       * \brief Retrieves the column where the error was detected
+       *
+       * \returns the byte position within the line, starting at 1.
+       */
+      size_t getColumn(void) const;
+
+      /**
+       * \brief Formats the description of the error
+       *
+       * \returns the same text reported as detail by the exceptions the
+       * parsers throw, or an empty string on success.
+       */
+      std::string getMessage(void) const;
+
+      /**
+       * \brief Resets the instance to report success
+       */
+      void clear(void);
+
+      /**
+       * \brief Counts the line feeds in a buffer
+       *
+       * \param data Pointer to the buffer.
+       *
+       * \param len Number of bytes in the buffer.
+       *
+       * \par Description
+       * Lets analyzers work out line numbers from blocks of input instead
+       * of checking every byte they consume. Sixteen bytes are checked at a
+       * time when SSE2 is available.
+       */
+      static size_t countLines(char const *data, size_t len);
+
+    private:
+
+      friend class Incremental_Parser;
+
+      /**
+       * \brief Error code
+       */
+      Error_Code                  code_;
+
+      /**
+       * \brief Byte offset of the error
+       */
+      size_t                      offset_;
+
+      /**
+       * \brief Line of the error
+       */
+      unsigned int                line_;
+
+      /**
+       * \brief Column of the error
+       */
+      size_t                      column_;
+
+      /**
+       * \brief Offending character or single character token
+       */
+      char                        character_;
+
+      /**
+       * \brief Name of the offending constant token, if any
+       */
+      char const                  *symbol_;
+
+      /**
+       * \brief Offending token text or handler supplied detail, if any
+       */
+      std::string                 text_;
+
+      /**
+       * \brief Flag for text_ being a string token
+       */
+      bool                        quoted_;
+
+      /**
+       * \brief Description of what was expected, if any
+       */
+      char const                  *expected_;
+  };                             // class Parse_Result
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
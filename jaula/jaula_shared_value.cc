@@ -0,0 +1,667 @@
+
+/*
+ * jaula_shared_value.cc : JSON Analysis User Library Acronym
+ * Persistent immutable values implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+}
+
+#ifdef HAVE_ALGORITHM
+#include <algorithm>
+#endif
+
+#ifdef HAVE_VECTOR
+#include <vector>
+#endif
+
+#include <jaula/jaula_number_format.h>
+#include <jaula/jaula_shared_value.h>
+#include <jaula/jaula_value_array.h>
+#include <jaula/jaula_value_boolean.h>
+#include <jaula/jaula_value_null.h>
+#include <jaula/jaula_value_number.h>
+#include <jaula/jaula_value_number_int.h>
+#include <jaula/jaula_value_object.h>
+#include <jaula/jaula_value_string.h>
+
+namespace JAULA
+{                                // namespace JAULA
+
+  struct Shared_Value::Node
+  {                              // struct Shared_Value::Node
+
+    /**
+     * \brief Constructor
+     *
+     * \par Description
+     * The node starts with one reference owned by the caller.
+     */
+    Node(Value::ValueType type)
+      : refs(1)
+      , type(type)
+      , boolean(false)
+      , numberInt(0)
+      , numberUnsigned(false)
+      , number(0)
+      , text()
+      , names()
+      , items()
+      {}
+
+    /**
+     * \brief Destructor
+     *
+     * \par Description
+     * Releases the references held on the children.
+     */
+    ~Node()
+    {
+      for (std::vector<Node *>::iterator it = items.begin()
+        ; (it != items.end())
+        ; it++)
+        release(*it);
+    }
+
+    /**
+     * \brief Adds a reference to a node
+     *
+     * \returns the same node.
+     */
+    static Node *acquire(Node *pNode)
+    {
+      if (pNode)
+        __sync_add_and_fetch(&pNode->refs, 1);
+      return pNode;
+    }
+
+    /**
+     * \brief Drops a reference to a node, destroying it with the last one
+     */
+    static void release(Node *pNode)
+    {
+      if (pNode && !__sync_sub_and_fetch(&pNode->refs, 1))
+        delete pNode;
+    }
+
+    /**
+     * \brief Builds a tree from a mutable value
+     */
+    static Node *build(Value const &value)
+    {
+      Node *pNode = new Node(value.getType());
+      switch (value.getType())
+      {
+        case Value::TYPE_BOOLEAN:
+          pNode->boolean = static_cast<Value_Boolean const &>(value)
+            .getData();
+          break;
+
+        case Value::TYPE_NUMBER_INT:
+          {
+            Value_Number_Int const &num
+              = static_cast<Value_Number_Int const &>(value);
+            pNode->numberInt = static_cast<int64_t>(num.getUnsigned());
+            pNode->numberUnsigned = num.isUnsigned();
+            pNode->text = num.getText();
+          }
+          break;
+
+        case Value::TYPE_NUMBER:
+          pNode->number = static_cast<Value_Number const &>(value)
+            .getData();
+          pNode->text = static_cast<Value_Number const &>(value).getText();
+          break;
+
+        case Value::TYPE_STRING:
+          pNode->text = static_cast<Value_String const &>(value).getData();
+          break;
+
+        case Value::TYPE_ARRAY:
+          {
+            Value_Array::dataType const &data
+              = static_cast<Value_Array const &>(value).getData();
+            pNode->items.reserve(data.size());
+            for (Value_Array::dataType::const_iterator it = data.begin()
+              ; (it != data.end())
+              ; it++)
+              pNode->items.push_back(build(**it));
+          }
+          break;
+
+        case Value::TYPE_OBJECT:
+          {
+            Value_Object::dataType const &data
+              = static_cast<Value_Object const &>(value).getData();
+            pNode->names.reserve(data.size());
+            pNode->items.reserve(data.size());
+            for (Value_Object::dataType::const_iterator it = data.begin()
+              ; (it != data.end())
+              ; it++)
+            {
+              pNode->names.push_back(it->first);
+              pNode->items.push_back(build(*it->second));
+            }
+          }
+          break;
+
+        default:
+          break;
+      }
+      return pNode;
+    }
+
+    /**
+     * \brief Builds a mutable copy of the tree
+     */
+    Value *materialize(void) const
+    {
+      switch (type)
+      {
+        case Value::TYPE_BOOLEAN:
+          return new Value_Boolean(boolean);
+
+        case Value::TYPE_NUMBER_INT:
+          {
+            Value_Number_Int *pNumber
+              = new Value_Number_Int(numberInt);
+            if (!text.empty())
+              pNumber->setText(text);
+            else if (numberUnsigned)
+              pNumber->setUnsigned(static_cast<uint64_t>(numberInt));
+            return pNumber;
+          }
+
+        case Value::TYPE_NUMBER:
+          {
+            Value_Number *pNumber = new Value_Number(number);
+            if (!text.empty())
+              pNumber->setText(text);
+            return pNumber;
+          }
+
+        case Value::TYPE_STRING:
+          return new Value_String(text);
+
+        case Value::TYPE_ARRAY:
+          {
+            Value_Array *pArray = new Value_Array();
+            for (size_t i = 0; (i < items.size()); i++)
+              pArray->adoptItem(items[i]->materialize());
+            return pArray;
+          }
+
+        case Value::TYPE_OBJECT:
+          {
+            Value_Object *pObject = new Value_Object();
+            for (size_t i = 0; (i < items.size()); i++)
+              pObject->adoptItem(names[i], items[i]->materialize());
+            return pObject;
+          }
+
+        default:
+          return new Value_Null();
+      }
+    }
+
+    /**
+     * \brief Computes the memory held by the tree
+     */
+    size_t footprint(void) const
+    {
+      size_t bytes = sizeof(Node) + text.capacity()
+        + (names.capacity() * sizeof(std::string))
+        + (items.capacity() * sizeof(Node *));
+      for (size_t i = 0; (i < names.size()); i++)
+        bytes += names[i].capacity();
+      for (size_t i = 0; (i < items.size()); i++)
+        bytes += items[i]->footprint();
+      return bytes;
+    }
+
+    /**
+     * \brief Builds a shallow copy sharing the children
+     */
+    Node *copy(void) const
+    {
+      Node *pNode = new Node(type);
+      pNode->boolean = boolean;
+      pNode->numberInt = numberInt;
+      pNode->numberUnsigned = numberUnsigned;
+      pNode->number = number;
+      pNode->text = text;
+      pNode->names = names;
+      pNode->items = items;
+      for (std::vector<Node *>::iterator it = pNode->items.begin()
+        ; (it != pNode->items.end())
+        ; it++)
+        acquire(*it);
+      return pNode;
+    }
+
+    /**
+     * \brief Finds the position for a property name
+     *
+     * \returns the position of the property or the one where it should be
+     * inserted.
+     */
+    size_t find(std::string const &name) const
+    {
+      return std::lower_bound(names.begin(), names.end(), name)
+        - names.begin();
+    }
+
+    /**
+     * \brief Checks whether a property exists at a position returned by
+     * find()
+     */
+    bool found(size_t pos, std::string const &name) const
+    {
+      return (pos < names.size()) && (names[pos] == name);
+    }
+
+    /**
+     * \brief Retrieves the child addressed by one pointer token
+     *
+     * \returns the child or NULL if it does not exist.
+     */
+    Node *child(Json_Pointer const &pointer, size_t depth) const
+    {
+      if (type == Value::TYPE_OBJECT)
+      {
+        size_t const pos = find(pointer.getToken(depth));
+        return found(pos, pointer.getToken(depth)) ? items[pos] : 0;
+      }
+      if (type == Value::TYPE_ARRAY)
+      {
+        size_t const index = pointer.getIndex(depth);
+        return (index < items.size()) ? items[index] : 0;
+      }
+      return 0;
+    }
+
+    /**
+     * \brief Resolves the first tokens of a pointer
+     *
+     * \returns the node referenced or NULL if it does not exist.
+     */
+    static Node *resolve(Node *pNode, Json_Pointer const &pointer
+      , size_t count)
+    {
+      for (size_t i = 0; (pNode && (i < count)); i++)
+        pNode = pNode->child(pointer, i);
+      return pNode;
+    }
+
+    /**
+     * \brief Builds a new version of a tree along a pointer
+     *
+     * \param pNode Root of the tree, already checked to contain the path.
+     *
+     * \param pointer Location of the change.
+     *
+     * \param depth Number of tokens already consumed.
+     *
+     * \param pValue Node to store, whose reference is taken over, or NULL
+     * to remove the location.
+     *
+     * \returns the new root with a reference owned by the caller.
+     */
+    static Node *rebuild(Node const *pNode, Json_Pointer const &pointer
+      , size_t depth, Node *pValue)
+    {
+      if (depth == pointer.size())
+        return pValue;
+      bool const last = ((depth + 1) == pointer.size());
+      Node *pResult = pNode->copy();
+      size_t pos;
+      if (pNode->type == Value::TYPE_OBJECT)
+      {
+        std::string const &name = pointer.getToken(depth);
+        pos = pNode->find(name);
+        if (!pNode->found(pos, name))
+        {
+          pResult->names.insert(pResult->names.begin() + pos, name);
+          pResult->items.insert(pResult->items.begin() + pos, pValue);
+          return pResult;
+        }
+        if (last && !pValue)
+          pResult->names.erase(pResult->names.begin() + pos);
+      }
+      else
+      {
+        pos = (pointer.getToken(depth) == "-") ? pNode->items.size()
+          : pointer.getIndex(depth);
+        if (pos == pNode->items.size())
+        {
+          pResult->items.push_back(pValue);
+          return pResult;
+        }
+      }
+      Node *pOld = pResult->items[pos];
+      if (!last)
+        pResult->items[pos] = rebuild(pOld, pointer, depth + 1, pValue);
+      else if (pValue)
+        pResult->items[pos] = pValue;
+      else
+        pResult->items.erase(pResult->items.begin() + pos);
+      release(pOld);
+      return pResult;
+    }
+
+    /**
+     * \brief Normalized text of a number, from its decimal text if it has one
+     */
+    static std::string numberKey(Node const *pNode)
+    {
+      if (pNode->text.empty())
+        return Number_Format::normalize(pNode->number);
+      return Number_Format::normalize(pNode->text.data()
+        , pNode->text.size());
+    }
+
+    /**
+     * \brief Compares two trees
+     */
+    static bool equals(Node const *pLeft, Node const *pRight)
+    {
+      if (pLeft == pRight)
+        return true;
+      if (!pLeft || !pRight || (pLeft->type != pRight->type))
+        return false;
+      switch (pLeft->type)
+      {
+        case Value::TYPE_BOOLEAN:
+          return pLeft->boolean == pRight->boolean;
+
+        case Value::TYPE_NUMBER_INT:
+          return (pLeft->numberInt == pRight->numberInt)
+            && (pLeft->numberUnsigned == pRight->numberUnsigned);
+
+        case Value::TYPE_NUMBER:
+          if (pLeft->text.empty() && pRight->text.empty())
+            return pLeft->number == pRight->number;
+          return numberKey(pLeft) == numberKey(pRight);
+
+        case Value::TYPE_STRING:
+          return pLeft->text == pRight->text;
+
+        case Value::TYPE_ARRAY:
+        case Value::TYPE_OBJECT:
+          if ((pLeft->items.size() != pRight->items.size())
+            || (pLeft->names != pRight->names))
+            return false;
+          for (size_t i = 0; (i < pLeft->items.size()); i++)
+            if (!equals(pLeft->items[i], pRight->items[i]))
+              return false;
+          return true;
+
+        default:
+          return true;
+      }
+    }
+
+    /**
+     * \brief Reference count
+     */
+    long                        refs;
+
+    /**
+     * \brief Value type
+     */
+    Value::ValueType            type;
+
+    /**
+     * \brief Contents for booleans
+     */
+    bool                        boolean;
+
+    /**
+     * \brief Contents for integers
+     */
+    int64_t                     numberInt;
+
+    /**
+     * \brief Flag for integers beyond the 64 bit signed range
+     */
+    bool                        numberUnsigned;
+
+    /**
+     * \brief Contents for numbers
+     */
+    double                      number;
+
+    /**
+     * \brief Contents for strings and decimal text of numbers
+     */
+    std::string                 text;
+
+    /**
+     * \brief Property names for objects, sorted
+     */
+    std::vector<std::string>    names;
+
+    /**
+     * \brief Array items or object property values
+     */
+    std::vector<Node *>         items;
+  };                             // struct Shared_Value::Node
+
+  Shared_Value::Shared_Value(void)
+    : pNode_(0)
+    {}
+
+  Shared_Value::Shared_Value(Value const &value)
+    : pNode_(Node::build(value))
+    {}
+
+  Shared_Value::Shared_Value(Shared_Value const &orig)
+    : pNode_(Node::acquire(orig.pNode_))
+    {}
+
+  Shared_Value::Shared_Value(Node *pNode)
+    : pNode_(pNode)
+    {}
+
+  Shared_Value::~Shared_Value()
+  {
+    Node::release(pNode_);
+  }
+
+  Shared_Value &Shared_Value::operator=(Shared_Value const &orig)
+  {
+    Node *pOld = pNode_;
+    pNode_ = Node::acquire(orig.pNode_);
+    Node::release(pOld);
+    return *this;
+  }
+
+  bool Shared_Value::isValid(void) const
+  {
+    return pNode_ != 0;
+  }
+
+  Value::ValueType Shared_Value::getType(void) const
+  {
+    return pNode_ ? pNode_->type : Value::TYPE_NULL;
+  }
+
+  bool Shared_Value::getBoolean(void) const throw(Bad_Data_Type)
+  {
+    if (getType() != Value::TYPE_BOOLEAN)
+      throw Bad_Data_Type("Value is not a boolean"
+        , "retrieving contents"
+        , "Shared_Value::getBoolean()");
+    return pNode_->boolean;
+  }
+
+  int64_t Shared_Value::getNumberInt(void) const throw(Bad_Data_Type)
+  {
+    if (getType() != Value::TYPE_NUMBER_INT)
+      throw Bad_Data_Type("Value is not an integer"
+        , "retrieving contents"
+        , "Shared_Value::getNumberInt()");
+    if (pNode_->numberUnsigned)
+      throw Bad_Data_Type("Value does not fit a 64 bit signed integer"
+        , "retrieving contents"
+        , "Shared_Value::getNumberInt()");
+    return pNode_->numberInt;
+  }
+
+  double Shared_Value::getNumber(void) const throw(Bad_Data_Type)
+  {
+    if (getType() == Value::TYPE_NUMBER_INT)
+      return pNode_->numberUnsigned
+        ? static_cast<double>(static_cast<uint64_t>(pNode_->numberInt))
+        : static_cast<double>(pNode_->numberInt);
+    if (getType() != Value::TYPE_NUMBER)
+      throw Bad_Data_Type("Value is not a number"
+        , "retrieving contents"
+        , "Shared_Value::getNumber()");
+    return pNode_->number;
+  }
+
+  std::string const &Shared_Value::getString(void) const
+    throw(Bad_Data_Type)
+  {
+    if (getType() != Value::TYPE_STRING)
+      throw Bad_Data_Type("Value is not a string"
+        , "retrieving contents"
+        , "Shared_Value::getString()");
+    return pNode_->text;
+  }
+
+  size_t Shared_Value::size(void) const
+  {
+    return pNode_ ? pNode_->items.size() : 0;
+  }
+
+  Shared_Value Shared_Value::getItem(size_t pos) const
+  {
+    if (pos >= size())
+      return Shared_Value();
+    return Shared_Value(Node::acquire(pNode_->items[pos]));
+  }
+
+  std::string const &Shared_Value::getName(size_t pos) const
+    throw(Bad_Data_Type)
+  {
+    if ((getType() != Value::TYPE_OBJECT) || (pos >= size()))
+      throw Bad_Data_Type("Property does not exist"
+        , "retrieving property name"
+        , "Shared_Value::getName(size_t)");
+    return pNode_->names[pos];
+  }
+
+  Shared_Value Shared_Value::getItem(std::string const &name) const
+  {
+    if (getType() != Value::TYPE_OBJECT)
+      return Shared_Value();
+    size_t const pos = pNode_->find(name);
+    if (!pNode_->found(pos, name))
+      return Shared_Value();
+    return Shared_Value(Node::acquire(pNode_->items[pos]));
+  }
+
+  Shared_Value Shared_Value::at(Json_Pointer const &pointer) const
+  {
+    return Shared_Value(Node::acquire(Node::resolve(pNode_, pointer
+      , pointer.size())));
+  }
+
+  Shared_Value Shared_Value::set(Json_Pointer const &pointer
+    , Shared_Value const &value) const throw(Bad_Data_Type)
+  {
+    if (!pNode_ || !value.pNode_)
+      throw Bad_Data_Type("Empty handle"
+        , "setting " + pointer.getPointer()
+        , "Shared_Value::set(Json_Pointer const &, Shared_Value const &)");
+    if (!pointer.size())
+      return value;
+
+    size_t const last = pointer.size() - 1;
+    Node const *pParent = Node::resolve(pNode_, pointer, last);
+    if (!pParent)
+      throw Bad_Data_Type("Container does not exist"
+        , "setting " + pointer.getPointer()
+        , "Shared_Value::set(Json_Pointer const &, Shared_Value const &)");
+    if (pParent->type == Value::TYPE_ARRAY)
+    {
+      if ((pointer.getToken(last) != "-")
+        && (pointer.getIndex(last) > pParent->items.size()))
+        throw Bad_Data_Type("Array index out of range"
+          , "setting " + pointer.getPointer()
+          , "Shared_Value::set(Json_Pointer const &, Shared_Value const &)");
+    }
+    else if (pParent->type != Value::TYPE_OBJECT)
+      throw Bad_Data_Type("Container is not an array or an object"
+        , "setting " + pointer.getPointer()
+        , "Shared_Value::set(Json_Pointer const &, Shared_Value const &)");
+
+    return Shared_Value(Node::rebuild(pNode_, pointer, 0
+      , Node::acquire(value.pNode_)));
+  }
+
+  Shared_Value Shared_Value::remove(Json_Pointer const &pointer) const
+    throw(Bad_Data_Type)
+  {
+    if (!pointer.size())
+      throw Bad_Data_Type("The whole value cannot be removed"
+        , "removing " + pointer.getPointer()
+        , "Shared_Value::remove(Json_Pointer const &)");
+    if (!Node::resolve(pNode_, pointer, pointer.size()))
+      throw Bad_Data_Type("Value does not exist"
+        , "removing " + pointer.getPointer()
+        , "Shared_Value::remove(Json_Pointer const &)");
+    return Shared_Value(Node::rebuild(pNode_, pointer, 0, 0));
+  }
+
+  size_t Shared_Value::footprint(void) const
+  {
+    return pNode_ ? pNode_->footprint() : 0;
+  }
+
+  bool Shared_Value::equals(Shared_Value const &other) const
+  {
+    return Node::equals(pNode_, other.pNode_);
+  }
+
+  bool Shared_Value::same(Shared_Value const &other) const
+  {
+    return pNode_ == other.pNode_;
+  }
+
+  Value *Shared_Value::toValue(void) const
+  {
+    return pNode_ ? pNode_->materialize() : 0;
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
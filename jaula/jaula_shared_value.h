@@ -0,0 +1,316 @@
+
+/*
+ * jaula_shared_value.h : JSON Analysis User Library Acronym
+ * Persistent immutable values definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_SHARED_VALUE_H_
+#define _JAULA_SHARED_VALUE_H_
+
+#include <string>
+
+#include <jaula/jaula_bad_data_type.h>
+#include <jaula/jaula_json_pointer.h>
+#include <jaula/jaula_value.h>
+
+/**
+ * \addtogroup jaula_val JAULA: JSON Values containers
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Handle to an immutable JSON value
+   *
+   * \ingroup jaula_val
+   *
+   * \par
+   * This class is the persistent counterpart of Value. The nodes a handle
+   * refers to never change once built and are reference counted with atomic
+   * operations, so copying a handle costs one increment and any number of
+   * threads may read the same tree at the same time without locks.
+   *
+   * \par
+   * Updates do not modify the tree: set() and remove() return a new root
+   * that copies only the nodes along the path to the change and shares
+   * every other subtree with the original. A writer can therefore produce
+   * new versions of a document while readers keep working on the snapshots
+   * they already hold, without going through Value::duplicate().
+   *
+   * \par
+   * A single handle instance is not meant to be assigned by one thread
+   * while others copy it; each thread should own the handles it uses.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Shared_Value
+  {                              // class Shared_Value
+    public:
+
+      /**
+       * \brief Default Constructor
+       *
+       * \par Description
+       * Builds an empty handle that does not refer to any value.
+       */
+      Shared_Value(void);
+
+      /**
+       * \brief Constructor
+       *
+       * \param value Value to take the contents from.
+       *
+       * \par Description
+       * Copies the whole value into a new immutable tree.
+       */
+      explicit Shared_Value(Value const &value);
+
+      /**
+       * \brief Copy Constructor
+       *
+       * \param orig Handle to copy.
+       *
+       * \par Description
+       * The new handle refers to the same tree as the original.
+       */
+      Shared_Value(Shared_Value const &orig);
+
+      /**
+       * \brief Destructor
+       *
+       * \par Description
+       * Releases the reference held, destroying the nodes no other handle
+       * or node refers to.
+       */
+      ~Shared_Value();
+
+      /**
+       * \brief Assignment operator
+       *
+       * \param orig Handle to copy.
+       *
+       * \returns a reference to the instance.
+       */
+      Shared_Value &operator=(Shared_Value const &orig);
+
+      /**
+       * \brief Checks whether the handle refers to a value
+       */
+      bool isValid(void) const;
+
+      /**
+       * \brief Retrieves the value type
+       *
+       * \returns the type of the value referred or Value::TYPE_NULL for an
+       * empty handle.
+       */
+      Value::ValueType getType(void) const;
+
+      /**
+       * \brief Retrieves a boolean value
+       *
+       * \exception Bad_Data_Type
+       * This exception is launched if the value is not a boolean.
+       */
+      bool getBoolean(void) const throw(Bad_Data_Type);
+
+      /**
+       * \brief Retrieves an integer value
+       *
+       * \exception Bad_Data_Type
+       * This exception is launched if the value is not an integer
+       * that fits a 64 bit signed integer.
+       */
+      int64_t getNumberInt(void) const throw(Bad_Data_Type);
+
+      /**
+       * \brief Retrieves a numeric value
+       *
+       * \exception Bad_Data_Type
+       * This exception is launched if the value is not a number. Integer
+       * values are accepted and converted.
+       */
+      double getNumber(void) const throw(Bad_Data_Type);
+
+      /**
+       * \brief Retrieves a string value
+       *
+       * \exception Bad_Data_Type
+       * This exception is launched if the value is not a string.
+       */
+      std::string const &getString(void) const throw(Bad_Data_Type);
+
+      /**
+       * \brief Number of items
+       *
+       * \returns the number of array items or object properties, 0 for
+       * any other value.
+       */
+      size_t size(void) const;
+
+      /**
+       * \brief Retrieves an array item or object property value by position
+       *
+       * \param pos Position of the item. Object properties are sorted by
+       * name.
+       *
+       * \returns a handle to the item or an empty handle if it does not
+       * exist.
+       */
+      Shared_Value getItem(size_t pos) const;
+
+      /**
+       * \brief Retrieves an object property name by position
+       *
+       * \param pos Position of the property.
+       *
+       * \exception Bad_Data_Type
+       * This exception is launched if the value is not an object or the
+       * position is out of range.
+       */
+      std::string const &getName(size_t pos) const throw(Bad_Data_Type);
+
+      /**
+       * \brief Retrieves an object property by name
+       *
+       * \param name Name of the property.
+       *
+       * \returns a handle to the property value or an empty handle if the
+       * value is not an object or does not have such property.
+       */
+      Shared_Value getItem(std::string const &name) const;
+
+      /**
+       * \brief Resolves a JSON Pointer
+       *
+       * \param pointer Location of the value.
+       *
+       * \returns a handle to the referenced value or an empty handle if it
+       * does not exist.
+       */
+      Shared_Value at(Json_Pointer const &pointer) const;
+
+      /**
+       * \brief Builds a new version with one value set
+       *
+       * \param pointer Location of the value to set.
+       *
+       * \param value Value to store.
+       *
+       * \returns the root of the new version.
+       *
+       * \exception Bad_Data_Type
+       * This exception is launched if the container of the location does not
+       * exist, if it is not an array or an object, if an array index is
+       * beyond the end or if either handle is empty.
+       *
+       * \par Description
+       * Object properties are added or replaced. Array items are replaced,
+       * except for index "-" or the index equal to the array size that
+       * append one. The empty pointer replaces the whole value. Only the
+       * nodes on the path are copied; the instance is left untouched.
+       */
+      Shared_Value set(Json_Pointer const &pointer
+        , Shared_Value const &value) const throw(Bad_Data_Type);
+
+      /**
+       * \brief Builds a new version without one value
+       *
+       * \param pointer Location of the value to remove.
+       *
+       * \returns the root of the new version.
+       *
+       * \exception Bad_Data_Type
+       * This exception is launched if the value does not exist or if the
+       * pointer is empty.
+       *
+       * \par Description
+       * Only the nodes on the path are copied; the instance is left
+       * untouched.
+       */
+      Shared_Value remove(Json_Pointer const &pointer) const
+        throw(Bad_Data_Type);
+
+      /**
+       * \brief Computes the memory held by the tree
+       *
+       * \returns the number of bytes allocated for the nodes and their
+       * contents.
+       *
+       * \par Description
+       * Subtrees shared by several parents are counted once per reference,
+       * so the result is what the tree would take if it was not sharing
+       * anything with other versions.
+       */
+      size_t footprint(void) const;
+
+      /**
+       * \brief Compares the contents of two handles
+       *
+       * \par Description
+       * Shared subtrees are recognized by identity without walking them,
+       * so comparing two versions of a document only visits the paths
+       * where they differ.
+       */
+      bool equals(Shared_Value const &other) const;
+
+      /**
+       * \brief Checks whether two handles refer to the same tree
+       */
+      bool same(Shared_Value const &other) const;
+
+      /**
+       * \brief Builds a mutable copy
+       *
+       * \returns a new Value with the contents or NULL for an empty handle.
+       * The caller is responsible for destroying it.
+       */
+      Value *toValue(void) const;
+
+    private:
+
+      /**
+       * \brief Immutable tree node
+       */
+      struct Node;
+
+      /**
+       * \brief Constructor
+       *
+       * \param pNode Node to refer to, whose reference is taken over.
+       */
+      explicit Shared_Value(Node *pNode);
+
+      /**
+       * \brief Node referred or NULL
+       */
+      Node                        *pNode_;
+  };                             // class Shared_Value
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
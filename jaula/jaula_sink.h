@@ -0,0 +1,94 @@
+
+/*
+ * jaula_sink.h : JSON Analysis User Library Acronym
+ * Output sink definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_SINK_H_
+#define _JAULA_SINK_H_
+
+#include <cstddef>
+
+/**
+ * \addtogroup jaula_out JAULA: JSON data output
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Base class for output sinks
+   *
+   * \ingroup jaula_out
+   *
+   * \par
+   * This class defines the destination for the data generated by the
+   * writers, so they can send it anywhere without going through standard
+   * C++ streams.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Sink
+  {                              // class Sink
+    public:
+
+      /**
+       * \brief Destructor
+       */
+      virtual ~Sink();
+
+      /**
+       * \brief Sends data to the sink
+       *
+       * \param data Pointer to the data to send.
+       *
+       * \param len Number of bytes to send.
+       *
+       * \par Description
+       * The data is not referenced once this method returns.
+       */
+      virtual void write(char const *data, size_t len) = 0;
+
+      /**
+       * \brief Forces any data kept by the sink to reach its destination
+       *
+       * \par Description
+       * The default implementation does nothing.
+       */
+      virtual void flush(void);
+
+    protected:
+
+      /**
+       * \brief Constructor
+       */
+      Sink(void);
+
+  };                             // class Sink
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
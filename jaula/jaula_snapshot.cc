@@ -0,0 +1,766 @@
+
+/*
+ * jaula_snapshot.cc : JSON Analysis User Library Acronym
+ * Binary snapshot implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_STDINT_H
+#include <stdint.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+}
+
+
+#ifdef HAVE_DEQUE
+#include <deque>
+#endif
+
+#ifdef HAVE_MAP
+#include <map>
+#endif
+
+#ifdef HAVE_VECTOR
+#include <vector>
+#endif
+
+#include <jaula/jaula_number_format.h>
+#include <jaula/jaula_snapshot.h>
+#include <jaula/jaula_value_array.h>
+#include <jaula/jaula_value_boolean.h>
+#include <jaula/jaula_value_number.h>
+#include <jaula/jaula_value_number_int.h>
+#include <jaula/jaula_value_object.h>
+#include <jaula/jaula_value_string.h>
+
+namespace
+{                                // anonymous namespace
+
+  using namespace JAULA;
+
+  /**
+   * \brief Header layout
+   */
+  enum    Header_Layout
+  {                              // enum Header_Layout
+    HEADER_MAGIC = 0
+    ,   HEADER_BYTE_ORDER = 8
+    ,   HEADER_VERSION = 12
+    ,   HEADER_SIZE = 16
+    ,   HEADER_KEY_COUNT = 20
+    ,   HEADER_KEY_TABLE = 24
+    ,   HEADER_ROOT = 28
+    ,   HEADER_LENGTH = 32
+  };                             // enum Header_Layout
+
+  /**
+   * \brief Snapshot identification
+   */
+  char const      magic[8] = { 'J', 'A', 'U', 'L', 'A', 'S', 'N', 'P' };
+
+  /**
+   * \brief Byte order mark
+   */
+  uint32_t const  byteOrder = 0x01020304;
+
+  /**
+   * \brief Format version
+   */
+  uint32_t const  version = 1;
+
+  /**
+   * \brief Largest snapshot size
+   */
+  uint64_t const  maxSize = 0xffffffffU;
+
+  /**
+   * \brief Property names and their key indexes
+   */
+  typedef std::map<std::string, uint32_t> keyMap;
+
+  /**
+   * \brief Rounds a size up to a multiple of 8
+   */
+  uint64_t align8(uint64_t len)
+  {
+    return (len + 7) & ~static_cast<uint64_t>(7);
+  }
+
+  /**
+   * \brief Reads a 32 bits number
+   */
+  uint32_t get32(unsigned char const *base, size_t offset)
+  {
+    uint32_t  n;
+    memcpy(&n, base + offset, sizeof(n));
+    return n;
+  }
+
+  /**
+   * \brief Writes a 32 bits number
+   */
+  void put32(Output_Buffer &out, uint32_t n)
+  {
+    out.append(reinterpret_cast<char const *>(&n), sizeof(n));
+  }
+
+  /**
+   * \brief Writes a node header
+   */
+  void putHead(Output_Buffer &out, Snapshot::Node_Type type, uint64_t arg)
+  {
+    put32(out, type);
+    put32(out, static_cast<uint32_t>(arg));
+  }
+
+  /**
+   * \brief Writes zeros up to a multiple of 8 bytes
+   */
+  void pad(Output_Buffer &out, uint64_t len)
+  {
+    static char const zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    out.append(zeros, static_cast<size_t>(align8(len) - len));
+  }
+
+  /**
+   * \brief Size of a string node
+   */
+  uint64_t stringSize(std::string const &str)
+  {
+    return 8 + align8(str.size() + 1);
+  }
+
+  /**
+   * \brief Writes a string node
+   */
+  void putString(Output_Buffer &out, std::string const &str)
+  {
+    putHead(out, Snapshot::NODE_STRING, str.size());
+    out.append(str.data(), str.size());
+    out.append('\0');
+    pad(out, str.size() + 1);
+  }
+
+  /**
+   * \brief Decimal text of a number that its double does not give back
+   *
+   * \returns a pointer to the text to store or null if the double is enough.
+   */
+  std::string const *exactText(Value_Number const &number)
+  {
+    std::string const &text = number.getText();
+    if (text.empty()
+      || (Number_Format::normalize(text.data(), text.size())
+        == Number_Format::normalize(number.getData())))
+      return 0;
+    return &text;
+  }
+
+  /**
+   * \brief Size of the node for a value
+   */
+  uint64_t nodeSize(Value const &val)
+  {
+    switch (val.getType())
+    {
+      case Value::TYPE_NUMBER :
+      {
+        std::string const *pText =
+          exactText(static_cast<Value_Number const &>(val));
+        return pText ? (16 + align8(pText->size() + 1)) : 16;
+      }
+
+      case Value::TYPE_NUMBER_INT :
+        return 16;
+
+      case Value::TYPE_STRING :
+        return stringSize(static_cast<Value_String const &>(val).getData());
+
+      case Value::TYPE_ARRAY :
+        return 8 + align8(4 * static_cast<uint64_t>(
+          static_cast<Value_Array const &>(val).getData().size()));
+
+      case Value::TYPE_OBJECT :
+        return 8 + 8 * static_cast<uint64_t>(
+          static_cast<Value_Object const &>(val).getData().size());
+
+      default :
+        return 8;
+    }
+  }
+
+  /**
+   * \brief Compares a key with a name (as std::string does)
+   */
+  int compareKey(unsigned char const *base, size_t offset
+    , char const *name, size_t len)
+  {
+    size_t  keyLen = get32(base, offset + 4);
+    int     result = memcmp(base + offset + 8, name
+      , (keyLen < len) ? keyLen : len);
+    if (result)
+      return result;
+    return (keyLen < len) ? -1 : ((keyLen > len) ? 1 : 0);
+  }
+
+  /**
+   * \brief Checks a string node
+   */
+  bool validString(unsigned char const *base, size_t size, size_t offset)
+  {
+    if ((offset & 7) || (offset > (size - 8)))
+      return false;
+    if (get32(base, offset) != Snapshot::NODE_STRING)
+      return false;
+    size_t  len = get32(base, offset + 4);
+    return (len < (size - offset - 8)) && !base[offset + 8 + len];
+  }
+
+  /**
+   * \brief Checks a number text node
+   */
+  bool validText(unsigned char const *base, size_t size, size_t offset)
+  {
+    size_t  avail = size - offset - 8;
+    if (avail < 8)
+      return false;
+    size_t  len = get32(base, offset + 4);
+    return (len < (avail - 8)) && !base[offset + 16 + len];
+  }
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Snapshot::Node::Node(void)
+    : base_(0)
+    , offset_(0)
+    {}
+
+  Snapshot::Node::Node(unsigned char const *base, size_t offset)
+    : base_(base)
+    , offset_(offset)
+    {}
+
+  bool Snapshot::Node::isValid(void) const
+  {
+    return base_ != 0;
+  }
+
+  Snapshot::Node_Type Snapshot::Node::getType(void) const
+  {
+    if (!base_)
+      return NODE_INVALID;
+    return static_cast<Node_Type>(get32(base_, offset_));
+  }
+
+  bool Snapshot::Node::getBoolean(void) const
+  {
+    return getType() == NODE_TRUE;
+  }
+
+  int64_t Snapshot::Node::getNumberInt(void) const
+  {
+    switch (getType())
+    {
+      case NODE_NUMBER_INT :
+      {
+        int64_t data;
+        memcpy(&data, base_ + offset_ + 8, sizeof(data));
+        return data;
+      }
+
+      case NODE_NUMBER_UNSIGNED :
+        return static_cast<int64_t>(getUnsigned());
+
+      case NODE_NUMBER :
+      case NODE_NUMBER_TEXT :
+        return static_cast<int64_t>(getNumber());
+
+      default :
+        return 0;
+    }
+  }
+
+  uint64_t Snapshot::Node::getUnsigned(void) const
+  {
+    switch (getType())
+    {
+      case NODE_NUMBER_UNSIGNED :
+      {
+        uint64_t  data;
+        memcpy(&data, base_ + offset_ + 8, sizeof(data));
+        return data;
+      }
+
+      case NODE_NUMBER_INT :
+        return static_cast<uint64_t>(getNumberInt());
+
+      default :
+        return 0;
+    }
+  }
+
+  double Snapshot::Node::getNumber(void) const
+  {
+    switch (getType())
+    {
+      case NODE_NUMBER :
+      case NODE_NUMBER_TEXT :
+      {
+        double  data;
+        memcpy(&data, base_ + offset_ + 8, sizeof(data));
+        return data;
+      }
+
+      case NODE_NUMBER_INT :
+        return static_cast<double>(getNumberInt());
+
+      case NODE_NUMBER_UNSIGNED :
+        return static_cast<double>(getUnsigned());
+
+      default :
+        return 0;
+    }
+  }
+
+  char const *Snapshot::Node::getText(void) const
+  {
+    if (getType() != NODE_NUMBER_TEXT)
+      return "";
+    return reinterpret_cast<char const *>(base_ + offset_ + 16);
+  }
+
+  char const *Snapshot::Node::getString(void) const
+  {
+    if (getType() != NODE_STRING)
+      return "";
+    return reinterpret_cast<char const *>(base_ + offset_ + 8);
+  }
+
+  size_t Snapshot::Node::getLength(void) const
+  {
+    Node_Type type = getType();
+    if ((type != NODE_STRING) && (type != NODE_NUMBER_TEXT))
+      return 0;
+    return get32(base_, offset_ + 4);
+  }
+
+  size_t Snapshot::Node::size(void) const
+  {
+    Node_Type type = getType();
+    if ((type != NODE_ARRAY) && (type != NODE_OBJECT))
+      return 0;
+    return get32(base_, offset_ + 4);
+  }
+
+  Snapshot::Node Snapshot::Node::getItem(size_t index) const
+  {
+    if ((getType() != NODE_ARRAY) || (index >= size()))
+      return Node();
+    return Node(base_, get32(base_, offset_ + 8 + 4 * index));
+  }
+
+  Snapshot::Node Snapshot::Node::getName(size_t index) const
+  {
+    if ((getType() != NODE_OBJECT) || (index >= size()))
+      return Node();
+    uint32_t  key = get32(base_, offset_ + 8 + 8 * index);
+    return Node(base_, get32(base_, get32(base_, HEADER_KEY_TABLE) + 4 * key));
+  }
+
+  Snapshot::Node Snapshot::Node::getValue(size_t index) const
+  {
+    if ((getType() != NODE_OBJECT) || (index >= size()))
+      return Node();
+    return Node(base_, get32(base_, offset_ + 12 + 8 * index));
+  }
+
+  Snapshot::Node Snapshot::Node::getProperty(std::string const &name) const
+  {
+    if (getType() != NODE_OBJECT)
+      return Node();
+
+    // key index search
+    size_t  keyTable = get32(base_, HEADER_KEY_TABLE);
+    size_t  low = 0;
+    size_t  high = get32(base_, HEADER_KEY_COUNT);
+    while (low < high)
+    {
+      size_t  mid = (low + high) / 2;
+      if (compareKey(base_, get32(base_, keyTable + 4 * mid)
+        , name.data(), name.size()) < 0)
+        low = mid + 1;
+      else
+        high = mid;
+    }
+    if ((low == get32(base_, HEADER_KEY_COUNT))
+      || compareKey(base_, get32(base_, keyTable + 4 * low)
+      , name.data(), name.size()))
+      return Node();
+    uint32_t  key = static_cast<uint32_t>(low);
+
+    // property search
+    low = 0;
+    high = size();
+    while (low < high)
+    {
+      size_t  mid = (low + high) / 2;
+      if (get32(base_, offset_ + 8 + 8 * mid) < key)
+        low = mid + 1;
+      else
+        high = mid;
+    }
+    if ((low == size()) || (get32(base_, offset_ + 8 + 8 * low) != key))
+      return Node();
+    return Node(base_, get32(base_, offset_ + 12 + 8 * low));
+  }
+
+  Snapshot::Snapshot(void const *data, size_t len, bool trusted)
+    throw(Syntax_Error)
+    : base_(static_cast<unsigned char const *>(data))
+    , size_(len)
+  {
+    if (!trusted)
+    {
+      std::string problem = validate(data, len);
+      if (!problem.empty())
+        throw Syntax_Error(problem, "validating a binary snapshot"
+          , "Snapshot::Snapshot(void const *, size_t, bool)");
+    }
+    size_ = get32(base_, HEADER_SIZE);
+  }
+
+  Snapshot::Node Snapshot::getRoot(void) const
+  {
+    return Node(base_, get32(base_, HEADER_ROOT));
+  }
+
+  size_t Snapshot::size(void) const
+  {
+    return size_;
+  }
+
+  void Snapshot::write(Value const &val, Output_Buffer &out)
+    throw(Bad_Data_Type)
+  {
+    // property names and value nodes size
+    keyMap  keys;
+    uint64_t  nodesSize = 0;
+    std::vector<Value const *>  pending(1, &val);
+    while (!pending.empty())
+    {                            // values loop
+      Value const *pItem = pending.back();
+      pending.pop_back();
+      nodesSize += nodeSize(*pItem);
+      if (pItem->getType() == Value::TYPE_ARRAY)
+      {
+        Value_Array::dataType const &items =
+          static_cast<Value_Array const *>(pItem)->getData();
+        pending.insert(pending.end(), items.begin(), items.end());
+      }
+      else if (pItem->getType() == Value::TYPE_OBJECT)
+      {
+        Value_Object::dataType const &properties =
+          static_cast<Value_Object const *>(pItem)->getData();
+        for (Value_Object::dataType::const_iterator it = properties.begin()
+          ; it != properties.end(); it++)
+        {
+          keys.insert(keyMap::value_type(it->first, 0));
+          pending.push_back(it->second);
+        }
+      }
+    }                            // values loop
+
+    // layout
+    uint64_t  keysSize = align8(4 * static_cast<uint64_t>(keys.size()));
+    uint32_t  index = 0;
+    for (keyMap::iterator it = keys.begin(); it != keys.end(); it++)
+    {
+      it->second = index++;
+      keysSize += stringSize(it->first);
+    }
+    uint64_t  root = HEADER_LENGTH + keysSize;
+    if ((root + nodesSize) > maxSize)
+      throw Bad_Data_Type("Value too large for a binary snapshot"
+        , "writing a binary snapshot"
+        , "Snapshot::write(Value const &, Output_Buffer &)");
+
+    // header
+    out.append(magic, sizeof(magic));
+    put32(out, byteOrder);
+    put32(out, version);
+    put32(out, static_cast<uint32_t>(root + nodesSize));
+    put32(out, static_cast<uint32_t>(keys.size()));
+    put32(out, HEADER_LENGTH);
+    put32(out, static_cast<uint32_t>(root));
+
+    // key table
+    uint64_t  offset = HEADER_LENGTH + align8(4 * static_cast<uint64_t>(keys.size()));
+    for (keyMap::const_iterator it = keys.begin(); it != keys.end(); it++)
+    {
+      put32(out, static_cast<uint32_t>(offset));
+      offset += stringSize(it->first);
+    }
+    pad(out, 4 * static_cast<uint64_t>(keys.size()));
+    for (keyMap::const_iterator it = keys.begin(); it != keys.end(); it++)
+      putString(out, it->first);
+
+    // value nodes in breadth first order
+    std::deque<Value const *> queue(1, &val);
+    offset = root + nodeSize(val);
+    while (!queue.empty())
+    {                            // nodes loop
+      Value const *pItem = queue.front();
+      queue.pop_front();
+      switch (pItem->getType())
+      {                          // value type switch
+        case Value::TYPE_BOOLEAN :
+          putHead(out, static_cast<Value_Boolean const *>(pItem)->getData()
+            ? NODE_TRUE : NODE_FALSE, 0);
+          break;
+
+        case Value::TYPE_NUMBER_INT :
+        {
+          Value_Number_Int const *pNumber =
+            static_cast<Value_Number_Int const *>(pItem);
+          if (pNumber->isUnsigned())
+          {
+            uint64_t  data = pNumber->getUnsigned();
+            putHead(out, NODE_NUMBER_UNSIGNED, 0);
+            out.append(reinterpret_cast<char const *>(&data), sizeof(data));
+            break;
+          }
+          int64_t data = pNumber->getInt64();
+          putHead(out, NODE_NUMBER_INT, 0);
+          out.append(reinterpret_cast<char const *>(&data), sizeof(data));
+        }
+        break;
+
+        case Value::TYPE_NUMBER :
+        {
+          Value_Number const *pNumber =
+            static_cast<Value_Number const *>(pItem);
+          double  data = pNumber->getData();
+          std::string const *pText = exactText(*pNumber);
+          putHead(out, pText ? NODE_NUMBER_TEXT : NODE_NUMBER
+            , pText ? pText->size() : 0);
+          out.append(reinterpret_cast<char const *>(&data), sizeof(data));
+          if (pText)
+          {
+            out.append(pText->data(), pText->size());
+            out.append('\0');
+            pad(out, pText->size() + 1);
+          }
+        }
+        break;
+
+        case Value::TYPE_STRING :
+          putString(out, static_cast<Value_String const *>(pItem)->getData());
+          break;
+
+        case Value::TYPE_ARRAY :
+        {
+          Value_Array::dataType const &items =
+            static_cast<Value_Array const *>(pItem)->getData();
+          putHead(out, NODE_ARRAY, items.size());
+          for (Value_Array::dataType::const_iterator it = items.begin()
+            ; it != items.end(); it++)
+          {
+            put32(out, static_cast<uint32_t>(offset));
+            offset += nodeSize(**it);
+            queue.push_back(*it);
+          }
+          pad(out, 4 * static_cast<uint64_t>(items.size()));
+        }
+        break;
+
+        case Value::TYPE_OBJECT :
+        {
+          Value_Object::dataType const &properties =
+            static_cast<Value_Object const *>(pItem)->getData();
+          putHead(out, NODE_OBJECT, properties.size());
+          for (Value_Object::dataType::const_iterator it = properties.begin()
+            ; it != properties.end(); it++)
+          {
+            put32(out, keys.find(it->first)->second);
+            put32(out, static_cast<uint32_t>(offset));
+            offset += nodeSize(*(it->second));
+            queue.push_back(it->second);
+          }
+        }
+        break;
+
+        default :
+          putHead(out, NODE_NULL, 0);
+          break;
+      }                          // value type switch
+    }                            // nodes loop
+  }
+
+  void Snapshot::write(Value const &val, Sink &sink) throw(Bad_Data_Type)
+  {
+    try
+    {
+      Output_Buffer out(sink);
+      write(val, out);
+      out.flush();
+    }
+    catch(Bad_Data_Type &ex)
+    {
+      ex.addOrigin("Snapshot::write(Value const &, Sink &)");
+      throw ex;
+    }
+  }
+
+  std::string Snapshot::validate(void const *data, size_t len)
+  {
+    unsigned char const *base = static_cast<unsigned char const *>(data);
+
+    // header
+    if (reinterpret_cast<size_t>(data) & 7)
+      return "Snapshot not aligned to 8 bytes";
+    if ((len < HEADER_LENGTH) || memcmp(base, magic, sizeof(magic)))
+      return "Not a binary snapshot";
+    if (get32(base, HEADER_BYTE_ORDER) != byteOrder)
+      return "Snapshot written with a different byte order";
+    if (get32(base, HEADER_VERSION) != version)
+      return "Unsupported snapshot version";
+    size_t  size = get32(base, HEADER_SIZE);
+    if ((size > len) || (size < HEADER_LENGTH) || (size & 7))
+      return "Invalid snapshot size";
+
+    // key table
+    size_t  keyCount = get32(base, HEADER_KEY_COUNT);
+    size_t  keyTable = get32(base, HEADER_KEY_TABLE);
+    if ((keyTable != HEADER_LENGTH)
+      || (keyCount > ((size - HEADER_LENGTH) / 4)))
+      return "Invalid key table";
+    size_t  keysEnd = keyTable + static_cast<size_t>(align8(4 * keyCount));
+    for (size_t i = 0; i < keyCount; i++)
+    {                            // keys loop
+      size_t  offset = get32(base, keyTable + 4 * i);
+      if ((offset < keysEnd) || !validString(base, size, offset))
+        return "Invalid key";
+      if (i)
+      {
+        size_t  previous = get32(base, keyTable + 4 * (i - 1));
+        if (compareKey(base, previous
+          , reinterpret_cast<char const *>(base + offset + 8)
+          , get32(base, offset + 4)) >= 0)
+          return "Keys not sorted";
+      }
+    }                            // keys loop
+
+    // value nodes
+    size_t  root = get32(base, HEADER_ROOT);
+    if (root < keysEnd)
+      return "Invalid first level node";
+    size_t  budget = size / 8;
+    std::vector<size_t> pending(1, root);
+    while (!pending.empty())
+    {                            // nodes loop
+      size_t  offset = pending.back();
+      pending.pop_back();
+      if (!budget--)
+        return "Too many nodes";
+      if ((offset & 7) || (offset > (size - 8)))
+        return "Node out of bounds";
+
+      uint32_t  type = get32(base, offset);
+      size_t    count = get32(base, offset + 4);
+      size_t    avail = size - offset - 8;
+      switch (type)
+      {                          // node type switch
+        case NODE_NULL :
+        case NODE_FALSE :
+        case NODE_TRUE :
+          break;
+
+        case NODE_NUMBER_INT :
+        case NODE_NUMBER :
+        case NODE_NUMBER_UNSIGNED :
+          if (avail < 8)
+            return "Node out of bounds";
+          break;
+
+        case NODE_NUMBER_TEXT :
+          if (!validText(base, size, offset))
+            return "Invalid number text";
+          break;
+
+        case NODE_STRING :
+          if (!validString(base, size, offset))
+            return "Invalid string";
+          break;
+
+        case NODE_ARRAY :
+          if (count > (avail / 4))
+            return "Node out of bounds";
+          for (size_t i = 0; i < count; i++)
+          {
+            size_t  item = get32(base, offset + 8 + 4 * i);
+            if (item <= offset)
+              return "Invalid node reference";
+            pending.push_back(item);
+          }
+          break;
+
+        case NODE_OBJECT :
+          if (count > (avail / 8))
+            return "Node out of bounds";
+          for (size_t i = 0; i < count; i++)
+          {
+            size_t  key = get32(base, offset + 8 + 8 * i);
+            size_t  item = get32(base, offset + 12 + 8 * i);
+            if (key >= keyCount)
+              return "Invalid key reference";
+            if (i && (key <= get32(base, offset + 8 * i)))
+              return "Properties not sorted";
+            if (item <= offset)
+              return "Invalid node reference";
+            pending.push_back(item);
+          }
+          break;
+
+        default :
+          return "Invalid node type";
+      }                          // node type switch
+    }                            // nodes loop
+    return "";
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
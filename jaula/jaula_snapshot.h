@@ -0,0 +1,327 @@
+
+/*
+ * jaula_snapshot.h : JSON Analysis User Library Acronym
+ * Binary snapshot definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_SNAPSHOT_H_
+#define _JAULA_SNAPSHOT_H_
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <string>
+
+#include <jaula/jaula_bad_data_type.h>
+#include <jaula/jaula_output_buffer.h>
+#include <jaula/jaula_sink.h>
+#include <jaula/jaula_syntax_error.h>
+#include <jaula/jaula_value.h>
+
+/**
+ * \addtogroup jaula_bin JAULA: Binary encodings
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Relocatable binary snapshot of a value
+   *
+   * \ingroup jaula_bin
+   *
+   * \par
+   * A snapshot stores a value as a block of memory that can be navigated
+   * directly, without any parsing or memory allocation, so it can be
+   * mapped from a file or a shared memory segment (mmap) and used at once.
+   * All the references inside the block are offsets from its beginning, so
+   * it can be placed at any address aligned to 8 bytes.
+   *
+   * \par
+   * The block starts with a header followed by the key table and the
+   * value nodes. Every object property name is stored only once and the
+   * key table keeps them sorted, so the properties of each object are
+   * sorted by key index and can be found by binary search. Nodes are
+   * placed in breadth first order, so every node is placed after its
+   * parent. Integer numbers, floating point numbers, strings and booleans
+   * keep their type. Integers only fitting a 64 bit unsigned one and
+   * numbers kept as decimal text that no double gives back are stored
+   * exactly too. Snapshots use the byte order of the machine writing them
+   * and are limited to 4 GB.
+   *
+   * \par
+   * Snapshots coming from untrusted sources must be validated (see
+   * validate()), which checks that every node can be navigated safely.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Snapshot
+  {                              // class Snapshot
+    public:
+
+      /**
+       * \brief Node types
+       */
+      enum    Node_Type
+      {                          // enum Node_Type
+        /** No node (result of a failed navigation) */
+        NODE_INVALID
+        /** Null value */
+        ,   NODE_NULL
+        /** Boolean false value */
+        ,   NODE_FALSE
+        /** Boolean true value */
+        ,   NODE_TRUE
+        /** Integer number */
+        ,   NODE_NUMBER_INT
+        /** Floating point number */
+        ,   NODE_NUMBER
+        /** String */
+        ,   NODE_STRING
+        /** Array */
+        ,   NODE_ARRAY
+        /** Object */
+        ,   NODE_OBJECT
+        /** Integer number only fitting a 64 bit unsigned integer */
+        ,   NODE_NUMBER_UNSIGNED
+        /** Number kept as decimal text, along with its nearest double */
+        ,   NODE_NUMBER_TEXT
+      };                         // enum Node_Type
+
+      /**
+       * \brief Reference to a node inside a snapshot
+       *
+       * \par
+       * Nodes are small handles that can be freely copied. Accessing a node
+       * as a type it does not have gives a neutral result (0, an empty
+       * string or an invalid node).
+       */
+      class Node
+      {                          // class Node
+        public:
+
+          /**
+           * \brief Default constructor (invalid node)
+           */
+          Node(void);
+
+          /**
+           * \brief Checks if the node exists
+           */
+          bool isValid(void) const;
+
+          /**
+           * \brief Retrieves the node type
+           */
+          Node_Type getType(void) const;
+
+          /**
+           * \brief Retrieves a boolean value
+           */
+          bool getBoolean(void) const;
+
+          /**
+           * \brief Retrieves an integer number
+           */
+          int64_t getNumberInt(void) const;
+
+          /**
+           * \brief Retrieves an unsigned integer number
+           *
+           * \returns the number of unsigned integer nodes, the bits of the
+           * number of integer nodes (as Value_Number_Int::getUnsigned()
+           * does) or 0 for other nodes.
+           */
+          uint64_t getUnsigned(void) const;
+
+          /**
+           * \brief Retrieves a number (integer ones are converted)
+           */
+          double getNumber(void) const;
+
+          /**
+           * \brief Retrieves the decimal text of a number
+           *
+           * \returns a pointer to the null terminated text of number text
+           * nodes, which stays inside the snapshot, or an empty string for
+           * other nodes.
+           */
+          char const *getText(void) const;
+
+          /**
+           * \brief Retrieves the contents of a string
+           *
+           * \returns a pointer to the null terminated contents, which stay
+           * inside the snapshot.
+           */
+          char const *getString(void) const;
+
+          /**
+           * \brief Retrieves the length of a string or of a number text
+           */
+          size_t getLength(void) const;
+
+          /**
+           * \brief Retrieves the number of array items or object properties
+           */
+          size_t size(void) const;
+
+          /**
+           * \brief Retrieves an array item
+           *
+           * \param index Item position.
+           */
+          Node getItem(size_t index) const;
+
+          /**
+           * \brief Retrieves the name of an object property
+           *
+           * \param index Property position (properties are sorted by name).
+           */
+          Node getName(size_t index) const;
+
+          /**
+           * \brief Retrieves the value of an object property
+           *
+           * \param index Property position (properties are sorted by name).
+           */
+          Node getValue(size_t index) const;
+
+          /**
+           * \brief Finds an object property
+           *
+           * \param name Property name.
+           *
+           * \returns the property value or an invalid node if the object
+           * does not have such a property.
+           */
+          Node getProperty(std::string const &name) const;
+
+        private:
+
+          friend class Snapshot;
+
+          /**
+           * \brief Constructor
+           */
+          Node(unsigned char const *base, size_t offset);
+
+          /**
+           * \brief Snapshot beginning (null for invalid nodes)
+           */
+          unsigned char const *base_;
+
+          /**
+           * \brief Node position inside the snapshot
+           */
+          size_t  offset_;
+      };                         // class Node
+
+      /**
+       * \brief Constructor
+       *
+       * \param data Pointer to the snapshot (aligned to 8 bytes). It is not
+       * copied, so it must exist during all the instance life cycle.
+       *
+       * \param len Number of bytes available.
+       *
+       * \param trusted flag for skipping validation (only for snapshots
+       * known to be correct).
+       *
+       * \exception Syntax_Error raised if the snapshot is not valid.
+       */
+      Snapshot(void const *data, size_t len, bool trusted = false)
+        throw(Syntax_Error);
+
+      /**
+       * \brief Retrieves the first level node
+       */
+      Node getRoot(void) const;
+
+      /**
+       * \brief Retrieves the snapshot size
+       */
+      size_t size(void) const;
+
+      /**
+       * \brief Writes the snapshot of a value
+       *
+       * \param val Value to take the snapshot from.
+       *
+       * \param out Buffer where the snapshot is to be written. The snapshot
+       * position inside the final file or memory block must be aligned to 8
+       * bytes.
+       *
+       * \exception Bad_Data_Type raised if the snapshot would exceed 4 GB.
+       */
+      static void write(Value const &val, Output_Buffer &out)
+        throw(Bad_Data_Type);
+
+      /**
+       * \brief Writes the snapshot of a value
+       *
+       * \param val Value to take the snapshot from.
+       *
+       * \param sink Sink where the snapshot is to be sent. It is flushed
+       * once the snapshot is complete.
+       *
+       * \exception Bad_Data_Type raised if the snapshot would exceed 4 GB.
+       */
+      static void write(Value const &val, Sink &sink) throw(Bad_Data_Type);
+
+      /**
+       * \brief Checks a snapshot
+       *
+       * \param data Pointer to the snapshot.
+       *
+       * \param len Number of bytes available.
+       *
+       * \returns an empty string if the snapshot is valid or a description
+       * of the first problem found.
+       *
+       * \par Description
+       * Checks the header and every node reachable from the first level
+       * one, so that any navigation inside the snapshot stays inside its
+       * boundaries. The work done is bounded by the snapshot size.
+       */
+      static std::string validate(void const *data, size_t len);
+
+    private:
+
+      /**
+       * \brief Snapshot beginning
+       */
+      unsigned char const *base_;
+
+      /**
+       * \brief Snapshot size
+       */
+      size_t  size_;
+  };                             // class Snapshot
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
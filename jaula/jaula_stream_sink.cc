@@ -0,0 +1,62 @@
+
+/*
+ * jaula_stream_sink.cc : JSON Analysis User Library Acronym
+ * Standard stream output sink definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+}
+
+
+#include <jaula/jaula_stream_sink.h>
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Stream_Sink::Stream_Sink(std::ostream &ostr)
+    : Sink()
+    , ostr_(ostr)
+    {}
+
+  Stream_Sink::~Stream_Sink()
+    {}
+
+  void Stream_Sink::write(char const *data, size_t len)
+  {
+    ostr_.write(data, len);
+  }
+
+  void Stream_Sink::flush(void)
+  {
+    ostr_.flush();
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
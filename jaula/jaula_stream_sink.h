@@ -0,0 +1,97 @@
+
+/*
+ * jaula_stream_sink.h : JSON Analysis User Library Acronym
+ * Standard stream output sink definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_STREAM_SINK_H_
+#define _JAULA_STREAM_SINK_H_
+
+#include <ostream>
+
+#include <jaula/jaula_sink.h>
+
+/**
+ * \addtogroup jaula_out JAULA: JSON data output
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Output sink for standard C++ streams
+   *
+   * \ingroup jaula_out
+   *
+   * \par
+   * This class adapts a standard C++ stream to be used as an output sink.
+   * Data is sent to the stream in large blocks.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Stream_Sink : public Sink
+  {                              // class Stream_Sink
+    public:
+
+      /**
+       * \brief Constructor
+       *
+       * \param ostr Stream where the data is to be written. It must exist
+       * during all the sink life cycle.
+       */
+      Stream_Sink(std::ostream &ostr);
+
+      /**
+       * \brief Destructor
+       */
+      virtual ~Stream_Sink();
+
+      /**
+       * \brief Sends data to the stream
+       *
+       * \param data Pointer to the data to send.
+       *
+       * \param len Number of bytes to send.
+       */
+      virtual void write(char const *data, size_t len);
+
+      /**
+       * \brief Flushes the stream
+       */
+      virtual void flush(void);
+
+    private:
+
+      /**
+       * \brief Destination stream
+       */
+      std::ostream  &ostr_;
+
+  };                             // class Stream_Sink
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
@@ -0,0 +1,304 @@
+
+/*
+ * jaula_stream_writer.cc : JSON Analysis User Library Acronym
+ * Streaming JSON writer implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+}
+
+
+#include <jaula/jaula_number_format.h>
+#include <jaula/jaula_stream_writer.h>
+#include <jaula/jaula_string_escape.h>
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Stream_Writer::Stream_Writer(void)
+    : buffer_()
+    , stack_()
+    , first_(true)
+    , keyPending_(false)
+    , done_(false)
+    , asciiOnly_(false)
+    , precision_(0)
+    , compact_(false)
+    {}
+
+  Stream_Writer::Stream_Writer(Sink &sink, size_t buffer_size)
+    : buffer_(sink, buffer_size)
+    , stack_()
+    , first_(true)
+    , keyPending_(false)
+    , done_(false)
+    , asciiOnly_(false)
+    , precision_(0)
+    , compact_(false)
+    {}
+
+  Stream_Writer::~Stream_Writer()
+    {}
+
+  void Stream_Writer::beginObject(void) throw(Syntax_Error)
+  {
+    open('}', "Stream_Writer::beginObject()");
+  }
+
+  void Stream_Writer::key(std::string const &name) throw(Syntax_Error)
+  {
+#ifdef EXTENDED_DEBUG
+    if (stack_.empty() || (stack_.back() != '}') || keyPending_)
+      throw Syntax_Error("Property name out of an object or missing a value"
+        , "writing JSON data stream", "Stream_Writer::key(std::string const &)");
+#endif
+    if (!first_)
+    {
+      if (compact_)
+        buffer_.append(',');
+      else
+        buffer_.append(", ", 2);
+    }
+    first_ = false;
+    String_Escape::escape(buffer_, name, asciiOnly_);
+    if (compact_)
+      buffer_.append(':');
+    else
+      buffer_.append(" : ", 3);
+    keyPending_ = true;
+  }
+
+  void Stream_Writer::endObject(void) throw(Syntax_Error)
+  {
+    close('}', "Stream_Writer::endObject()");
+  }
+
+  void Stream_Writer::beginArray(void) throw(Syntax_Error)
+  {
+    open(']', "Stream_Writer::beginArray()");
+  }
+
+  void Stream_Writer::endArray(void) throw(Syntax_Error)
+  {
+    close(']', "Stream_Writer::endArray()");
+  }
+
+  void Stream_Writer::nullValue(void) throw(Syntax_Error)
+  {
+    beginValue("Stream_Writer::nullValue()");
+    buffer_.append("null", 4);
+    endValue();
+  }
+
+  void Stream_Writer::value(bool data) throw(Syntax_Error)
+  {
+    beginValue("Stream_Writer::value(bool)");
+    if (data)
+      buffer_.append("true", 4);
+    else
+      buffer_.append("false", 5);
+    endValue();
+  }
+
+  void Stream_Writer::value(int data) throw(Syntax_Error)
+  {
+    beginValue("Stream_Writer::value(int)");
+    Number_Format::writeInt(buffer_, data);
+    endValue();
+  }
+
+  void Stream_Writer::value(long data) throw(Syntax_Error)
+  {
+    beginValue("Stream_Writer::value(long)");
+    Number_Format::writeInt(buffer_, data);
+    endValue();
+  }
+
+  void Stream_Writer::value(uint64_t data) throw(Syntax_Error)
+  {
+    beginValue("Stream_Writer::value(uint64_t)");
+    Number_Format::writeUnsigned(buffer_, data);
+    endValue();
+  }
+
+  void Stream_Writer::value(double data) throw(Syntax_Error)
+  {
+    beginValue("Stream_Writer::value(double)");
+    Number_Format::writeDouble(buffer_, data, precision_);
+    endValue();
+  }
+
+  void Stream_Writer::value(char const *data) throw(Syntax_Error)
+  {
+    beginValue("Stream_Writer::value(char const *)");
+    size_t  len = strlen(data);
+    String_Escape::escape(buffer_, data, len
+      , String_Escape::classify(data, len), asciiOnly_);
+    endValue();
+  }
+
+  void Stream_Writer::value(std::string const &data) throw(Syntax_Error)
+  {
+    beginValue("Stream_Writer::value(std::string const &)");
+    String_Escape::escape(buffer_, data, asciiOnly_);
+    endValue();
+  }
+
+  bool Stream_Writer::complete(void) const
+  {
+    return done_;
+  }
+
+  char const *Stream_Writer::data(void) const
+  {
+    return buffer_.data();
+  }
+
+  size_t Stream_Writer::size(void) const
+  {
+    return buffer_.size();
+  }
+
+  std::string Stream_Writer::str(void) const
+  {
+    return buffer_.str();
+  }
+
+  void Stream_Writer::clear(void)
+  {
+    buffer_.clear();
+    stack_.clear();
+    first_ = true;
+    keyPending_ = false;
+    done_ = false;
+  }
+
+  void Stream_Writer::flush(void)
+  {
+    buffer_.flush();
+  }
+
+  void Stream_Writer::setAsciiOnly(bool ascii_only)
+  {
+    asciiOnly_ = ascii_only;
+  }
+
+  void Stream_Writer::setPrecision(int precision)
+  {
+    precision_ = precision;
+  }
+
+  void Stream_Writer::setCompact(bool compact)
+  {
+    compact_ = compact;
+  }
+
+  void Stream_Writer::beginValue(char const *method) throw(Syntax_Error)
+  {
+#ifndef EXTENDED_DEBUG
+    (void)method;
+#endif
+    if (stack_.empty())
+    {                            // root value
+#ifdef EXTENDED_DEBUG
+      if (done_)
+        throw Syntax_Error("The output stream contains more than one first"
+          " level element", "writing JSON data stream", method);
+#endif
+      return;
+    }                            // root value
+
+    if (stack_.back() == '}')
+    {
+#ifdef EXTENDED_DEBUG
+      if (!keyPending_)
+        throw Syntax_Error("Object property value without a name"
+          , "writing JSON data stream", method);
+#endif
+      return;
+    }
+
+    if (!first_)
+    {
+      if (compact_)
+        buffer_.append(',');
+      else
+        buffer_.append(", ", 2);
+    }
+    first_ = false;
+  }
+
+  void Stream_Writer::endValue(void)
+  {
+    keyPending_ = false;
+    if (stack_.empty())
+    {
+      done_ = true;
+      if (buffer_.getSink())
+        buffer_.flush();
+    }
+  }
+
+  void Stream_Writer::open(char bracket, char const *method)
+    throw(Syntax_Error)
+  {
+    beginValue(method);
+    buffer_.append((bracket == '}') ? '{' : '[');
+    if (!compact_)
+      buffer_.append(' ');
+    stack_.push_back(bracket);
+    first_ = true;
+    keyPending_ = false;
+  }
+
+  void Stream_Writer::close(char bracket, char const *method)
+    throw(Syntax_Error)
+  {
+#ifdef EXTENDED_DEBUG
+    if (stack_.empty() || (stack_.back() != bracket) || keyPending_)
+      throw Syntax_Error("Closing bracket does not match the last one opened"
+        , "writing JSON data stream", method);
+#else
+    (void)method;
+#endif
+    if (!compact_)
+      buffer_.append(' ');
+    buffer_.append(bracket);
+    stack_.pop_back();
+    first_ = false;
+    endValue();
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
@@ -0,0 +1,301 @@
+
+/*
+ * jaula_stream_writer.h : JSON Analysis User Library Acronym
+ * Streaming JSON writer definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_STREAM_WRITER_H_
+#define _JAULA_STREAM_WRITER_H_
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <jaula/jaula_output_buffer.h>
+#include <jaula/jaula_sink.h>
+#include <jaula/jaula_syntax_error.h>
+
+/**
+ * \addtogroup jaula_out JAULA: JSON data output
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Streaming JSON Data Writer
+   *
+   * \ingroup jaula_out
+   *
+   * \par
+   * This class writes JSON data straight from a sequence of calls
+   * (beginObject(), key(), value(), endObject() ...) without building any
+   * Value tree. Strings are escaped and numbers formatted as done by Writer
+   * and, by default, the output layout is the same one obtained from
+   * Value::repr().
+   *
+   * \par
+   * The calls must be properly nested. This is only checked when the
+   * library is configured with extended debugging, throwing a Syntax_Error
+   * for every misplaced call; otherwise the output for misplaced calls is
+   * undefined.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Stream_Writer
+  {                              // class Stream_Writer
+    public:
+
+      /**
+       * \brief Default Constructor
+       *
+       * \par Description
+       * Creates a writer that keeps all the data written in a buffer that
+       * grows as needed (see data() and str()).
+       */
+      Stream_Writer(void);
+
+      /**
+       * \brief Sink Constructor
+       *
+       * \param sink Reference to the sink where data is to be sent. It must
+       * exist during all the writer life cycle.
+       *
+       * \param buffer_size Amount of data to gather before sending it to the
+       * sink.
+       */
+      Stream_Writer(Sink &sink, size_t buffer_size = 65536);
+
+      /**
+       * \brief Destructor
+       *
+       * \note
+       * Data not flushed yet is sent to the sink (if any).
+       */
+      ~Stream_Writer();
+
+      /**
+       * \brief Starts an object
+       */
+      void beginObject(void) throw(Syntax_Error);
+
+      /**
+       * \brief Writes the name of the next object property
+       *
+       * \param name Property name.
+       */
+      void key(std::string const &name) throw(Syntax_Error);
+
+      /**
+       * \brief Ends the current object
+       */
+      void endObject(void) throw(Syntax_Error);
+
+      /**
+       * \brief Starts an array
+       */
+      void beginArray(void) throw(Syntax_Error);
+
+      /**
+       * \brief Ends the current array
+       */
+      void endArray(void) throw(Syntax_Error);
+
+      /**
+       * \brief Writes a null value
+       */
+      void nullValue(void) throw(Syntax_Error);
+
+      /**
+       * \brief Writes a boolean value
+       */
+      void value(bool data) throw(Syntax_Error);
+
+      /**
+       * \brief Writes an integer value
+       */
+      void value(int data) throw(Syntax_Error);
+
+      /**
+       * \brief Writes an integer value
+       */
+      void value(long data) throw(Syntax_Error);
+
+      /**
+       * \brief Writes an unsigned integer value
+       */
+      void value(uint64_t data) throw(Syntax_Error);
+
+      /**
+       * \brief Writes a floating point value
+       */
+      void value(double data) throw(Syntax_Error);
+
+      /**
+       * \brief Writes a string value
+       *
+       * \param data Pointer to a null terminated string.
+       */
+      void value(char const *data) throw(Syntax_Error);
+
+      /**
+       * \brief Writes a string value
+       */
+      void value(std::string const &data) throw(Syntax_Error);
+
+      /**
+       * \brief Checks if a complete value has been written
+       *
+       * \returns true if at least a value has been written and there are
+       * no arrays or objects left open.
+       */
+      bool complete(void) const;
+
+      /**
+       * \brief Retrieves the data written and not sent to a sink
+       */
+      char const *data(void) const;
+
+      /**
+       * \brief Retrieves the number of bytes returned by data()
+       */
+      size_t size(void) const;
+
+      /**
+       * \brief Retrieves a copy of the data written and not sent to a sink
+       */
+      std::string str(void) const;
+
+      /**
+       * \brief Discards the data written and not sent to a sink and any
+       * open array or object
+       */
+      void clear(void);
+
+      /**
+       * \brief Sends pending data to the sink and flushes it
+       */
+      void flush(void);
+
+      /**
+       * \brief Establishes how non ASCII characters are written (see
+       * Writer::setAsciiOnly())
+       */
+      void setAsciiOnly(bool ascii_only);
+
+      /**
+       * \brief Establishes how floating point numbers are written (see
+       * Writer::setPrecision())
+       */
+      void setPrecision(int precision);
+
+      /**
+       * \brief Establishes the compact mode (see Writer::setCompact())
+       */
+      void setCompact(bool compact);
+
+    private:
+
+      /**
+       * \brief Copy constructor (not available)
+       */
+      Stream_Writer(Stream_Writer const &orig);
+
+      /**
+       * \brief Assignment operator (not available)
+       */
+      Stream_Writer &operator=(Stream_Writer const &orig);
+
+      /**
+       * \brief Prepares the output for a new value
+       *
+       * \param method Name of the calling method (for error reports).
+       */
+      void beginValue(char const *method) throw(Syntax_Error);
+
+      /**
+       * \brief Updates the state after a value
+       */
+      void endValue(void);
+
+      /**
+       * \brief Starts an array or object
+       */
+      void open(char bracket, char const *method) throw(Syntax_Error);
+
+      /**
+       * \brief Ends an array or object
+       */
+      void close(char bracket, char const *method) throw(Syntax_Error);
+
+      /**
+       * \brief Output buffer
+       */
+      Output_Buffer buffer_;
+
+      /**
+       * \brief Closing brackets of the arrays and objects open
+       */
+      std::vector<char> stack_;
+
+      /**
+       * \brief Flag for no items written in the innermost array or object
+       */
+      bool  first_;
+
+      /**
+       * \brief Flag for a property name written without its value
+       */
+      bool  keyPending_;
+
+      /**
+       * \brief Flag for a complete value written
+       */
+      bool  done_;
+
+      /**
+       * \brief Flag for writing non ASCII characters as escape sequences
+       */
+      bool  asciiOnly_;
+
+      /**
+       * \brief Significant digits for floating point numbers (0 for
+       * shortest)
+       */
+      int   precision_;
+
+      /**
+       * \brief Flag for writing without blanks
+       */
+      bool  compact_;
+
+  };                             // class Stream_Writer
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
@@ -0,0 +1,438 @@
+
+/*
+ * jaula_string_escape.cc : JSON Analysis User Library Acronym
+ * JSON string escaping definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+}
+
+
+#if defined(HAVE_EMMINTRIN_H) && defined(__SSE2__)
+#include <emmintrin.h>
+#define JAULA_USE_SSE2
+#endif
+
+
+#include <jaula/jaula_string_escape.h>
+
+namespace
+{                                // anonymous namespace
+
+  char const  hexDigits[] = "0123456789abcdef";
+
+  /**
+   * \brief Characters to write after a backslash for control characters
+   *
+   * \par Description
+   * 'u' means the character is written as an unicode escape sequence.
+   */
+  char const  controlEscapes[32] =
+  {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u'
+  };
+
+  /**
+   * \brief True for the bytes that always need escaping
+   */
+  inline bool special(unsigned char c)
+  {
+    return (c < 0x20) || (c == '"') || (c == '\\');
+  }
+
+  /**
+   * \brief Length of the leading run of bytes needing no escaping
+   *
+   * \param stop_high flag to end the run at bytes outside the ASCII range
+   * too.
+   */
+  size_t safeRun(char const *data, size_t len, bool stop_high)
+  {
+    size_t  i = 0;
+#ifdef JAULA_USE_SSE2
+    __m128i const quote = _mm_set1_epi8('"');
+    __m128i const backslash = _mm_set1_epi8('\\');
+    __m128i const space = _mm_set1_epi8(0x20);
+    __m128i const bias = _mm_set1_epi8(static_cast<char>(0x80));
+    __m128i const limit = _mm_set1_epi8(static_cast<char>(0xa0));
+    for (; ((i + 16) <= len); i += 16)
+    {
+      __m128i block =
+        _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i));
+      __m128i found = _mm_or_si128(_mm_cmpeq_epi8(block, quote)
+        , _mm_cmpeq_epi8(block, backslash));
+      // signed comparison catches bytes over 0x7f too, biased one does not
+      if (stop_high)
+        found = _mm_or_si128(found, _mm_cmplt_epi8(block, space));
+      else
+        found = _mm_or_si128(found
+          , _mm_cmplt_epi8(_mm_xor_si128(block, bias), limit));
+      int mask = _mm_movemask_epi8(found);
+      if (mask)
+        return i + __builtin_ctz(mask);
+    }
+#endif
+    for (; (i < len); i++)
+    {
+      unsigned char c = static_cast<unsigned char>(data[i]);
+      if (special(c) || (stop_high && (c & 0x80)))
+        break;
+    }
+    return i;
+  }
+
+  /**
+   * \brief Length of the leading run of ASCII bytes
+   */
+  size_t asciiRun(char const *data, size_t len)
+  {
+    size_t  i = 0;
+#ifdef JAULA_USE_SSE2
+    for (; ((i + 16) <= len); i += 16)
+    {
+      int mask = _mm_movemask_epi8(
+        _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i)));
+      if (mask)
+        return i + __builtin_ctz(mask);
+    }
+#endif
+    while ((i < len) && (!(data[i] & 0x80)))
+      i++;
+    return i;
+  }
+
+  /**
+   * \brief Value of four hexadecimal digits
+   *
+   * \returns false if any of them is not a hexadecimal digit.
+   */
+  bool hexValue(char const *data, unsigned int &code)
+  {
+    code = 0;
+    for (size_t i = 0; (i < 4); i++)
+    {
+      char  c = data[i];
+      if ((c >= '0') && (c <= '9'))
+        code = (code << 4) | (c - '0');
+      else if (((c | 0x20) >= 'a') && ((c | 0x20) <= 'f'))
+        code = (code << 4) | ((c | 0x20) - 'a' + 10);
+      else
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * \brief Writes an unicode escape sequence
+   */
+  void unicodeEscape(JAULA::Output_Buffer &out, unsigned int code)
+  {
+    char  *p = out.reserve(6);
+    p[0] = '\\';
+    p[1] = 'u';
+    p[2] = hexDigits[(code >> 12) & 0x0f];
+    p[3] = hexDigits[(code >> 8) & 0x0f];
+    p[4] = hexDigits[(code >> 4) & 0x0f];
+    p[5] = hexDigits[code & 0x0f];
+    out.commit(6);
+  }
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  unsigned int String_Escape::classify(char const *data, size_t len)
+  {
+    unsigned int  flags = 0;
+    size_t  i = 0;
+    size_t  firstHigh = len;
+#ifdef JAULA_USE_SSE2
+    __m128i const quote = _mm_set1_epi8('"');
+    __m128i const backslash = _mm_set1_epi8('\\');
+    __m128i const bias = _mm_set1_epi8(static_cast<char>(0x80));
+    __m128i const limit = _mm_set1_epi8(static_cast<char>(0xa0));
+    __m128i found = _mm_setzero_si128();
+    for (; ((i + 16) <= len); i += 16)
+    {
+      __m128i block =
+        _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i));
+      found = _mm_or_si128(found, _mm_cmpeq_epi8(block, quote));
+      found = _mm_or_si128(found, _mm_cmpeq_epi8(block, backslash));
+      found = _mm_or_si128(found
+        , _mm_cmplt_epi8(_mm_xor_si128(block, bias), limit));
+      int high = _mm_movemask_epi8(block);
+      if (high && (firstHigh == len))
+        firstHigh = i + __builtin_ctz(high);
+    }
+    if (_mm_movemask_epi8(found))
+      flags |= NEEDS_ESCAPE;
+#endif
+    for (; (i < len); i++)
+    {
+      unsigned char c = static_cast<unsigned char>(data[i]);
+      if (special(c))
+        flags |= NEEDS_ESCAPE;
+      else if ((c & 0x80) && (firstHigh == len))
+        firstHigh = i;
+    }
+
+    if (firstHigh == len)
+      return flags;
+
+    flags |= NON_ASCII;
+    for (i = firstHigh; (i < len);)
+    {
+      if (!(data[i] & 0x80))
+      {
+        i += asciiRun(data + i, len - i);
+        continue;
+      }
+      size_t  seq = validUTF8(data + i, len - i);
+      if (!seq)
+        return flags | INVALID_UTF8;
+      i += seq;
+    }
+    return flags;
+  }
+
+  size_t String_Escape::validUTF8(char const *data, size_t len)
+  {
+    unsigned char const *p = reinterpret_cast<unsigned char const *>(data);
+    if (!len)
+      return 0;
+    if (p[0] < 0x80)
+      return 1;
+    if (p[0] < 0xc2)
+      return 0;
+    if (p[0] < 0xe0)
+      return ((len >= 2) && ((p[1] & 0xc0) == 0x80)) ? 2 : 0;
+    if (p[0] < 0xf0)
+    {
+      if ((len < 3) || ((p[2] & 0xc0) != 0x80))
+        return 0;
+      unsigned char lo = (p[0] == 0xe0) ? 0xa0 : 0x80;
+      unsigned char hi = (p[0] == 0xed) ? 0x9f : 0xbf;
+      return ((p[1] >= lo) && (p[1] <= hi)) ? 3 : 0;
+    }
+    if (p[0] < 0xf5)
+    {
+      if ((len < 4) || ((p[2] & 0xc0) != 0x80) || ((p[3] & 0xc0) != 0x80))
+        return 0;
+      unsigned char lo = (p[0] == 0xf0) ? 0x90 : 0x80;
+      unsigned char hi = (p[0] == 0xf4) ? 0x8f : 0xbf;
+      return ((p[1] >= lo) && (p[1] <= hi)) ? 4 : 0;
+    }
+    return 0;
+  }
+
+  size_t String_Escape::stringRun(char const *data, size_t len
+    , bool stop_high)
+  {
+    size_t  i = 0;
+#ifdef JAULA_USE_SSE2
+    __m128i const quote = _mm_set1_epi8('"');
+    __m128i const backslash = _mm_set1_epi8('\\');
+    __m128i const newLine = _mm_set1_epi8('\n');
+    for (; ((i + 16) <= len); i += 16)
+    {
+      __m128i block =
+        _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i));
+      int mask = _mm_movemask_epi8(_mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(block, quote)
+        , _mm_cmpeq_epi8(block, backslash))
+        , _mm_cmpeq_epi8(block, newLine)));
+      if (stop_high)
+        mask |= _mm_movemask_epi8(block);
+      if (mask)
+        return i + __builtin_ctz(mask);
+    }
+#endif
+    for (; (i < len); i++)
+    {
+      char  c = data[i];
+      if ((c == '"') || (c == '\\') || (c == '\n') || (stop_high && (c & 0x80)))
+        break;
+    }
+    return i;
+  }
+
+  void String_Escape::appendUTF8(std::string &out, unsigned int code)
+  {
+    char  buf[4];
+    size_t  len;
+    if (code < 0x80)
+    {
+      buf[0] = static_cast<char>(code);
+      len = 1;
+    }
+    else if (code < 0x800)
+    {
+      buf[0] = static_cast<char>(0xc0 | (code >> 6));
+      buf[1] = static_cast<char>(0x80 | (code & 0x3f));
+      len = 2;
+    }
+    else if (code < 0x10000)
+    {
+      buf[0] = static_cast<char>(0xe0 | (code >> 12));
+      buf[1] = static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+      buf[2] = static_cast<char>(0x80 | (code & 0x3f));
+      len = 3;
+    }
+    else
+    {
+      buf[0] = static_cast<char>(0xf0 | (code >> 18));
+      buf[1] = static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+      buf[2] = static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+      buf[3] = static_cast<char>(0x80 | (code & 0x3f));
+      len = 4;
+    }
+    out.append(buf, len);
+  }
+
+  size_t String_Escape::unescapeUnicode(char const *data, size_t len
+    , std::string &out)
+  {
+    size_t  done = 0;
+    for (;;)
+    {                            // escape sequences loop
+      size_t  pos = done;
+      if (done)
+      {
+        if ((done >= len) || (data[done] != '\\'))
+          break;
+        pos++;
+      }
+      unsigned int  code;
+      if (((pos + 5) > len) || (data[pos] != 'u')
+        || (!hexValue(data + pos + 1, code)))
+        break;
+      pos += 5;
+      if ((code >= 0xdc00) && (code <= 0xdfff))
+        break;
+      if ((code >= 0xd800) && (code <= 0xdbff))
+      {
+        unsigned int  low;
+        if (((pos + 6) > len) || (data[pos] != '\\') || (data[pos + 1] != 'u')
+          || (!hexValue(data + pos + 2, low))
+          || (low < 0xdc00) || (low > 0xdfff))
+          break;
+        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+        pos += 6;
+      }
+      appendUTF8(out, code);
+      done = pos;
+    }                            // escape sequences loop
+    return done;
+  }
+
+  void String_Escape::escape(Output_Buffer &out, char const *data
+    , size_t len, unsigned int flags, bool ascii_only)
+  {
+    out.append('"');
+    if ((!(flags & NEEDS_ESCAPE))
+      && ((!(flags & NON_ASCII))
+      || ((!ascii_only) && (!(flags & INVALID_UTF8)))))
+    {
+      out.append(data, len);
+      out.append('"');
+      return;
+    }
+
+    bool  stopHigh = ascii_only || (flags & INVALID_UTF8);
+    char const  *end = data + len;
+    while (data != end)
+    {                            // safe runs loop
+      size_t  run = safeRun(data, end - data, stopHigh);
+      if (run)
+      {
+        out.append(data, run);
+        data += run;
+        if (data == end)
+          break;
+      }
+
+      unsigned char c = static_cast<unsigned char>(*data);
+      if (!(c & 0x80))
+      {                          // ASCII symbol
+        char  *p = out.reserve(2);
+        p[0] = '\\';
+        if (c >= 0x20)
+          p[1] = static_cast<char>(c);
+        else
+          p[1] = controlEscapes[c];
+        if (p[1] != 'u')
+          out.commit(2);
+        else
+          unicodeEscape(out, c);
+        data++;
+        continue;
+      }                          // ASCII symbol
+
+      size_t  seq = validUTF8(data, end - data);
+      if (!seq)
+      {
+        unicodeEscape(out, c);
+        data++;
+      }
+      else if (!ascii_only)
+      {
+        out.append(data, seq);
+        data += seq;
+      }
+      else
+      {                          // ASCII only output
+        unsigned int  code = c & (0x7f >> seq);
+        for (size_t i = 1; (i < seq); i++)
+          code = (code << 6) | (static_cast<unsigned char>(data[i]) & 0x3f);
+        if (code < 0x10000)
+          unicodeEscape(out, code);
+        else
+        {
+          code -= 0x10000;
+          unicodeEscape(out, 0xd800 | (code >> 10));
+          unicodeEscape(out, 0xdc00 | (code & 0x3ff));
+        }
+        data += seq;
+      }                          // ASCII only output
+    }                            // safe runs loop
+    out.append('"');
+  }
+
+  void String_Escape::escape(Output_Buffer &out, std::string const &str
+    , bool ascii_only)
+  {
+    escape(out, str.data(), str.size(), classify(str.data(), str.size())
+      , ascii_only);
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
@@ -0,0 +1,196 @@
+
+/*
+ * jaula_string_escape.h : JSON Analysis User Library Acronym
+ * JSON string escaping definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_STRING_ESCAPE_H_
+#define _JAULA_STRING_ESCAPE_H_
+
+#include <cstddef>
+#include <string>
+
+#include <jaula/jaula_output_buffer.h>
+
+/**
+ * \addtogroup jaula_out JAULA: JSON data output
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief JSON string escaping routines
+   *
+   * \ingroup jaula_out
+   *
+   * \par
+   * This class groups the routines that write strings in JSON notation.
+   * Strings are scanned several bytes at a time (using SSE2 instructions
+   * where available) and the runs that need no escaping are copied as a
+   * block.
+   *
+   * \par
+   * Strings are supposed to be UTF-8 encoded. Valid multibyte sequences are
+   * copied unchanged or, if ASCII only output is requested, written as
+   * unicode escape sequences (surrogate pairs for characters outside the
+   * basic multilingual plane). Bytes not belonging to a valid sequence are
+   * written as unicode escape sequences for the byte value.
+   *
+   * \par
+   * The routines used by the parsers for decoding unicode escape sequences
+   * and scanning raw string contents are here too, so both directions
+   * agree on what a valid string is.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class String_Escape
+  {                              // class String_Escape
+    public:
+
+      /**
+       * \brief String contents flags as returned by classify()
+       */
+      enum    Flags
+      {                          // enum Flags
+        /** String contains quotes, backslashes or control characters */
+        NEEDS_ESCAPE = 0x01
+        /** String contains bytes outside the ASCII range */
+        ,   NON_ASCII = 0x02
+        /** String contains bytes not belonging to valid UTF-8 sequences */
+        ,   INVALID_UTF8 = 0x04
+      };                         // enum Flags
+
+      /**
+       * \brief Analyzes the contents of a string
+       *
+       * \param data Pointer to the string contents.
+       *
+       * \param len Number of bytes of the string.
+       *
+       * \returns a combination of Flags describing the string contents.
+       */
+      static unsigned int classify(char const *data, size_t len);
+
+      /**
+       * \brief Checks for a valid UTF-8 sequence
+       *
+       * \param data Pointer to the first byte of the sequence.
+       *
+       * \param len Number of bytes available.
+       *
+       * \returns the length of the valid UTF-8 sequence starting at data or 0
+       * if there is none (overlong forms, surrogates and values beyond
+       * U+10FFFF are not valid).
+       */
+      static size_t validUTF8(char const *data, size_t len);
+
+      /**
+       * \brief Length of the leading run of raw string contents
+       *
+       * \param data Pointer to the contents, after the opening quote.
+       *
+       * \param len Number of bytes available.
+       *
+       * \param stop_high flag to end the run at bytes outside the ASCII range
+       * too, so they can be validated.
+       *
+       * \returns the number of bytes before the first quote, backslash or
+       * new line (or byte outside the ASCII range), len if there is none.
+       */
+      static size_t stringRun(char const *data, size_t len, bool stop_high);
+
+      /**
+       * \brief Appends a character encoded as UTF-8
+       *
+       * \param out String to append to.
+       *
+       * \param code Unicode code point, that must not be a surrogate nor be
+       * beyond U+10FFFF.
+       */
+      static void appendUTF8(std::string &out, unsigned int code);
+
+      /**
+       * \brief Decodes a run of unicode escape sequences
+       *
+       * \param data Pointer to the 'u' of the first sequence, the following
+       * ones starting with their backslash.
+       *
+       * \param len Number of bytes available.
+       *
+       * \param out String where the characters decoded are appended as
+       * UTF-8.
+       *
+       * \returns the number of bytes decoded.
+       *
+       * \par Description
+       * Surrogate pairs are combined into a single character. Decoding stops
+       * before the first sequence that is malformed, incomplete, an unpaired
+       * surrogate or a high surrogate whose pair is not available yet, so
+       * callers can deal with it one byte at a time.
+       */
+      static size_t unescapeUnicode(char const *data, size_t len
+        , std::string &out);
+
+      /**
+       * \brief Writes a string in JSON notation
+       *
+       * \param out Buffer where the representation is to be written.
+       *
+       * \param data Pointer to the string contents.
+       *
+       * \param len Number of bytes of the string.
+       *
+       * \param flags String contents as returned by classify().
+       *
+       * \param ascii_only flag to write characters outside the ASCII range as
+       * unicode escape sequences.
+       *
+       * \par Description
+       * Writes the string surrounded by quotes, escaping every symbol that
+       * cannot appear in a JSON string as is.
+       */
+      static void escape(Output_Buffer &out, char const *data, size_t len
+        , unsigned int flags, bool ascii_only = false);
+
+      /**
+       * \brief Writes a string in JSON notation
+       *
+       * \param out Buffer where the representation is to be written.
+       *
+       * \param str String to write.
+       *
+       * \param ascii_only flag to write characters outside the ASCII range as
+       * unicode escape sequences.
+       */
+      static void escape(Output_Buffer &out, std::string const &str
+        , bool ascii_only = false);
+
+  };                             // class String_Escape
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
@@ -31,6 +31,14 @@ extern "C"
 #ifdef HAVE_CONFIG_H
 #include <config.h>
 #endif
+
+#ifdef HAVE_STDINT_H
+#include <stdint.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
 }
 
 
@@ -38,6 +46,11 @@ extern "C"
 #include <iostream>
 #endif
 
+#ifdef HAVE_LIMITS
+#include <limits>
+#endif
+
+#include <jaula/jaula_number_format.h>
 #include <jaula/jaula_value.h>
 #include <jaula/jaula_value_array.h>
 #include <jaula/jaula_value_boolean.h>
@@ -47,6 +60,88 @@ extern "C"
 #include <jaula/jaula_value_object.h>
 #include <jaula/jaula_value_string.h>
 
+namespace
+{                                // anonymous namespace
+
+  /**
+   * \brief Multiplier for hash seeds (2^64 divided by the golden ratio)
+   */
+  uint64_t const  GOLDEN = (static_cast<uint64_t>(0x9e3779b9UL) << 32)
+    | 0x7f4a7c15UL;
+
+  /**
+   * \brief Mixes the bits of a 64 bit quantity (MurmurHash3 finalizer)
+   */
+  uint64_t mix(uint64_t h)
+  {
+    h ^= h >> 33;
+    h *= (static_cast<uint64_t>(0xff51afd7UL) << 32) | 0xed558ccdUL;
+    h ^= h >> 33;
+    h *= (static_cast<uint64_t>(0xc4ceb9feUL) << 32) | 0x1a85ec53UL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  /**
+   * \brief Combines a hash with the one of the next item in a sequence
+   */
+  uint64_t combine(uint64_t h, uint64_t item)
+  {
+    return mix(h ^ (item + GOLDEN + (h << 6) + (h >> 2)));
+  }
+
+  /**
+   * \brief Hashes a sequence of bytes eight at a time
+   */
+  uint64_t hashBytes(uint64_t seed, char const *data, size_t len)
+  {
+    uint64_t  h = mix(seed ^ (len * GOLDEN));
+    for (; (len >= 8); data += 8, len -= 8)
+    {
+      uint64_t  word;
+      memcpy(&word, data, 8);
+      h = mix(h ^ word) * GOLDEN;
+    }
+    uint64_t  tail = 0;
+    memcpy(&tail, data, len);
+    return mix(h ^ tail);
+  }
+
+  /**
+   * \brief Normalized text of a number, from its decimal text if it has one
+   */
+  std::string numberKey(JAULA::Value_Number const &number)
+  {
+    std::string const &text = number.getText();
+    if (text.empty())
+      return JAULA::Number_Format::normalize(number.getData());
+    return JAULA::Number_Format::normalize(text.data(), text.size());
+  }
+
+  /**
+   * \brief Resolves a pointer checking the type of the referenced value
+   *
+   * \exception JAULA::Bad_Data_Type
+   * This exception is launched if the value does not exist or if its type
+   * is neither type nor alt.
+   */
+  JAULA::Value const &require(JAULA::Value const &root
+    , JAULA::Json_Pointer const &pointer
+    , JAULA::Value::ValueType type
+    , JAULA::Value::ValueType alt) throw(JAULA::Bad_Data_Type)
+  {
+    JAULA::Value const *pValue = pointer.resolve(root);
+    if (!pValue)
+      throw JAULA::Bad_Data_Type("Referenced value does not exist"
+        , "resolving pointer " + pointer.getPointer());
+    if ((pValue->getType() != type) && (pValue->getType() != alt))
+      throw JAULA::Bad_Data_Type("Referenced value type does not match"
+        , "resolving pointer " + pointer.getPointer());
+    return *pValue;
+  }
+
+}                                // anonymous namespace
+
 namespace JAULA
 {                                // namespace JAULA
 
@@ -103,20 +198,28 @@ namespace JAULA
       {                          // String Value
         Value_String const *pOrg = dynamic_cast<Value_String const *>(&orig);
         if (pOrg)
-          return new Value_String(pOrg->getData());
+          return new Value_String(pOrg->getData(), pOrg->getEscapeFlags());
       }                          // String Value
 
       {                          // Number (Int) Value
         Value_Number_Int const *pOrg =
           dynamic_cast<Value_Number_Int const *>(&orig);
         if (pOrg)
-          return new Value_Number_Int(pOrg->getData());
+        {
+          Value_Number_Int  *pNumber = new Value_Number_Int();
+          pNumber->set(*pOrg);
+          return pNumber;
+        }
       }                          // Number (Int) Value
 
       {                          // Number Value
         Value_Number const *pOrg = dynamic_cast<Value_Number const *>(&orig);
         if (pOrg)
-          return new Value_Number(pOrg->getData());
+        {
+          Value_Number  *pNumber = new Value_Number();
+          pNumber->set(*pOrg);
+          return pNumber;
+        }
       }                          // Number Value
 
       {                          // Array Value
@@ -147,10 +250,316 @@ namespace JAULA
     }
   }
 
+  Value const *Value::at(Json_Pointer const &pointer) const
+  {
+    return pointer.resolve(*this);
+  }
+
+  Value *Value::at(Json_Pointer const &pointer)
+  {
+    return pointer.resolve(*this);
+  }
+
+  Value *Value::numberFromText(std::string const &text)
+  {
+    if (!Number_Format::isInt(text.data(), text.size()))
+    {
+      Value_Number  *pNumber = new Value_Number();
+      pNumber->setText(text);
+      return pNumber;
+    }
+
+    size_t const  digits = text.size()
+      - (((text[0] == '+') || (text[0] == '-')) ? 1 : 0);
+    if (digits <= static_cast<size_t>(std::numeric_limits<int64_t>::digits10))
+    {
+      Value_Number_Int  *pNumber = new Value_Number_Int();
+      pNumber->setText(text);
+      return pNumber;
+    }
+
+    int64_t   val = 0;
+    uint64_t  uval = 0;
+    switch (Number_Format::scanInt(text.data(), text.size(), val, uval))
+    {
+      case Number_Format::INT_SIGNED :
+      case Number_Format::INT_UNSIGNED :
+      {
+        Value_Number_Int  *pNumber = new Value_Number_Int();
+        pNumber->setText(text);
+        return pNumber;
+      }
+
+      default :
+      {
+        Value_Number  *pNumber = new Value_Number();
+        pNumber->setText(text);
+        return pNumber;
+      }
+    }
+  }
+
+  bool Value::getBoolean(Json_Pointer const &pointer) const
+    throw(Bad_Data_Type)
+  {
+    try
+    {
+      return static_cast<Value_Boolean const &>(require(*this, pointer
+        , TYPE_BOOLEAN, TYPE_BOOLEAN)).getData();
+    }
+    catch(Bad_Data_Type &ex)
+    {
+      ex.addOrigin("Value::getBoolean(Json_Pointer const &)");
+      throw ex;
+    }
+  }
+
+  int64_t Value::getNumberInt(Json_Pointer const &pointer) const
+    throw(Bad_Data_Type)
+  {
+    try
+    {
+      Value_Number_Int const &value = static_cast<Value_Number_Int const &>(
+        require(*this, pointer, TYPE_NUMBER_INT, TYPE_NUMBER_INT));
+      if (value.isUnsigned())
+        throw Bad_Data_Type("Referenced value does not fit a 64 bit signed integer"
+          , "resolving pointer " + pointer.getPointer());
+      return value.getInt64();
+    }
+    catch(Bad_Data_Type &ex)
+    {
+      ex.addOrigin("Value::getNumberInt(Json_Pointer const &)");
+      throw ex;
+    }
+  }
+
+  double Value::getNumber(Json_Pointer const &pointer) const
+    throw(Bad_Data_Type)
+  {
+    try
+    {
+      Value const &value = require(*this, pointer
+        , TYPE_NUMBER, TYPE_NUMBER_INT);
+      if (value.getType() == TYPE_NUMBER_INT)
+      {
+        Value_Number_Int const &num =
+          static_cast<Value_Number_Int const &>(value);
+        if (num.isUnsigned())
+          return static_cast<double>(num.getUnsigned());
+        return static_cast<double>(num.getInt64());
+      }
+      return static_cast<Value_Number const &>(value).getData();
+    }
+    catch(Bad_Data_Type &ex)
+    {
+      ex.addOrigin("Value::getNumber(Json_Pointer const &)");
+      throw ex;
+    }
+  }
+
+  std::string const &Value::getString(Json_Pointer const &pointer) const
+    throw(Bad_Data_Type)
+  {
+    try
+    {
+      return static_cast<Value_String const &>(require(*this, pointer
+        , TYPE_STRING, TYPE_STRING)).getData();
+    }
+    catch(Bad_Data_Type &ex)
+    {
+      ex.addOrigin("Value::getString(Json_Pointer const &)");
+      throw ex;
+    }
+  }
+
+  uint64_t Value::hash(void) const
+  {
+    switch (Type_)
+    {                            // value type switch
+      case TYPE_BOOLEAN :
+        return mix(TYPE_BOOLEAN * GOLDEN
+          + static_cast<Value_Boolean const *>(this)->getData());
+
+      case TYPE_NUMBER_INT :
+        return mix(TYPE_NUMBER_INT * GOLDEN
+          + static_cast<Value_Number_Int const *>(this)->getUnsigned());
+
+      case TYPE_NUMBER :
+      {
+        Value_Number const *pNumber = static_cast<Value_Number const *>(this);
+        double  data = pNumber->getData();
+        if (!pNumber->getText().empty())
+        {                        // text not given by its double
+          std::string const  key = numberKey(*pNumber);
+          if (key != Number_Format::normalize(data))
+            return hashBytes(TYPE_NUMBER * GOLDEN, key.data(), key.size());
+        }                        // text not given by its double
+        uint64_t  bits = 0;
+        if (data != 0)
+          memcpy(&bits, &data, sizeof(bits));
+        return mix(TYPE_NUMBER * GOLDEN + bits);
+      }
+
+      case TYPE_STRING :
+      {
+        std::string const &data =
+          static_cast<Value_String const *>(this)->getData();
+        return hashBytes(TYPE_STRING * GOLDEN, data.data(), data.size());
+      }
+
+      case TYPE_ARRAY :
+      case TYPE_OBJECT :
+        break;
+
+      default :
+        return mix(TYPE_NULL * GOLDEN);
+    }                            // value type switch
+
+    Value_Complex const *pComplex = static_cast<Value_Complex const *>(this);
+    if (pComplex->hashed_)
+      return pComplex->hash_;
+
+    uint64_t  h = mix(Type_ * GOLDEN + pComplex->size());
+    if (Type_ == TYPE_ARRAY)
+    {
+      Value_Array::dataType const &items =
+        static_cast<Value_Array const *>(this)->getData();
+      for (Value_Array::dataType::const_iterator it = items.begin()
+        ; (it != items.end())
+        ; it++)
+        h = combine(h, (*it)->hash());
+    }
+    else
+    {
+      Value_Object::dataType const &props =
+        static_cast<Value_Object const *>(this)->getData();
+      for (Value_Object::dataType::const_iterator it = props.begin()
+        ; (it != props.end())
+        ; it++)
+      {
+        h = combine(h, hashBytes(TYPE_STRING * GOLDEN, it->first.data()
+          , it->first.size()));
+        h = combine(h, it->second->hash());
+      }
+    }
+    pComplex->hash_ = h;
+    pComplex->hashed_ = true;
+    return h;
+  }
+
+  bool Value::equals(Value const &other) const
+  {
+    if (this == &other)
+      return true;
+    if (Type_ != other.Type_)
+      return false;
+
+    switch (Type_)
+    {                            // value type switch
+      case TYPE_BOOLEAN :
+        return static_cast<Value_Boolean const *>(this)->getData()
+          == static_cast<Value_Boolean const &>(other).getData();
+
+      case TYPE_NUMBER_INT :
+      {
+        Value_Number_Int const *pThis =
+          static_cast<Value_Number_Int const *>(this);
+        Value_Number_Int const &num =
+          static_cast<Value_Number_Int const &>(other);
+        return (pThis->getUnsigned() == num.getUnsigned())
+          && (pThis->isUnsigned() == num.isUnsigned());
+      }
+
+      case TYPE_NUMBER :
+      {
+        Value_Number const *pThis = static_cast<Value_Number const *>(this);
+        Value_Number const &num = static_cast<Value_Number const &>(other);
+        if (pThis->getText().empty() && num.getText().empty())
+          return pThis->getData() == num.getData();
+        return numberKey(*pThis) == numberKey(num);
+      }
+
+      case TYPE_STRING :
+        return static_cast<Value_String const *>(this)->getData()
+          == static_cast<Value_String const &>(other).getData();
+
+      case TYPE_ARRAY :
+      case TYPE_OBJECT :
+        break;
+
+      default :
+        return true;
+    }                            // value type switch
+
+    Value_Complex const *pLeft = static_cast<Value_Complex const *>(this);
+    Value_Complex const &right = static_cast<Value_Complex const &>(other);
+    if (pLeft->size() != right.size())
+      return false;
+    if (pLeft->hashed_ && right.hashed_ && (pLeft->hash_ != right.hash_))
+      return false;
+
+    if (Type_ == TYPE_ARRAY)
+    {
+      Value_Array::dataType const &left =
+        static_cast<Value_Array const *>(this)->getData();
+      Value_Array::dataType::const_iterator it =
+        static_cast<Value_Array const &>(other).getData().begin();
+      for (Value_Array::dataType::const_iterator lt = left.begin()
+        ; (lt != left.end())
+        ; lt++, it++)
+        if (!(*lt)->equals(**it))
+          return false;
+    }
+    else
+    {
+      Value_Object::dataType const &left =
+        static_cast<Value_Object const *>(this)->getData();
+      Value_Object::dataType::const_iterator it =
+        static_cast<Value_Object const &>(other).getData().begin();
+      for (Value_Object::dataType::const_iterator lt = left.begin()
+        ; (lt != left.end())
+        ; lt++, it++)
+        if ((lt->first != it->first) || !lt->second->equals(*(it->second)))
+          return false;
+    }
+    return true;
+  }
+
+  bool Value::operator==(Value const &other) const
+  {
+    return equals(other);
+  }
+
+  bool Value::operator!=(Value const &other) const
+  {
+    return !equals(other);
+  }
+
+  Value_Complex *Value::getParent(void) const
+  {
+    return pParent_;
+  }
+
   Value::Value(ValueType Type)
     : Type_(Type)
+    , pParent_(0)
+    {}
+
+  Value::Value(Value const &orig)
+    : Type_(orig.Type_)
+    , pParent_(0)
     {}
 
+  void Value::changed(void)
+  {
+    if ((Type_ == TYPE_ARRAY) || (Type_ == TYPE_OBJECT))
+      static_cast<Value_Complex *>(this)->hashed_ = false;
+    for (Value_Complex *pContainer = pParent_
+      ; (pContainer && pContainer->hashed_)
+      ; pContainer = pContainer->pParent_)
+      pContainer->hashed_ = false;
+  }
+
 }                                // namespace JAULA
 
 
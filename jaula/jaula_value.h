@@ -29,7 +29,12 @@
 #ifndef _JAULA_VALUE_H_
 #define _JAULA_VALUE_H_
 
+#include <stdint.h>
+
+#include <string>
+
 #include <jaula/jaula_bad_data_type.h>
+#include <jaula/jaula_json_pointer.h>
 
 /**
  * \addtogroup jaula_val JAULA: JSON Values containers
@@ -38,6 +43,8 @@
 namespace JAULA
 {                                // namespace JAULA
 
+  class Value_Complex;
+
   /**
    * \brief Base class for handling values
    *
@@ -144,6 +151,144 @@ namespace JAULA
        */
       static Value *duplicate(Value const &orig);
 
+      /**
+       * \brief Creates a number value from its decimal text
+       *
+       * \param text Representation of a valid JSON number.
+       *
+       * \returns a pointer to memory taken from the heap containing either a
+       * Value_Number_Int or a Value_Number instance. It is up to the caller to
+       * release it.
+       *
+       * \par Description
+       * The text is kept by the value to be written back as read (see
+       * Value_Number::setText()). Integers short enough to surely fit 64 bits
+       * and any number with decimals or exponent are not converted until
+       * they are retrieved. Other integers are checked at once to choose the
+       * type that holds them exactly.
+       */
+      static Value *numberFromText(std::string const &text);
+
+      /**
+       * \brief Computes a structural hash for the instance
+       *
+       * \returns a 64 bit hash depending only on the contents, so equal
+       * values have equal hashes.
+       *
+       * \par Description
+       * Arrays and objects keep the hash once computed until they or any
+       * of their descendants change, so hashing a document again only
+       * visits the parts modified since the last time.
+       *
+       * \note
+       * Integer and floating point numbers are different types and hash
+       * differently even if they hold the same quantity. Hashes are not
+       * meant to be stored, as they may differ between platforms.
+       */
+      uint64_t hash(void) const;
+
+      /**
+       * \brief Compares the contents of two values
+       *
+       * \param other Value to compare with.
+       *
+       * \returns true if both values have the same type and contents.
+       *
+       * \par Description
+       * Arrays and objects with different sizes or with hashes already
+       * computed and different are rejected without visiting their items.
+       */
+      bool equals(Value const &other) const;
+
+      /**
+       * \brief Equality operator
+       *
+       * \par Description
+       * Same as equals().
+       */
+      bool operator==(Value const &other) const;
+
+      /**
+       * \brief Inequality operator
+       */
+      bool operator!=(Value const &other) const;
+
+      /**
+       * \brief Retrieves the array or object containing the instance
+       *
+       * \returns a pointer to the container or NULL for values not
+       * contained in any other.
+       */
+      Value_Complex *getParent(void) const;
+
+      /**
+       * \brief Retrieves a value contained in the instance
+       *
+       * \param pointer JSON Pointer to the value, relative to the instance.
+       *
+       * \returns a pointer to the value or NULL if it does not exist. The
+       * value is still owned by its container.
+       */
+      Value const *at(Json_Pointer const &pointer) const;
+
+      /**
+       * \brief Retrieves a value contained in the instance
+       *
+       * \param pointer JSON Pointer to the value, relative to the instance.
+       *
+       * \returns a pointer to the value or NULL if it does not exist. The
+       * value is still owned by its container.
+       */
+      Value *at(Json_Pointer const &pointer);
+
+      /**
+       * \brief Retrieves a boolean value contained in the instance
+       *
+       * \param pointer JSON Pointer to the value, relative to the instance.
+       *
+       * \exception Bad_Data_Type
+       * This exception is launched if the value does not exist or it is not
+       * a boolean.
+       */
+      bool getBoolean(Json_Pointer const &pointer) const
+        throw(Bad_Data_Type);
+
+      /**
+       * \brief Retrieves an integer value contained in the instance
+       *
+       * \param pointer JSON Pointer to the value, relative to the instance.
+       *
+       * \exception Bad_Data_Type
+       * This exception is launched if the value does not exist or it is not
+       * an integer number that fits a 64 bit signed integer.
+       */
+      int64_t getNumberInt(Json_Pointer const &pointer) const
+        throw(Bad_Data_Type);
+
+      /**
+       * \brief Retrieves a numeric value contained in the instance
+       *
+       * \param pointer JSON Pointer to the value, relative to the instance.
+       *
+       * \exception Bad_Data_Type
+       * This exception is launched if the value does not exist or it is not
+       * a number. Integer numbers are converted.
+       */
+      double getNumber(Json_Pointer const &pointer) const
+        throw(Bad_Data_Type);
+
+      /**
+       * \brief Retrieves a string value contained in the instance
+       *
+       * \param pointer JSON Pointer to the value, relative to the instance.
+       *
+       * \exception Bad_Data_Type
+       * This exception is launched if the value does not exist or it is not
+       * a string.
+       */
+      std::string const &getString(Json_Pointer const &pointer) const
+        throw(Bad_Data_Type);
+
     protected:
 
       /**
@@ -160,12 +305,38 @@ namespace JAULA
        */
       Value(ValueType Type);
 
+      /**
+       * \brief Copy constructor
+       *
+       * \param orig Original instance.
+       *
+       * \note
+       * The copy is not contained in any array or object.
+       */
+      Value(Value const &orig);
+
+      /**
+       * \brief Notifies a change in the contents of the instance
+       *
+       * \par Description
+       * Discards the hashes kept by the instance and by the containers
+       * holding it. Every method modifying a value must invoke it.
+       */
+      void changed(void);
+
     private:
 
+      friend class Value_Complex;
+
       /**
        * \brief Container for error code
        */
       ValueType  Type_;
+
+      /**
+       * \brief Container holding the instance
+       */
+      Value_Complex   *pParent_;
   };                             // class Value
 
 }                                // namespace JAULA
@@ -49,8 +49,9 @@ namespace JAULA
     : Value_Complex(TYPE_ARRAY)
     , data_()
   {
+    data_.reserve(data.size());
     for (dataType::const_iterator it = data.begin(); (it != data.end()); it++)
-      data_.push_back(duplicate(*(*it)));
+      addItem(*(*it));
   }
 
   Value_Array::~Value_Array()
@@ -63,6 +64,11 @@ namespace JAULA
     return data_;
   }
 
+  Value *Value_Array::getItem(size_t index) const
+  {
+    return (index < data_.size()) ? data_[index] : 0;
+  }
+
   void Value_Array::repr(std::ostream &ostr) const
   {
     ostr << "[ ";
@@ -90,8 +96,9 @@ namespace JAULA
   void Value_Array::set(dataType const &data)
   {
     clear();
+    data_.reserve(data.size());
     for (dataType::const_iterator it = data.begin(); (it != data.end()); it++)
-      data_.push_back(duplicate(*(*it)));
+      addItem(*(*it));
   }
 
   void Value_Array::set(Value const &origin) throw(Bad_Data_Type)
@@ -114,7 +121,52 @@ namespace JAULA
 
   void Value_Array::addItem(Value const &item)
   {
-    data_.push_back(duplicate(item));
+    adoptItem(duplicate(item));
+  }
+
+  void Value_Array::adoptItem(Value *item)
+  {
+    adopt(item);
+    data_.push_back(item);
+    changed();
+  }
+
+  void Value_Array::adoptItem(size_t index, Value *item)
+    throw(Bad_Data_Type)
+  {
+    if (index > data_.size())
+    {
+      delete item;
+      throw Bad_Data_Type("Index beyond the end of the array"
+        , "inserting a new array item"
+        , "Value_Array::adoptItem(size_t, Value *)");
+    }
+    adopt(item);
+    data_.insert(data_.begin() + index, item);
+    changed();
+  }
+
+  Value *Value_Array::detachItem(size_t index)
+  {
+    if (index >= data_.size())
+      return 0;
+    Value *pItem = data_[index];
+    data_.erase(data_.begin() + index);
+    disown(pItem);
+    changed();
+    return pItem;
+  }
+
+  Value *Value_Array::replaceItem(size_t index, Value *item)
+  {
+    if (index >= data_.size())
+      return 0;
+    Value *pItem = data_[index];
+    disown(pItem);
+    adopt(item);
+    data_[index] = item;
+    changed();
+    return pItem;
   }
 
   void Value_Array::clear(void)
@@ -124,6 +176,20 @@ namespace JAULA
       ; it++)
       delete *it;
     data_.clear();
+    changed();
+  }
+
+  void Value_Array::swap(Value_Array &other)
+  {
+    data_.swap(other.data_);
+    for (dataType::const_iterator it = data_.begin(); (it != data_.end()); it++)
+      adopt(*it);
+    for (dataType::const_iterator it = other.data_.begin()
+      ; (it != other.data_.end())
+      ; it++)
+      other.adopt(*it);
+    changed();
+    other.changed();
   }
 
 }                                // namespace JAULA
@@ -29,7 +29,7 @@
 #ifndef _JAULA_VALUE_ARRAY_H_
 #define _JAULA_VALUE_ARRAY_H_
 
-#include <list>
+#include <vector>
 
 #include <jaula/jaula_value_complex.h>
 
@@ -60,10 +60,10 @@ namespace JAULA
        * \par Description
        * Definition for the data container internal structure.
        *
-       * This data type defines a list of pointers to any kind of values
-       * (including arrays).
+       * This data type defines a sequence of pointers to any kind of values
+       * (including arrays) with constant time access by position.
        */
-      typedef std::list<Value *>  dataType;
+      typedef std::vector<Value *>  dataType;
 
       /**
        * \brief Default Constructor
@@ -99,6 +99,16 @@ namespace JAULA
        */
       dataType const &getData(void) const;
 
+      /**
+       * \brief Retrieves one item by position
+       *
+       * \param index Position of the item, starting at 0.
+       *
+       * \returns a pointer to the item or NULL if the position is out of
+       * range. The item is still owned by the instance.
+       */
+      Value *getItem(size_t index) const;
+
       /**
        * \brief Represents the instance in a stream
        *
@@ -160,6 +170,64 @@ namespace JAULA
        */
       void addItem(Value const &item);
 
+      /**
+       * \brief Appends one item to the array taking its ownership
+       *
+       * \param item Pointer to an item allocated from the heap.
+       *
+       * \par Description
+       * Appends the item at the end of the array without copying it. From
+       * this point on the instance is responsible for releasing the item.
+       */
+      void adoptItem(Value *item);
+
+      /**
+       * \brief Inserts one item in the array taking its ownership
+       *
+       * \param index Position for the item. Items from this position on are
+       * shifted one place. It must not be greater than size().
+       *
+       * \param item Pointer to an item allocated from the heap.
+       *
+       * \exception Bad_Data_Type
+       * This exception is thrown if the index is greater than size(). The
+       * item is released before the exception is thrown.
+       *
+       * \par Description
+       * Inserts the item without copying it. From this point on the instance
+       * is responsible for releasing the item.
+       */
+      void adoptItem(size_t index, Value *item) throw(Bad_Data_Type);
+
+      /**
+       * \brief Takes one item out of the array
+       *
+       * \param index Position of the item.
+       *
+       * \returns a pointer to the item or NULL if the position is out of
+       * range. Items after it are shifted one place.
+       *
+       * \warning
+       * From this point on it is up to the caller to release the item.
+       */
+      Value *detachItem(size_t index);
+
+      /**
+       * \brief Replaces one item taking the ownership of the new one
+       *
+       * \param index Position of the item.
+       *
+       * \param item Pointer to the new item allocated from the heap.
+       *
+       * \returns a pointer to the former item or NULL if the position is
+       * out of range, in which case the new item is not taken.
+       *
+       * \warning
+       * From this point on it is up to the caller to release the former
+       * item.
+       */
+      Value *replaceItem(size_t index, Value *item);
+
       /**
        * \brief Empties the contents of an instance
        *
@@ -172,6 +240,17 @@ namespace JAULA
        */
       virtual void clear(void);
 
+      /**
+       * \brief Exchanges the contents of two instances
+       *
+       * \param other Instance to exchange the contents with.
+       *
+       * \par Description
+       * The items are not copied, so any references to them remain valid
+       * although they belong to the other instance.
+       */
+      void swap(Value_Array &other);
+
     private:
 
       /**
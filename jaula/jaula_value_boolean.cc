@@ -63,6 +63,7 @@ namespace JAULA
   void Value_Boolean::set(bool data)
   {
     data_ = data;
+    changed();
   }
 
   void Value_Boolean::set(Value const &origin) throw(Bad_Data_Type)
@@ -76,6 +77,7 @@ namespace JAULA
         throw Bad_Data_Type("Origin and Destination types do not match"
           , "narrowing origin to destination type");
       data_ = pOrg->getData();
+      changed();
     }
     catch(Bad_Data_Type &ex)
     {
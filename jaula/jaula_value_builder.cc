@@ -0,0 +1,229 @@
+
+/*
+ * jaula_value_builder.cc : JSON Analysis User Library Acronym
+ * Values construction from parsing events
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+}
+
+
+#include <jaula/jaula_syntax_error.h>
+#include <jaula/jaula_value_array.h>
+#include <jaula/jaula_value_boolean.h>
+#include <jaula/jaula_value_builder.h>
+#include <jaula/jaula_value_null.h>
+#include <jaula/jaula_value_number.h>
+#include <jaula/jaula_value_number_int.h>
+#include <jaula/jaula_value_object.h>
+#include <jaula/jaula_value_string.h>
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Value_Builder::Value_Builder(void)
+    : Parse_Handler()
+    , pRoot_(0)
+    , stack_()
+    , name_()
+    , complete_(false)
+    , pErrorReport_(0)
+    , errorCode_(Parse_Result::SUCCESS)
+    {}
+
+  Value_Builder::~Value_Builder()
+  {
+    reset();
+  }
+
+  bool Value_Builder::nullValue(void)
+  {
+    return attach(new Value_Null());
+  }
+
+  bool Value_Builder::booleanValue(bool data)
+  {
+    return attach(new Value_Boolean(data));
+  }
+
+  bool Value_Builder::numberValue(double data)
+  {
+    return attach(new Value_Number(data));
+  }
+
+  bool Value_Builder::numberIntValue(int64_t data)
+  {
+    return attach(new Value_Number_Int(data));
+  }
+
+  bool Value_Builder::numberUnsignedValue(uint64_t data)
+  {
+    Value_Number_Int  *pNumber = new Value_Number_Int();
+    pNumber->setUnsigned(data);
+    return attach(pNumber);
+  }
+
+  bool Value_Builder::numberTextValue(std::string const &data)
+  {
+    return attach(Value::numberFromText(data));
+  }
+
+  bool Value_Builder::stringValue(std::string const &data)
+  {
+    return attach(new Value_String(data));
+  }
+
+  bool Value_Builder::arrayBegin(void)
+  {
+    Value_Array *pArray = new Value_Array();
+    if (!attach(pArray))
+      return false;
+    stack_.push_back(pArray);
+    return true;
+  }
+
+  bool Value_Builder::arrayEnd(void)
+  {
+    stack_.pop_back();
+    complete_ = stack_.empty();
+    return true;
+  }
+
+  bool Value_Builder::objectBegin(void)
+  {
+    Value_Object *pObject = new Value_Object();
+    if (!attach(pObject))
+      return false;
+    stack_.push_back(pObject);
+    return true;
+  }
+
+  bool Value_Builder::propertyName(std::string const &name)
+  {
+    name_ = name;
+    return true;
+  }
+
+  bool Value_Builder::objectEnd(void)
+  {
+    stack_.pop_back();
+    complete_ = stack_.empty();
+    return true;
+  }
+
+  Exception const *Value_Builder::getErrorReport(void) const
+  {
+    return pErrorReport_;
+  }
+
+  Parse_Result::Error_Code Value_Builder::getErrorCode(void) const
+  {
+    return errorCode_;
+  }
+
+  bool Value_Builder::complete(void) const
+  {
+    return complete_;
+  }
+
+  Value const *Value_Builder::getValue(void) const
+  {
+    return pRoot_;
+  }
+
+  Value *Value_Builder::release(void)
+  {
+    Value *pResult = pRoot_;
+    pRoot_ = 0;
+    reset();
+    return pResult;
+  }
+
+  void Value_Builder::reset(void)
+  {
+    if (pRoot_)
+      delete pRoot_;
+    pRoot_ = 0;
+    stack_.clear();
+    name_.erase();
+    complete_ = false;
+    if (pErrorReport_)
+      delete pErrorReport_;
+    pErrorReport_ = 0;
+    errorCode_ = Parse_Result::SUCCESS;
+  }
+
+  bool Value_Builder::attach(Value *pVal)
+  {
+    if (stack_.empty())
+    {
+      if (pRoot_)
+      {
+        delete pVal;
+        if (pErrorReport_)
+          delete pErrorReport_;
+        pErrorReport_ = new Syntax_Error("A value has been found after the"
+          " first level one"
+          , "building values from parsing events"
+          , "Value_Builder::attach(Value *)");
+        errorCode_ = Parse_Result::EXTRA_VALUE;
+        return false;
+      }
+      pRoot_ = pVal;
+      complete_ = (pVal->getType() != Value::TYPE_ARRAY)
+        && (pVal->getType() != Value::TYPE_OBJECT);
+      return true;
+    }
+
+    Value *pParent = stack_.back();
+    if (pParent->getType() == Value::TYPE_ARRAY)
+    {
+      static_cast<Value_Array *>(pParent)->adoptItem(pVal);
+      return true;
+    }
+
+    Value_Object  *pObject = static_cast<Value_Object *>(pParent);
+    if (pObject->getData().count(name_))
+    {
+      delete pVal;
+      if (pErrorReport_)
+        delete pErrorReport_;
+      pErrorReport_ = new Name_Duplicated(name_
+        , "inserting a new object property"
+        , "Value_Builder::attach(Value *)");
+      errorCode_ = Parse_Result::DUPLICATED_NAME;
+      return false;
+    }
+    pObject->adoptItem(name_, pVal);
+    return true;
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
@@ -0,0 +1,238 @@
+
+/*
+ * jaula_value_builder.h : JSON Analysis User Library Acronym
+ * Values construction from parsing events
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_VALUE_BUILDER_H_
+#define _JAULA_VALUE_BUILDER_H_
+
+#include <string>
+#include <vector>
+
+#include <jaula/jaula_name_duplicated.h>
+#include <jaula/jaula_parse_handler.h>
+#include <jaula/jaula_value.h>
+
+/**
+ * \addtogroup jaula_parse JAULA: JSON data parser
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Parsing events handler that builds values
+   *
+   * \ingroup jaula_parse
+   *
+   * \par
+   * This class collects the events produced by a parser and builds the
+   * values they describe.
+   *
+   * \par
+   * Complex values are attached to their container as soon as they begin, so
+   * items are never copied on their way to the final structure.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Value_Builder : public Parse_Handler
+  {                              // class Value_Builder
+    public:
+
+      /**
+       * \brief Constructor
+       */
+      Value_Builder(void);
+
+      /**
+       * \brief Destructor
+       *
+       * \note
+       * Any value built and not released is destroyed with the instance.
+       */
+      virtual ~Value_Builder();
+
+      /**
+       * \brief Adds a null value
+       */
+      virtual bool nullValue(void);
+
+      /**
+       * \brief Adds a boolean value
+       */
+      virtual bool booleanValue(bool data);
+
+      /**
+       * \brief Adds a numeric value
+       */
+      virtual bool numberValue(double data);
+
+      /**
+       * \brief Adds a numeric (integer) value
+       */
+      virtual bool numberIntValue(int64_t data);
+
+      /**
+       * \brief Adds a numeric (unsigned integer) value
+       */
+      virtual bool numberUnsignedValue(uint64_t data);
+
+      /**
+       * \brief Adds a numeric value keeping its decimal text
+       *
+       * \par Description
+       * The value is not converted until it is retrieved (see
+       * Value::numberFromText()).
+       */
+      virtual bool numberTextValue(std::string const &data);
+
+      /**
+       * \brief Adds a string value
+       */
+      virtual bool stringValue(std::string const &data);
+
+      /**
+       * \brief Adds an empty array and makes it the current container
+       */
+      virtual bool arrayBegin(void);
+
+      /**
+       * \brief Closes the current array
+       */
+      virtual bool arrayEnd(void);
+
+      /**
+       * \brief Adds an empty object and makes it the current container
+       */
+      virtual bool objectBegin(void);
+
+      /**
+       * \brief Establishes the name for the next property to add
+       */
+      virtual bool propertyName(std::string const &name);
+
+      /**
+       * \brief Closes the current object
+       */
+      virtual bool objectEnd(void);
+
+      /**
+       * \brief Retrieves details for the last error detected
+       *
+       * \returns a pointer to an instance containing the details about why
+       * the last value could not be added or a null pointer if no error has
+       * been detected.
+       */
+      virtual Exception const *getErrorReport(void) const;
+
+      /**
+       * \brief Retrieves the kind of the last error detected
+       *
+       * \returns Parse_Result::DUPLICATED_NAME for a property name already
+       * present in its object, Parse_Result::EXTRA_VALUE for a value after
+       * the first level one.
+       */
+      virtual Parse_Result::Error_Code getErrorCode(void) const;
+
+      /**
+       * \brief True once a whole first level value has been built
+       */
+      bool complete(void) const;
+
+      /**
+       * \brief Retrieves the value built so far
+       *
+       * \returns a pointer to the first level value or a null pointer if no
+       * value has been started yet.
+       */
+      Value const *getValue(void) const;
+
+      /**
+       * \brief Takes the value built
+       *
+       * \returns a pointer to memory taken from the heap containing the first
+       * level value (or a null pointer if none was started). The instance is
+       * reset so it can be used to build a new value.
+       *
+       * \warning
+       * As this method returns a pointer to memory allocated from the heap,
+       * it is up to the caller to release once it is no longer needed in
+       * order to avoid leaks.
+       */
+      Value *release(void);
+
+      /**
+       * \brief Discards any value built so far
+       */
+      void reset(void);
+
+    private:
+
+      /**
+       * \brief Attaches a new value to the structure being built
+       *
+       * \param pVal Pointer to the value (ownership is taken).
+       *
+       * \returns true if the value could be attached.
+       */
+      bool attach(Value *pVal);
+
+      /**
+       * \brief First level value
+       */
+      Value   *pRoot_;
+
+      /**
+       * \brief Complex values still open (owned by pRoot_)
+       */
+      std::vector<Value *>  stack_;
+
+      /**
+       * \brief Name for the next object property
+       */
+      std::string name_;
+
+      /**
+       * \brief Flag for a whole first level value read
+       */
+      bool    complete_;
+
+      /**
+       * \brief Pointer to the last exception detected
+       */
+      Exception   *pErrorReport_;
+
+      /**
+       * \brief Code for the last error detected
+       */
+      Parse_Result::Error_Code  errorCode_;
+
+  };                             // class Value_Builder
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
@@ -44,8 +44,20 @@ namespace JAULA
 
   Value_Complex::Value_Complex(ValueType Type)
     : Value(Type)
+    , hash_(0)
+    , hashed_(false)
     {}
 
+  void Value_Complex::adopt(Value *pItem)
+  {
+    pItem->pParent_ = this;
+  }
+
+  void Value_Complex::disown(Value *pItem)
+  {
+    pItem->pParent_ = 0;
+  }
+
 }                                // namespace JAULA
 
 
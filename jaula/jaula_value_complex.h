@@ -97,6 +97,37 @@ namespace JAULA
        */
       Value_Complex(ValueType Type);
 
+      /**
+       * \brief Registers the instance as container of an item
+       *
+       * \param pItem Item being stored in the instance.
+       *
+       * \par Description
+       * Derived classes must invoke it for every item they take, so changes
+       * to the item are notified to the instance.
+       */
+      void adopt(Value *pItem);
+
+      /**
+       * \brief Unregisters the instance as container of an item
+       *
+       * \param pItem Item being taken out of the instance.
+       */
+      void disown(Value *pItem);
+
+    private:
+
+      friend class Value;
+
+      /**
+       * \brief Structural hash kept
+       */
+      mutable uint64_t  hash_;
+
+      /**
+       * \brief Flag for hash_ up to date
+       */
+      mutable bool  hashed_;
   };                             // class Value_Complex
 
 }                                // namespace JAULA
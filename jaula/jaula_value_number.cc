@@ -31,9 +31,15 @@ extern "C"
 #ifdef HAVE_CONFIG_H
 #include <config.h>
 #endif
+
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
 }
 
 
+#include <jaula/jaula_number_format.h>
 #include <jaula/jaula_value_number.h>
 
 namespace JAULA
@@ -42,6 +48,8 @@ namespace JAULA
   Value_Number::Value_Number(double data)
     : Value(TYPE_NUMBER)
     , data_(data)
+    , pending_(false)
+    , text_()
     {}
 
   Value_Number::~Value_Number()
@@ -49,17 +57,48 @@ namespace JAULA
 
   double Value_Number::getData(void) const
   {
+    if (pending_)
+    {
+      data_ = strtod(text_.c_str(), 0);
+      pending_ = false;
+    }
     return data_;
   }
 
+  std::string const &Value_Number::getText(void) const
+  {
+    return text_;
+  }
+
   void Value_Number::repr(std::ostream &ostr) const
   {
-    ostr << data_;
+    if (!text_.empty())
+    {
+      ostr << text_;
+      return;
+    }
+    char  buffer[Number_Format::BUFFER_SIZE];
+    ostr.write(buffer, Number_Format::formatDouble(buffer, data_));
   }
 
   void Value_Number::set(double data)
   {
     data_ = data;
+    pending_ = false;
+    text_.erase();
+    changed();
+  }
+
+  void Value_Number::setText(std::string const &text)
+  {
+    if (!Number_Format::jsonText(text.data(), text.size(), text_))
+    {
+      set(strtod(text.c_str(), 0));
+      return;
+    }
+    data_ = 0;
+    pending_ = true;
+    changed();
   }
 
   void Value_Number::set(Value const &origin) throw(Bad_Data_Type)
@@ -70,7 +109,10 @@ namespace JAULA
       Value_Number const *pOrg = dynamic_cast<Value_Number const *>(&origin);
       if (!pOrg)
         throw Bad_Data_Type("Origin and Destination types do not match", "narrowing origin to destination type");
-      data_ = pOrg->getData();
+      data_ = pOrg->data_;
+      pending_ = pOrg->pending_;
+      text_ = pOrg->text_;
+      changed();
     }
     catch(Bad_Data_Type &ex)
     {
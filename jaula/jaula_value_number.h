@@ -29,6 +29,8 @@
 #ifndef _JAULA_VALUE_NUMBER_H_
 #define _JAULA_VALUE_NUMBER_H_
 
+#include <string>
+
 #include <jaula/jaula_value.h>
 
 /**
@@ -46,6 +48,14 @@ namespace JAULA
    * \par
    * This class is a container for JSON numeric values.
    *
+   * \par
+   * Instances may be established from the decimal text read by a parser. The
+   * text is then written back as read (only the leading plus sign and zeros
+   * JSON does not allow are dropped) and it is only converted to double
+   * the first time the value is retrieved, so numbers that are forwarded
+   * untouched are never converted and integers beyond 64 bits are not
+   * approximated.
+   *
    * \author Kombo Morongo <morongo666@gmail.com>
    */
   class Value_Number : public Value
@@ -66,9 +76,20 @@ namespace JAULA
 
       /**
        * \brief Retrieves the value contained by the instance
+       *
+       * \par Description
+       * Converts the decimal text (see setText()) on the first invocation.
        */
       double getData(void) const;
 
+      /**
+       * \brief Retrieves the decimal text kept by the instance
+       *
+       * \returns the text the value was established from by setText() or an
+       * empty string if the value was set in any other way.
+       */
+      std::string const &getText(void) const;
+
       /**
        * \brief Represents the instance in a stream
        *
@@ -86,6 +107,20 @@ namespace JAULA
        */
       void set(double data);
 
+      /**
+       * \brief Establishes the contents of the instance from decimal text
+       *
+       * \param text JSON number to assign to the instance
+       *
+       * \par Description
+       * The text is kept to be represented as read, without the leading
+       * plus sign and zeros JSON does not allow (see
+       * Number_Format::jsonText()), and it is not converted to the nearest
+       * double until getData() is invoked. Text not being a number is
+       * converted at once.
+       */
+      void setText(std::string const &text);
+
       /**
        * \brief Copies the contents of one instance into another
        *
@@ -102,7 +137,17 @@ namespace JAULA
       /**
        * \brief Container to hold the value itself
        */
-      double    data_;
+      mutable double  data_;
+
+      /**
+       * \brief Flag for a decimal text not converted yet
+       */
+      mutable bool    pending_;
+
+      /**
+       * \brief Decimal text the value was established from
+       */
+      std::string     text_;
   };                             // class Value_Number
 
 }                                // namespace JAULA
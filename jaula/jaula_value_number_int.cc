@@ -33,14 +33,22 @@ extern "C"
 }
 
 
+#ifdef HAVE_LIMITS
+#include <limits>
+#endif
+
+#include <jaula/jaula_number_format.h>
 #include <jaula/jaula_value_number_int.h>
 
 namespace JAULA
 {                                // namespace JAULA
 
-  Value_Number_Int::Value_Number_Int(long data)
+  Value_Number_Int::Value_Number_Int(int64_t data)
     : Value(TYPE_NUMBER_INT)
     , data_(data)
+    , unsigned_(false)
+    , pending_(false)
+    , text_()
     {}
 
   Value_Number_Int::~Value_Number_Int()
@@ -48,17 +56,100 @@ namespace JAULA
 
   long Value_Number_Int::getData(void) const
   {
+    convert();
+    return static_cast<long>(data_);
+  }
+
+  int64_t Value_Number_Int::getInt64(void) const
+  {
+    convert();
     return data_;
   }
 
+  uint64_t Value_Number_Int::getUnsigned(void) const
+  {
+    convert();
+    return static_cast<uint64_t>(data_);
+  }
+
+  bool Value_Number_Int::isUnsigned(void) const
+  {
+    convert();
+    return unsigned_;
+  }
+
+  std::string const &Value_Number_Int::getText(void) const
+  {
+    return text_;
+  }
+
   void Value_Number_Int::repr(std::ostream &ostr) const
   {
-    ostr << data_;
+    if (!text_.empty())
+    {
+      ostr << text_;
+      return;
+    }
+    char  buffer[Number_Format::BUFFER_SIZE];
+    if (unsigned_)
+      ostr.write(buffer, Number_Format::formatUnsigned(buffer
+        , static_cast<uint64_t>(data_)));
+    else
+      ostr.write(buffer, Number_Format::formatInt(buffer, data_));
   }
 
-  void Value_Number_Int::set(long data)
+  void Value_Number_Int::set(int64_t data)
   {
     data_ = data;
+    unsigned_ = false;
+    pending_ = false;
+    text_.erase();
+    changed();
+  }
+
+  void Value_Number_Int::setUnsigned(uint64_t data)
+  {
+    data_ = static_cast<int64_t>(data);
+    unsigned_ = (data > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()));
+    pending_ = false;
+    text_.erase();
+    changed();
+  }
+
+  void Value_Number_Int::setText(std::string const &text)
+  {
+    if (!Number_Format::jsonText(text.data(), text.size(), text_))
+    {
+      int64_t   val = 0;
+      uint64_t  uval = 0;
+      if (Number_Format::scanInt(text.data(), text.size(), val, uval)
+        == Number_Format::INT_UNSIGNED)
+        setUnsigned(uval);
+      else
+        set(val);
+      return;
+    }
+    data_ = 0;
+    unsigned_ = false;
+    pending_ = true;
+    changed();
+  }
+
+  void Value_Number_Int::convert(void) const
+  {
+    if (!pending_)
+      return;
+    int64_t   val = 0;
+    uint64_t  uval = 0;
+    if (Number_Format::scanInt(text_.data(), text_.size(), val, uval)
+      == Number_Format::INT_UNSIGNED)
+    {
+      data_ = static_cast<int64_t>(uval);
+      unsigned_ = true;
+    }
+    else
+      data_ = val;
+    pending_ = false;
   }
 
   void Value_Number_Int::set(Value const &origin) throw(Bad_Data_Type)
@@ -69,7 +160,11 @@ namespace JAULA
       Value_Number_Int const *pOrg = dynamic_cast<Value_Number_Int const *>(&origin);
       if (!pOrg)
         throw Bad_Data_Type("Origin and Destination types do not match", "narrowing origin to destination type");
-      data_ = pOrg->getData();
+      data_ = pOrg->data_;
+      unsigned_ = pOrg->unsigned_;
+      pending_ = pOrg->pending_;
+      text_ = pOrg->text_;
+      changed();
     }
     catch(Bad_Data_Type &ex)
     {
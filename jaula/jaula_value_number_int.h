@@ -29,6 +29,8 @@
 #ifndef _JAULA_VALUE_NUMBER_INT_H_
 #define _JAULA_VALUE_NUMBER_INT_H_
 
+#include <string>
+
 #include <jaula/jaula_value.h>
 
 /**
@@ -47,6 +49,15 @@ namespace JAULA
    * This class is a container for JSON numeric values adapted to hold only
    * integer values.
    *
+   * \par
+   * Values are held exactly in the range of a 64 bit signed integer plus the
+   * positive range of a 64 bit unsigned integer. The later ones are flagged
+   * as unsigned and can only be retrieved through getUnsigned().
+   *
+   * \par
+   * As with Value_Number, the decimal text read by a parser may be kept to be
+   * written back and converted on first retrieval.
+   *
    * \author Kombo Morongo <morongo666@gmail.com>
    */
   class Value_Number_Int : public Value
@@ -58,7 +69,7 @@ namespace JAULA
        *
        * \param data Initial value to be hold by the conatiner
        */
-      Value_Number_Int(long data = 0);
+      Value_Number_Int(int64_t data = 0);
 
       /**
        * \brief Destructor
@@ -67,9 +78,44 @@ namespace JAULA
 
       /**
        * \brief Retrieves the value contained by the instance
+       *
+       * \note
+       * Kept for compatibility, the result is only meaningful for values in
+       * the long range (see getInt64()).
        */
       long getData(void) const;
 
+      /**
+       * \brief Retrieves the value contained by the instance
+       *
+       * \note
+       * The result is not meaningful for unsigned values (see isUnsigned()).
+       */
+      int64_t getInt64(void) const;
+
+      /**
+       * \brief Retrieves the value contained by the instance as unsigned
+       *
+       * \note
+       * The result is not meaningful for negative values.
+       */
+      uint64_t getUnsigned(void) const;
+
+      /**
+       * \brief Checks whether the value is beyond the 64 bit signed range
+       *
+       * \returns true if the value can only be retrieved by getUnsigned().
+       */
+      bool isUnsigned(void) const;
+
+      /**
+       * \brief Retrieves the decimal text kept by the instance
+       *
+       * \returns the text the value was established from by setText() or an
+       * empty string if the value was set in any other way.
+       */
+      std::string const &getText(void) const;
+
       /**
        * \brief Represents the instance in a stream
        *
@@ -85,7 +131,31 @@ namespace JAULA
        *
        * \param data Value to assign to the instance
        */
-      void set(long data);
+      void set(int64_t data);
+
+      /**
+       * \brief Establishes the contents of the instance
+       *
+       * \param data Value to assign to the instance
+       *
+       * \par Description
+       * Values inside the 64 bit signed range are held as signed ones.
+       */
+      void setUnsigned(uint64_t data);
+
+      /**
+       * \brief Establishes the contents of the instance from decimal text
+       *
+       * \param text JSON integer to assign to the instance. It must fit a
+       * 64 bit signed or unsigned integer (see Number_Format::scanInt()).
+       *
+       * \par Description
+       * The text is kept to be represented as read, without the leading
+       * plus sign and zeros JSON does not allow (see
+       * Number_Format::jsonText()), and it is not converted until the value
+       * is retrieved. Text not being a number is converted at once.
+       */
+      void setText(std::string const &text);
 
       /**
        * \brief Copies the contents of one instance into another
@@ -103,7 +173,27 @@ namespace JAULA
       /**
        * \brief Container to hold the value itself
        */
-      long    data_;
+      mutable int64_t data_;
+
+      /**
+       * \brief Flag for values beyond the 64 bit signed range
+       */
+      mutable bool    unsigned_;
+
+      /**
+       * \brief Flag for a decimal text not converted yet
+       */
+      mutable bool    pending_;
+
+      /**
+       * \brief Decimal text the value was established from
+       */
+      std::string     text_;
+
+      /**
+       * \brief Converts the decimal text if it is still pending
+       */
+      void convert(void) const;
   };                             // class Value_Number_Int
 
 }                                // namespace JAULA
@@ -36,6 +36,7 @@ extern "C"
 
 
 #include <jaula/jaula_value_object.h>
+#include <jaula/jaula_value_string.h>
 
 namespace JAULA
 {                                // namespace JAULA
@@ -50,7 +51,11 @@ namespace JAULA
     , data_()
   {
     for (dataType::const_iterator it = data.begin(); (it != data.end()); it++)
-      data_.insert(dataType::value_type(it->first, duplicate(*(it->second))));
+    {
+      Value *pItem = duplicate(*(it->second));
+      adopt(pItem);
+      data_.insert(dataType::value_type(it->first, pItem));
+    }
   }
 
   Value_Object::~Value_Object()
@@ -63,6 +68,12 @@ namespace JAULA
     return data_;
   }
 
+  Value *Value_Object::getItem(std::string const &name) const
+  {
+    dataType::const_iterator it = data_.find(name);
+    return (it != data_.end()) ? it->second : 0;
+  }
+
   void Value_Object::repr(std::ostream &ostr) const
   {
     ostr << "{ ";
@@ -70,8 +81,8 @@ namespace JAULA
     {
       if (it != data_.begin())
         ostr << ", ";
-      ostr << '"' << it->first << '"'
-        << " : " << *(it->second);
+      Value_String::stringRepr(ostr, it->first);
+      ostr << " : " << *(it->second);
     }
     ostr << " }";
   }
@@ -90,7 +101,11 @@ namespace JAULA
   {
     clear();
     for (dataType::const_iterator it = data.begin(); (it != data.end()); it++)
-      data_.insert(dataType::value_type(it->first, duplicate(*(it->second))));
+    {
+      Value *pItem = duplicate(*(it->second));
+      adopt(pItem);
+      data_.insert(dataType::value_type(it->first, pItem));
+    }
   }
 
   void Value_Object::set(Value const &origin) throw(Bad_Data_Type)
@@ -112,10 +127,56 @@ namespace JAULA
 
   void Value_Object::insertItem(std::string const &name, Value const &item) throw(Name_Duplicated)
   {
-    std::pair<dataType::iterator, bool> insSt = data_.insert(dataType::value_type(name, duplicate(item)));
-    if (!insSt.second)
+    if (data_.find(name) != data_.end())
       throw Name_Duplicated(name, "inserting a new object property"
         , "Value_Object::insertItem(std::string const &, Value const &)");
+    Value *pItem = duplicate(item);
+    adopt(pItem);
+    data_.insert(dataType::value_type(name, pItem));
+    changed();
+  }
+
+  void Value_Object::adoptItem(std::string const &name, Value *item)
+    throw(Name_Duplicated)
+  {
+    std::pair<dataType::iterator, bool> insSt =
+      data_.insert(dataType::value_type(name, item));
+    if (!insSt.second)
+    {
+      delete item;
+      throw Name_Duplicated(name, "inserting a new object property"
+        , "Value_Object::adoptItem(std::string const &, Value *)");
+    }
+    adopt(item);
+    changed();
+  }
+
+  Value *Value_Object::detachItem(std::string const &name)
+  {
+    dataType::iterator it = data_.find(name);
+    if (it == data_.end())
+      return 0;
+    Value *pItem = it->second;
+    data_.erase(it);
+    disown(pItem);
+    changed();
+    return pItem;
+  }
+
+  Value *Value_Object::replaceItem(std::string const &name, Value *item)
+  {
+    adopt(item);
+    std::pair<dataType::iterator, bool> insSt =
+      data_.insert(dataType::value_type(name, item));
+    Value *pItem = 0;
+    if (!insSt.second)
+    {
+      pItem = insSt.first->second;
+      disown(pItem);
+      insSt.first->second = item;
+    }
+    changed();
+    return pItem;
   }
 
   void Value_Object::clear(void)
@@ -123,6 +184,20 @@ namespace JAULA
     for (dataType::const_iterator it = data_.begin(); (it != data_.end()); it++)
       delete it->second;
     data_.clear();
+    changed();
+  }
+
+  void Value_Object::swap(Value_Object &other)
+  {
+    data_.swap(other.data_);
+    for (dataType::const_iterator it = data_.begin(); (it != data_.end()); it++)
+      adopt(it->second);
+    for (dataType::const_iterator it = other.data_.begin()
+      ; (it != other.data_.end())
+      ; it++)
+      other.adopt(it->second);
+    changed();
+    other.changed();
   }
 
 }                                // namespace JAULA
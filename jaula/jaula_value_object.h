@@ -102,6 +102,16 @@ namespace JAULA
        */
       dataType const &getData(void) const;
 
+      /**
+       * \brief Retrieves one item by name
+       *
+       * \param name Name of the item.
+       *
+       * \returns a pointer to the item or NULL if there is no item with that
+       * name. The item is still owned by the instance.
+       */
+      Value *getItem(std::string const &name) const;
+
       /**
        * \brief Represents the instance in a stream
        *
@@ -171,6 +181,55 @@ namespace JAULA
       void insertItem(std::string const &name, Value const &item)
         throw(Name_Duplicated);
 
+      /**
+       * \brief Inserts one item to the object taking its ownership
+       *
+       * \param name Name for the property to insert
+       *
+       * \param item Pointer to an item value allocated from the heap.
+       *
+       * \exception Name_Duplicated
+       * This exception is thrown in case the object already has a property
+       * with the same name as the one to insert. The item is released before
+       * the exception is thrown.
+       *
+       * \par Description
+       * Inserts the item at the specified name for the object without copying
+       * it. From this point on the instance is responsible for releasing the
+       * item.
+       */
+      void adoptItem(std::string const &name, Value *item)
+        throw(Name_Duplicated);
+
+      /**
+       * \brief Takes one item out of the object
+       *
+       * \param name Name of the property.
+       *
+       * \returns a pointer to the item or NULL if there is no property with
+       * that name.
+       *
+       * \warning
+       * From this point on it is up to the caller to release the item.
+       */
+      Value *detachItem(std::string const &name);
+
+      /**
+       * \brief Sets one property taking the ownership of the new item
+       *
+       * \param name Name of the property.
+       *
+       * \param item Pointer to the new item allocated from the heap.
+       *
+       * \returns a pointer to the former item or NULL if the property did
+       * not exist, in which case it is inserted.
+       *
+       * \warning
+       * From this point on it is up to the caller to release the former
+       * item.
+       */
+      Value *replaceItem(std::string const &name, Value *item);
+
       /**
        * \brief Empties the contents of an instance
        *
@@ -183,6 +242,17 @@ namespace JAULA
        */
       virtual void clear(void);
 
+      /**
+       * \brief Exchanges the contents of two instances
+       *
+       * \param other Instance to exchange the contents with.
+       *
+       * \par Description
+       * The items are not copied, so any references to them remain valid
+       * although they belong to the other instance.
+       */
+      void swap(Value_Object &other);
+
     private:
 
       /**
@@ -32,17 +32,12 @@ extern "C"
 #include <config.h>
 #endif
 
-#ifdef HAVE_CTYPE_H
-#include <ctype.h>
-#endif
-
 }
 
 
-#ifdef HAVE_SSTREAM
-#include <sstream>
-#endif
-
+#include <jaula/jaula_output_buffer.h>
+#include <jaula/jaula_stream_sink.h>
+#include <jaula/jaula_string_escape.h>
 #include <jaula/jaula_value_string.h>
 
 namespace JAULA
@@ -51,6 +46,16 @@ namespace JAULA
   Value_String::Value_String(std::string const &data)
     : Value(TYPE_STRING)
     , data_(data)
+    , escapeFlags_(0)
+    , classified_(false)
+    {}
+
+  Value_String::Value_String(std::string const &data
+    , unsigned int escape_flags)
+    : Value(TYPE_STRING)
+    , data_(data)
+    , escapeFlags_(escape_flags)
+    , classified_(true)
     {}
 
   Value_String::~Value_String()
@@ -61,14 +66,28 @@ namespace JAULA
     return data_;
   }
 
+  unsigned int Value_String::getEscapeFlags(void) const
+  {
+    if (!classified_)
+    {
+      escapeFlags_ = String_Escape::classify(data_.data(), data_.size());
+      classified_ = true;
+    }
+    return escapeFlags_;
+  }
+
   void Value_String::repr(std::ostream &ostr) const
   {
-    stringRepr(ostr, data_);
+    Stream_Sink   sink(ostr);
+    Output_Buffer out(sink, data_.size() + 64);
+    String_Escape::escape(out, data_.data(), data_.size(), getEscapeFlags());
   }
 
   void Value_String::set(std::string const &data)
   {
     data_ = data;
+    classified_ = false;
+    changed();
   }
 
   void Value_String::set(Value const &origin) throw(Bad_Data_Type)
@@ -80,6 +99,9 @@ namespace JAULA
       if (!pOrg)
         throw Bad_Data_Type("Origin and Destination types do not match", "narrowing origin to destination type");
       data_ = pOrg->getData();
+      escapeFlags_ = pOrg->getEscapeFlags();
+      classified_ = true;
+      changed();
     }
     catch(Bad_Data_Type &ex)
     {
@@ -90,41 +112,9 @@ namespace JAULA
 
   void Value_String::stringRepr(std::ostream &ostr, std::string const &str)
   {
-    ostr << '"';
-    for (std::string::size_type i = 0; (i != str.size()); i++)
-    {
-      if (str[i] == '"')
-        ostr << '\\' << '"';
-      else if (str[i] == '\\')
-        ostr << '\\' << '\\';
-      else if (str[i] == '/')
-        ostr << '\\' << '/';
-      else if (str[i] == '\b')
-        ostr << '\\' << 'b';
-      else if (str[i] == '\f')
-        ostr << '\\' << 'f';
-      else if (str[i] == '\n')
-        ostr << '\\' << 'n';
-      else if (str[i] == '\r')
-        ostr << '\\' << 'r';
-      else if (str[i] == '\t')
-        ostr << '\\' << 't';
-      else if (str[i] == ' ')
-        ostr << ' ';
-      else if (isprint(str[i]))
-        ostr << str[i];
-      else
-      {
-        std::ostringstream  aux;
-        int val = static_cast<int>(str[i]) & 0x00ff;
-        aux << std::hex << val;
-        ostr << '\\' << 'u';
-        for (std::string::size_type j = 0; ((j + aux.str().size()) < 4); j++)
-          ostr << '0';
-        ostr << aux.str();
-      }
-    }
-    ostr << '"';
+    Stream_Sink   sink(ostr);
+    Output_Buffer out(sink, str.size() + 64);
+    String_Escape::escape(out, str);
   }
 
 }                                // namespace JAULA
@@ -59,6 +59,20 @@ namespace JAULA
        */
       Value_String(std::string const &data = "");
 
+      /**
+       * \brief Constructor for already analyzed contents
+       *
+       * \param data Initial value to be hold by the conatiner
+       *
+       * \param escape_flags Contents description as returned by
+       * String_Escape::classify() for data.
+       *
+       * \par Description
+       * Used when copying values, so the contents already analyzed need not
+       * be analyzed again when writing them.
+       */
+      Value_String(std::string const &data, unsigned int escape_flags);
+
       /**
        * \brief Destructor
        */
@@ -69,6 +83,15 @@ namespace JAULA
        */
       std::string const &getData(void) const;
 
+      /**
+       * \brief Retrieves the contents description
+       *
+       * \returns the contents description as returned by
+       * String_Escape::classify(). The analysis is only performed the first
+       * time it is needed after the contents change.
+       */
+      unsigned int getEscapeFlags(void) const;
+
       /**
        * \brief Represents the instance in a stream
        *
@@ -107,8 +130,8 @@ namespace JAULA
        *
        * \par Description
        * Represents a string in JSON notation, surrounding it with quotes and
-       * changing all the non-printable symbols by its control codes or
-       * unicode values.
+       * changing quotes, backslashes and control characters by their escape
+       * sequences. UTF-8 sequences are kept as they are.
        */
       static void stringRepr(std::ostream &ostr, std::string const &str);
 
@@ -118,6 +141,16 @@ namespace JAULA
        * \brief Container to hold the value itself
        */
       std::string    data_;
+
+      /**
+       * \brief Contents description (see String_Escape::classify())
+       */
+      mutable unsigned int  escapeFlags_;
+
+      /**
+       * \brief Flag for a valid contents description
+       */
+      mutable bool  classified_;
   };                             // class Value_String
 
 }                                // namespace JAULA
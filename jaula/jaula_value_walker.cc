@@ -0,0 +1,183 @@
+
+/*
+ * jaula_value_walker.cc : JSON Analysis User Library Acronym
+ * Value events generator implementation
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+}
+
+
+#ifdef HAVE_VECTOR
+#include <vector>
+#endif
+
+#include <jaula/jaula_value_array.h>
+#include <jaula/jaula_value_boolean.h>
+#include <jaula/jaula_value_number.h>
+#include <jaula/jaula_value_number_int.h>
+#include <jaula/jaula_value_object.h>
+#include <jaula/jaula_value_string.h>
+#include <jaula/jaula_value_walker.h>
+
+namespace
+{                                // anonymous namespace
+
+  using namespace JAULA;
+
+  /**
+   * \brief Complex value being walked through
+   */
+  struct Frame
+  {                              // struct Frame
+    /** array being walked through (null for objects) */
+    Value_Array const   *pArray;
+    /** object being walked through (null for arrays) */
+    Value_Object const  *pObject;
+    /** next array item */
+    Value_Array::dataType::const_iterator   item;
+    /** next object property */
+    Value_Object::dataType::const_iterator  property;
+  };                             // struct Frame
+
+}                                // anonymous namespace
+
+namespace JAULA
+{                                // namespace JAULA
+
+  bool Value_Walker::walk(Value const &val, Parse_Handler &handler)
+  {
+    std::vector<Frame>  stack;
+    Value const *pItem = &val;
+    for (;;)
+    {                            // items loop
+      bool  accepted = true;
+      switch (pItem->getType())
+      {                          // value type switch
+        case Value::TYPE_BOOLEAN :
+          accepted = handler.booleanValue(
+            static_cast<Value_Boolean const *>(pItem)->getData());
+          break;
+
+        case Value::TYPE_STRING :
+          accepted = handler.stringValue(
+            static_cast<Value_String const *>(pItem)->getData());
+          break;
+
+        case Value::TYPE_NUMBER :
+        {
+          Value_Number const *pNumber =
+            static_cast<Value_Number const *>(pItem);
+          accepted = pNumber->getText().empty()
+            ? handler.numberValue(pNumber->getData())
+            : handler.numberTextValue(pNumber->getText());
+          break;
+        }
+
+        case Value::TYPE_NUMBER_INT :
+        {
+          Value_Number_Int const *pNumber =
+            static_cast<Value_Number_Int const *>(pItem);
+          if (!pNumber->getText().empty())
+            accepted = handler.numberTextValue(pNumber->getText());
+          else if (pNumber->isUnsigned())
+            accepted = handler.numberUnsignedValue(pNumber->getUnsigned());
+          else
+            accepted = handler.numberIntValue(pNumber->getInt64());
+          break;
+        }
+
+        case Value::TYPE_ARRAY :
+        {
+          Frame frame;
+          frame.pArray = static_cast<Value_Array const *>(pItem);
+          frame.pObject = 0;
+          frame.item = frame.pArray->getData().begin();
+          stack.push_back(frame);
+          accepted = handler.arrayBegin();
+        }
+        break;
+
+        case Value::TYPE_OBJECT :
+        {
+          Frame frame;
+          frame.pArray = 0;
+          frame.pObject = static_cast<Value_Object const *>(pItem);
+          frame.property = frame.pObject->getData().begin();
+          stack.push_back(frame);
+          accepted = handler.objectBegin();
+        }
+        break;
+
+        default :
+          accepted = handler.nullValue();
+          break;
+      }                          // value type switch
+      if (!accepted)
+        return false;
+
+      pItem = 0;
+      while (!pItem)
+      {                          // next item search
+        if (stack.empty())
+          return true;
+        Frame &frame = stack.back();
+        if (frame.pArray)
+        {
+          if (frame.item != frame.pArray->getData().end())
+            pItem = *(frame.item++);
+          else
+          {
+            stack.pop_back();
+            if (!handler.arrayEnd())
+              return false;
+          }
+        }
+        else
+        {
+          if (frame.property != frame.pObject->getData().end())
+          {
+            if (!handler.propertyName(frame.property->first))
+              return false;
+            pItem = (frame.property++)->second;
+          }
+          else
+          {
+            stack.pop_back();
+            if (!handler.objectEnd())
+              return false;
+          }
+        }
+      }                          // next item search
+    }                            // items loop
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
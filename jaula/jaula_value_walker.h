@@ -0,0 +1,76 @@
+
+/*
+ * jaula_value_walker.h : JSON Analysis User Library Acronym
+ * Value events generator definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_VALUE_WALKER_H_
+#define _JAULA_VALUE_WALKER_H_
+
+#include <jaula/jaula_parse_handler.h>
+#include <jaula/jaula_value.h>
+
+/**
+ * \addtogroup jaula_parse JAULA: JSON data parser
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief Parsing events generator for values
+   *
+   * \ingroup jaula_parse
+   *
+   * \par
+   * This class walks through a value sending a handler the same events a
+   * parser would send while reading its JSON representation, so any
+   * handler can be used on values already built. The walk is done without
+   * recursion.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Value_Walker
+  {                              // class Value_Walker
+    public:
+
+      /**
+       * \brief Walks through a value
+       *
+       * \param val Value to walk through.
+       *
+       * \param handler Handler to receive the events.
+       *
+       * \returns true if the handler accepted all the events or false if
+       * it stopped the walk.
+       */
+      static bool walk(Value const &val, Parse_Handler &handler);
+
+  };                             // class Value_Walker
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$
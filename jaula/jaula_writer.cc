@@ -0,0 +1,340 @@
+
+/*
+ * jaula_writer.cc : JSON Analysis User Library Acronym
+ * JSON data writer definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+extern "C"
+{
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+}
+
+
+#include <jaula/jaula_number_format.h>
+#include <jaula/jaula_string_escape.h>
+#include <jaula/jaula_value_boolean.h>
+#include <jaula/jaula_value_number.h>
+#include <jaula/jaula_value_number_int.h>
+#include <jaula/jaula_value_string.h>
+#include <jaula/jaula_writer.h>
+
+namespace JAULA
+{                                // namespace JAULA
+
+  Writer::Writer(void)
+    : buffer_()
+    , stack_()
+    , asciiOnly_(false)
+    , precision_(0)
+    , indent_(0)
+    , compact_(false)
+    , itemSeparator_(", ")
+    , nameSeparator_(" : ")
+    {}
+
+  Writer::Writer(Sink &sink, size_t buffer_size)
+    : buffer_(sink, buffer_size)
+    , stack_()
+    , asciiOnly_(false)
+    , precision_(0)
+    , indent_(0)
+    , compact_(false)
+    , itemSeparator_(", ")
+    , nameSeparator_(" : ")
+    {}
+
+  Writer::~Writer()
+    {}
+
+  void Writer::write(Value const &val)
+  {
+    if ((val.getType() != Value::TYPE_ARRAY)
+      && (val.getType() != Value::TYPE_OBJECT))
+      writeSimple(val);
+    else
+      open(val);
+
+    while (!stack_.empty())
+    {                            // complex values loop
+      Frame &frame = stack_.back();
+      Value const *pItem;
+      if (frame.pArray)
+      {                          // array item
+        if (frame.item == frame.pArray->getData().end())
+        {
+          bool  empty = frame.pArray->empty();
+          stack_.pop_back();
+          close(']', empty);
+          continue;
+        }
+        if (frame.item != frame.pArray->getData().begin())
+          separate();
+        pItem = *(frame.item++);
+      }                          // array item
+      else
+      {                          // object property
+        if (frame.property == frame.pObject->getData().end())
+        {
+          bool  empty = frame.pObject->empty();
+          stack_.pop_back();
+          close('}', empty);
+          continue;
+        }
+        if (frame.property != frame.pObject->getData().begin())
+          separate();
+        String_Escape::escape(buffer_, frame.property->first, asciiOnly_);
+        if (compact_)
+          buffer_.append(':');
+        else
+          buffer_.append(nameSeparator_.data(), nameSeparator_.size());
+        pItem = (frame.property++)->second;
+      }                          // object property
+
+      if ((pItem->getType() != Value::TYPE_ARRAY)
+        && (pItem->getType() != Value::TYPE_OBJECT))
+        writeSimple(*pItem);
+      else
+        open(*pItem);
+    }                            // complex values loop
+
+    if (buffer_.getSink())
+      buffer_.flush();
+  }
+
+  char const *Writer::data(void) const
+  {
+    return buffer_.data();
+  }
+
+  size_t Writer::size(void) const
+  {
+    return buffer_.size();
+  }
+
+  std::string Writer::str(void) const
+  {
+    return buffer_.str();
+  }
+
+  void Writer::clear(void)
+  {
+    buffer_.clear();
+  }
+
+  void Writer::flush(void)
+  {
+    buffer_.flush();
+  }
+
+  void Writer::setAsciiOnly(bool ascii_only)
+  {
+    asciiOnly_ = ascii_only;
+  }
+
+  bool Writer::getAsciiOnly(void) const
+  {
+    return asciiOnly_;
+  }
+
+  void Writer::setIndent(size_t indent)
+  {
+    indent_ = indent;
+  }
+
+  size_t Writer::getIndent(void) const
+  {
+    return indent_;
+  }
+
+  void Writer::setSeparators(std::string const &item_separator
+    , std::string const &name_separator)
+  {
+    itemSeparator_ = item_separator;
+    nameSeparator_ = name_separator;
+  }
+
+  std::string const &Writer::getItemSeparator(void) const
+  {
+    return itemSeparator_;
+  }
+
+  std::string const &Writer::getNameSeparator(void) const
+  {
+    return nameSeparator_;
+  }
+
+  void Writer::setCompact(bool compact)
+  {
+    compact_ = compact;
+  }
+
+  bool Writer::getCompact(void) const
+  {
+    return compact_;
+  }
+
+  void Writer::setPrecision(int precision)
+  {
+    precision_ = precision;
+  }
+
+  int Writer::getPrecision(void) const
+  {
+    return precision_;
+  }
+
+  void Writer::writeSimple(Value const &val)
+  {
+    switch (val.getType())
+    {                            // value type switch
+      case Value::TYPE_NULL :
+        buffer_.append("null", 4);
+        break;
+
+      case Value::TYPE_BOOLEAN :
+        if (static_cast<Value_Boolean const &>(val).getData())
+          buffer_.append("true", 4);
+        else
+          buffer_.append("false", 5);
+        break;
+
+      case Value::TYPE_STRING :
+      {
+        Value_String const &str = static_cast<Value_String const &>(val);
+        String_Escape::escape(buffer_, str.getData().data()
+          , str.getData().size(), str.getEscapeFlags(), asciiOnly_);
+      }
+      break;
+
+      case Value::TYPE_NUMBER :
+      {
+        Value_Number const &num = static_cast<Value_Number const &>(val);
+        if (num.getText().empty())
+          Number_Format::writeDouble(buffer_, num.getData(), precision_);
+        else
+          buffer_.append(num.getText().data(), num.getText().size());
+      }
+      break;
+
+      case Value::TYPE_NUMBER_INT :
+      {
+        Value_Number_Int const &num =
+          static_cast<Value_Number_Int const &>(val);
+        if (!num.getText().empty())
+          buffer_.append(num.getText().data(), num.getText().size());
+        else if (num.isUnsigned())
+          Number_Format::writeUnsigned(buffer_, num.getUnsigned());
+        else
+          Number_Format::writeInt(buffer_, num.getInt64());
+      }
+      break;
+
+      default :
+        break;
+
+    }                            // value type switch
+  }
+
+  void Writer::open(Value const &val)
+  {
+    Frame frame;
+    bool  empty;
+    if (val.getType() == Value::TYPE_ARRAY)
+    {
+      frame.pArray = static_cast<Value_Array const *>(&val);
+      frame.pObject = 0;
+      frame.item = frame.pArray->getData().begin();
+      empty = frame.pArray->empty();
+      buffer_.append('[');
+    }
+    else
+    {
+      frame.pArray = 0;
+      frame.pObject = static_cast<Value_Object const *>(&val);
+      frame.property = frame.pObject->getData().begin();
+      empty = frame.pObject->empty();
+      buffer_.append('{');
+    }
+    stack_.push_back(frame);
+
+    if (indent_)
+    {
+      if (!empty)
+        newLine();
+    }
+    else if (!compact_)
+      buffer_.append(' ');
+  }
+
+  void Writer::close(char bracket, bool empty)
+  {
+    if (indent_)
+    {
+      if (!empty)
+        newLine();
+    }
+    else if (!compact_)
+      buffer_.append(' ');
+    buffer_.append(bracket);
+  }
+
+  void Writer::separate(void)
+  {
+    if (compact_)
+      buffer_.append(',');
+    else if (!indent_)
+    {
+      buffer_.append(itemSeparator_.data(), itemSeparator_.size());
+      return;
+    }
+    else
+    {
+      size_t  len = itemSeparator_.size();
+      while (len && (itemSeparator_[len - 1] == ' '))
+        len--;
+      buffer_.append(itemSeparator_.data(), len);
+    }
+    if (indent_)
+      newLine();
+  }
+
+  void Writer::newLine(void)
+  {
+    size_t  len = indent_ * stack_.size();
+    char    *p = buffer_.reserve(len + 1);
+    *p = '\n';
+    memset(p + 1, ' ', len);
+    buffer_.commit(len + 1);
+  }
+
+}                                // namespace JAULA
+
+// EOF $Id$
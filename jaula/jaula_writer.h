@@ -0,0 +1,319 @@
+
+/*
+ * jaula_writer.h : JSON Analysis User Library Acronym
+ * JSON data writer definitions
+ *
+ * Copyright (C) 2007, 2008, 2009 Kombo Morongo <morongo666@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * svn info:
+ * $Author$
+ * $HeadURL$
+ * $Id$
+ * $Revision$
+ */
+
+#ifndef _JAULA_WRITER_H_
+#define _JAULA_WRITER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <jaula/jaula_output_buffer.h>
+#include <jaula/jaula_sink.h>
+#include <jaula/jaula_value.h>
+#include <jaula/jaula_value_array.h>
+#include <jaula/jaula_value_object.h>
+
+/**
+ * \addtogroup jaula_out JAULA: JSON data output
+ */
+
+namespace JAULA
+{                                // namespace JAULA
+
+  /**
+   * \brief JSON Data Writer
+   *
+   * \ingroup jaula_out
+   *
+   * \par
+   * This class writes values in JSON notation into a contiguous memory
+   * buffer or into a sink. By default the output is the same one obtained
+   * from Value::repr() but it is generated without standard C++ streams and
+   * without recursion, so nesting depth is only limited by the available
+   * memory.
+   *
+   * \par
+   * The layout can be changed to compact output without any blanks (see
+   * setCompact()) or to an indented one with an item per line (see
+   * setIndent()). Object properties are always written sorted by name, as
+   * they are kept by Value_Object.
+   *
+   * \author Kombo Morongo <morongo666@gmail.com>
+   */
+  class Writer
+  {                              // class Writer
+    public:
+
+      /**
+       * \brief Default Constructor
+       *
+       * \par Description
+       * Creates a writer that keeps all the data written in a buffer that
+       * grows as needed (see data() and str()).
+       */
+      Writer(void);
+
+      /**
+       * \brief Sink Constructor
+       *
+       * \param sink Reference to the sink where data is to be sent. It must
+       * exist during all the writer life cycle.
+       *
+       * \param buffer_size Amount of data to gather before sending it to the
+       * sink.
+       */
+      Writer(Sink &sink, size_t buffer_size = 65536);
+
+      /**
+       * \brief Destructor
+       *
+       * \note
+       * Data not flushed yet is sent to the sink (if any).
+       */
+      ~Writer();
+
+      /**
+       * \brief Writes a value
+       *
+       * \param val Value to write.
+       *
+       * \par Description
+       * Writes the value in JSON notation after any data already written.
+       * When writing to a sink, all the data is sent to it before returning.
+       */
+      void write(Value const &val);
+
+      /**
+       * \brief Retrieves the data written and not sent to a sink
+       */
+      char const *data(void) const;
+
+      /**
+       * \brief Retrieves the number of bytes returned by data()
+       */
+      size_t size(void) const;
+
+      /**
+       * \brief Retrieves a copy of the data written and not sent to a sink
+       */
+      std::string str(void) const;
+
+      /**
+       * \brief Discards the data written and not sent to a sink
+       */
+      void clear(void);
+
+      /**
+       * \brief Sends pending data to the sink and flushes it
+       */
+      void flush(void);
+
+      /**
+       * \brief Establishes how non ASCII characters are written
+       *
+       * \param ascii_only flag to write characters outside the ASCII range as
+       * unicode escape sequences instead of copying their UTF-8 sequences.
+       */
+      void setAsciiOnly(bool ascii_only);
+
+      /**
+       * \brief Retrieves how non ASCII characters are written
+       */
+      bool getAsciiOnly(void) const;
+
+      /**
+       * \brief Establishes the indentation
+       *
+       * \param indent Number of spaces per nesting level, 0 (the default) to
+       * write everything in a single line.
+       *
+       * \par Description
+       * When indenting, every array item and object property is written in
+       * its own line and the trailing blanks of the item separator are
+       * omitted.
+       */
+      void setIndent(size_t indent);
+
+      /**
+       * \brief Retrieves the indentation
+       */
+      size_t getIndent(void) const;
+
+      /**
+       * \brief Establishes the separators
+       *
+       * \param item_separator Text written between array items or object
+       * properties (\", \" by default).
+       *
+       * \param name_separator Text written between a property name and its
+       * value (\" : \" by default).
+       *
+       * \par Description
+       * The separators are kept but not used while in compact mode.
+       */
+      void setSeparators(std::string const &item_separator
+        , std::string const &name_separator);
+
+      /**
+       * \brief Retrieves the item separator
+       */
+      std::string const &getItemSeparator(void) const;
+
+      /**
+       * \brief Retrieves the property name separator
+       */
+      std::string const &getNameSeparator(void) const;
+
+      /**
+       * \brief Establishes the compact mode
+       *
+       * \param compact flag for writing without any blanks. Separators are
+       * written as \",\" and \":\" while it is set, and the ones established
+       * by setSeparators() are used again once it is cleared.
+       */
+      void setCompact(bool compact);
+
+      /**
+       * \brief Retrieves the compact mode
+       */
+      bool getCompact(void) const;
+
+      /**
+       * \brief Establishes how floating point numbers are written
+       *
+       * \param precision Number of significant digits to write, 0 (the
+       * default) for the shortest representation that reads back as the same
+       * value.
+       */
+      void setPrecision(int precision);
+
+      /**
+       * \brief Retrieves how floating point numbers are written
+       */
+      int getPrecision(void) const;
+
+    private:
+
+      /**
+       * \brief Complex value being written
+       */
+      struct Frame
+      {                          // struct Frame
+        /** array being written (null for objects) */
+        Value_Array const   *pArray;
+        /** object being written (null for arrays) */
+        Value_Object const  *pObject;
+        /** next array item to write */
+        Value_Array::dataType::const_iterator   item;
+        /** next object property to write */
+        Value_Object::dataType::const_iterator  property;
+      };                         // struct Frame
+
+      /**
+       * \brief Copy constructor (not available)
+       */
+      Writer(Writer const &orig);
+
+      /**
+       * \brief Assignment operator (not available)
+       */
+      Writer &operator=(Writer const &orig);
+
+      /**
+       * \brief Writes a value not being a complex one
+       */
+      void writeSimple(Value const &val);
+
+      /**
+       * \brief Writes the beginning of a complex value
+       */
+      void open(Value const &val);
+
+      /**
+       * \brief Writes the end of a complex value
+       */
+      void close(char bracket, bool empty);
+
+      /**
+       * \brief Writes the separation between items of a complex value
+       */
+      void separate(void);
+
+      /**
+       * \brief Starts a new line indented for the current nesting level
+       */
+      void newLine(void);
+
+      /**
+       * \brief Output buffer
+       */
+      Output_Buffer buffer_;
+
+      /**
+       * \brief Complex values being written
+       */
+      std::vector<Frame>  stack_;
+
+      /**
+       * \brief Flag for writing non ASCII characters as escape sequences
+       */
+      bool  asciiOnly_;
+
+      /**
+       * \brief Significant digits for floating point numbers (0 for
+       * shortest)
+       */
+      int   precision_;
+
+      /**
+       * \brief Spaces per nesting level (0 for no indentation)
+       */
+      size_t  indent_;
+
+      /**
+       * \brief Flag for writing without blanks
+       */
+      bool  compact_;
+
+      /**
+       * \brief Text between items
+       */
+      std::string itemSeparator_;
+
+      /**
+       * \brief Text between property names and values
+       */
+      std::string nameSeparator_;
+
+  };                             // class Writer
+
+}                                // namespace JAULA
+#endif
+
+// EOF $Id$